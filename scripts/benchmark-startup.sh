@@ -0,0 +1,64 @@
+#!/usr/bin/env bash
+#
+# Benchmark the startup time of sherpa-onnx binaries with and without
+# the optimized model cache (--model-cache).
+#
+# Usage:
+#
+#   ./scripts/benchmark-startup.sh [num_runs] -- \
+#     ./build/bin/sherpa-onnx-offline \
+#       --tokens=/path/to/tokens.txt \
+#       --encoder=/path/to/encoder.onnx \
+#       --decoder=/path/to/decoder.onnx \
+#       --joiner=/path/to/joiner.onnx \
+#       /path/to/foo.wav
+#
+# It works with ./build/bin/sherpa-onnx as well. Each run is a new process
+# and the binary prints "Recognizer init time". The first run with the cache
+# enabled populates the cache and is reported separately.
+
+set -e
+
+num_runs=5
+if [ $# -gt 0 ] && [ "$1" != "--" ]; then
+  num_runs=$1
+  shift
+fi
+
+if [ "$1" == "--" ]; then
+  shift
+fi
+
+if [ $# -lt 1 ]; then
+  sed -n '3,18p' "$0" | sed 's/^# \{0,1\}//'
+  exit 1
+fi
+
+cache_dir=$(mktemp -d)
+trap 'rm -rf "$cache_dir"' EXIT
+
+init_time() {
+  "$@" 2>&1 | grep "Recognizer init time" | awk '{print $4}'
+}
+
+average() {
+  awk '{ s += $1 } END { if (NR > 0) printf "%.3f", s / NR }'
+}
+
+echo "Without the model cache:"
+for i in $(seq "$num_runs"); do
+  init_time "$@"
+done | tee "$cache_dir/no-cache.txt"
+
+# Options have to be given before the positional arguments, so the cache
+# options are inserted right after the binary.
+echo "First run with the model cache (populating it):"
+init_time "$1" --model-cache=true --model-cache-dir="$cache_dir" "${@:2}"
+
+echo "With the model cache:"
+for i in $(seq "$num_runs"); do
+  init_time "$1" --model-cache=true --model-cache-dir="$cache_dir" "${@:2}"
+done | tee "$cache_dir/cache.txt"
+
+echo "Average init time without the cache: $(average < "$cache_dir/no-cache.txt") s"
+echo "Average init time with the cache:    $(average < "$cache_dir/cache.txt") s"
@@ -1023,13 +1023,13 @@ void SherpaOnnxVoiceActivityDetectorClear(SherpaOnnxVoiceActivityDetector *p) {
 
 const SherpaOnnxSpeechSegment *SherpaOnnxVoiceActivityDetectorFront(
     SherpaOnnxVoiceActivityDetector *p) {
-  const sherpa_onnx::SpeechSegment &segment = p->impl->Front();
+  const sherpa_onnx::SpeechSegmentView &segment = p->impl->FrontView();
 
   SherpaOnnxSpeechSegment *ans = new SherpaOnnxSpeechSegment;
   ans->start = segment.start;
-  ans->samples = new float[segment.samples.size()];
-  std::copy(segment.samples.begin(), segment.samples.end(), ans->samples);
-  ans->n = segment.samples.size();
+  ans->samples = new float[segment.NumSamples()];
+  segment.CopyTo(ans->samples);
+  ans->n = segment.NumSamples();
 
   return ans;
 }
@@ -0,0 +1,157 @@
+// sherpa-onnx/csrc/batched-voice-activity-detector.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/batched-voice-activity-detector.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if __ANDROID_API__ >= 9
+#include "android/asset_manager.h"
+#include "android/asset_manager_jni.h"
+#endif
+
+#if __OHOS__
+#include "rawfile/raw_file_manager.h"
+#endif
+
+#include "sherpa-onnx/csrc/vad-model.h"
+
+namespace sherpa_onnx {
+
+class BatchedVoiceActivityDetector::Impl {
+ public:
+  explicit Impl(const VadModelConfig &config, float buffer_size_in_seconds)
+      : model_(VadModel::Create(config)),
+        config_(config),
+        buffer_size_in_seconds_(buffer_size_in_seconds) {}
+
+  template <typename Manager>
+  Impl(Manager *mgr, const VadModelConfig &config,
+       float buffer_size_in_seconds)
+      : model_(VadModel::Create(mgr, config)),
+        config_(config),
+        buffer_size_in_seconds_(buffer_size_in_seconds) {}
+
+  std::unique_ptr<VadStream> CreateStream() const {
+    return std::make_unique<VadStream>(config_, model_->WindowSize(),
+                                       model_->WindowShift(),
+                                       buffer_size_in_seconds_);
+  }
+
+  void Compute(VadStream **ss, int32_t n) {
+    int32_t window_size = model_->WindowSize();
+
+    std::vector<int32_t> num_windows(n);
+    std::vector<std::vector<float>> probs(n);
+
+    int32_t max_num_windows = 0;
+    for (int32_t i = 0; i != n; ++i) {
+      num_windows[i] = ss[i]->GetSegmenter().NumWindows();
+      probs[i].resize(num_windows[i]);
+      max_num_windows = std::max(max_num_windows, num_windows[i]);
+
+      if (ss[i]->GetStates().empty()) {
+        ss[i]->SetStates(model_->GetInitStates());
+      }
+    }
+
+    std::vector<int32_t> indexes;
+    indexes.reserve(n);
+
+    std::vector<std::vector<Ort::Value>> states;
+    states.reserve(n);
+
+    for (int32_t w = 0; w != max_num_windows; ++w) {
+      indexes.clear();
+      for (int32_t i = 0; i != n; ++i) {
+        if (w < num_windows[i]) {
+          indexes.push_back(i);
+        }
+      }
+
+      int32_t batch_size = static_cast<int32_t>(indexes.size());
+
+      samples_.resize(batch_size * window_size);
+      states.clear();
+
+      float *p = samples_.data();
+      for (int32_t i : indexes) {
+        const float *window = ss[i]->GetSegmenter().GetWindow(w);
+        std::copy(window, window + window_size, p);
+        p += window_size;
+
+        states.push_back(std::move(ss[i]->GetStates()));
+      }
+
+      std::vector<float> batch_probs = model_->GetProbBatch(
+          samples_.data(), batch_size, window_size, &states);
+
+      for (int32_t b = 0; b != batch_size; ++b) {
+        int32_t i = indexes[b];
+        probs[i][w] = batch_probs[b];
+        ss[i]->SetStates(std::move(states[b]));
+      }
+    }
+
+    // The segment logic is applied to each stream separately
+    for (int32_t i = 0; i != n; ++i) {
+      if (num_windows[i] == 0) {
+        continue;
+      }
+
+      ss[i]->SetLastScore(probs[i].back());
+      ss[i]->GetSegmenter().AcceptProbs(probs[i].data(), num_windows[i]);
+    }
+  }
+
+  const VadModelConfig &GetConfig() const { return config_; }
+
+ private:
+  std::unique_ptr<VadModel> model_;
+  VadModelConfig config_;
+  float buffer_size_in_seconds_;
+
+  // input samples of a batch, (batch_size, window_size)
+  std::vector<float> samples_;
+};
+
+BatchedVoiceActivityDetector::BatchedVoiceActivityDetector(
+    const VadModelConfig &config, float buffer_size_in_seconds /*= 60*/)
+    : impl_(std::make_unique<Impl>(config, buffer_size_in_seconds)) {}
+
+template <typename Manager>
+BatchedVoiceActivityDetector::BatchedVoiceActivityDetector(
+    Manager *mgr, const VadModelConfig &config,
+    float buffer_size_in_seconds /*= 60*/)
+    : impl_(std::make_unique<Impl>(mgr, config, buffer_size_in_seconds)) {}
+
+BatchedVoiceActivityDetector::~BatchedVoiceActivityDetector() = default;
+
+std::unique_ptr<VadStream> BatchedVoiceActivityDetector::CreateStream() const {
+  return impl_->CreateStream();
+}
+
+void BatchedVoiceActivityDetector::Compute(VadStream **ss, int32_t n) const {
+  impl_->Compute(ss, n);
+}
+
+const VadModelConfig &BatchedVoiceActivityDetector::GetConfig() const {
+  return impl_->GetConfig();
+}
+
+#if __ANDROID_API__ >= 9
+template BatchedVoiceActivityDetector::BatchedVoiceActivityDetector(
+    AAssetManager *mgr, const VadModelConfig &config,
+    float buffer_size_in_seconds = 60);
+#endif
+
+#if __OHOS__
+template BatchedVoiceActivityDetector::BatchedVoiceActivityDetector(
+    NativeResourceManager *mgr, const VadModelConfig &config,
+    float buffer_size_in_seconds = 60);
+#endif
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,68 @@
+// sherpa-onnx/csrc/batched-voice-activity-detector.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_BATCHED_VOICE_ACTIVITY_DETECTOR_H_
+#define SHERPA_ONNX_CSRC_BATCHED_VOICE_ACTIVITY_DETECTOR_H_
+
+#include <memory>
+
+#include "sherpa-onnx/csrc/vad-model-config.h"
+#include "sherpa-onnx/csrc/vad-stream.h"
+
+namespace sherpa_onnx {
+
+// Voice activity detection for many streams with a single model.
+//
+// Compared with using one VoiceActivityDetector per stream, it runs the
+// model once for the current windows of all streams instead of once per
+// stream and window.
+//
+// Usage:
+//
+//   BatchedVoiceActivityDetector vad(config);
+//   auto s1 = vad.CreateStream();
+//   auto s2 = vad.CreateStream();
+//
+//   s1->AcceptWaveform(...);
+//   s2->AcceptWaveform(...);
+//
+//   VadStream *ss[] = {s1.get(), s2.get()};
+//   vad.Compute(ss, 2);
+//
+//   while (!s1->Empty()) { use s1->Front(); s1->Pop(); }
+class BatchedVoiceActivityDetector {
+ public:
+  explicit BatchedVoiceActivityDetector(const VadModelConfig &config,
+                                        float buffer_size_in_seconds = 60);
+
+  template <typename Manager>
+  BatchedVoiceActivityDetector(Manager *mgr, const VadModelConfig &config,
+                               float buffer_size_in_seconds = 60);
+
+  ~BatchedVoiceActivityDetector();
+
+  std::unique_ptr<VadStream> CreateStream() const;
+
+  /** Process the samples received by the given streams.
+   *
+   * Each stream may have several complete windows. The model is run once
+   * per window index, i.e., the i-th run processes the i-th window of all
+   * streams that have at least i+1 windows.
+   *
+   * It is not thread-safe.
+   *
+   * @param ss Pointer to an array of streams.
+   * @param n Number of streams in ss.
+   */
+  void Compute(VadStream **ss, int32_t n) const;
+
+  const VadModelConfig &GetConfig() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_BATCHED_VOICE_ACTIVITY_DETECTOR_H_
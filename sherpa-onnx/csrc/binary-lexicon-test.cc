@@ -0,0 +1,100 @@
+// sherpa-onnx/csrc/binary-lexicon-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/binary-lexicon.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(BinaryLexicon, CompileAndLookup) {
+  std::string filename = "binary-lexicon-test.bin";
+
+  std::istringstream is(R"(HELLO h e l o
+world w o r l d
+
+a x
+a a
+good g u d
+你好 n i h ao
+)");
+
+  ASSERT_TRUE(BinaryLexicon::Compile(is, false, filename));
+  EXPECT_TRUE(BinaryLexicon::IsBinaryLexicon(filename));
+
+  // x is not a token, so the second entry of a is used
+  std::unordered_map<std::string, int32_t> token2id = {
+      {"h", 1}, {"e", 2}, {"l", 3}, {"o", 4}, {"w", 5}, {"r", 6},
+      {"d", 7}, {"a", 8}, {"n", 9}, {"i", 10}, {"ao", 11}};
+
+  BinaryLexicon lexicon(filename, token2id);
+  EXPECT_EQ(lexicon.NumWords(), 6);
+  EXPECT_FALSE(lexicon.HasTones());
+
+  std::vector<int64_t> ids;
+  EXPECT_TRUE(lexicon.Lookup("hello", &ids));
+  EXPECT_TRUE(lexicon.Lookup("world", &ids));
+  EXPECT_EQ(ids, (std::vector<int64_t>{1, 2, 3, 4, 5, 4, 6, 3, 7}));
+
+  ids.clear();
+  EXPECT_TRUE(lexicon.Lookup("a", &ids));
+  EXPECT_TRUE(lexicon.Lookup("你好", &ids));
+  EXPECT_EQ(ids, (std::vector<int64_t>{8, 9, 10, 1, 11}));
+
+  // u is not a token
+  ids.clear();
+  EXPECT_FALSE(lexicon.Lookup("good", &ids));
+  EXPECT_FALSE(lexicon.Lookup("HELLO", &ids));
+  EXPECT_FALSE(lexicon.Lookup("hell", &ids));
+  EXPECT_FALSE(lexicon.Lookup("", &ids));
+  EXPECT_TRUE(ids.empty());
+
+  // Load it from a buffer
+  std::ifstream ifs(filename, std::ios::binary);
+  std::vector<char> buf((std::istreambuf_iterator<char>(ifs)),
+                        std::istreambuf_iterator<char>());
+  BinaryLexicon lexicon2(buf, token2id);
+  EXPECT_TRUE(lexicon2.Lookup("world", &ids));
+  EXPECT_EQ(ids, (std::vector<int64_t>{5, 4, 6, 3, 7}));
+
+  std::remove(filename.c_str());
+}
+
+TEST(BinaryLexicon, Tones) {
+  std::string filename = "binary-lexicon-test-tones.bin";
+
+  std::istringstream is(R"(你 n i 0 3
+好 h ao 0 3
+)");
+
+  ASSERT_TRUE(BinaryLexicon::Compile(is, true, filename));
+
+  std::unordered_map<std::string, int32_t> token2id = {
+      {"n", 1}, {"i", 2}, {"h", 3}, {"ao", 4}};
+
+  BinaryLexicon lexicon(filename, token2id);
+  EXPECT_TRUE(lexicon.HasTones());
+
+  std::vector<int64_t> ids;
+  std::vector<int64_t> tones;
+  EXPECT_TRUE(lexicon.Lookup("你", &ids, &tones));
+  EXPECT_TRUE(lexicon.Lookup("好", &ids, &tones));
+  EXPECT_EQ(ids, (std::vector<int64_t>{1, 2, 3, 4}));
+  EXPECT_EQ(tones, (std::vector<int64_t>{0, 3, 0, 3}));
+
+  // The number of tones does not match
+  std::istringstream is2("你 n i 0\n");
+  EXPECT_FALSE(BinaryLexicon::Compile(is2, true, filename));
+
+  std::remove(filename.c_str());
+}
+
+}  // namespace sherpa_onnx
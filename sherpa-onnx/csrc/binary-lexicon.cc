@@ -0,0 +1,315 @@
+// sherpa-onnx/csrc/binary-lexicon.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/binary-lexicon.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'H', 'E', 'R', 'P', 'A', 'L', 'X'};
+constexpr int32_t kVersion = 1;
+
+// magic, version, number of words, number of tokens and has_tones
+constexpr size_t kHeaderSize = sizeof(kMagic) + 4 * sizeof(int32_t);
+
+struct LexiconEntry {
+  std::string word;
+  std::vector<int32_t> indexes;
+  std::vector<int32_t> tones;
+};
+
+template <typename T>
+void WriteVector(const std::vector<T> &v, std::ostream *os) {
+  os->write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(T));
+}
+
+}  // namespace
+
+BinaryLexicon::BinaryLexicon(
+    const std::string &filename,
+    const std::unordered_map<std::string, int32_t> &token2id)
+    : file_(filename), data_(file_.data()), size_(file_.size()) {
+  if (!IsBinaryLexicon(data_, size_)) {
+    SHERPA_ONNX_LOGE("'%s' is not a binary lexicon", filename.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  Init(token2id);
+}
+
+BinaryLexicon::BinaryLexicon(
+    std::vector<char> buf,
+    const std::unordered_map<std::string, int32_t> &token2id)
+    : buf_(std::move(buf)), data_(buf_.data()), size_(buf_.size()) {
+  if (!IsBinaryLexicon(data_, size_)) {
+    SHERPA_ONNX_LOGE("The given buffer is not a binary lexicon");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  Init(token2id);
+}
+
+bool BinaryLexicon::IsBinaryLexicon(const std::string &filename) {
+  std::ifstream is(filename, std::ios::binary);
+  char magic[sizeof(kMagic)] = {0};
+  is.read(magic, sizeof(magic));
+  return is && IsBinaryLexicon(magic, sizeof(magic));
+}
+
+bool BinaryLexicon::IsBinaryLexicon(const char *data, size_t size) {
+  return data && size >= sizeof(kMagic) &&
+         std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+void BinaryLexicon::Init(
+    const std::unordered_map<std::string, int32_t> &token2id) {
+  int32_t header[4] = {0};
+  if (size_ < kHeaderSize) {
+    SHERPA_ONNX_LOGE("The binary lexicon is truncated");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  std::memcpy(header, data_ + sizeof(kMagic), sizeof(header));
+
+  int32_t version = header[0];
+  num_words_ = header[1];
+  num_tokens_ = header[2];
+  bool has_tones = header[3] != 0;
+
+  if (version != kVersion || num_words_ < 0 || num_tokens_ < 0) {
+    SHERPA_ONNX_LOGE("Unsupported binary lexicon. Version: %d", version);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  size_t offsets_size = (2 * (num_words_ + 1) + num_tokens_ + 1) *
+                        sizeof(uint32_t);
+  if (size_ < kHeaderSize + offsets_size) {
+    SHERPA_ONNX_LOGE("The binary lexicon is truncated");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  const char *p = data_ + kHeaderSize;
+  word_offsets_ = reinterpret_cast<const uint32_t *>(p);
+  index_offsets_ = word_offsets_ + num_words_ + 1;
+  const uint32_t *token_offsets = index_offsets_ + num_words_ + 1;
+  p += offsets_size;
+
+  size_t num_indexes = index_offsets_[num_words_];
+  size_t expected_size = kHeaderSize + offsets_size +
+                         num_indexes * sizeof(int32_t) * (has_tones ? 2 : 1) +
+                         word_offsets_[num_words_] + token_offsets[num_tokens_];
+
+  if (size_ < expected_size) {
+    SHERPA_ONNX_LOGE(
+        "The binary lexicon is truncated. Expected size: %zu. Given: %zu",
+        expected_size, size_);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  indexes_ = reinterpret_cast<const int32_t *>(p);
+  p += num_indexes * sizeof(int32_t);
+
+  if (has_tones) {
+    tones_ = reinterpret_cast<const int32_t *>(p);
+    p += num_indexes * sizeof(int32_t);
+  }
+
+  words_ = p;
+  p += word_offsets_[num_words_];
+
+  token_ids_.resize(num_tokens_);
+  for (int32_t i = 0; i != num_tokens_; ++i) {
+    std::string token(p + token_offsets[i],
+                      token_offsets[i + 1] - token_offsets[i]);
+    auto it = token2id.find(token);
+    token_ids_[i] = it != token2id.end() ? it->second : -1;
+  }
+}
+
+bool BinaryLexicon::Lookup(const std::string &word, std::vector<int64_t> *ids,
+                           std::vector<int64_t> *tones /*= nullptr*/) const {
+  auto compare = [this, &word](int32_t i) {
+    uint32_t begin = word_offsets_[i];
+    return word.compare(0, word.size(), words_ + begin,
+                        word_offsets_[i + 1] - begin);
+  };
+
+  // Binary search for the first word not less than the given word
+  int32_t lo = 0;
+  int32_t hi = num_words_;
+  while (lo < hi) {
+    int32_t mid = lo + (hi - lo) / 2;
+    if (compare(mid) > 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  // A word may occur several times. Use the first one whose tokens are
+  // all known.
+  for (int32_t i = lo; i < num_words_ && compare(i) == 0; ++i) {
+    uint32_t begin = index_offsets_[i];
+    uint32_t end = index_offsets_[i + 1];
+
+    bool ok = std::all_of(indexes_ + begin, indexes_ + end,
+                          [this](int32_t k) { return token_ids_[k] != -1; });
+    if (!ok) {
+      continue;
+    }
+
+    for (uint32_t k = begin; k != end; ++k) {
+      ids->push_back(token_ids_[indexes_[k]]);
+    }
+
+    if (tones && tones_) {
+      tones->insert(tones->end(), tones_ + begin, tones_ + end);
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+bool BinaryLexicon::Compile(std::istream &is, bool with_tones,
+                            const std::string &filename) {
+  std::vector<LexiconEntry> entries;
+  std::vector<std::string> tokens;
+  std::unordered_map<std::string, int32_t> token2index;
+
+  std::string line;
+  std::string word;
+  std::string s;
+  std::vector<std::string> token_list;
+  int32_t line_num = 0;
+
+  while (std::getline(is, line)) {
+    ++line_num;
+
+    std::istringstream iss(line);
+    if (!(iss >> word)) {
+      continue;
+    }
+    ToLowerCase(&word);
+
+    token_list.clear();
+    while (iss >> s) {
+      token_list.push_back(std::move(s));
+    }
+
+    int32_t num_tokens = token_list.size();
+    if (with_tones) {
+      if ((num_tokens & 1) != 0) {
+        SHERPA_ONNX_LOGE("Invalid line %d: '%s'", line_num, line.c_str());
+        return false;
+      }
+      num_tokens /= 2;
+    }
+
+    if (num_tokens == 0) {
+      continue;
+    }
+
+    LexiconEntry e;
+    e.word = std::move(word);
+    e.indexes.reserve(num_tokens);
+
+    for (int32_t i = 0; i != num_tokens; ++i) {
+      auto it = token2index.find(token_list[i]);
+      if (it == token2index.end()) {
+        it = token2index.emplace(token_list[i], tokens.size()).first;
+        tokens.push_back(token_list[i]);
+      }
+      e.indexes.push_back(it->second);
+    }
+
+    if (with_tones) {
+      e.tones.reserve(num_tokens);
+      for (int32_t i = 0; i != num_tokens; ++i) {
+        const auto &t = token_list[num_tokens + i];
+        int32_t tone = -1;
+        if (!ConvertStringToInteger(t, &tone) || tone < 0 || tone > 50) {
+          SHERPA_ONNX_LOGE("Invalid line %d: '%s'", line_num, line.c_str());
+          return false;
+        }
+        e.tones.push_back(tone);
+      }
+    }
+
+    entries.push_back(std::move(e));
+  }
+
+  // Keep the order of duplicated words
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const LexiconEntry &a, const LexiconEntry &b) {
+                     return a.word < b.word;
+                   });
+
+  int32_t num_words = entries.size();
+
+  std::vector<uint32_t> word_offsets = {0};
+  std::vector<uint32_t> index_offsets = {0};
+  std::vector<uint32_t> token_offsets = {0};
+  std::vector<int32_t> indexes;
+  std::vector<int32_t> tones;
+
+  for (const auto &e : entries) {
+    word_offsets.push_back(word_offsets.back() + e.word.size());
+    index_offsets.push_back(index_offsets.back() + e.indexes.size());
+    indexes.insert(indexes.end(), e.indexes.begin(), e.indexes.end());
+    tones.insert(tones.end(), e.tones.begin(), e.tones.end());
+  }
+
+  for (const auto &t : tokens) {
+    token_offsets.push_back(token_offsets.back() + t.size());
+  }
+
+  std::ofstream os(filename, std::ios::binary);
+  if (!os) {
+    SHERPA_ONNX_LOGE("Failed to open '%s' for writing", filename.c_str());
+    return false;
+  }
+
+  int32_t header[4] = {kVersion, num_words, static_cast<int32_t>(tokens.size()),
+                       with_tones ? 1 : 0};
+
+  os.write(kMagic, sizeof(kMagic));
+  os.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+  WriteVector(word_offsets, &os);
+  WriteVector(index_offsets, &os);
+  WriteVector(token_offsets, &os);
+  WriteVector(indexes, &os);
+  WriteVector(tones, &os);
+
+  for (const auto &e : entries) {
+    os.write(e.word.data(), e.word.size());
+  }
+
+  for (const auto &t : tokens) {
+    os.write(t.data(), t.size());
+  }
+
+  if (!os) {
+    SHERPA_ONNX_LOGE("Failed to write '%s'", filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,107 @@
+// sherpa-onnx/csrc/binary-lexicon.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_BINARY_LEXICON_H_
+#define SHERPA_ONNX_CSRC_BINARY_LEXICON_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+
+namespace sherpa_onnx {
+
+/** A lexicon compiled from lexicon.txt by sherpa-onnx-compile-lexicon.
+ *
+ * Words are kept sorted in the file and searched in place, so loading
+ * it needs neither parsing nor a hash table. The file is memory-mapped,
+ * so its pages are shared by all processes using it. It contains
+ *
+ *   - a header: magic "SHERPALX", version, number of words, number of
+ *     tokens and whether it has tones, all but the magic in int32_t
+ *   - byte offsets of the words, uint32_t[num_words + 1]
+ *   - offsets of the token indexes of the words, uint32_t[num_words + 1]
+ *   - byte offsets of the tokens, uint32_t[num_tokens + 1]
+ *   - token indexes of all words, int32_t[]
+ *   - tones of all words if it has tones, int32_t[]
+ *   - the words in UTF-8, lowercased and sorted by bytes
+ *   - the tokens in UTF-8
+ *
+ * Tokens are saved as strings and mapped to IDs with tokens.txt when the
+ * lexicon is loaded, so the file does not depend on tokens.txt.
+ */
+class BinaryLexicon {
+ public:
+  // It exits if the file is not a valid binary lexicon
+  BinaryLexicon(const std::string &filename,
+                const std::unordered_map<std::string, int32_t> &token2id);
+
+  // Use the content of a binary lexicon, e.g., read from an asset manager
+  BinaryLexicon(std::vector<char> buf,
+                const std::unordered_map<std::string, int32_t> &token2id);
+
+  // Return true if the file or buffer starts with the magic of a binary
+  // lexicon
+  static bool IsBinaryLexicon(const std::string &filename);
+  static bool IsBinaryLexicon(const char *data, size_t size);
+
+  /* Look up a word.
+   *
+   * If the word exists and all of its tokens are in tokens.txt, the token
+   * IDs are appended to ids, its tones are appended to tones if tones is
+   * not nullptr, and it returns true. Otherwise, it returns false and
+   * changes nothing.
+   */
+  bool Lookup(const std::string &word, std::vector<int64_t> *ids,
+              std::vector<int64_t> *tones = nullptr) const;
+
+  int32_t NumWords() const { return num_words_; }
+
+  bool HasTones() const { return tones_ != nullptr; }
+
+  /* Compile lexicon.txt.
+   *
+   * Each line contains a word followed by its tokens. If with_tones is
+   * true, the tokens are followed by one tone per token, as in lexicons
+   * of MeloTTS models. Words are lowercased. If a word occurs several
+   * times, the first one whose tokens are all in tokens.txt is used.
+   *
+   * @return Return false on error.
+   */
+  static bool Compile(std::istream &is, bool with_tones,
+                      const std::string &filename);
+
+ private:
+  void Init(const std::unordered_map<std::string, int32_t> &token2id);
+
+ private:
+  MappedFile file_;
+
+  // Used only when it is constructed from a buffer
+  std::vector<char> buf_;
+
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+
+  int32_t num_words_ = 0;
+  int32_t num_tokens_ = 0;
+
+  const uint32_t *word_offsets_ = nullptr;
+  const uint32_t *index_offsets_ = nullptr;
+  const int32_t *indexes_ = nullptr;
+  const int32_t *tones_ = nullptr;
+  const char *words_ = nullptr;
+
+  // token_ids_[i] is the ID of the i-th token in the file. It is -1 if
+  // the token is not in tokens.txt.
+  std::vector<int32_t> token_ids_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_BINARY_LEXICON_H_
@@ -0,0 +1,137 @@
+// sherpa-onnx/csrc/chunked-vocoder-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/chunked-vocoder.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+static constexpr int32_t kHop = 4;
+
+// Each frame produces kHop samples. Sample k of a frame is the mean of all
+// mel bins over the frames within the given radius plus k, with zero
+// padding at the edges of the input. mel is of shape (num_mels, num_frames).
+static std::vector<float> FakeVocoder(const float *mel, int32_t num_mels,
+                                      int32_t num_frames, int32_t radius) {
+  std::vector<float> ans;
+  for (int32_t t = 0; t != num_frames; ++t) {
+    float sum = 0;
+    for (int32_t m = 0; m != num_mels; ++m) {
+      for (int32_t d = -radius; d <= radius; ++d) {
+        if (t + d >= 0 && t + d < num_frames) {
+          sum += mel[m * num_frames + t + d];
+        }
+      }
+    }
+
+    for (int32_t k = 0; k != kHop; ++k) {
+      ans.push_back(sum / ((2 * radius + 1) * num_mels) + k);
+    }
+  }
+
+  return ans;
+}
+
+static std::vector<float> MakeMel(int32_t num_mels, int32_t num_frames) {
+  std::vector<float> mel(num_mels * num_frames);
+  for (int32_t i = 0; i != static_cast<int32_t>(mel.size()); ++i) {
+    mel[i] = (i * 37) % 11;
+  }
+
+  return mel;
+}
+
+TEST(ChunkedVocoder, SameAsFullVocoding) {
+  int32_t num_mels = 3;
+  int32_t radius = 2;
+  auto vocoder = [radius](const float *mel, int32_t num_mels,
+                          int32_t num_frames) {
+    return FakeVocoder(mel, num_mels, num_frames, radius);
+  };
+
+  for (int32_t num_frames : {1, 5, 10, 23, 50, 101}) {
+    std::vector<float> mel = MakeMel(num_mels, num_frames);
+    std::vector<float> expected = vocoder(mel.data(), num_mels, num_frames);
+
+    for (int32_t chunk_size : {0, 7, 10, 20}) {
+      std::vector<float> pieces;
+      int32_t num_calls = 0;
+      float last_progress = 0;
+
+      std::vector<float> samples = RunVocoderInChunks(
+          vocoder, mel.data(), num_mels, num_frames, chunk_size, 6,
+          [&](const float *p, int32_t n, float progress) -> int32_t {
+            pieces.insert(pieces.end(), p, p + n);
+            EXPECT_GT(progress, last_progress);
+            last_progress = progress;
+            ++num_calls;
+            return 1;
+          });
+
+      ASSERT_EQ(samples.size(), expected.size());
+      for (size_t i = 0; i != expected.size(); ++i) {
+        EXPECT_NEAR(samples[i], expected[i], 1e-5)
+            << num_frames << " " << chunk_size << " " << i;
+      }
+
+      EXPECT_EQ(pieces, samples);
+      EXPECT_FLOAT_EQ(last_progress, 1);
+      if (chunk_size > 0 && num_frames > 2 * chunk_size) {
+        EXPECT_GT(num_calls, 1);
+      }
+    }
+  }
+}
+
+TEST(ChunkedVocoder, FirstChunkIsSmall) {
+  int32_t num_mels = 2;
+  int32_t num_frames = 1000;
+  std::vector<float> mel = MakeMel(num_mels, num_frames);
+
+  int32_t max_frames = 0;
+  auto vocoder = [&max_frames](const float *mel, int32_t num_mels,
+                               int32_t num_frames) {
+    max_frames = std::max(max_frames, num_frames);
+    return FakeVocoder(mel, num_mels, num_frames, 0);
+  };
+
+  int32_t first = -1;
+  RunVocoderInChunks(vocoder, mel.data(), num_mels, num_frames, 50, 8,
+                     [&first](const float *, int32_t n, float) -> int32_t {
+                       if (first == -1) {
+                         first = n;
+                       }
+                       return 1;
+                     });
+
+  // The first chunk stops at the start of the crossfade
+  EXPECT_EQ(first, (50 - 4) * kHop);
+  EXPECT_EQ(max_frames, 50 + 2 * 8);
+}
+
+TEST(ChunkedVocoder, Stop) {
+  int32_t num_mels = 2;
+  int32_t num_frames = 100;
+  std::vector<float> mel = MakeMel(num_mels, num_frames);
+
+  int32_t num_runs = 0;
+  auto vocoder = [&num_runs](const float *mel, int32_t num_mels,
+                             int32_t num_frames) {
+    ++num_runs;
+    return FakeVocoder(mel, num_mels, num_frames, 0);
+  };
+
+  std::vector<float> samples = RunVocoderInChunks(
+      vocoder, mel.data(), num_mels, num_frames, 10, 4,
+      [](const float *, int32_t, float) -> int32_t { return 0; });
+
+  EXPECT_EQ(num_runs, 1);
+  EXPECT_EQ(samples.size(), (10 - 2) * kHop);
+}
+
+}  // namespace sherpa_onnx
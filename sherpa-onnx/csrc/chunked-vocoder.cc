@@ -0,0 +1,117 @@
+// sherpa-onnx/csrc/chunked-vocoder.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/chunked-vocoder.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace sherpa_onnx {
+
+namespace {
+
+// Return the frames [start, end) of a mel spectrogram of shape
+// (num_mels, num_frames)
+std::vector<float> SliceFrames(const float *mel, int32_t num_mels,
+                               int32_t num_frames, int32_t start,
+                               int32_t end) {
+  int32_t n = end - start;
+  std::vector<float> ans(static_cast<size_t>(num_mels) * n);
+  for (int32_t i = 0; i != num_mels; ++i) {
+    const float *p = mel + static_cast<size_t>(i) * num_frames + start;
+    std::copy(p, p + n, ans.begin() + static_cast<size_t>(i) * n);
+  }
+
+  return ans;
+}
+
+}  // namespace
+
+std::vector<float> RunVocoderInChunks(const VocoderFunc &vocoder,
+                                      const float *mel, int32_t num_mels,
+                                      int32_t num_frames, int32_t chunk_size,
+                                      int32_t overlap,
+                                      const VocoderChunkCallback &callback) {
+  std::vector<float> ans;
+  if (num_frames <= 0) {
+    return ans;
+  }
+
+  // Chunk i contains the frames [boundaries[i], boundaries[i + 1])
+  // without context
+  std::vector<int32_t> boundaries = {0};
+  if (chunk_size > 0) {
+    overlap = std::max(0, std::min(overlap, chunk_size - 1));
+    for (int32_t b = chunk_size; num_frames - b > overlap; b += chunk_size) {
+      boundaries.push_back(b);
+    }
+  } else {
+    overlap = 0;
+  }
+  boundaries.push_back(num_frames);
+
+  int32_t num_chunks = static_cast<int32_t>(boundaries.size()) - 1;
+
+  // The crossfade covers the frames [b - left, b + right) around
+  // each boundary b
+  int32_t left = overlap / 2;
+  int32_t right = overlap - left;
+
+  // Samples of the previous chunk in the crossfade region
+  std::vector<float> tail;
+
+  for (int32_t i = 0; i != num_chunks; ++i) {
+    int32_t start = boundaries[i];
+    int32_t end = boundaries[i + 1];
+    bool is_last = i + 1 == num_chunks;
+
+    int32_t context_start = std::max(0, start - overlap);
+    int32_t context_end = std::min(num_frames, end + overlap);
+
+    std::vector<float> audio =
+        num_chunks == 1
+            ? vocoder(mel, num_mels, num_frames)
+            : vocoder(SliceFrames(mel, num_mels, num_frames, context_start,
+                                  context_end)
+                          .data(),
+                      num_mels, context_end - context_start);
+
+    // Number of samples per frame
+    size_t hop = audio.size() / (context_end - context_start);
+    auto sample = [hop, context_start](int32_t frame) {
+      return (frame - context_start) * hop;
+    };
+
+    size_t offset = ans.size();
+
+    if (i > 0) {
+      size_t begin = sample(start - left);
+      size_t n = std::min(tail.size(), overlap * hop);
+      for (size_t k = 0; k != n; ++k) {
+        float w = (k + 0.5f) / n;
+        ans.push_back(tail[k] * (1 - w) + audio[begin + k] * w);
+      }
+    }
+
+    int32_t emit_start = i == 0 ? start : start + right;
+    int32_t emit_end = is_last ? end : end - left;
+    ans.insert(ans.end(), audio.begin() + sample(emit_start),
+               audio.begin() + sample(emit_end));
+
+    if (!is_last) {
+      tail.assign(audio.begin() + sample(end - left),
+                  audio.begin() + sample(end + right));
+    }
+
+    int32_t n = static_cast<int32_t>(ans.size() - offset);
+    if (callback && !callback(ans.data() + offset, n,
+                              static_cast<float>(end) / num_frames)) {
+      break;
+    }
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
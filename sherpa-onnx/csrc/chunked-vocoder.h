@@ -0,0 +1,54 @@
+// sherpa-onnx/csrc/chunked-vocoder.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_CHUNKED_VOCODER_H_
+#define SHERPA_ONNX_CSRC_CHUNKED_VOCODER_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// It converts a mel spectrogram of shape (num_mels, num_frames) in row major
+// to audio samples. The number of returned samples must be a multiple of
+// num_frames.
+using VocoderFunc = std::function<std::vector<float>(
+    const float * /*mel*/, int32_t /*num_mels*/, int32_t /*num_frames*/)>;
+
+// It is called with the samples of each chunk and the fraction of frames
+// vocoded so far. Return 0 to stop.
+using VocoderChunkCallback = std::function<int32_t(
+    const float * /*samples*/, int32_t /*n*/, float /*progress*/)>;
+
+/* Run a vocoder over overlapping chunks of a mel spectrogram.
+ *
+ * Chunk i contains the frames [i * chunk_size, (i + 1) * chunk_size) plus
+ * up to overlap frames of context on each side. Neighboring chunks are
+ * linearly crossfaded over overlap frames centered at their boundary.
+ * The last chunk also contains the remaining frames if no more than
+ * overlap frames would be left after it.
+ *
+ * @param vocoder The vocoder.
+ * @param mel A mel spectrogram of shape (num_mels, num_frames) in row major.
+ * @param num_mels Number of mel bins.
+ * @param num_frames Number of frames.
+ * @param chunk_size Number of frames per chunk. If it is not positive, all
+ *                   frames are vocoded at once.
+ * @param overlap Number of frames of context on each side of a chunk. It
+ *                must be less than chunk_size.
+ * @param callback If not empty, it is called after each chunk.
+ *
+ * @return Return the samples of all chunks vocoded before the callback
+ *         returns 0.
+ */
+std::vector<float> RunVocoderInChunks(const VocoderFunc &vocoder,
+                                      const float *mel, int32_t num_mels,
+                                      int32_t num_frames, int32_t chunk_size,
+                                      int32_t overlap,
+                                      const VocoderChunkCallback &callback);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_CHUNKED_VOCODER_H_
@@ -147,4 +147,107 @@ TEST(CircularBuffer, PushAndPop) {
   EXPECT_EQ(c[1], 4000);
 }
 
+TEST(CircularBuffer, GetRegions) {
+  CircularBuffer buffer(5);
+  std::vector<float> a = {0, 1, 2, 3};
+  buffer.Push(a.data(), a.size());
+  buffer.Pop(3);
+
+  a = {4, 5, 6};
+  buffer.Push(a.data(), a.size());
+
+  const float *p1 = nullptr;
+  const float *p2 = nullptr;
+  int32_t n1 = 0;
+  int32_t n2 = 0;
+
+  ASSERT_TRUE(buffer.GetRegions(3, 2, &p1, &n1, &p2, &n2));
+  EXPECT_EQ(n1, 2);
+  EXPECT_EQ(n2, 0);
+  EXPECT_EQ(p1[0], 3);
+  EXPECT_EQ(p1[1], 4);
+
+  // It wraps around
+  ASSERT_TRUE(buffer.GetRegions(3, 4, &p1, &n1, &p2, &n2));
+  EXPECT_EQ(n1, 2);
+  EXPECT_EQ(n2, 2);
+  EXPECT_EQ(p1[0], 3);
+  EXPECT_EQ(p1[1], 4);
+  EXPECT_EQ(p2[0], 5);
+  EXPECT_EQ(p2[1], 6);
+
+  EXPECT_FALSE(buffer.GetRegions(2, 2, &p1, &n1, &p2, &n2));
+  EXPECT_FALSE(buffer.GetRegions(3, 5, &p1, &n1, &p2, &n2));
+}
+
+TEST(CircularBuffer, Retain) {
+  CircularBuffer buffer(4);
+  std::vector<float> a = {0, 1, 2};
+  buffer.Push(a.data(), a.size());
+
+  const float *p1 = nullptr;
+  const float *p2 = nullptr;
+  int32_t n1 = 0;
+  int32_t n2 = 0;
+  buffer.GetRegions(1, 2, &p1, &n1, &p2, &n2);
+
+  {
+    auto storage = buffer.Retain(1, 2);
+    buffer.Pop(3);
+
+    // They overwrite nothing and the unretained element 0, respectively
+    a = {3};
+    buffer.Push(a.data(), a.size());
+    a = {4};
+    buffer.Push(a.data(), a.size());
+
+    const float *q1 = nullptr;
+    buffer.GetRegions(4, 1, &q1, &n1, &p2, &n2);
+    EXPECT_EQ(q1, p1 - 1);  // the same storage
+    EXPECT_EQ(p1[0], 1);
+    EXPECT_EQ(p1[1], 2);
+
+    // It would overwrite the retained element 1, so the buffer switches to
+    // a new storage
+    a = {5};
+    buffer.Push(a.data(), a.size());
+    EXPECT_EQ(p1[0], 1);
+    EXPECT_EQ(p1[1], 2);
+
+    auto c = buffer.Get(3, 3);
+    EXPECT_EQ(c[0], 3);
+    EXPECT_EQ(c[1], 4);
+    EXPECT_EQ(c[2], 5);
+
+    // Only the elements in the buffer were copied to the new storage
+    const float *q2 = nullptr;
+    int32_t m1 = 0;
+    int32_t m2 = 0;
+    buffer.GetRegions(3, 3, &q1, &m1, &q2, &m2);
+    EXPECT_EQ(q1[0], 3);
+    EXPECT_EQ(q2[0], 4);
+    EXPECT_EQ(q2[1], 5);
+    EXPECT_EQ(q2[2], 0);
+  }
+
+  // Without retained elements, it does not switch the storage
+  buffer.GetRegions(5, 1, &p1, &n1, &p2, &n2);
+  buffer.Pop(3);
+
+  a = {6, 7, 8, 9};
+  buffer.Push(a.data(), a.size());
+  EXPECT_EQ(p1[0], 9);
+}
+
+TEST(CircularBuffer, Grow) {
+  CircularBuffer buffer(2);
+  std::vector<float> a = {0, 1, 2, 3, 4};
+  buffer.Push(a.data(), a.size());
+
+  EXPECT_EQ(buffer.Size(), 5);
+
+  auto c = buffer.Get(0, 5);
+  EXPECT_EQ(c, a);
+}
+
 }  // namespace sherpa_onnx
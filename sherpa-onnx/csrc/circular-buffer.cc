@@ -5,6 +5,8 @@
 #include "sherpa-onnx/csrc/circular-buffer.h"
 
 #include <algorithm>
+#include <memory>
+#include <utility>
 
 #include "sherpa-onnx/csrc/macros.h"
 
@@ -16,11 +18,11 @@ CircularBuffer::CircularBuffer(int32_t capacity) {
                      capacity);
     exit(-1);
   }
-  buffer_.resize(capacity);
+  buffer_ = std::make_shared<std::vector<float>>(capacity);
 }
 
 void CircularBuffer::Resize(int32_t new_capacity) {
-  int32_t capacity = static_cast<int32_t>(buffer_.size());
+  int32_t capacity = Capacity();
   if (new_capacity <= capacity) {
 #if __OHOS__
     SHERPA_ONNX_LOGE(
@@ -33,30 +35,36 @@ void CircularBuffer::Resize(int32_t new_capacity) {
     return;
   }
 
+  // Elements are never moved within a storage since it may be retained.
+  // The old storage is released unless it is retained.
+  retained_begin_ = 0;
+  retained_end_ = 0;
+
   int32_t size = Size();
   if (size == 0) {
-    buffer_.resize(new_capacity);
+    buffer_ = std::make_shared<std::vector<float>>(new_capacity);
     return;
   }
 
+  const std::vector<float> &buffer = *buffer_;
   std::vector<float> new_buffer(new_capacity);
   int32_t start = head_ % capacity;
   int32_t dest = head_ % new_capacity;
 
   if (start + size <= capacity) {
     if (dest + size <= new_capacity) {
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + size,
+      std::copy(buffer.begin() + start, buffer.begin() + start + size,
                 new_buffer.begin() + dest);
     } else {
       int32_t part1_size = new_capacity - dest;
 
       // copy [start, start+part1_size] to new_buffer
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + part1_size,
+      std::copy(buffer.begin() + start, buffer.begin() + start + part1_size,
                 new_buffer.begin() + dest);
 
       // copy [start+part1_size, start+size] to new_buffer
-      std::copy(buffer_.begin() + start + part1_size,
-                buffer_.begin() + start + size, new_buffer.begin());
+      std::copy(buffer.begin() + start + part1_size,
+                buffer.begin() + start + size, new_buffer.begin());
     }
   } else {
     int32_t part1_size = capacity - start;
@@ -64,35 +72,35 @@ void CircularBuffer::Resize(int32_t new_capacity) {
 
     // copy [start, start+part1_size] to new_buffer
     if (dest + part1_size <= new_capacity) {
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + part1_size,
+      std::copy(buffer.begin() + start, buffer.begin() + start + part1_size,
                 new_buffer.begin() + dest);
     } else {
       int32_t first_part = new_capacity - dest;
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + first_part,
+      std::copy(buffer.begin() + start, buffer.begin() + start + first_part,
                 new_buffer.begin() + dest);
 
-      std::copy(buffer_.begin() + start + first_part,
-                buffer_.begin() + start + part1_size, new_buffer.begin());
+      std::copy(buffer.begin() + start + first_part,
+                buffer.begin() + start + part1_size, new_buffer.begin());
     }
 
     int32_t new_dest = (dest + part1_size) % new_capacity;
 
     if (new_dest + part2_size <= new_capacity) {
-      std::copy(buffer_.begin(), buffer_.begin() + part2_size,
+      std::copy(buffer.begin(), buffer.begin() + part2_size,
                 new_buffer.begin() + new_dest);
     } else {
       int32_t first_part = new_capacity - new_dest;
-      std::copy(buffer_.begin(), buffer_.begin() + first_part,
+      std::copy(buffer.begin(), buffer.begin() + first_part,
                 new_buffer.begin() + new_dest);
-      std::copy(buffer_.begin() + first_part, buffer_.begin() + part2_size,
+      std::copy(buffer.begin() + first_part, buffer.begin() + part2_size,
                 new_buffer.begin());
     }
   }
-  buffer_.swap(new_buffer);
+  buffer_ = std::make_shared<std::vector<float>>(std::move(new_buffer));
 }
 
 void CircularBuffer::Push(const float *p, int32_t n) {
-  int32_t capacity = static_cast<int32_t>(buffer_.size());
+  int32_t capacity = Capacity();
   int32_t size = Size();
   if (n + size > capacity) {
     int32_t new_capacity = std::max(capacity * 2, n + size);
@@ -113,20 +121,26 @@ void CircularBuffer::Push(const float *p, int32_t n) {
     capacity = new_capacity;
   }
 
+  // The new elements overwrite the elements [tail_ - capacity,
+  // tail_ + n - capacity), which may still be retained
+  Detach(tail_ - capacity, tail_ + n - capacity);
+
+  std::vector<float> &buffer = *buffer_;
+
   int32_t start = tail_ % capacity;
 
   tail_ += n;
 
   if (start + n < capacity) {
-    std::copy(p, p + n, buffer_.begin() + start);
+    std::copy(p, p + n, buffer.begin() + start);
     return;
   }
 
   int32_t part1_size = capacity - start;
 
-  std::copy(p, p + part1_size, buffer_.begin() + start);
+  std::copy(p, p + part1_size, buffer.begin() + start);
 
-  std::copy(p + part1_size, p + n, buffer_.begin());
+  std::copy(p + part1_size, p + n, buffer.begin());
 }
 
 std::vector<float> CircularBuffer::Get(int32_t start_index, int32_t n) const {
@@ -142,30 +156,114 @@ std::vector<float> CircularBuffer::Get(int32_t start_index, int32_t n) const {
     return {};
   }
 
-  int32_t capacity = static_cast<int32_t>(buffer_.size());
-
   if (start_index - head_ + n > size) {
     SHERPA_ONNX_LOGE("Invalid start_index: %d and n: %d. head_: %d, size: %d",
                      start_index, n, head_, size);
     return {};
   }
 
+  const float *p1 = nullptr;
+  const float *p2 = nullptr;
+  int32_t n1 = 0;
+  int32_t n2 = 0;
+  GetRegions(start_index, n, &p1, &n1, &p2, &n2);
+
+  std::vector<float> ans(n);
+  std::copy(p1, p1 + n1, ans.begin());
+  std::copy(p2, p2 + n2, ans.begin() + n1);
+
+  return ans;
+}
+
+bool CircularBuffer::GetRegions(int32_t start_index, int32_t n,
+                                const float **p1, int32_t *n1,
+                                const float **p2, int32_t *n2) const {
+  if (n < 0 || start_index < head_ || start_index + n > tail_) {
+    SHERPA_ONNX_LOGE("Invalid start_index: %d and n: %d. head_: %d, tail_: %d",
+                     start_index, n, head_, tail_);
+    return false;
+  }
+
+  const std::vector<float> &buffer = *buffer_;
+  int32_t capacity = Capacity();
   int32_t start = start_index % capacity;
 
-  if (start + n < capacity) {
-    return {buffer_.begin() + start, buffer_.begin() + start + n};
+  *p1 = buffer.data() + start;
+  *p2 = buffer.data();
+
+  if (start + n <= capacity) {
+    *n1 = n;
+    *n2 = 0;
+  } else {
+    *n1 = capacity - start;
+    *n2 = n - *n1;
   }
 
-  std::vector<float> ans(n);
+  return true;
+}
 
-  std::copy(buffer_.begin() + start, buffer_.end(), ans.begin());
+std::shared_ptr<const std::vector<float>> CircularBuffer::Retain(
+    int32_t start_index, int32_t n) {
+  if (n <= 0) {
+    return buffer_;
+  }
 
-  int32_t part1_size = capacity - start;
-  int32_t part2_size = n - part1_size;
-  std::copy(buffer_.begin(), buffer_.begin() + part2_size,
-            ans.begin() + part1_size);
+  if (retained_begin_ == retained_end_) {
+    retained_begin_ = start_index;
+    retained_end_ = start_index + n;
+  } else {
+    retained_begin_ = std::min(retained_begin_, start_index);
+    retained_end_ = std::max(retained_end_, start_index + n);
+  }
 
-  return ans;
+  return buffer_;
+}
+
+void CircularBuffer::Detach(int32_t begin, int32_t end) {
+  if (retained_begin_ == retained_end_) {
+    return;
+  }
+
+  if (buffer_.use_count() == 1) {
+    // All retained elements have been released
+    retained_begin_ = 0;
+    retained_end_ = 0;
+    return;
+  }
+
+  if (end <= retained_begin_ || begin >= retained_end_) {
+    return;
+  }
+
+  // The retained elements stay in the old storage with their holders, so
+  // only the elements in [head_, tail_) are copied, to the same positions.
+  auto old = std::move(buffer_);
+  int32_t capacity = static_cast<int32_t>(old->size());
+  buffer_ = std::make_shared<std::vector<float>>(capacity);
+  retained_begin_ = 0;
+  retained_end_ = 0;
+
+  int32_t size = Size();
+  int32_t start = head_ % capacity;
+  int32_t n1 = std::min(size, capacity - start);
+
+  std::copy(old->begin() + start, old->begin() + start + n1,
+            buffer_->begin() + start);
+  std::copy(old->begin(), old->begin() + (size - n1), buffer_->begin());
+}
+
+void CircularBuffer::Reset() {
+  head_ = 0;
+  tail_ = 0;
+
+  if (retained_begin_ != retained_end_ && buffer_.use_count() > 1) {
+    // Linear indexes restart from 0, so new elements could overwrite
+    // retained ones anywhere in the storage
+    buffer_ = std::make_shared<std::vector<float>>(Capacity());
+  }
+
+  retained_begin_ = 0;
+  retained_end_ = 0;
 }
 
 void CircularBuffer::Pop(int32_t n) {
@@ -5,14 +5,14 @@
 #define SHERPA_ONNX_CSRC_CIRCULAR_BUFFER_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace sherpa_onnx {
 
 class CircularBuffer {
  public:
-  // Capacity of this buffer. Should be large enough.
-  // If it is full, we just print a message and exit the program.
+  // Capacity of this buffer. If it is full, it grows automatically.
   explicit CircularBuffer(int32_t capacity);
 
   // Push an array
@@ -20,7 +20,7 @@ class CircularBuffer {
   // @param p Pointer to the start address of the array
   // @param n Number of elements in the array
   //
-  // Note: If n + Size() > capacity, we print an error message and exit.
+  // Note: If n + Size() > capacity, the capacity is increased.
   void Push(const float *p, int32_t n);
 
   // @param start_index Should in the range [head_, tail_)
@@ -28,6 +28,31 @@ class CircularBuffer {
   // @return Return a vector of size n containing the requested elements
   std::vector<float> Get(int32_t start_index, int32_t n) const;
 
+  /** Get the requested elements without copying them.
+   *
+   * The elements may wrap around the end of the buffer, so they are
+   * returned as up to two contiguous regions: [*p1, *p1 + *n1) followed by
+   * [*p2, *p2 + *n2). *n2 is 0 if there is only one region.
+   *
+   * The pointers are invalidated by the next Push(), Resize() or Reset()
+   * unless the elements are retained with Retain().
+   *
+   * @return Return false if the arguments are invalid.
+   */
+  bool GetRegions(int32_t start_index, int32_t n, const float **p1,
+                  int32_t *n1, const float **p2, int32_t *n2) const;
+
+  /** Keep the elements in [start_index, start_index + n) and the pointers
+   * returned by GetRegions() for them valid as long as the returned
+   * pointer exists, even after Pop().
+   *
+   * Later Push() calls do not overwrite retained elements. If they would,
+   * the buffer switches to a new storage and leaves the old one to the
+   * holders of the returned pointers.
+   */
+  std::shared_ptr<const std::vector<float>> Retain(int32_t start_index,
+                                                   int32_t n);
+
   // Remove n elements from the buffer
   //
   // @param n Should be in the range [0, size_]
@@ -42,15 +67,26 @@ class CircularBuffer {
   // Current position of the tail
   int32_t Tail() const { return tail_; }
 
-  void Reset() {
-    head_ = 0;
-    tail_ = 0;
-  }
+  void Reset();
 
   void Resize(int32_t new_capacity);
 
  private:
-  std::vector<float> buffer_;
+  int32_t Capacity() const { return static_cast<int32_t>(buffer_->size()); }
+
+  // Switch to a new storage with the elements in [head_, tail_) if the
+  // current one is retained and [begin, end) overlaps with the retained
+  // elements. The arguments are physical positions expressed as linear
+  // indexes.
+  void Detach(int32_t begin, int32_t end);
+
+ private:
+  // It is shared with the holders of the pointers returned by Retain()
+  std::shared_ptr<std::vector<float>> buffer_;
+
+  // Linear indexes of the retained elements in buffer_
+  int32_t retained_begin_ = 0;
+  int32_t retained_end_ = 0;
 
   int32_t head_ = 0;  // linear index; always increasing; never wraps around
   int32_t tail_ = 0;  // linear index, always increasing; never wraps around.
@@ -15,7 +15,9 @@ std::string FastClusteringConfig::ToString() const {
 
   os << "FastClusteringConfig(";
   os << "num_clusters=" << num_clusters << ", ";
-  os << "threshold=" << threshold << ")";
+  os << "threshold=" << threshold << ", ";
+  os << "block_size=" << block_size << ", ";
+  os << "max_memory_mb=" << max_memory_mb << ")";
 
   return os.str();
 }
@@ -31,6 +33,15 @@ void FastClusteringConfig::Register(ParseOptions *po) {
                "If num_clusters is not specified, then it specifies the "
                "distance threshold for clustering. smaller value -> more "
                "clusters. larger value -> fewer clusters");
+
+  po->Register("cluster-block-size", &block_size,
+               "If positive, inputs with more rows are clustered in two "
+               "stages: blocks of this many consecutive rows first, then "
+               "the centroids of the clusters found in the blocks.");
+
+  po->Register("cluster-max-memory", &max_memory_mb,
+               "Maximum memory in MB for the pairwise distances. Larger "
+               "inputs are clustered in two stages. 0 means no limit.");
 }
 
 bool FastClusteringConfig::Validate() const {
@@ -39,6 +50,18 @@ bool FastClusteringConfig::Validate() const {
     return false;
   }
 
+  if (block_size < 0 || block_size == 1) {
+    SHERPA_ONNX_LOGE("block_size should be 0 or at least 2. Given: %d",
+                     block_size);
+    return false;
+  }
+
+  if (max_memory_mb < 0) {
+    SHERPA_ONNX_LOGE("max_memory_mb should be >= 0. Given: %d",
+                     max_memory_mb);
+    return false;
+  }
+
   return true;
 }
 
@@ -24,6 +24,18 @@ struct FastClusteringConfig {
   // The larger, the fewer clusters it will generate.
   float threshold = 0.5;
 
+  // If greater than 0, inputs with more than block_size rows are
+  // clustered in two stages. First, each block of block_size consecutive
+  // rows is clustered with the threshold. Then the centroids of the
+  // resulting clusters are clustered. It should be much larger than the
+  // number of clusters.
+  int32_t block_size = 0;
+
+  // Maximum memory in MB for the pairwise distances. If the input needs
+  // more, two-stage clustering is used with the largest block size that
+  // fits. 0 means no limit.
+  int32_t max_memory_mb = 1024;
+
   FastClusteringConfig() = default;
 
   FastClusteringConfig(int32_t num_clusters, float threshold)
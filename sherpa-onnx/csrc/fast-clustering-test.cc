@@ -4,12 +4,68 @@
 
 #include "sherpa-onnx/csrc/fast-clustering.h"
 
+#include <random>
+#include <unordered_map>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 namespace sherpa_onnx {
 
+// Generate num_turns * turn_length rows. Each turn contains rows of
+// the same speaker, like consecutive embeddings of a recording.
+static std::vector<float> GenerateTurns(int32_t num_speakers,
+                                        int32_t num_turns,
+                                        int32_t turn_length, int32_t dim,
+                                        std::vector<int32_t> *speakers) {
+  std::mt19937 gen(20241019);
+  std::normal_distribution<float> normal;
+
+  std::vector<float> centers(num_speakers * dim);
+  for (auto &f : centers) {
+    f = normal(gen);
+  }
+
+  std::vector<float> ans;
+  for (int32_t t = 0; t != num_turns; ++t) {
+    int32_t s = t % num_speakers;
+    for (int32_t i = 0; i != turn_length; ++i) {
+      for (int32_t d = 0; d != dim; ++d) {
+        ans.push_back(centers[s * dim + d] + 0.1 * normal(gen));
+      }
+      speakers->push_back(s);
+    }
+  }
+
+  return ans;
+}
+
+// Return true if a and b are the same partition up to renaming of labels
+static bool SamePartition(const std::vector<int32_t> &a,
+                          const std::vector<int32_t> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+
+  std::unordered_map<int32_t, int32_t> a2b;
+  std::unordered_map<int32_t, int32_t> b2a;
+  for (size_t i = 0; i != a.size(); ++i) {
+    if (!a2b.count(a[i])) {
+      a2b[a[i]] = b[i];
+    }
+
+    if (!b2a.count(b[i])) {
+      b2a[b[i]] = a[i];
+    }
+
+    if (a2b[a[i]] != b[i] || b2a[b[i]] != a[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 TEST(FastClustering, TestTwoClusters) {
   std::vector<float> features = {
       // point 0
@@ -66,4 +122,38 @@ TEST(FastClustering, TestClusteringWithThreshold) {
   }
 }
 
+TEST(FastClustering, TestTwoStage) {
+  std::vector<int32_t> speakers;
+  std::vector<float> features = GenerateTurns(3, 12, 10, 16, &speakers);
+  int32_t num_rows = speakers.size();
+
+  FastClusteringConfig config;
+  config.max_memory_mb = 0;
+
+  std::vector<float> f = features;
+  auto expected = FastClustering(config).Cluster(f.data(), num_rows, 16);
+  EXPECT_TRUE(SamePartition(expected, speakers));
+
+  for (int32_t block_size : {7, 16, 64}) {
+    config.block_size = block_size;
+
+    f = features;
+    auto labels = FastClustering(config).Cluster(f.data(), num_rows, 16);
+    EXPECT_TRUE(SamePartition(labels, expected)) << block_size;
+  }
+}
+
+TEST(FastClustering, TestTwoStageWithNumClusters) {
+  std::vector<int32_t> speakers;
+  std::vector<float> features = GenerateTurns(4, 8, 5, 16, &speakers);
+  int32_t num_rows = speakers.size();
+
+  FastClusteringConfig config;
+  config.num_clusters = 4;
+  config.block_size = 8;
+
+  auto labels = FastClustering(config).Cluster(features.data(), num_rows, 16);
+  EXPECT_TRUE(SamePartition(labels, speakers));
+}
+
 }  // namespace sherpa_onnx
@@ -4,6 +4,9 @@
 
 #include "sherpa-onnx/csrc/fast-clustering.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <vector>
 
 #include "Eigen/Dense"
@@ -11,6 +14,60 @@
 
 namespace sherpa_onnx {
 
+namespace {
+
+using RowMajorMatrix =
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// Maximum number of entries of the temporary similarity matrix
+// in ComputeDistance()
+constexpr int32_t kMaxSimilarityBlockSize = 1 << 22;
+
+// It is used in the first stage of two-stage clustering if the threshold
+// is not given
+constexpr float kDefaultBlockThreshold = 0.5;
+
+/* Compute the cosine dissimilarity, i.e., 1 - (cosine similarity), of
+ * each pair of rows.
+ *
+ * @param m The rows must have unit length.
+ * @return Return the upper triangle of the distance matrix in row major,
+ *         i.e., the condensed form used by hclust_fast().
+ */
+std::vector<double> ComputeDistance(
+    const Eigen::Map<const RowMajorMatrix> &m) {
+  int32_t num_rows = m.rows();
+
+  std::vector<double> distance(static_cast<size_t>(num_rows) *
+                               (num_rows - 1) / 2);
+
+  // Rows of the similarity matrix are computed in blocks with a matrix
+  // multiplication. The block size limits the temporary memory.
+  int32_t block_size = std::max(
+      1, std::min(num_rows, kMaxSimilarityBlockSize / std::max(1, num_rows)));
+
+  RowMajorMatrix s;
+  size_t k = 0;
+  for (int32_t i = 0; i < num_rows - 1; i += block_size) {
+    int32_t b = std::min(block_size, num_rows - 1 - i);
+    int32_t num_cols = num_rows - 1 - i;
+
+    // s(r, c) is the similarity between row i + r and row i + 1 + c
+    s.noalias() = m.middleRows(i, b) * m.bottomRows(num_cols).transpose();
+
+    for (int32_t r = 0; r != b; ++r) {
+      for (int32_t c = r; c != num_cols; ++c) {
+        double d = 1 - s(r, c);
+        distance[k++] = d < 0 ? 0 : d;
+      }
+    }
+  }
+
+  return distance;
+}
+
+}  // namespace
+
 class FastClustering::Impl {
  public:
   explicit Impl(const FastClusteringConfig &config) : config_(config) {}
@@ -25,29 +82,48 @@ class FastClustering::Impl {
       return {0};
     }
 
-    Eigen::Map<
-        Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-        m(features, num_rows, num_cols);
+    Eigen::Map<RowMajorMatrix> m(features, num_rows, num_cols);
     m.rowwise().normalize();
 
-    std::vector<double> distance((num_rows * (num_rows - 1)) / 2);
+    return ClusterNormalized(features, num_rows, num_cols);
+  }
 
-    int32_t k = 0;
-    for (int32_t i = 0; i != num_rows; ++i) {
-      auto v = m.row(i);
-      for (int32_t j = i + 1; j != num_rows; ++j) {
-        double cosine_similarity = v.dot(m.row(j));
-        double consine_dissimilarity = 1 - cosine_similarity;
+ private:
+  // The rows of features must have unit length
+  std::vector<int32_t> ClusterNormalized(const float *features,
+                                         int32_t num_rows,
+                                         int32_t num_cols) const {
+    int32_t max_rows = MaxRows();
+    if (max_rows == 0 || num_rows <= max_rows) {
+      return Hierarchical(features, num_rows, num_cols, config_.num_clusters,
+                          config_.threshold, 0);
+    }
 
-        if (consine_dissimilarity < 0) {
-          consine_dissimilarity = 0;
-        }
+    return ClusterTwoStage(features, num_rows, num_cols, max_rows);
+  }
 
-        distance[k] = consine_dissimilarity;
-        ++k;
-      }
+  /* Complete-linkage hierarchical clustering.
+   *
+   * @param features The rows must have unit length.
+   * @param num_clusters If greater than 0, the threshold is ignored.
+   * @param threshold The distance threshold.
+   * @param max_num_clusters If greater than 0, at most this number of
+   *                         clusters are returned when the threshold is
+   *                         used.
+   */
+  std::vector<int32_t> Hierarchical(const float *features, int32_t num_rows,
+                                    int32_t num_cols, int32_t num_clusters,
+                                    float threshold,
+                                    int32_t max_num_clusters) const {
+    std::vector<int32_t> labels(num_rows);
+    if (num_rows == 1 || num_clusters >= num_rows) {
+      std::iota(labels.begin(), labels.end(), 0);
+      return labels;
     }
 
+    Eigen::Map<const RowMajorMatrix> m(features, num_rows, num_cols);
+    std::vector<double> distance = ComputeDistance(m);
+
     std::vector<int32_t> merge(2 * (num_rows - 1));
     std::vector<double> height(num_rows - 1);
 
@@ -55,18 +131,105 @@ class FastClustering::Impl {
                                 fastclustercpp::HCLUST_METHOD_COMPLETE,
                                 merge.data(), height.data());
 
-    std::vector<int32_t> labels(num_rows);
-    if (config_.num_clusters > 0) {
-      fastclustercpp::cutree_k(num_rows, merge.data(), config_.num_clusters,
+    distance = {};
+
+    if (num_clusters > 0) {
+      fastclustercpp::cutree_k(num_rows, merge.data(), num_clusters,
+                               labels.data());
+      return labels;
+    }
+
+    fastclustercpp::cutree_cdist(num_rows, merge.data(), height.data(),
+                                 threshold, labels.data());
+
+    if (max_num_clusters > 0 &&
+        *std::max_element(labels.begin(), labels.end()) >= max_num_clusters) {
+      fastclustercpp::cutree_k(num_rows, merge.data(), max_num_clusters,
                                labels.data());
-    } else {
-      fastclustercpp::cutree_cdist(num_rows, merge.data(), height.data(),
-                                   config_.threshold, labels.data());
     }
 
     return labels;
   }
 
+  /* Cluster blocks of block_size consecutive rows, which are close in
+   * time for speaker diarization, and then cluster the centroids of the
+   * clusters found in the blocks.
+   *
+   * @param reduce_blocks If true, each block is reduced to at most half of
+   *                      its rows even if they are farther apart than the
+   *                      threshold.
+   */
+  std::vector<int32_t> ClusterTwoStage(const float *features,
+                                       int32_t num_rows, int32_t num_cols,
+                                       int32_t block_size,
+                                       bool reduce_blocks = false) const {
+    float threshold =
+        config_.threshold >= 0 ? config_.threshold : kDefaultBlockThreshold;
+
+    // centroid_index[i] is the centroid of the i-th row
+    std::vector<int32_t> centroid_index(num_rows);
+    std::vector<float> centroids;
+    int32_t num_centroids = 0;
+
+    for (int32_t start = 0; start < num_rows; start += block_size) {
+      int32_t n = std::min(block_size, num_rows - start);
+      const float *p = features + static_cast<size_t>(start) * num_cols;
+
+      std::vector<int32_t> labels = Hierarchical(
+          p, n, num_cols, -1, threshold, reduce_blocks ? (n + 1) / 2 : 0);
+
+      int32_t k = *std::max_element(labels.begin(), labels.end()) + 1;
+
+      centroids.resize(static_cast<size_t>(num_centroids + k) * num_cols);
+      Eigen::Map<RowMajorMatrix> c(
+          centroids.data() + static_cast<size_t>(num_centroids) * num_cols, k,
+          num_cols);
+      c.setZero();
+
+      Eigen::Map<const RowMajorMatrix> m(p, n, num_cols);
+      for (int32_t i = 0; i != n; ++i) {
+        c.row(labels[i]) += m.row(i);
+        centroid_index[start + i] = num_centroids + labels[i];
+      }
+
+      c.rowwise().normalize();
+
+      num_centroids += k;
+    }
+
+    if (num_centroids == num_rows && !reduce_blocks) {
+      // No rows are close enough to be merged. Reduce each block to half
+      // of its rows, so that the recursion below terminates.
+      return ClusterTwoStage(features, num_rows, num_cols, block_size, true);
+    }
+
+    std::vector<int32_t> centroid_labels =
+        ClusterNormalized(centroids.data(), num_centroids, num_cols);
+
+    std::vector<int32_t> ans(num_rows);
+    for (int32_t i = 0; i != num_rows; ++i) {
+      ans[i] = centroid_labels[centroid_index[i]];
+    }
+
+    return ans;
+  }
+
+  // Maximum number of rows clustered in a single stage. 0 means no limit.
+  int32_t MaxRows() const {
+    int32_t ans = config_.block_size;
+
+    if (config_.max_memory_mb > 0) {
+      // n * (n - 1) / 2 distances in double must fit into the memory
+      double c = config_.max_memory_mb * 1024.0 * 1024.0 / sizeof(double);
+      double n = std::floor((1 + std::sqrt(1 + 8 * c)) / 2);
+      int32_t max_rows = static_cast<int32_t>(std::max(2.0, std::min(n, 1e9)));
+
+      ans = ans > 0 ? std::min(ans, max_rows) : max_rows;
+    }
+
+    return ans;
+  }
+
  private:
   FastClusteringConfig config_;
 };
@@ -4,6 +4,9 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 
+#include <sys/stat.h>
+#include <sys/types.h>
+
 #include <fstream>
 #include <string>
 
@@ -18,8 +21,28 @@ bool FileExists(const std::string &filename) {
 void AssertFileExists(const std::string &filename) {
   if (!FileExists(filename)) {
     SHERPA_ONNX_LOGE("filename '%s' does not exist", filename.c_str());
-    exit(-1);
+    SHERPA_ONNX_EXIT(-1);
+  }
+}
+
+bool GetFileSizeAndMtime(const std::string &filename, int64_t *size,
+                         int64_t *mtime) {
+#if defined(_WIN32)
+  struct _stat64 st;
+  if (_stat64(filename.c_str(), &st) != 0) {
+    return false;
   }
+#else
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) {
+    return false;
+  }
+#endif
+
+  *size = static_cast<int64_t>(st.st_size);
+  *mtime = static_cast<int64_t>(st.st_mtime);
+
+  return true;
 }
 
 }  // namespace sherpa_onnx
@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_FILE_UTILS_H_
 #define SHERPA_ONNX_CSRC_FILE_UTILS_H_
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 
@@ -23,6 +24,17 @@ bool FileExists(const std::string &filename);
  */
 void AssertFileExists(const std::string &filename);
 
+/** Get the size and the last modification time of a file.
+ *
+ * @param filename The file to check.
+ * @param size On return, it contains the size in bytes.
+ * @param mtime On return, it contains the modification time in seconds
+ *              since the epoch.
+ * @return Return false if the file does not exist.
+ */
+bool GetFileSizeAndMtime(const std::string &filename, int64_t *size,
+                         int64_t *mtime);
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_FILE_UTILS_H_
@@ -30,7 +30,7 @@ class HifiganVocoder::Impl {
       : env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(num_threads, provider)),
         allocator_{} {
-    auto buf = ReadFile(model);
+    auto buf = MapModelFile(model, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -52,9 +52,8 @@ class HifiganVocoder::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
@@ -5,7 +5,7 @@
 #include "sherpa-onnx/csrc/jieba-lexicon.h"
 
 #include <fstream>
-#include <regex>  // NOLINT
+#include <sstream>
 #include <strstream>
 #include <unordered_set>
 #include <utility>
@@ -20,6 +20,7 @@
 #endif
 
 #include "cppjieba/Jieba.hpp"
+#include "sherpa-onnx/csrc/binary-lexicon.h"
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
@@ -61,7 +62,9 @@ class JiebaLexicon::Impl {
       InitTokens(is);
     }
 
-    {
+    if (BinaryLexicon::IsBinaryLexicon(lexicon)) {
+      binary_lexicon_ = std::make_unique<BinaryLexicon>(lexicon, token2id_);
+    } else {
       std::ifstream is(lexicon);
       InitLexicon(is);
     }
@@ -95,25 +98,24 @@ class JiebaLexicon::Impl {
 
     {
       auto buf = ReadFile(mgr, lexicon);
-      std::istrstream is(buf.data(), buf.size());
-      InitLexicon(is);
+      if (BinaryLexicon::IsBinaryLexicon(buf.data(), buf.size())) {
+        binary_lexicon_ =
+            std::make_unique<BinaryLexicon>(std::move(buf), token2id_);
+      } else {
+        std::istrstream is(buf.data(), buf.size());
+        InitLexicon(is);
+      }
     }
   }
 
   std::vector<TokenIDs> ConvertTextToTokenIds(const std::string &text) const {
     // see
     // https://github.com/Plachtaa/VITS-fast-fine-tuning/blob/main/text/mandarin.py#L244
-    std::regex punct_re{"：|、|；"};
-    std::string s = std::regex_replace(text, punct_re, "，");
-
-    std::regex punct_re2("[.]");
-    s = std::regex_replace(s, punct_re2, "。");
-
-    std::regex punct_re3("[?]");
-    s = std::regex_replace(s, punct_re3, "？");
-
-    std::regex punct_re4("[!]");
-    s = std::regex_replace(s, punct_re4, "！");
+    static const std::vector<std::pair<std::string, std::string>> kPuncts = {
+        {"：", "，"}, {"、", "，"}, {"；", "，"},
+        {".", "。"},  {"?", "？"},  {"!", "！"},
+    };
+    std::string s = ReplaceAll(text, kPuncts);
 
     std::vector<std::string> words;
     bool is_hmm = true;
@@ -213,28 +215,40 @@ class JiebaLexicon::Impl {
   }
 
  private:
-  std::vector<int32_t> ConvertWordToIds(const std::string &w) const {
-    if (word2ids_.count(w)) {
-      return word2ids_.at(w);
+  std::vector<int64_t> ConvertWordToIds(const std::string &w) const {
+    std::vector<int64_t> ans;
+    if (LookupWord(w, &ans)) {
+      return ans;
     }
 
     if (token2id_.count(w)) {
       return {token2id_.at(w)};
     }
 
-    std::vector<int32_t> ans;
-
     std::vector<std::string> words = SplitUtf8(w);
     for (const auto &word : words) {
-      if (word2ids_.count(word)) {
-        auto ids = ConvertWordToIds(word);
-        ans.insert(ans.end(), ids.begin(), ids.end());
-      }
+      LookupWord(word, &ans);
     }
 
     return ans;
   }
 
+  // Append the token IDs of w to ids. Return false if w is not in the
+  // lexicon.
+  bool LookupWord(const std::string &w, std::vector<int64_t> *ids) const {
+    if (binary_lexicon_) {
+      return binary_lexicon_->Lookup(w, ids);
+    }
+
+    auto it = word2ids_.find(w);
+    if (it == word2ids_.end()) {
+      return false;
+    }
+
+    ids->insert(ids->end(), it->second.begin(), it->second.end());
+    return true;
+  }
+
   void InitTokens(std::istream &is) {
     token2id_ = ReadTokens(is);
 
@@ -309,6 +323,10 @@ class JiebaLexicon::Impl {
   // lexicon.txt is saved in word2ids_
   std::unordered_map<std::string, std::vector<int32_t>> word2ids_;
 
+  // If lexicon is a file compiled by sherpa-onnx-compile-lexicon, it is
+  // used instead of word2ids_
+  std::unique_ptr<BinaryLexicon> binary_lexicon_;
+
   // tokens.txt is saved in token2id_
   std::unordered_map<std::string, int32_t> token2id_;
 
@@ -7,7 +7,7 @@
 
 #include <algorithm>
 #include <memory>
-#include <regex>  // NOLINT
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -120,7 +120,8 @@ class KeywordSpotterTransducerImpl : public KeywordSpotterImpl {
 
   std::unique_ptr<OnlineStream> CreateStream(
       const std::string &keywords) const override {
-    auto kws = std::regex_replace(keywords, std::regex("/"), "\n");
+    std::string kws = keywords;
+    std::replace(kws.begin(), kws.end(), '/', '\n');
     std::istringstream is(kws);
 
     std::vector<std::vector<int32_t>> current_ids;
@@ -105,7 +105,9 @@ Lexicon::Lexicon(const std::string &lexicon, const std::string &tokens,
     InitTokens(is);
   }
 
-  {
+  if (BinaryLexicon::IsBinaryLexicon(lexicon)) {
+    binary_lexicon_ = std::make_unique<BinaryLexicon>(lexicon, token2id_);
+  } else {
     std::ifstream is(lexicon);
     InitLexicon(is);
   }
@@ -129,8 +131,13 @@ Lexicon::Lexicon(Manager *mgr, const std::string &lexicon,
 
   {
     auto buf = ReadFile(mgr, lexicon);
-    std::istrstream is(buf.data(), buf.size());
-    InitLexicon(is);
+    if (BinaryLexicon::IsBinaryLexicon(buf.data(), buf.size())) {
+      binary_lexicon_ =
+          std::make_unique<BinaryLexicon>(std::move(buf), token2id_);
+    } else {
+      std::istrstream is(buf.data(), buf.size());
+      InitLexicon(is);
+    }
   }
 
   InitPunctuations(punctuations);
@@ -236,14 +243,11 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsChinese(
       continue;
     }
 
-    if (!word2ids_.count(w)) {
+    if (!LookupWord(w, &this_sentence)) {
       SHERPA_ONNX_LOGE("OOV %s. Ignore it!", w.c_str());
       continue;
     }
 
-    const auto &token_ids = word2ids_.at(w);
-    this_sentence.insert(this_sentence.end(), token_ids.begin(),
-                         token_ids.end());
     if (blank != -1) {
       this_sentence.push_back(blank);
     }
@@ -313,14 +317,11 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsNotChinese(
       continue;
     }
 
-    if (!word2ids_.count(w)) {
+    if (!LookupWord(w, &this_sentence)) {
       SHERPA_ONNX_LOGE("OOV %s. Ignore it!", w.c_str());
       continue;
     }
 
-    const auto &token_ids = word2ids_.at(w);
-    this_sentence.insert(this_sentence.end(), token_ids.begin(),
-                         token_ids.end());
     this_sentence.push_back(blank);
   }
 
@@ -336,6 +337,21 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsNotChinese(
   return ans;
 }
 
+bool Lexicon::LookupWord(const std::string &w,
+                         std::vector<int64_t> *ids) const {
+  if (binary_lexicon_) {
+    return binary_lexicon_->Lookup(w, ids);
+  }
+
+  auto it = word2ids_.find(w);
+  if (it == word2ids_.end()) {
+    return false;
+  }
+
+  ids->insert(ids->end(), it->second.begin(), it->second.end());
+  return true;
+}
+
 void Lexicon::InitTokens(std::istream &is) { token2id_ = ReadTokens(is); }
 
 void Lexicon::InitLanguage(const std::string &_lang) {
@@ -13,6 +13,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "sherpa-onnx/csrc/binary-lexicon.h"
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 
 namespace sherpa_onnx {
@@ -41,6 +42,10 @@ class Lexicon : public OfflineTtsFrontend {
   std::vector<TokenIDs> ConvertTextToTokenIdsChinese(
       const std::string &text) const;
 
+  // Append the token IDs of w to ids. Return false if w is not in the
+  // lexicon.
+  bool LookupWord(const std::string &w, std::vector<int64_t> *ids) const;
+
   void InitLanguage(const std::string &lang);
   void InitTokens(std::istream &is);
   void InitLexicon(std::istream &is);
@@ -55,6 +60,10 @@ class Lexicon : public OfflineTtsFrontend {
 
  private:
   std::unordered_map<std::string, std::vector<int32_t>> word2ids_;
+
+  // If lexicon is a file compiled by sherpa-onnx-compile-lexicon, it is
+  // used instead of word2ids_
+  std::unique_ptr<BinaryLexicon> binary_lexicon_;
   std::unordered_set<std::string> punctuations_;
   std::unordered_map<std::string, int32_t> token2id_;
   Language language_ = Language::kUnknown;
@@ -0,0 +1,73 @@
+// sherpa-onnx/csrc/lru-cache-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/lru-cache.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(LruCache, EvictLeastRecentlyUsed) {
+  LruCache<std::string, int32_t> cache(2);
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+
+  int32_t v = 0;
+  EXPECT_TRUE(cache.Get("a", &v));
+  EXPECT_EQ(v, 1);
+
+  // b is the least recently used one
+  cache.Put("c", 3);
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_FALSE(cache.Get("b", &v));
+  EXPECT_TRUE(cache.Get("a", &v));
+  EXPECT_TRUE(cache.Get("c", &v));
+  EXPECT_EQ(v, 3);
+
+  EXPECT_EQ(cache.NumHits(), 3);
+  EXPECT_EQ(cache.NumMisses(), 1);
+}
+
+TEST(LruCache, Cost) {
+  LruCache<int32_t, std::vector<float>> cache(10);
+  cache.Put(1, std::vector<float>(4), 4);
+  cache.Put(2, std::vector<float>(4), 4);
+  EXPECT_EQ(cache.Cost(), 8);
+
+  // Replace an entry
+  cache.Put(1, std::vector<float>(2), 2);
+  EXPECT_EQ(cache.Cost(), 6);
+  EXPECT_EQ(cache.Size(), 2);
+
+  // It evicts 2 and then 1
+  cache.Put(3, std::vector<float>(9), 9);
+  EXPECT_EQ(cache.Cost(), 9);
+  EXPECT_EQ(cache.Size(), 1);
+
+  // Too large to be cached
+  cache.Put(4, std::vector<float>(11), 11);
+  std::vector<float> v;
+  EXPECT_FALSE(cache.Get(4, &v));
+  EXPECT_TRUE(cache.Get(3, &v));
+  EXPECT_EQ(v.size(), 9);
+}
+
+TEST(LruCache, ForEach) {
+  LruCache<int32_t, int32_t> cache(3);
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  cache.Put(3, 30);
+
+  int32_t v = 0;
+  cache.Get(1, &v);
+
+  std::vector<int32_t> keys;
+  cache.ForEach([&keys](int32_t k, int32_t) { keys.push_back(k); });
+  EXPECT_EQ(keys, (std::vector<int32_t>{2, 3, 1}));
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,128 @@
+// sherpa-onnx/csrc/lru-cache.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_LRU_CACHE_H_
+#define SHERPA_ONNX_CSRC_LRU_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+
+namespace sherpa_onnx {
+
+/** A thread-safe least recently used cache.
+ *
+ * Each entry has a cost, e.g., 1 to limit the number of entries or its
+ * size in bytes to limit the memory. The least recently used entries are
+ * evicted when the total cost exceeds the capacity.
+ */
+template <typename Key, typename Value>
+class LruCache {
+ public:
+  // @param capacity Maximum total cost of all entries
+  explicit LruCache(size_t capacity) : capacity_(capacity) {}
+
+  // Return true and copy the value to *value if the key is in the cache.
+  // It counts a hit or a miss.
+  bool Get(const Key &key, Value *value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      ++num_misses_;
+      return false;
+    }
+
+    ++num_hits_;
+    list_.splice(list_.begin(), list_, it->second);
+    *value = it->second->value;
+
+    return true;
+  }
+
+  // Insert or replace an entry. An entry whose cost exceeds the capacity
+  // is not inserted.
+  void Put(const Key &key, Value value, size_t cost = 1) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+      cost_ -= it->second->cost;
+      list_.erase(it->second);
+      map_.erase(it);
+    }
+
+    if (cost > capacity_) {
+      return;
+    }
+
+    list_.push_front({key, std::move(value), cost});
+    map_.emplace(key, list_.begin());
+    cost_ += cost;
+
+    while (cost_ > capacity_) {
+      cost_ -= list_.back().cost;
+      map_.erase(list_.back().key);
+      list_.pop_back();
+    }
+  }
+
+  // Visit all entries from the least recently used to the most recently
+  // used one
+  void ForEach(
+      const std::function<void(const Key &, const Value &)> &f) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = list_.rbegin(); it != list_.rend(); ++it) {
+      f(it->key, it->value);
+    }
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return list_.size();
+  }
+
+  // Total cost of all entries
+  size_t Cost() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cost_;
+  }
+
+  int64_t NumHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_hits_;
+  }
+
+  int64_t NumMisses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_misses_;
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    Value value;
+    size_t cost;
+  };
+
+  mutable std::mutex mutex_;
+
+  // The most recently used entry is at the front
+  std::list<Entry> list_;
+  std::unordered_map<Key, typename std::list<Entry>::iterator> map_;
+
+  size_t capacity_;
+  size_t cost_ = 0;
+
+  int64_t num_hits_ = 0;
+  int64_t num_misses_ = 0;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_LRU_CACHE_H_
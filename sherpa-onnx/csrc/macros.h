@@ -8,6 +8,18 @@
 #include <stdlib.h>
 
 #include <utility>
+
+// Each message is written while holding the lock of the stream so that
+// messages logged from several threads, e.g., when models are loaded
+// concurrently, do not interleave.
+#if defined(_WIN32)
+#define SHERPA_ONNX_LOCK_FILE(f) _lock_file(f)
+#define SHERPA_ONNX_UNLOCK_FILE(f) _unlock_file(f)
+#else
+#define SHERPA_ONNX_LOCK_FILE(f) flockfile(f)
+#define SHERPA_ONNX_UNLOCK_FILE(f) funlockfile(f)
+#endif
+
 #if __OHOS__
 #include "hilog/log.h"
 
@@ -23,10 +35,12 @@
 #include "android/log.h"
 #define SHERPA_ONNX_LOGE(...)                                            \
   do {                                                                   \
+    SHERPA_ONNX_LOCK_FILE(stderr);                                       \
     fprintf(stderr, "%s:%s:%d ", __FILE__, __func__,                     \
             static_cast<int>(__LINE__));                                 \
     fprintf(stderr, ##__VA_ARGS__);                                      \
     fprintf(stderr, "\n");                                               \
+    SHERPA_ONNX_UNLOCK_FILE(stderr);                                     \
     __android_log_print(ANDROID_LOG_WARN, "sherpa-onnx", ##__VA_ARGS__); \
   } while (0)
 #elif defined(__OHOS__)
@@ -34,22 +48,35 @@
 #elif SHERPA_ONNX_ENABLE_WASM
 #define SHERPA_ONNX_LOGE(...)                        \
   do {                                               \
+    SHERPA_ONNX_LOCK_FILE(stdout);                   \
     fprintf(stdout, "%s:%s:%d ", __FILE__, __func__, \
             static_cast<int>(__LINE__));             \
     fprintf(stdout, ##__VA_ARGS__);                  \
     fprintf(stdout, "\n");                           \
+    SHERPA_ONNX_UNLOCK_FILE(stdout);                 \
   } while (0)
 #else
 #define SHERPA_ONNX_LOGE(...)                        \
   do {                                               \
+    SHERPA_ONNX_LOCK_FILE(stderr);                   \
     fprintf(stderr, "%s:%s:%d ", __FILE__, __func__, \
             static_cast<int>(__LINE__));             \
     fprintf(stderr, ##__VA_ARGS__);                  \
     fprintf(stderr, "\n");                           \
+    SHERPA_ONNX_UNLOCK_FILE(stderr);                 \
   } while (0)
 #endif
 
-#define SHERPA_ONNX_EXIT(code) exit(code)
+namespace sherpa_onnx {
+
+// It calls exit(code). Inside a task of RunConcurrently() it throws instead
+// and the calling thread exits after all tasks have finished.
+// See thread-pool.cc
+[[noreturn]] void Exit(int code);
+
+}  // namespace sherpa_onnx
+
+#define SHERPA_ONNX_EXIT(code) sherpa_onnx::Exit(code)
 
 // Read an integer
 #define SHERPA_ONNX_READ_META_DATA(dst, src_key)                           \
@@ -0,0 +1,44 @@
+// sherpa-onnx/csrc/mapped-file-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(MappedFile, Read) {
+  std::string filename = "mapped-file-test.bin";
+  std::string content = "sherpa-onnx\n0123456789";
+  {
+    std::ofstream os(filename, std::ios::binary);
+    os << content;
+  }
+
+  {
+    MappedFile f(filename);
+    ASSERT_EQ(f.size(), content.size());
+    EXPECT_EQ(std::string(f.data(), f.size()), content);
+
+    MappedFile g = std::move(f);
+    EXPECT_EQ(f.data(), nullptr);
+    EXPECT_EQ(f.size(), 0);
+    EXPECT_EQ(std::string(g.data(), g.size()), content);
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST(MappedFile, NonExistentFile) {
+  MappedFile f("/path/to/a/non-existent/file");
+  EXPECT_EQ(f.data(), nullptr);
+  EXPECT_TRUE(f.empty());
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,159 @@
+// sherpa-onnx/csrc/mapped-file.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHERPA_ONNX_HAVE_MMAP 1
+#endif
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+#if defined(_WIN32)
+static bool MapFile(const std::string &filename, const char **data,
+                    size_t *size) {
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return false;
+  }
+
+  void *p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  // The view keeps a reference to the mapping object
+  CloseHandle(mapping);
+  if (p == nullptr) {
+    return false;
+  }
+
+  *data = static_cast<const char *>(p);
+  *size = static_cast<size_t>(file_size.QuadPart);
+
+  return true;
+}
+
+static void UnmapFile(const char *data, size_t /*size*/) {
+  UnmapViewOfFile(data);
+}
+
+#elif SHERPA_ONNX_HAVE_MMAP
+static bool MapFile(const std::string &filename, const char **data,
+                    size_t *size) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+  if (p == MAP_FAILED) {
+    return false;
+  }
+
+  *data = static_cast<const char *>(p);
+  *size = static_cast<size_t>(st.st_size);
+
+  return true;
+}
+
+static void UnmapFile(const char *data, size_t size) {
+  munmap(const_cast<char *>(data), size);
+}
+
+#else
+static bool MapFile(const std::string & /*filename*/, const char ** /*data*/,
+                    size_t * /*size*/) {
+  return false;
+}
+
+static void UnmapFile(const char * /*data*/, size_t /*size*/) {}
+#endif
+
+MappedFile::MappedFile(const std::string &filename) {
+  if (MapFile(filename, &data_, &size_)) {
+    mapped_ = true;
+    return;
+  }
+
+  std::ifstream is(filename, std::ios::binary);
+  if (!is) {
+    SHERPA_ONNX_LOGE("Failed to open '%s'", filename.c_str());
+    return;
+  }
+
+  buffer_.assign(std::istreambuf_iterator<char>(is), {});
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() { Release(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  Release();
+
+  mapped_ = other.mapped_;
+  size_ = other.size_;
+  buffer_ = std::move(other.buffer_);
+  data_ = mapped_ ? other.data_ : buffer_.data();
+
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.mapped_ = false;
+
+  return *this;
+}
+
+void MappedFile::Release() {
+  if (mapped_ && data_) {
+    UnmapFile(data_, size_);
+  }
+
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  buffer_.clear();
+}
+
+}  // namespace sherpa_onnx
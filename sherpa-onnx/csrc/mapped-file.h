@@ -0,0 +1,59 @@
+// sherpa-onnx/csrc/mapped-file.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_MAPPED_FILE_H_
+#define SHERPA_ONNX_CSRC_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sherpa_onnx {
+
+/** A read-only view of a file.
+ *
+ * The file is memory-mapped if the platform supports it, so its pages live
+ * in the page cache and are shared by all processes mapping the same file;
+ * nothing is copied into a private buffer. Otherwise, we fall back to
+ * reading the whole file into memory.
+ */
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  // If the file cannot be opened, data() returns nullptr and size() is 0.
+  explicit MappedFile(const std::string &filename);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  // Return true if the file is memory-mapped; false if it has been read
+  // into memory.
+  bool IsMapped() const { return mapped_; }
+
+ private:
+  void Release();
+
+ private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+
+  // Used only when memory mapping is not available
+  std::vector<char> buffer_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_MAPPED_FILE_H_
@@ -5,7 +5,7 @@
 #include "sherpa-onnx/csrc/melo-tts-lexicon.h"
 
 #include <fstream>
-#include <regex>  // NOLINT
+#include <sstream>
 #include <strstream>
 #include <utility>
 #if __ANDROID_API__ >= 9
@@ -18,6 +18,7 @@
 #endif
 
 #include "cppjieba/Jieba.hpp"
+#include "sherpa-onnx/csrc/binary-lexicon.h"
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
@@ -52,10 +53,7 @@ class MeloTtsLexicon::Impl {
       InitTokens(is);
     }
 
-    {
-      std::ifstream is(lexicon);
-      InitLexicon(is);
-    }
+    InitLexicon(lexicon);
   }
 
   Impl(const std::string &lexicon, const std::string &tokens,
@@ -66,10 +64,7 @@ class MeloTtsLexicon::Impl {
       InitTokens(is);
     }
 
-    {
-      std::ifstream is(lexicon);
-      InitLexicon(is);
-    }
+    InitLexicon(lexicon);
   }
 
   template <typename Manager>
@@ -99,12 +94,7 @@ class MeloTtsLexicon::Impl {
       InitTokens(is);
     }
 
-    {
-      auto buf = ReadFile(mgr, lexicon);
-
-      std::istrstream is(buf.data(), buf.size());
-      InitLexicon(is);
-    }
+    InitLexicon(ReadFile(mgr, lexicon));
   }
 
   template <typename Manager>
@@ -118,29 +108,18 @@ class MeloTtsLexicon::Impl {
       InitTokens(is);
     }
 
-    {
-      auto buf = ReadFile(mgr, lexicon);
-
-      std::istrstream is(buf.data(), buf.size());
-      InitLexicon(is);
-    }
+    InitLexicon(ReadFile(mgr, lexicon));
   }
 
   std::vector<TokenIDs> ConvertTextToTokenIds(const std::string &_text) const {
     std::string text = ToLowerCase(_text);
     // see
     // https://github.com/Plachtaa/VITS-fast-fine-tuning/blob/main/text/mandarin.py#L244
-    std::regex punct_re{"：|、|；"};
-    std::string s = std::regex_replace(text, punct_re, ",");
-
-    std::regex punct_re2("。");
-    s = std::regex_replace(s, punct_re2, ".");
-
-    std::regex punct_re3("？");
-    s = std::regex_replace(s, punct_re3, "?");
-
-    std::regex punct_re4("！");
-    s = std::regex_replace(s, punct_re4, "!");
+    static const std::vector<std::pair<std::string, std::string>> kPuncts = {
+        {"：", ","}, {"、", ","}, {"；", ","},
+        {"。", "."}, {"？", "?"}, {"！", "!"},
+    };
+    std::string s = ReplaceAll(text, kPuncts);
 
     std::vector<std::string> words;
     if (jieba_) {
@@ -216,24 +195,18 @@ class MeloTtsLexicon::Impl {
 
  private:
   TokenIDs ConvertWordToIds(const std::string &w) const {
-    if (word2ids_.count(w)) {
-      return word2ids_.at(w);
+    TokenIDs ans;
+    if (LookupWord(w, &ans)) {
+      return ans;
     }
 
     if (token2id_.count(w)) {
       return {{token2id_.at(w)}, {0}};
     }
 
-    TokenIDs ans;
-
     std::vector<std::string> words = SplitUtf8(w);
     for (const auto &word : words) {
-      if (word2ids_.count(word)) {
-        auto ids = ConvertWordToIds(word);
-        ans.tokens.insert(ans.tokens.end(), ids.tokens.begin(),
-                          ids.tokens.end());
-        ans.tones.insert(ans.tones.end(), ids.tones.begin(), ids.tones.end());
-      } else {
+      if (!LookupWord(word, &ans)) {
         // If the lexicon does not contain the word, we split the word into
         // characters.
         //
@@ -242,12 +215,7 @@ class MeloTtsLexicon::Impl {
         std::string s;
         for (char c : word) {
           s = c;
-          if (word2ids_.count(s)) {
-            const auto &t = word2ids_.at(s);
-            ans.tokens.insert(ans.tokens.end(), t.tokens.begin(),
-                              t.tokens.end());
-            ans.tones.insert(ans.tones.end(), t.tones.begin(), t.tones.end());
-          }
+          LookupWord(s, &ans);
         }
       }
     }
@@ -255,6 +223,21 @@ class MeloTtsLexicon::Impl {
     return ans;
   }
 
+  // Append the token IDs and tones of w to ans. Return false if w is not
+  // in the lexicon.
+  bool LookupWord(const std::string &w, TokenIDs *ans) const {
+    auto it = word2ids_.find(w);
+    if (it != word2ids_.end()) {
+      const auto &t = it->second;
+      ans->tokens.insert(ans->tokens.end(), t.tokens.begin(), t.tokens.end());
+      ans->tones.insert(ans->tones.end(), t.tones.begin(), t.tones.end());
+      return true;
+    }
+
+    return binary_lexicon_ &&
+           binary_lexicon_->Lookup(w, &ans->tokens, &ans->tones);
+  }
+
   void InitTokens(std::istream &is) {
     token2id_ = ReadTokens(is);
     token2id_[" "] = token2id_["_"];
@@ -277,6 +260,37 @@ class MeloTtsLexicon::Impl {
     }
   }
 
+  void InitLexicon(const std::string &lexicon) {
+    if (BinaryLexicon::IsBinaryLexicon(lexicon)) {
+      InitBinaryLexicon(std::make_unique<BinaryLexicon>(lexicon, token2id_));
+    } else {
+      std::ifstream is(lexicon);
+      InitLexicon(is);
+    }
+  }
+
+  void InitLexicon(std::vector<char> buf) {
+    if (BinaryLexicon::IsBinaryLexicon(buf.data(), buf.size())) {
+      InitBinaryLexicon(
+          std::make_unique<BinaryLexicon>(std::move(buf), token2id_));
+    } else {
+      std::istrstream is(buf.data(), buf.size());
+      InitLexicon(is);
+    }
+  }
+
+  void InitBinaryLexicon(std::unique_ptr<BinaryLexicon> lexicon) {
+    if (!lexicon->HasTones()) {
+      SHERPA_ONNX_LOGE(
+          "The binary lexicon has no tones. Please compile it with "
+          "--with-tones");
+      SHERPA_ONNX_EXIT(-1);
+    }
+
+    binary_lexicon_ = std::move(lexicon);
+    AddAliases();
+  }
+
   void InitLexicon(std::istream &is) {
     std::string word;
     std::vector<std::string> token_list;
@@ -344,15 +358,29 @@ class MeloTtsLexicon::Impl {
           {std::move(word), TokenIDs{std::move(ids64), std::move(tone_list)}});
     }
 
-    // For Chinese+English MeloTTS
-    word2ids_["呣"] = word2ids_["母"];
-    word2ids_["嗯"] = word2ids_["恩"];
+    AddAliases();
+  }
+
+  // For Chinese+English MeloTTS
+  void AddAliases() {
+    std::vector<std::pair<std::string, std::string>> aliases = {
+        {"呣", "母"}, {"嗯", "恩"}};
+
+    for (const auto &p : aliases) {
+      TokenIDs ids;
+      LookupWord(p.second, &ids);
+      word2ids_[p.first] = std::move(ids);
+    }
   }
 
  private:
   // lexicon.txt is saved in word2ids_
   std::unordered_map<std::string, TokenIDs> word2ids_;
 
+  // If lexicon is a file compiled by sherpa-onnx-compile-lexicon, it is
+  // used for words not in word2ids_
+  std::unique_ptr<BinaryLexicon> binary_lexicon_;
+
   // tokens.txt is saved in token2id_
   std::unordered_map<std::string, int32_t> token2id_;
 
@@ -0,0 +1,91 @@
+// sherpa-onnx/csrc/model-cache-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/model-cache.h"
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(ModelCache, HashBytes) {
+  std::string a = "hello sherpa-onnx";
+  std::string b = "hello sherpa-onnY";
+
+  EXPECT_EQ(HashBytes(a.data(), a.size()), HashBytes(a.data(), a.size()));
+  EXPECT_NE(HashBytes(a.data(), a.size()), HashBytes(b.data(), b.size()));
+  EXPECT_NE(HashBytes(a.data(), a.size()), HashBytes(a.data(), a.size(), 1));
+
+  // Trailing zero bytes are part of the content
+  std::string c = a + std::string(3, '\0');
+  EXPECT_NE(HashBytes(a.data(), a.size()), HashBytes(c.data(), c.size()));
+
+  EXPECT_EQ(HashBytes(nullptr, 0), HashBytes(a.data(), 0));
+}
+
+TEST(ModelCache, GetOptimizedModelPath) {
+  ModelCacheConfig config;
+  config.enabled = true;
+
+  std::string model = "model content";
+
+  std::string p = GetOptimizedModelPath(config, "/a/b/encoder.onnx",
+                                        model.data(), model.size(), "cpu");
+  EXPECT_EQ(p.rfind("/a/b/encoder.", 0), 0) << p;
+  EXPECT_EQ(p.substr(p.size() - 4), ".ort") << p;
+
+  // Different options use different files
+  std::string p2 = GetOptimizedModelPath(config, "/a/b/encoder.onnx",
+                                         model.data(), model.size(), "cuda");
+  EXPECT_NE(p, p2);
+
+  std::string p3 = GetOptimizedModelPath(config, "encoder.onnx", model.data(),
+                                         model.size(), "cpu");
+  EXPECT_EQ(p3.rfind("./encoder.", 0), 0) << p3;
+
+  config.dir = "/tmp/cache";
+  std::string p4 = GetOptimizedModelPath(config, "/a/b/encoder.onnx",
+                                         model.data(), model.size(), "cpu");
+  EXPECT_EQ(p4.rfind("/tmp/cache/encoder.", 0), 0) << p4;
+  EXPECT_EQ(p4.substr(p4.find_last_of('/')), p.substr(p.find_last_of('/')));
+}
+
+TEST(ModelCache, Stamp) {
+  ModelCacheConfig config;
+  config.enabled = true;
+
+  std::string s = GetModelStampPath(config, "./encoder.onnx", 10, 100, "cpu");
+  EXPECT_EQ(s.rfind("./encoder.", 0), 0) << s;
+  EXPECT_EQ(s.substr(s.size() - 6), ".stamp") << s;
+
+  // The stamp changes if the model is modified
+  EXPECT_NE(s, GetModelStampPath(config, "./encoder.onnx", 11, 100, "cpu"));
+  EXPECT_NE(s, GetModelStampPath(config, "./encoder.onnx", 10, 101, "cpu"));
+  EXPECT_NE(s, GetModelStampPath(config, "./encoder.onnx", 10, 100, "cuda"));
+
+  EXPECT_EQ(ReadModelStamp(s), "");
+
+  EXPECT_TRUE(WriteModelStamp(s, "./encoder.0123456789abcdef.ort"));
+  EXPECT_EQ(ReadModelStamp(s), "./encoder.0123456789abcdef.ort");
+
+  // Replace an existing stamp
+  EXPECT_TRUE(WriteModelStamp(s, "./encoder.fedcba9876543210.ort"));
+  EXPECT_EQ(ReadModelStamp(s), "./encoder.fedcba9876543210.ort");
+
+  std::remove(s.c_str());
+}
+
+TEST(ModelCache, IsOrtFormatModel) {
+  std::string ort = std::string(4, '\0') + "ORTM" + std::string(8, '\0');
+  EXPECT_TRUE(IsOrtFormatModel(ort.data(), ort.size()));
+
+  std::string onnx = "\x08\x07\x12\x07pytorch";
+  EXPECT_FALSE(IsOrtFormatModel(onnx.data(), onnx.size()));
+
+  EXPECT_FALSE(IsOrtFormatModel(ort.data(), 6));
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,195 @@
+// sherpa-onnx/csrc/model-cache.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/model-cache.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+
+namespace sherpa_onnx {
+
+void ModelCacheConfig::Register(ParseOptions *po) {
+  po->Register("model-cache", &enabled,
+               "true to save the optimized graph of each model the first time "
+               "it is loaded and to reuse it afterwards. It reduces the "
+               "startup time. Used only for the cpu provider.");
+
+  po->Register("model-cache-dir", &dir,
+               "Directory for the optimized models. If empty, they are saved "
+               "next to the original models.");
+}
+
+bool ModelCacheConfig::Validate() const { return true; }
+
+std::string ModelCacheConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "ModelCacheConfig(";
+  os << "enabled=" << (enabled ? "True" : "False") << ", ";
+  os << "dir=\"" << dir << "\")";
+
+  return os.str();
+}
+
+static std::mutex g_model_cache_mutex;
+static ModelCacheConfig g_model_cache_config;
+
+void SetModelCacheConfig(const ModelCacheConfig &config) {
+  std::lock_guard<std::mutex> lock(g_model_cache_mutex);
+  g_model_cache_config = config;
+}
+
+ModelCacheConfig GetModelCacheConfig() {
+  std::lock_guard<std::mutex> lock(g_model_cache_mutex);
+  return g_model_cache_config;
+}
+
+// The finalizer of splitmix64
+static uint64_t Mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+uint64_t HashBytes(const void *data, size_t n, uint64_t seed /*= 0*/) {
+  constexpr uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+
+  const char *p = static_cast<const char *>(data);
+  uint64_t h = Mix(seed ^ (n * kMul));
+
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t w;
+    std::memcpy(&w, p + i, 8);
+    h = (h ^ Mix(w)) * kMul;
+  }
+
+  uint64_t tail = 0;
+  if (i < n) {
+    std::memcpy(&tail, p + i, n - i);
+  }
+
+  return Mix(h ^ Mix(tail));
+}
+
+// Split filename into the cache directory and the model name without
+// the suffix .onnx
+static void GetCacheDirAndName(const ModelCacheConfig &config,
+                               const std::string &filename, std::string *dir,
+                               std::string *name) {
+  *dir = config.dir;
+  *name = filename;
+
+  auto pos = filename.find_last_of("/\\");
+  if (pos != std::string::npos) {
+    if (dir->empty()) {
+      *dir = pos == 0 ? "/" : filename.substr(0, pos);
+    }
+    *name = filename.substr(pos + 1);
+  }
+
+  if (dir->empty()) {
+    *dir = ".";
+  }
+
+  if (dir->back() != '/' && dir->back() != '\\') {
+    *dir += '/';
+  }
+
+  const std::string suffix = ".onnx";
+  if (name->size() > suffix.size() &&
+      name->compare(name->size() - suffix.size(), suffix.size(), suffix) ==
+          0) {
+    name->resize(name->size() - suffix.size());
+  }
+}
+
+static std::string ToHex(uint64_t h) {
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+  return hex;
+}
+
+std::string GetOptimizedModelPath(const ModelCacheConfig &config,
+                                  const std::string &filename,
+                                  const char *data, size_t size,
+                                  const std::string &options) {
+  std::string dir;
+  std::string name;
+  GetCacheDirAndName(config, filename, &dir, &name);
+
+  uint64_t h =
+      HashBytes(data, size, HashBytes(options.data(), options.size()));
+
+  return dir + name + "." + ToHex(h) + ".ort";
+}
+
+std::string GetModelStampPath(const ModelCacheConfig &config,
+                              const std::string &filename, int64_t size,
+                              int64_t mtime, const std::string &options) {
+  std::string dir;
+  std::string name;
+  GetCacheDirAndName(config, filename, &dir, &name);
+
+  std::ostringstream os;
+  os << filename << "|" << size << "|" << mtime << "|" << options;
+  std::string key = os.str();
+
+  return dir + name + "." + ToHex(HashBytes(key.data(), key.size())) +
+         ".stamp";
+}
+
+std::string ReadModelStamp(const std::string &stamp) {
+  std::ifstream is(stamp);
+  std::string path;
+  std::getline(is, path);
+  return path;
+}
+
+bool WriteModelStamp(const std::string &stamp, const std::string &path) {
+  // Write a temporary file first so that other processes never read an
+  // incomplete stamp
+  std::ostringstream name;
+  name << stamp << ".tmp"
+       << std::hash<std::thread::id>()(std::this_thread::get_id())
+       << std::chrono::steady_clock::now().time_since_epoch().count();
+  std::string tmp = name.str();
+
+  {
+    std::ofstream os(tmp);
+    os << path << "\n";
+    if (!os) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+  }
+
+#if defined(_WIN32)
+  // rename() does not replace an existing file on Windows
+  std::remove(stamp.c_str());
+#endif
+
+  if (std::rename(tmp.c_str(), stamp.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool IsOrtFormatModel(const char *data, size_t size) {
+  // The flatbuffers file identifier is at bytes 4-7
+  return size > 8 && std::memcmp(data + 4, "ORTM", 4) == 0;
+}
+
+}  // namespace sherpa_onnx
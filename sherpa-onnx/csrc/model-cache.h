@@ -0,0 +1,94 @@
+// sherpa-onnx/csrc/model-cache.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_MODEL_CACHE_H_
+#define SHERPA_ONNX_CSRC_MODEL_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+// Cache of optimized models.
+//
+// onnxruntime runs graph optimizations every time a model is loaded, which
+// can take several seconds for large models. If the cache is enabled, the
+// optimized graph of a model is saved in the ORT format the first time it is
+// loaded and later loads skip the optimizations.
+//
+// Some optimizations depend on the CPU, so a cache directory should not be
+// shared between machines with different CPUs.
+struct ModelCacheConfig {
+  bool enabled = false;
+
+  // Directory for the optimized models. If empty, they are saved next to
+  // the original models.
+  std::string dir;
+
+  ModelCacheConfig() = default;
+
+  ModelCacheConfig(bool enabled, const std::string &dir)
+      : enabled(enabled), dir(dir) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+// Set the cache config used by all models loaded afterwards in this process.
+void SetModelCacheConfig(const ModelCacheConfig &config);
+
+ModelCacheConfig GetModelCacheConfig();
+
+// A fast non-cryptographic 64-bit hash
+uint64_t HashBytes(const void *data, size_t n, uint64_t seed = 0);
+
+/** Return the path of the optimized model for the given model.
+ *
+ * The filename contains a hash of the model content and of options, so a
+ * cached model is never used for a different model or with different
+ * session options.
+ *
+ * @param config The cache config.
+ * @param filename Path to the original model.
+ * @param data Content of the original model.
+ * @param size Number of bytes of data.
+ * @param options Anything that affects the optimized graph, e.g., the
+ *                provider, the number of threads and the onnxruntime
+ *                version.
+ */
+std::string GetOptimizedModelPath(const ModelCacheConfig &config,
+                                  const std::string &filename,
+                                  const char *data, size_t size,
+                                  const std::string &options);
+
+/** Return the path of the stamp file of a model.
+ *
+ * A stamp file contains the path returned by GetOptimizedModelPath() for
+ * the model. Its name depends only on the path, the size and the
+ * modification time of the model and on options, so the optimized model
+ * can be found without reading the whole model. If the model is modified,
+ * its stamp file changes and the content is hashed again.
+ */
+std::string GetModelStampPath(const ModelCacheConfig &config,
+                              const std::string &filename, int64_t size,
+                              int64_t mtime, const std::string &options);
+
+// Return the content of a stamp file. Return an empty string if it does
+// not exist.
+std::string ReadModelStamp(const std::string &stamp);
+
+// Save path into a stamp file. Return false on error.
+bool WriteModelStamp(const std::string &stamp, const std::string &path);
+
+// Return true if data is a model in the ORT format
+bool IsOrtFormatModel(const char *data, size_t size);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_MODEL_CACHE_H_
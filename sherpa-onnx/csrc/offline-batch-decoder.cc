@@ -0,0 +1,399 @@
+// sherpa-onnx/csrc/offline-batch-decoder.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-batch-decoder.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace sherpa_onnx {
+
+void OfflineBatchDecoderConfig::Register(ParseOptions *po) {
+  po->Register("nj", &num_threads,
+               "Number of threads decoding batches concurrently. Each of "
+               "them uses --num-threads threads to run the neural network.");
+
+  po->Register("batch-size", &batch_size,
+               "Maximum number of wave files decoded at once.");
+
+  po->Register("max-batch-duration", &max_batch_duration,
+               "Maximum total duration in seconds of the wave files in a "
+               "batch. 0 means no limit.");
+
+  po->Register("prefetch", &prefetch,
+               "Maximum number of wave files kept in memory before they are "
+               "decoded. Files of similar length among them are decoded in "
+               "the same batch. If it is <= 0, 2 * nj * batch-size is used.");
+
+  po->Register("num-io-threads", &num_io_threads,
+               "Number of threads reading wave files.");
+}
+
+bool OfflineBatchDecoderConfig::Validate() const {
+  if (num_threads < 1) {
+    SHERPA_ONNX_LOGE("--nj should be positive. Given: %d", num_threads);
+    return false;
+  }
+
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("--batch-size should be positive. Given: %d",
+                     batch_size);
+    return false;
+  }
+
+  if (max_batch_duration < 0) {
+    SHERPA_ONNX_LOGE("--max-batch-duration should be >= 0. Given: %.3f",
+                     max_batch_duration);
+    return false;
+  }
+
+  if (num_io_threads < 1) {
+    SHERPA_ONNX_LOGE("--num-io-threads should be positive. Given: %d",
+                     num_io_threads);
+    return false;
+  }
+
+  return true;
+}
+
+std::string OfflineBatchDecoderConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "OfflineBatchDecoderConfig(";
+  os << "num_threads=" << num_threads << ", ";
+  os << "batch_size=" << batch_size << ", ";
+  os << "max_batch_duration=" << max_batch_duration << ", ";
+  os << "prefetch=" << prefetch << ", ";
+  os << "num_io_threads=" << num_io_threads << ")";
+
+  return os.str();
+}
+
+std::string OfflineBatchDecoderStats::ToString() const {
+  std::ostringstream os;
+
+  os << "OfflineBatchDecoderStats(";
+  os << "num_files=" << num_files << ", ";
+  os << "num_failed=" << num_failed << ", ";
+  os << "num_batches=" << num_batches << ", ";
+  os << "total_duration=" << total_duration << ", ";
+  os << "elapsed_seconds=" << elapsed_seconds << ", ";
+  os << "rtf=" << RealTimeFactor() << ", ";
+  os << "throughput=" << Throughput() << ")";
+
+  return os.str();
+}
+
+class OfflineBatchDecoder::Impl {
+ public:
+  Impl(const OfflineRecognizer *recognizer,
+       const OfflineBatchDecoderConfig &config)
+      : recognizer_(recognizer), config_(config), pool_(config.num_threads) {
+    if (config_.prefetch <= 0) {
+      config_.prefetch = 2 * config_.num_threads * config_.batch_size;
+    }
+
+    // Otherwise we could never form a full batch
+    config_.prefetch = std::max(config_.prefetch, config_.batch_size);
+  }
+
+  OfflineBatchDecoderStats Decode(const std::vector<std::string> &filenames,
+                                  OfflineBatchDecoderCallback callback) {
+    const auto begin = std::chrono::steady_clock::now();
+
+    int32_t num_files = static_cast<int32_t>(filenames.size());
+
+    State s;
+    s.filenames = &filenames;
+    s.callback = std::move(callback);
+    s.results.resize(num_files);
+    s.finished.resize(num_files, false);
+    s.num_active_readers = config_.num_io_threads;
+
+    std::vector<std::thread> readers;
+    readers.reserve(config_.num_io_threads);
+    for (int32_t i = 0; i != config_.num_io_threads; ++i) {
+      readers.emplace_back([this, &s]() { ReadFiles(&s); });
+    }
+
+    int32_t num_batches = 0;
+    while (true) {
+      auto batch = std::make_shared<std::vector<Wave>>();
+      {
+        std::unique_lock<std::mutex> lock(s.mutex);
+        s.cv.wait(lock, [this, &s]() { return CanDispatch(s); });
+
+        if (s.num_active_readers == 0 && s.ready.empty()) {
+          break;
+        }
+
+        *batch = TakeBatch(&s.ready);
+        ++s.num_outstanding_batches;
+      }
+
+      ++num_batches;
+      pool_.Submit([this, &s, batch]() { DecodeBatch(&s, batch.get()); });
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(s.mutex);
+      s.cv.wait(lock, [&s]() { return s.num_outstanding_batches == 0; });
+    }
+
+    for (auto &t : readers) {
+      t.join();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    OfflineBatchDecoderStats stats;
+    stats.num_files = num_files;
+    stats.num_failed = s.num_failed;
+    stats.num_batches = num_batches;
+    stats.total_duration = s.total_duration;
+    stats.elapsed_seconds =
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+            .count() /
+        1000.;
+
+    return stats;
+  }
+
+ private:
+  struct Wave {
+    int32_t index = 0;
+    int32_t sampling_rate = 0;
+    std::vector<float> samples;
+
+    float Duration() const {
+      return samples.size() / static_cast<float>(sampling_rate);
+    }
+  };
+
+  struct State {
+    const std::vector<std::string> *filenames = nullptr;
+    OfflineBatchDecoderCallback callback;
+
+    // The following fields are protected by mutex
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Wave> ready;  // read but not yet assigned to a batch
+    int32_t next_file = 0;
+    int32_t num_in_flight = 0;  // read but not yet decoded
+    int32_t num_outstanding_batches = 0;
+    int32_t num_active_readers = 0;
+
+    // The following fields are protected by emit_mutex
+    std::mutex emit_mutex;
+    std::vector<OfflineBatchDecoderResult> results;
+    std::vector<bool> finished;
+    int32_t next_to_emit = 0;
+    int32_t num_failed = 0;
+    float total_duration = 0;
+  };
+
+  // Must be called with s.mutex held
+  bool CanDispatch(const State &s) const {
+    bool reading_done = s.num_active_readers == 0;
+    int32_t num_ready = static_cast<int32_t>(s.ready.size());
+
+    if (reading_done && num_ready == 0) {
+      return true;
+    }
+
+    // Keep at most one batch per decoding thread in the pool so that
+    // the remaining files can accumulate in s.ready and be grouped by length.
+    if (s.num_outstanding_batches >= pool_.NumThreads()) {
+      return false;
+    }
+
+    if (num_ready >= config_.batch_size) {
+      return true;
+    }
+
+    // Either there are no more files or the readers are blocked
+    return num_ready > 0 &&
+           (reading_done || s.num_in_flight >= config_.prefetch);
+  }
+
+  // Take the longest files first, so that files in a batch have similar
+  // lengths and long files do not end up in the last batch.
+  std::vector<Wave> TakeBatch(std::vector<Wave> *ready) const {
+    std::stable_sort(ready->begin(), ready->end(),
+                     [](const Wave &a, const Wave &b) {
+                       return a.samples.size() > b.samples.size();
+                     });
+
+    int32_t n = 0;
+    float duration = 0;
+    for (const auto &w : *ready) {
+      if (n == config_.batch_size) {
+        break;
+      }
+
+      if (n > 0 && config_.max_batch_duration > 0 &&
+          duration + w.Duration() > config_.max_batch_duration) {
+        break;
+      }
+
+      duration += w.Duration();
+      ++n;
+    }
+
+    std::vector<Wave> ans(std::make_move_iterator(ready->begin()),
+                          std::make_move_iterator(ready->begin() + n));
+    ready->erase(ready->begin(), ready->begin() + n);
+
+    return ans;
+  }
+
+  void ReadFiles(State *s) const {
+    int32_t num_files = static_cast<int32_t>(s->filenames->size());
+
+    while (true) {
+      int32_t index;
+      {
+        std::unique_lock<std::mutex> lock(s->mutex);
+        s->cv.wait(lock, [this, s]() {
+          return s->num_in_flight < config_.prefetch;
+        });
+
+        index = s->next_file;
+        if (index >= num_files) {
+          break;
+        }
+
+        ++s->next_file;
+        ++s->num_in_flight;
+      }
+
+      const auto &filename = (*s->filenames)[index];
+
+      Wave w;
+      w.index = index;
+
+      bool is_ok = false;
+      w.samples = ReadWave(filename, &w.sampling_rate, &is_ok);
+      if (!is_ok) {
+        SHERPA_ONNX_LOGE("Failed to read '%s'", filename.c_str());
+        Finish(s, index, false, 0, {});
+
+        std::lock_guard<std::mutex> lock(s->mutex);
+        --s->num_in_flight;
+        s->cv.notify_all();
+        continue;
+      }
+
+      std::lock_guard<std::mutex> lock(s->mutex);
+      s->ready.push_back(std::move(w));
+      s->cv.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(s->mutex);
+    --s->num_active_readers;
+    s->cv.notify_all();
+  }
+
+  void DecodeBatch(State *s, std::vector<Wave> *batch) const {
+    int32_t n = static_cast<int32_t>(batch->size());
+
+    std::vector<std::unique_ptr<OfflineStream>> ss;
+    std::vector<OfflineStream *> ss_pointers;
+    std::vector<float> durations;
+    ss.reserve(n);
+    ss_pointers.reserve(n);
+    durations.reserve(n);
+
+    for (auto &w : *batch) {
+      auto stream = recognizer_->CreateStream();
+      stream->AcceptWaveform(w.sampling_rate, w.samples.data(),
+                             w.samples.size());
+      durations.push_back(w.Duration());
+
+      // Features have been computed. Release the samples early.
+      std::vector<float>().swap(w.samples);
+
+      ss_pointers.push_back(stream.get());
+      ss.push_back(std::move(stream));
+    }
+
+    recognizer_->DecodeStreams(ss_pointers.data(), n);
+
+    for (int32_t i = 0; i != n; ++i) {
+      Finish(s, (*batch)[i].index, true, durations[i], ss[i]->GetResult());
+    }
+
+    // Notify while holding the lock since s is destroyed by Decode() once
+    // num_outstanding_batches reaches 0.
+    std::lock_guard<std::mutex> lock(s->mutex);
+    s->num_in_flight -= n;
+    --s->num_outstanding_batches;
+    s->cv.notify_all();
+  }
+
+  // Record the result of a file and emit all results that are ready
+  // in the input order.
+  void Finish(State *s, int32_t index, bool is_ok, float duration,
+              const OfflineRecognitionResult &result) const {
+    int32_t num_files = static_cast<int32_t>(s->results.size());
+
+    std::lock_guard<std::mutex> lock(s->emit_mutex);
+
+    auto &r = s->results[index];
+    r.index = index;
+    r.filename = (*s->filenames)[index];
+    r.is_ok = is_ok;
+    r.duration = duration;
+    r.result = result;
+    s->finished[index] = true;
+
+    if (is_ok) {
+      s->total_duration += duration;
+    } else {
+      s->num_failed += 1;
+    }
+
+    while (s->next_to_emit < num_files && s->finished[s->next_to_emit]) {
+      auto &e = s->results[s->next_to_emit];
+      if (s->callback) {
+        s->callback(e);
+      }
+
+      e = {};
+      ++s->next_to_emit;
+    }
+  }
+
+ private:
+  const OfflineRecognizer *recognizer_;
+  OfflineBatchDecoderConfig config_;
+  mutable ThreadPool pool_;
+};
+
+OfflineBatchDecoder::OfflineBatchDecoder(
+    const OfflineRecognizer *recognizer,
+    const OfflineBatchDecoderConfig &config)
+    : impl_(std::make_unique<Impl>(recognizer, config)) {}
+
+OfflineBatchDecoder::~OfflineBatchDecoder() = default;
+
+OfflineBatchDecoderStats OfflineBatchDecoder::Decode(
+    const std::vector<std::string> &filenames,
+    OfflineBatchDecoderCallback callback) const {
+  return impl_->Decode(filenames, std::move(callback));
+}
+
+}  // namespace sherpa_onnx
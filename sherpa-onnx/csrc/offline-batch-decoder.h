@@ -0,0 +1,132 @@
+// sherpa-onnx/csrc/offline-batch-decoder.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_BATCH_DECODER_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_BATCH_DECODER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+struct OfflineBatchDecoderConfig {
+  // Number of threads calling OfflineRecognizer::DecodeStreams()
+  // concurrently. Note that each of them uses model_config.num_threads
+  // intra-op threads.
+  int32_t num_threads = 1;
+
+  // Maximum number of streams decoded in a single batch
+  int32_t batch_size = 1;
+
+  // Maximum total audio duration in seconds of a batch. Batches are cut
+  // earlier if adding another file would exceed it. 0 means no limit.
+  float max_batch_duration = 0;
+
+  // Maximum number of files that are read into memory but not yet decoded.
+  // It bounds the memory usage and is also the window used for grouping
+  // files of similar length into a batch.
+  // If it is <= 0, we use 2 * num_threads * batch_size.
+  int32_t prefetch = 0;
+
+  // Number of threads reading wave files
+  int32_t num_io_threads = 1;
+
+  OfflineBatchDecoderConfig() = default;
+
+  OfflineBatchDecoderConfig(int32_t num_threads, int32_t batch_size,
+                            float max_batch_duration, int32_t prefetch,
+                            int32_t num_io_threads)
+      : num_threads(num_threads),
+        batch_size(batch_size),
+        max_batch_duration(max_batch_duration),
+        prefetch(prefetch),
+        num_io_threads(num_io_threads) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+struct OfflineBatchDecoderResult {
+  // Index into the list of files passed to OfflineBatchDecoder::Decode()
+  int32_t index = 0;
+
+  std::string filename;
+
+  // false if we failed to read the file. In that case, result is empty.
+  bool is_ok = false;
+
+  // Duration of the file in seconds
+  float duration = 0;
+
+  OfflineRecognitionResult result;
+};
+
+struct OfflineBatchDecoderStats {
+  int32_t num_files = 0;
+  int32_t num_failed = 0;
+  int32_t num_batches = 0;
+
+  // Sum of the durations of all successfully read files, in seconds
+  float total_duration = 0;
+
+  // Wall-clock time of OfflineBatchDecoder::Decode(), in seconds
+  float elapsed_seconds = 0;
+
+  float RealTimeFactor() const {
+    return total_duration > 0 ? elapsed_seconds / total_duration : 0;
+  }
+
+  // Number of files decoded per second
+  float Throughput() const {
+    return elapsed_seconds > 0 ? num_files / elapsed_seconds : 0;
+  }
+
+  std::string ToString() const;
+};
+
+// It is invoked in the order of the input files, never concurrently.
+using OfflineBatchDecoderCallback =
+    std::function<void(const OfflineBatchDecoderResult &)>;
+
+/** Decode a list of wave files with a single shared recognizer.
+ *
+ * The files are read by a separate I/O stage ahead of decoding. Files that
+ * are ready are grouped by length into batches, and the batches are decoded
+ * on a work-stealing thread pool. Results are emitted in the input order as
+ * soon as all files before them have finished.
+ */
+class OfflineBatchDecoder {
+ public:
+  // @param recognizer It is not owned by this class and must outlive it.
+  OfflineBatchDecoder(const OfflineRecognizer *recognizer,
+                      const OfflineBatchDecoderConfig &config);
+
+  ~OfflineBatchDecoder();
+
+  /** Decode the given files.
+   *
+   * @param filenames  Path to the wave files.
+   * @param callback  If not empty, it is invoked once for each file in the
+   *                  order of filenames.
+   * @return Return statistics about this run.
+   */
+  OfflineBatchDecoderStats Decode(
+      const std::vector<std::string> &filenames,
+      OfflineBatchDecoderCallback callback = nullptr) const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_BATCH_DECODER_H_
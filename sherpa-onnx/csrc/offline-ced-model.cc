@@ -21,7 +21,7 @@ class OfflineCEDModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto buf = ReadFile(config_.ced);
+    auto buf = MapModelFile(config_.ced, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -49,9 +49,8 @@ class OfflineCEDModel::Impl {
   OrtAllocator *Allocator() { return allocator_; }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
@@ -20,7 +20,7 @@ class OfflineCtTransformerModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto buf = ReadFile(config_.ct_transformer);
+    auto buf = MapModelFile(config_.ct_transformer, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -51,9 +51,8 @@ class OfflineCtTransformerModel::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
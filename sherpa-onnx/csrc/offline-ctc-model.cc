@@ -6,7 +6,6 @@
 
 #include <algorithm>
 #include <memory>
-#include <sstream>
 #include <string>
 
 #if __ANDROID_API__ >= 9
@@ -19,6 +18,7 @@
 #endif
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/mapped-file.h"
 #include "sherpa-onnx/csrc/offline-nemo-enc-dec-ctc-model.h"
 #include "sherpa-onnx/csrc/offline-tdnn-ctc-model.h"
 #include "sherpa-onnx/csrc/offline-telespeech-ctc-model.h"
@@ -43,30 +43,20 @@ enum class ModelType : std::uint8_t {
 
 namespace sherpa_onnx {
 
-static ModelType GetModelType(char *model_data, size_t model_data_length,
+static ModelType GetModelType(const char *model_data, size_t model_data_length,
                               bool debug) {
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
-  Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(1);
-  sess_opts.SetInterOpNumThreads(1);
-
-  auto sess = std::make_unique<Ort::Session>(env, model_data, model_data_length,
-                                             sess_opts);
-
-  Ort::ModelMetadata meta_data = sess->GetModelMetadata();
+  // Read the metadata without creating a session so that external data
+  // is not needed here
+  OnnxModelInfo info = GetOnnxModelInfo(model_data, model_data_length);
   if (debug) {
-    std::ostringstream os;
-    PrintModelMetadata(os, meta_data);
 #if __OHOS__
-    SHERPA_ONNX_LOGE("%{public}s\n", os.str().c_str());
+    SHERPA_ONNX_LOGE("%{public}s\n", info.ToString().c_str());
 #else
-    SHERPA_ONNX_LOGE("%s\n", os.str().c_str());
+    SHERPA_ONNX_LOGE("%s\n", info.ToString().c_str());
 #endif
   }
 
-  Ort::AllocatorWithDefaultOptions allocator;
-  auto model_type =
-      LookupCustomModelMetaData(meta_data, "model_type", allocator);
+  auto model_type = info.LookupMetadata("model_type");
   if (model_type.empty()) {
     SHERPA_ONNX_LOGE(
         "No model_type in the metadata!\n"
@@ -129,7 +119,7 @@ std::unique_ptr<OfflineCtcModel> OfflineCtcModel::Create(
   }
 
   {
-    auto buffer = ReadFile(filename);
+    MappedFile buffer(filename);
 
     model_type = GetModelType(buffer.data(), buffer.size(), config.debug);
   }
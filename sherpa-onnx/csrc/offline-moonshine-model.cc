@@ -32,22 +32,22 @@ class OfflineMoonshineModel::Impl {
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.moonshine.preprocessor);
+      auto buf = MapModelFile(config.moonshine.preprocessor, &sess_opts_);
       InitPreprocessor(buf.data(), buf.size());
     }
 
     {
-      auto buf = ReadFile(config.moonshine.encoder);
+      auto buf = MapModelFile(config.moonshine.encoder, &sess_opts_);
       InitEncoder(buf.data(), buf.size());
     }
 
     {
-      auto buf = ReadFile(config.moonshine.uncached_decoder);
+      auto buf = MapModelFile(config.moonshine.uncached_decoder, &sess_opts_);
       InitUnCachedDecoder(buf.data(), buf.size());
     }
 
     {
-      auto buf = ReadFile(config.moonshine.cached_decoder);
+      auto buf = MapModelFile(config.moonshine.cached_decoder, &sess_opts_);
       InitCachedDecoder(buf.data(), buf.size());
     }
   }
@@ -166,9 +166,9 @@ class OfflineMoonshineModel::Impl {
   OrtAllocator *Allocator() { return allocator_; }
 
  private:
-  void InitPreprocessor(void *model_data, size_t model_data_length) {
-    preprocessor_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitPreprocessor(const void *model_data, size_t model_data_length) {
+    preprocessor_sess_ = CreateSession(env_, model_data, model_data_length,
+                                       sess_opts_);
 
     GetInputNames(preprocessor_sess_.get(), &preprocessor_input_names_,
                   &preprocessor_input_names_ptr_);
@@ -177,9 +177,9 @@ class OfflineMoonshineModel::Impl {
                    &preprocessor_output_names_ptr_);
   }
 
-  void InitEncoder(void *model_data, size_t model_data_length) {
-    encoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitEncoder(const void *model_data, size_t model_data_length) {
+    encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts_);
 
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
@@ -188,9 +188,9 @@ class OfflineMoonshineModel::Impl {
                    &encoder_output_names_ptr_);
   }
 
-  void InitUnCachedDecoder(void *model_data, size_t model_data_length) {
-    uncached_decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitUnCachedDecoder(const void *model_data, size_t model_data_length) {
+    uncached_decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                           sess_opts_);
 
     GetInputNames(uncached_decoder_sess_.get(), &uncached_decoder_input_names_,
                   &uncached_decoder_input_names_ptr_);
@@ -200,9 +200,9 @@ class OfflineMoonshineModel::Impl {
                    &uncached_decoder_output_names_ptr_);
   }
 
-  void InitCachedDecoder(void *model_data, size_t model_data_length) {
-    cached_decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitCachedDecoder(const void *model_data, size_t model_data_length) {
+    cached_decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                         sess_opts_);
 
     GetInputNames(cached_decoder_sess_.get(), &cached_decoder_input_names_,
                   &cached_decoder_input_names_ptr_);
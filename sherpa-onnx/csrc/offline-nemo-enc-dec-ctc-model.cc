@@ -28,7 +28,7 @@ class OfflineNemoEncDecCtcModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto buf = ReadFile(config_.nemo_ctc.model);
+    auto buf = MapModelFile(config_.nemo_ctc.model, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -83,9 +83,8 @@ class OfflineNemoEncDecCtcModel::Impl {
   bool IsGigaAM() const { return is_giga_am_; }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
@@ -6,6 +6,8 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -38,117 +40,229 @@ class OfflinePunctuationCtTransformerImpl : public OfflinePunctuationImpl {
 #endif
 
   std::string AddPunctuation(const std::string &text) const override {
-    if (text.empty()) {
-      return {};
+    return AddPunctuationBatch({text})[0];
+  }
+
+  std::vector<std::string> AddPunctuationBatch(
+      const std::vector<std::string> &texts) const override {
+    int32_t num_texts = static_cast<int32_t>(texts.size());
+
+    std::vector<TextState> states(num_texts);
+    std::vector<TextState *> active;
+    active.reserve(num_texts);
+
+    for (int32_t i = 0; i != num_texts; ++i) {
+      Init(texts[i], &states[i]);
+      if (states[i].num_segments > 0) {
+        active.push_back(&states[i]);
+      }
+    }
+
+    // Segments of a text depend on the result of its previous segment,
+    // so we process the i-th segment of all texts in the i-th round.
+    int32_t batch_size = std::max(config_.model.batch_size, 1);
+
+    while (!active.empty()) {
+      for (auto s : active) {
+        s->this_start = s->i * kSegmentSize;
+        s->this_end = std::min<int32_t>(s->this_start + kSegmentSize,
+                                        s->token_ids.size());
+        if (s->last != -1) {
+          s->this_start = s->last;
+        }
+      }
+
+      // Put segments of similar lengths into the same batch to reduce
+      // padding
+      std::stable_sort(active.begin(), active.end(),
+                       [](const TextState *a, const TextState *b) {
+                         return a->this_end - a->this_start >
+                                b->this_end - b->this_start;
+                       });
+
+      int32_t num_active = static_cast<int32_t>(active.size());
+      for (int32_t b = 0; b < num_active; b += batch_size) {
+        int32_t n = std::min(batch_size, num_active - b);
+        RunBatch(active.data() + b, n);
+      }
+
+      active.erase(std::remove_if(active.begin(), active.end(),
+                                  [](const TextState *s) {
+                                    return s->i == s->num_segments;
+                                  }),
+                   active.end());
     }
 
-    std::vector<std::string> tokens = SplitUtf8(text);
+    std::vector<std::string> ans(num_texts);
+    for (int32_t i = 0; i != num_texts; ++i) {
+      ans[i] = Finalize(texts[i], &states[i]);
+    }
+
+    return ans;
+  }
+
+ private:
+  static constexpr int32_t kSegmentSize = 20;
+  static constexpr int32_t kMaxLen = 200;
+
+  struct TextState {
+    std::vector<std::string> tokens;
     std::vector<int32_t> token_ids;
-    token_ids.reserve(tokens.size());
+    std::vector<int32_t> punctuations;
+
+    int32_t num_segments = 0;
+
+    // index of the segment to be processed
+    int32_t i = 0;
+
+    int32_t last = -1;
+
+    // token_ids[this_start:this_end] is sent to the model
+    int32_t this_start = 0;
+    int32_t this_end = 0;
+  };
+
+  void Init(const std::string &text, TextState *s) const {
+    if (text.empty()) {
+      return;
+    }
+
+    s->tokens = SplitUtf8(text);
+    s->token_ids.reserve(s->tokens.size());
 
     const auto &meta_data = model_.GetModelMetadata();
 
-    for (const auto &t : tokens) {
+    for (const auto &t : s->tokens) {
       std::string token = ToLowerCase(t);
       if (meta_data.token2id.count(token)) {
-        token_ids.push_back(meta_data.token2id.at(token));
+        s->token_ids.push_back(meta_data.token2id.at(token));
       } else {
-        token_ids.push_back(meta_data.unk_id);
+        s->token_ids.push_back(meta_data.unk_id);
       }
     }
 
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    if (s->token_ids.empty()) {
+      return;
+    }
 
-    int32_t segment_size = 20;
-    int32_t max_len = 200;
-    int32_t num_segments =
-        ceil((static_cast<float>(token_ids.size()) + segment_size - 1) /
-             segment_size);
+    s->num_segments =
+        ceil((static_cast<float>(s->token_ids.size()) + kSegmentSize - 1) /
+             kSegmentSize);
+  }
 
-    std::vector<int32_t> punctuations;
-    int32_t last = -1;
-    for (int32_t i = 0; i != num_segments; ++i) {
-      int32_t this_start = i * segment_size;         // included
-      int32_t this_end = this_start + segment_size;  // not included
-      if (this_end > static_cast<int32_t>(token_ids.size())) {
-        this_end = token_ids.size();
-      }
+  // Run the model on the current segments of states[0:n] with a single
+  // call. Shorter segments are padded.
+  void RunBatch(TextState *const *states, int32_t n) const {
+    const auto &meta_data = model_.GetModelMetadata();
 
-      if (last != -1) {
-        this_start = last;
-      }
-      // token_ids[this_start:this_end] is sent to the model
+    std::vector<int32_t> lens(n);
+    int32_t max_len = 0;
+    for (int32_t k = 0; k != n; ++k) {
+      lens[k] = states[k]->this_end - states[k]->this_start;
+      max_len = std::max(max_len, lens[k]);
+    }
+
+    std::vector<int32_t> x_data(n * max_len, 0);
+    for (int32_t k = 0; k != n; ++k) {
+      const auto *s = states[k];
+      std::copy(s->token_ids.begin() + s->this_start,
+                s->token_ids.begin() + s->this_end,
+                x_data.begin() + k * max_len);
+    }
+
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+    std::array<int64_t, 2> x_shape = {n, max_len};
+    Ort::Value x =
+        Ort::Value::CreateTensor(memory_info, x_data.data(), x_data.size(),
+                                 x_shape.data(), x_shape.size());
 
-      std::array<int64_t, 2> x_shape = {1, this_end - this_start};
-      Ort::Value x =
-          Ort::Value::CreateTensor(memory_info, token_ids.data() + this_start,
-                                   x_shape[1], x_shape.data(), x_shape.size());
+    int64_t len_shape = n;
+    Ort::Value x_len =
+        Ort::Value::CreateTensor(memory_info, lens.data(), n, &len_shape, 1);
 
-      int64_t len_shape = 1;
-      int32_t len = x_shape[1];
-      Ort::Value x_len =
-          Ort::Value::CreateTensor(memory_info, &len, 1, &len_shape, 1);
+    Ort::Value out = model_.Forward(std::move(x), std::move(x_len));
 
-      Ort::Value out = model_.Forward(std::move(x), std::move(x_len));
+    // [N, T, num_punctuations]
+    std::vector<int64_t> out_shape = out.GetTensorTypeAndShapeInfo().GetShape();
 
-      // [N, T, num_punctuations]
-      std::vector<int64_t> out_shape =
-          out.GetTensorTypeAndShapeInfo().GetShape();
+    assert(out_shape[0] == n);
+    assert(out_shape[1] == max_len);
+    assert(out_shape[2] == meta_data.num_punctuations);
 
-      assert(out_shape[0] == 1);
-      assert(out_shape[1] == len);
-      assert(out_shape[2] == meta_data.num_punctuations);
+    const float *out_data = out.GetTensorData<float>();
 
+    for (int32_t k = 0; k != n; ++k) {
       std::vector<int32_t> this_punctuations;
-      this_punctuations.reserve(len);
+      this_punctuations.reserve(lens[k]);
 
-      const float *p = out.GetTensorData<float>();
-      for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations) {
+      const float *p = out_data + k * out_shape[1] * out_shape[2];
+      for (int32_t t = 0; t != lens[k]; ++t, p += meta_data.num_punctuations) {
         auto index = static_cast<int32_t>(std::distance(
             p, std::max_element(p, p + meta_data.num_punctuations)));
         this_punctuations.push_back(index);
-      }  // for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations)
+      }
 
-      int32_t dot_index = -1;
-      int32_t comma_index = -1;
+      ProcessSegment(std::move(this_punctuations), states[k]);
+    }
+  }
 
-      for (int32_t m = static_cast<int32_t>(this_punctuations.size()) - 2;
-           m >= 1; --m) {
-        int32_t punct_id = this_punctuations[m];
+  void ProcessSegment(std::vector<int32_t> this_punctuations,
+                      TextState *s) const {
+    const auto &meta_data = model_.GetModelMetadata();
+    int32_t len = s->this_end - s->this_start;
 
-        if (punct_id == meta_data.dot_id || punct_id == meta_data.quest_id) {
-          dot_index = m;
-          break;
-        }
+    int32_t dot_index = -1;
+    int32_t comma_index = -1;
 
-        if (comma_index == -1 && punct_id == meta_data.comma_id) {
-          comma_index = m;
-        }
-      }  // for (int32_t k = this_punctuations.size() - 1; k >= 1; --k)
+    for (int32_t m = static_cast<int32_t>(this_punctuations.size()) - 2;
+         m >= 1; --m) {
+      int32_t punct_id = this_punctuations[m];
 
-      if (dot_index == -1 && len >= max_len && comma_index != -1) {
-        dot_index = comma_index;
-        this_punctuations[dot_index] = meta_data.dot_id;
+      if (punct_id == meta_data.dot_id || punct_id == meta_data.quest_id) {
+        dot_index = m;
+        break;
       }
 
-      if (dot_index == -1) {
-        if (last == -1) {
-          last = this_start;
-        }
+      if (comma_index == -1 && punct_id == meta_data.comma_id) {
+        comma_index = m;
+      }
+    }  // for (int32_t k = this_punctuations.size() - 1; k >= 1; --k)
 
-        if (i == num_segments - 1) {
-          dot_index = static_cast<int32_t>(this_punctuations.size()) - 1;
-        }
-      } else {
-        last = this_start + dot_index + 1;
+    if (dot_index == -1 && len >= kMaxLen && comma_index != -1) {
+      dot_index = comma_index;
+      this_punctuations[dot_index] = meta_data.dot_id;
+    }
+
+    if (dot_index == -1) {
+      if (s->last == -1) {
+        s->last = s->this_start;
       }
 
-      if (dot_index != -1) {
-        punctuations.insert(punctuations.end(), this_punctuations.begin(),
-                            this_punctuations.begin() + (dot_index + 1));
+      if (s->i == s->num_segments - 1) {
+        dot_index = static_cast<int32_t>(this_punctuations.size()) - 1;
       }
-    }  // for (int32_t i = 0; i != num_segments; ++i)
+    } else {
+      s->last = s->this_start + dot_index + 1;
+    }
+
+    if (dot_index != -1) {
+      s->punctuations.insert(s->punctuations.end(), this_punctuations.begin(),
+                             this_punctuations.begin() + (dot_index + 1));
+    }
+
+    s->i += 1;
+  }
+
+  std::string Finalize(const std::string &text, TextState *s) const {
+    if (text.empty()) {
+      return {};
+    }
+
+    const auto &meta_data = model_.GetModelMetadata();
+    const auto &punctuations = s->punctuations;
+    auto &tokens = s->tokens;
 
     if (punctuations.empty()) {
       return text + meta_data.id2punct[meta_data.dot_id];
@@ -29,6 +29,16 @@ class OfflinePunctuationImpl {
 #endif
 
   virtual std::string AddPunctuation(const std::string &text) const = 0;
+
+  virtual std::vector<std::string> AddPunctuationBatch(
+      const std::vector<std::string> &texts) const {
+    std::vector<std::string> ans;
+    ans.reserve(texts.size());
+    for (const auto &text : texts) {
+      ans.push_back(AddPunctuation(text));
+    }
+    return ans;
+  }
 };
 
 }  // namespace sherpa_onnx
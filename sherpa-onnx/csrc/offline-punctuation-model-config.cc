@@ -21,6 +21,11 @@ void OfflinePunctuationModelConfig::Register(ParseOptions *po) {
 
   po->Register("provider", &provider,
                "Specify a provider to use: cpu, cuda, coreml");
+
+  po->Register("batch-size", &batch_size,
+               "Number of segments processed by the model in a single call "
+               "when punctuating many texts at once. Use 1 if your model "
+               "does not support batches.");
 }
 
 bool OfflinePunctuationModelConfig::Validate() const {
@@ -35,6 +40,11 @@ bool OfflinePunctuationModelConfig::Validate() const {
     return false;
   }
 
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("batch_size should be > 0. Given %d", batch_size);
+    return false;
+  }
+
   return true;
 }
 
@@ -45,7 +55,8 @@ std::string OfflinePunctuationModelConfig::ToString() const {
   os << "ct_transformer=\"" << ct_transformer << "\", ";
   os << "num_threads=" << num_threads << ", ";
   os << "debug=" << (debug ? "True" : "False") << ", ";
-  os << "provider=\"" << provider << "\")";
+  os << "provider=\"" << provider << "\", ";
+  os << "batch_size=" << batch_size << ")";
 
   return os.str();
 }
@@ -17,6 +17,10 @@ struct OfflinePunctuationModelConfig {
   bool debug = false;
   std::string provider = "cpu";
 
+  // Number of segments processed by the model in a single call when
+  // punctuating many texts at once
+  int32_t batch_size = 32;
+
   OfflinePunctuationModelConfig() = default;
 
   OfflinePunctuationModelConfig(const std::string &ct_transformer,
@@ -50,4 +50,9 @@ std::string OfflinePunctuation::AddPunctuation(const std::string &text) const {
   return impl_->AddPunctuation(text);
 }
 
+std::vector<std::string> OfflinePunctuation::AddPunctuationBatch(
+    const std::vector<std::string> &texts) const {
+  return impl_->AddPunctuationBatch(texts);
+}
+
 }  // namespace sherpa_onnx
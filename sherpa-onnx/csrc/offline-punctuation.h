@@ -48,6 +48,12 @@ class OfflinePunctuation {
   // Add punctuation to the input text and return it.
   std::string AddPunctuation(const std::string &text) const;
 
+  // Like AddPunctuation() but for many texts at once. Segments of all
+  // texts are packed into padded batches of --batch-size so that the
+  // model is run fewer times. ans[i] is the result of texts[i].
+  std::vector<std::string> AddPunctuationBatch(
+      const std::vector<std::string> &texts) const;
+
  private:
   std::unique_ptr<OfflinePunctuationImpl> impl_;
 };
@@ -4,6 +4,8 @@
 
 #include "sherpa-onnx/csrc/offline-recognizer-impl.h"
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <strstream>
 #include <utility>
@@ -23,6 +25,8 @@
 #include "kaldifst/csrc/kaldi-fst-io.h"
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/mapped-file.h"
+#include "sherpa-onnx/csrc/model-cache.h"
 #include "sherpa-onnx/csrc/offline-recognizer-ctc-impl.h"
 #include "sherpa-onnx/csrc/offline-recognizer-moonshine-impl.h"
 #include "sherpa-onnx/csrc/offline-recognizer-paraformer-impl.h"
@@ -31,12 +35,23 @@
 #include "sherpa-onnx/csrc/offline-recognizer-transducer-nemo-impl.h"
 #include "sherpa-onnx/csrc/offline-recognizer-whisper-impl.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/shared-runtime.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
 std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     const OfflineRecognizerConfig &config) {
+  if (config.shared_runtime.enabled) {
+    // Before any Ort::Env is created below
+    SharedRuntime::Init(config.shared_runtime);
+  }
+
+  if (config.model_cache.enabled) {
+    SetModelCacheConfig(config.model_cache);
+  }
+
   if (!config.model_config.sense_voice.model.empty()) {
     return std::make_unique<OfflineRecognizerSenseVoiceImpl>(config);
   }
@@ -88,12 +103,6 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     }
   }
 
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
-
-  Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(1);
-  sess_opts.SetInterOpNumThreads(1);
-
   std::string model_filename;
   if (!config.model_config.transducer.encoder_filename.empty()) {
     model_filename = config.model_config.transducer.encoder_filename;
@@ -116,17 +125,12 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     exit(-1);
   }
 
-  auto buf = ReadFile(model_filename);
-
-  auto encoder_sess =
-      std::make_unique<Ort::Session>(env, buf.data(), buf.size(), sess_opts);
-
-  Ort::ModelMetadata meta_data = encoder_sess->GetModelMetadata();
-
-  Ort::AllocatorWithDefaultOptions allocator;  // used in the macro below
+  MappedFile buf(model_filename);
 
+  // Read the metadata without creating a session so that external data
+  // is not needed here
   auto model_type =
-      LookupCustomModelMetaData(meta_data, "model_type", allocator);
+      GetOnnxModelInfo(buf.data(), buf.size()).LookupMetadata("model_type");
   if (model_type.empty()) {
     SHERPA_ONNX_LOGE(
         "No model_type in the metadata!\n\n"
@@ -218,6 +222,15 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
 template <typename Manager>
 std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     Manager *mgr, const OfflineRecognizerConfig &config) {
+  if (config.shared_runtime.enabled) {
+    // Before any Ort::Env is created below
+    SharedRuntime::Init(config.shared_runtime);
+  }
+
+  if (config.model_cache.enabled) {
+    SetModelCacheConfig(config.model_cache);
+  }
+
   if (!config.model_config.sense_voice.model.empty()) {
     return std::make_unique<OfflineRecognizerSenseVoiceImpl>(mgr, config);
   }
@@ -267,12 +280,6 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     }
   }
 
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
-
-  Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(1);
-  sess_opts.SetInterOpNumThreads(1);
-
   std::string model_filename;
   if (!config.model_config.transducer.encoder_filename.empty()) {
     model_filename = config.model_config.transducer.encoder_filename;
@@ -297,15 +304,10 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
 
   auto buf = ReadFile(mgr, model_filename);
 
-  auto encoder_sess =
-      std::make_unique<Ort::Session>(env, buf.data(), buf.size(), sess_opts);
-
-  Ort::ModelMetadata meta_data = encoder_sess->GetModelMetadata();
-
-  Ort::AllocatorWithDefaultOptions allocator;  // used in the macro below
-
+  // Read the metadata without creating a session so that external data
+  // is not needed here
   auto model_type =
-      LookupCustomModelMetaData(meta_data, "model_type", allocator);
+      GetOnnxModelInfo(buf.data(), buf.size()).LookupMetadata("model_type");
   if (model_type.empty()) {
     SHERPA_ONNX_LOGE(
         "No model_type in the metadata!\n\n"
@@ -397,46 +399,61 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
 OfflineRecognizerImpl::OfflineRecognizerImpl(
     const OfflineRecognizerConfig &config)
     : config_(config) {
+  std::vector<std::string> fsts;
   if (!config.rule_fsts.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
-    itn_list_.reserve(files.size());
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-      }
-      itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
-    }
+    SplitStringToVector(config.rule_fsts, ",", false, &fsts);
   }
 
+  std::vector<std::string> fars;
   if (!config.rule_fars.empty()) {
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("Loading FST archives");
-    }
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
+    SplitStringToVector(config.rule_fars, ",", false, &fars);
+  }
 
-    itn_list_.reserve(files.size() + itn_list_.size());
+  // The files are loaded concurrently. loaded[i] contains the rules of the
+  // i-th file, so the rules are applied in the given order.
+  std::vector<std::vector<std::unique_ptr<kaldifst::TextNormalizer>>> loaded(
+      fsts.size() + fars.size());
 
-    for (const auto &f : files) {
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(loaded.size());
+
+  for (size_t i = 0; i != fsts.size(); ++i) {
+    tasks.push_back([&config, &fsts, &loaded, i]() {
       if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
+        SHERPA_ONNX_LOGE("rule fst: %s", fsts[i].c_str());
+      }
+      loaded[i].push_back(std::make_unique<kaldifst::TextNormalizer>(fsts[i]));
+    });
+  }
+
+  for (size_t i = 0; i != fars.size(); ++i) {
+    tasks.push_back([&config, &fars, &loaded, i, offset = fsts.size()]() {
+      if (config.model_config.debug) {
+        SHERPA_ONNX_LOGE("rule far: %s", fars[i].c_str());
       }
       std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-          fst::FarReader<fst::StdArc>::Open(f));
+          fst::FarReader<fst::StdArc>::Open(fars[i]));
       for (; !reader->Done(); reader->Next()) {
         std::unique_ptr<fst::StdConstFst> r(
             fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
 
-        itn_list_.push_back(
+        loaded[offset + i].push_back(
             std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
       }
-    }
+    });
+  }
+
+  RunConcurrently(tasks);
 
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("FST archives loaded!");
+  for (auto &rules : loaded) {
+    for (auto &r : rules) {
+      itn_list_.push_back(std::move(r));
     }
   }
+
+  if (!fars.empty() && config.model_config.debug) {
+    SHERPA_ONNX_LOGE("FST archives loaded!");
+  }
 }
 
 template <typename Manager>
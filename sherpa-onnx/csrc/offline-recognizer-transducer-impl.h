@@ -5,10 +5,11 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <ios>
 #include <memory>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <utility>
@@ -25,6 +26,7 @@
 #include "sherpa-onnx/csrc/offline-transducer-modified-beam-search-decoder.h"
 #include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/utils.h"
 #include "ssentencepiece/csrc/ssentencepiece.h"
 
@@ -73,10 +75,34 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
  public:
   explicit OfflineRecognizerTransducerImpl(
       const OfflineRecognizerConfig &config)
-      : OfflineRecognizerImpl(config),
-        config_(config),
-        symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineTransducerModel>(config_.model_config)) {
+      : OfflineRecognizerImpl(config), config_(config) {
+    bool is_modified_beam_search =
+        config_.decoding_method == "modified_beam_search";
+
+    // The model, the tokens, the BPE vocabulary and the LM are independent,
+    // so they are loaded concurrently. Hotwords need the tokens and the BPE
+    // vocabulary and are loaded afterwards.
+    std::vector<std::function<void()>> tasks;
+    tasks.push_back([this]() {
+      model_ = std::make_unique<OfflineTransducerModel>(config_.model_config);
+    });
+
+    tasks.push_back(
+        [this]() { symbol_table_ = SymbolTable(config_.model_config.tokens); });
+
+    if (is_modified_beam_search && !config_.lm_config.model.empty()) {
+      tasks.push_back([this]() { lm_ = OfflineLM::Create(config_.lm_config); });
+    }
+
+    if (is_modified_beam_search && !config_.model_config.bpe_vocab.empty()) {
+      tasks.push_back([this]() {
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
+            config_.model_config.bpe_vocab);
+      });
+    }
+
+    RunConcurrently(tasks);
+
     if (symbol_table_.Contains("<unk>")) {
       unk_id_ = symbol_table_["<unk>"];
     }
@@ -84,16 +110,7 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
     if (config_.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OfflineTransducerGreedySearchDecoder>(
           model_.get(), unk_id_, config_.blank_penalty);
-    } else if (config_.decoding_method == "modified_beam_search") {
-      if (!config_.lm_config.model.empty()) {
-        lm_ = OfflineLM::Create(config.lm_config);
-      }
-
-      if (!config_.model_config.bpe_vocab.empty()) {
-        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
-            config_.model_config.bpe_vocab);
-      }
-
+    } else if (is_modified_beam_search) {
       if (!config_.hotwords_file.empty()) {
         InitHotwords();
       }
@@ -150,7 +167,8 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
   std::unique_ptr<OfflineStream> CreateStream(
       const std::string &hotwords) const override {
-    auto hws = std::regex_replace(hotwords, std::regex("/"), "\n");
+    std::string hws = hotwords;
+    std::replace(hws.begin(), hws.end(), '/', '\n');
     std::istringstream is(hws);
     std::vector<std::vector<int32_t>> current;
     std::vector<float> current_scores;
@@ -28,6 +28,8 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
   model_config.Register(po);
   lm_config.Register(po);
   ctc_fst_decoder_config.Register(po);
+  shared_runtime.Register(po);
+  model_cache.Register(po);
 
   po->Register(
       "decoding-method", &decoding_method,
@@ -67,6 +69,10 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
 }
 
 bool OfflineRecognizerConfig::Validate() const {
+  if (!shared_runtime.Validate()) {
+    return false;
+  }
+
   if (decoding_method == "modified_beam_search" && !lm_config.model.empty()) {
     if (max_active_paths <= 0) {
       SHERPA_ONNX_LOGE("max_active_paths is less than 0! Given: %d",
@@ -137,7 +143,9 @@ std::string OfflineRecognizerConfig::ToString() const {
   os << "hotwords_score=" << hotwords_score << ", ";
   os << "blank_penalty=" << blank_penalty << ", ";
   os << "rule_fsts=\"" << rule_fsts << "\", ";
-  os << "rule_fars=\"" << rule_fars << "\")";
+  os << "rule_fars=\"" << rule_fars << "\", ";
+  os << "shared_runtime=" << shared_runtime.ToString() << ", ";
+  os << "model_cache=" << model_cache.ToString() << ")";
 
   return os.str();
 }
@@ -10,12 +10,14 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/features.h"
+#include "sherpa-onnx/csrc/model-cache.h"
 #include "sherpa-onnx/csrc/offline-ctc-fst-decoder-config.h"
 #include "sherpa-onnx/csrc/offline-lm-config.h"
 #include "sherpa-onnx/csrc/offline-model-config.h"
 #include "sherpa-onnx/csrc/offline-stream.h"
 #include "sherpa-onnx/csrc/offline-transducer-model-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/shared-runtime-config.h"
 
 namespace sherpa_onnx {
 
@@ -41,6 +43,14 @@ struct OfflineRecognizerConfig {
   // If there are multiple FST archives, they are applied from left to right.
   std::string rule_fars;
 
+  // If enabled, all models of the process run on shared onnxruntime
+  // thread pools. See shared-runtime.h
+  SharedRuntimeConfig shared_runtime;
+
+  // If enabled, optimized models are saved and reused by later runs.
+  // See model-cache.h
+  ModelCacheConfig model_cache;
+
   // only greedy_search is implemented
   // TODO(fangjun): Implement modified_beam_search
 
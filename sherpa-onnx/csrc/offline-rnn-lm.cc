@@ -32,7 +32,7 @@ class OfflineRnnLM::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_{GetSessionOptions(config)},
         allocator_{} {
-    auto buf = ReadFile(config_.model);
+    auto buf = MapModelFile(config_.model, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -57,9 +57,8 @@ class OfflineRnnLM::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
@@ -32,6 +32,9 @@ class OfflineSpeakerDiarizationImpl {
       const float *audio, int32_t n,
       OfflineSpeakerDiarizationProgressCallback callback = nullptr,
       void *callback_arg = nullptr) const = 0;
+
+  virtual std::unique_ptr<OfflineSpeakerDiarizationStream> CreateStream()
+      const = 0;
 };
 
 }  // namespace sherpa_onnx
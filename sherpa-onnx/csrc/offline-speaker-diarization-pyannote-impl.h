@@ -5,8 +5,12 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_SPEAKER_DIARIZATION_PYANNOTE_IMPL_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -17,6 +21,7 @@
 #include "sherpa-onnx/csrc/offline-speaker-diarization-impl.h"
 #include "sherpa-onnx/csrc/offline-speaker-segmentation-pyannote-model.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
@@ -91,6 +96,9 @@ class OfflineSpeakerDiarizationPyannoteImpl
     config_.clustering = config.clustering;
   }
 
+  std::unique_ptr<OfflineSpeakerDiarizationStream> CreateStream()
+      const override;
+
   OfflineSpeakerDiarizationResult Process(
       const float *audio, int32_t n,
       OfflineSpeakerDiarizationProgressCallback callback = nullptr,
@@ -180,7 +188,16 @@ class OfflineSpeakerDiarizationPyannoteImpl
   }
 
  private:
-  void Init() { InitPowersetMapping(); }
+  friend class OfflineSpeakerDiarizationPyannoteStream;
+
+  void Init() {
+    InitPowersetMapping();
+
+    if (config_.segmentation.num_parallel_batches > 1) {
+      pool_ = std::make_unique<ThreadPool>(
+          config_.segmentation.num_parallel_batches);
+    }
+  }
 
   // see also
   // https://github.com/pyannote/pyannote-audio/blob/develop/pyannote/audio/utils/powerset.py#L68
@@ -248,7 +265,9 @@ class OfflineSpeakerDiarizationPyannoteImpl
 
       std::copy(audio, audio + n, buf.data());
 
-      Matrix2D m = ProcessChunk(buf.data());
+      const float *p = buf.data();
+      Matrix2D m;
+      ProcessChunks(&p, 1, &m);
 
       ans.push_back(std::move(m));
 
@@ -258,47 +277,158 @@ class OfflineSpeakerDiarizationPyannoteImpl
     int32_t num_chunks = (n - window_size) / window_shift + 1;
     bool has_last_chunk = ((n - window_size) % window_shift) > 0;
 
-    ans.reserve(num_chunks + has_last_chunk);
-
-    const float *p = audio;
+    int32_t total_chunks = num_chunks + has_last_chunk;
 
-    for (int32_t i = 0; i != num_chunks; ++i, p += window_shift) {
-      Matrix2D m = ProcessChunk(p);
-
-      ans.push_back(std::move(m));
+    std::vector<const float *> chunks(total_chunks);
+    for (int32_t i = 0; i != num_chunks; ++i) {
+      chunks[i] = audio + i * window_shift;
     }
 
+    std::vector<float> last_chunk;
     if (has_last_chunk) {
-      std::vector<float> buf(window_size);
-      std::copy(p, audio + n, buf.data());
+      // NOTE: last_chunk is zero padded
+      last_chunk.resize(window_size);
+      std::copy(audio + num_chunks * window_shift, audio + n,
+                last_chunk.data());
+      chunks[num_chunks] = last_chunk.data();
+    }
 
-      Matrix2D m = ProcessChunk(buf.data());
+    ans.resize(total_chunks);
 
-      ans.push_back(std::move(m));
-    }
+    int32_t batch_size = config_.segmentation.batch_size;
+    int32_t num_batches = (total_chunks + batch_size - 1) / batch_size;
+
+    auto run_batch = [&](int32_t b) {
+      int32_t start = b * batch_size;
+      int32_t k = std::min(batch_size, total_chunks - start);
+      ProcessChunks(chunks.data() + start, k, ans.data() + start);
+    };
+
+    ParallelFor(num_batches, run_batch);
 
     return ans;
   }
 
-  Matrix2D ProcessChunk(const float *p) const {
+  // Invoke f(i) for 0 <= i < n. It uses pool_ if it is not null.
+  //
+  // It returns after all calls have finished. Errors are reported on the
+  // calling thread, i.e., an exception is rethrown and SHERPA_ONNX_EXIT()
+  // exits only then. See RunConcurrently().
+  template <typename F>
+  void ParallelFor(int32_t n, F &&f) const {
+    if (!pool_ || n == 1) {
+      for (int32_t i = 0; i != n; ++i) {
+        f(i);
+      }
+      return;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(n);
+    for (int32_t i = 0; i != n; ++i) {
+      tasks.push_back([&f, i]() { f(i); });
+    }
+
+    RunConcurrently(pool_.get(), tasks);
+  }
+
+  /* Run the segmentation model on k windows with a single call.
+   *
+   * @param chunks chunks[i] points to window_size samples of the i-th window.
+   *               The windows may overlap.
+   * @param k Number of windows.
+   * @param out It contains k entries on return. out[i] is of shape
+   *            (num_frames, num_powerset_classes).
+   */
+  void ProcessChunks(const float *const *chunks, int32_t k,
+                     Matrix2D *out) const {
+    if (k > 1 && !batch_supported_) {
+      for (int32_t i = 0; i != k; ++i) {
+        ProcessChunks(chunks + i, 1, out + i);
+      }
+      return;
+    }
+
     const auto &meta_data = segmentation_model_.GetModelMetaData();
     int32_t window_size = meta_data.window_size;
 
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    std::array<int64_t, 3> shape = {1, 1, window_size};
+    std::array<int64_t, 3> shape = {k, 1, window_size};
+
+    // Neighboring windows overlap, so they are copied into a contiguous
+    // buffer unless there is only one of them
+    std::vector<float> buf;
+    float *p = const_cast<float *>(chunks[0]);
+    if (k > 1) {
+      buf.resize(static_cast<size_t>(k) * window_size);
+      for (int32_t i = 0; i != k; ++i) {
+        std::copy(chunks[i], chunks[i] + window_size,
+                  buf.data() + static_cast<size_t>(i) * window_size);
+      }
+      p = buf.data();
+    }
+
+    Ort::Value x = Ort::Value::CreateTensor(
+        memory_info, p, static_cast<size_t>(k) * window_size, shape.data(),
+        shape.size());
+
+    Ort::Value y{nullptr};
+    try {
+      y = segmentation_model_.Forward(std::move(x));
+    } catch (const Ort::Exception &e) {
+      if (k == 1) {
+        throw;
+      }
+
+      // Models exported with a fixed batch size of 1 reject the input
+      DisableBatch(k, e.what());
+      ProcessChunks(chunks, k, out);
+      return;
+    }
+
+    std::vector<int64_t> y_shape = y.GetTensorTypeAndShapeInfo().GetShape();
+    if (y_shape.size() != 3) {
+      SHERPA_ONNX_LOGE(
+          "The segmentation model output should be 3-d. Given: %d-d",
+          static_cast<int32_t>(y_shape.size()));
+      SHERPA_ONNX_EXIT(-1);
+    }
+
+    if (y_shape[0] != k) {
+      if (k > 1) {
+        DisableBatch(k, "unexpected output batch size");
+        ProcessChunks(chunks, k, out);
+        return;
+      }
+
+      SHERPA_ONNX_LOGE(
+          "The segmentation model returns %d windows for a single window",
+          static_cast<int32_t>(y_shape[0]));
+      SHERPA_ONNX_EXIT(-1);
+    }
 
-    Ort::Value x =
-        Ort::Value::CreateTensor(memory_info, const_cast<float *>(p),
-                                 window_size, shape.data(), shape.size());
+    const float *py = y.GetTensorData<float>();
 
-    Ort::Value out = segmentation_model_.Forward(std::move(x));
-    std::vector<int64_t> out_shape = out.GetTensorTypeAndShapeInfo().GetShape();
-    Matrix2D m(out_shape[1], out_shape[2]);
-    std::copy(out.GetTensorData<float>(), out.GetTensorData<float>() + m.size(),
-              &m(0, 0));
-    return m;
+    for (int32_t i = 0; i != k; ++i) {
+      Matrix2D m(y_shape[1], y_shape[2]);
+      std::copy(py, py + m.size(), &m(0, 0));
+      py += m.size();
+
+      out[i] = std::move(m);
+    }
+  }
+
+  // Process windows one by one from now on
+  void DisableBatch(int32_t k, const char *reason) const {
+    if (batch_supported_.exchange(false)) {
+      SHERPA_ONNX_LOGE(
+          "The segmentation model does not support a batch of %d windows "
+          "(%s). Please use --segmentation.batch-size=1. Falling back to "
+          "batch size 1.",
+          k, reason);
+    }
   }
 
   Matrix2DInt32 ToMultiLabel(const Matrix2D &m) const {
@@ -355,100 +485,104 @@ class OfflineSpeakerDiarizationPyannoteImpl
   // ans.first[i] corresponds to ans.second[i]
   std::pair<std::vector<Int32Pair>, std::vector<std::vector<Int32Pair>>>
   GetChunkSpeakerSampleIndexes(const std::vector<Matrix2DInt32> &labels) const {
-    auto new_labels = ExcludeOverlap(labels);
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t window_shift = meta_data.window_shift;
 
     std::vector<Int32Pair> chunk_speaker_list;
     std::vector<std::vector<Int32Pair>> samples_index_list;
 
-    const auto &meta_data = segmentation_model_.GetModelMetaData();
-    int32_t window_size = meta_data.window_size;
-    int32_t window_shift = meta_data.window_shift;
-    int32_t receptive_field_shift = meta_data.receptive_field_shift;
-    int32_t num_speakers = meta_data.num_speakers;
-
     int32_t chunk_index = 0;
-    for (const auto &label : new_labels) {
-      Matrix2DInt32 tmp = label.transpose();
-      // tmp: (num_speakers, num_frames)
-      int32_t num_frames = tmp.cols();
+    for (const auto &label : labels) {
+      GetSpeakerSampleIndexes(ExcludeOverlap(label), chunk_index,
+                              chunk_index * window_shift, &chunk_speaker_list,
+                              &samples_index_list);
+      chunk_index += 1;
+    }
 
-      int32_t sample_offset = chunk_index * window_shift;
+    return {chunk_speaker_list, samples_index_list};
+  }
 
-      for (int32_t speaker_index = 0; speaker_index != num_speakers;
-           ++speaker_index) {
-        auto d = tmp.row(speaker_index);
-        if (d.sum() < 10) {
-          // skip segments less than 10 frames
-          continue;
-        }
+  /* Append the (chunk_index, speaker) pairs of a chunk and their sample
+   * segments.
+   *
+   * @param label A 0-1 matrix of shape (num_frames, num_speakers) without
+   *              overlapping frames. See ExcludeOverlap().
+   * @param chunk_index Index of the chunk.
+   * @param sample_offset Index of the first sample of the chunk.
+   */
+  void GetSpeakerSampleIndexes(
+      const Matrix2DInt32 &label, int32_t chunk_index, int32_t sample_offset,
+      std::vector<Int32Pair> *chunk_speaker_list,
+      std::vector<std::vector<Int32Pair>> *samples_index_list) const {
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t window_size = meta_data.window_size;
+    int32_t num_speakers = meta_data.num_speakers;
 
-        Int32Pair this_chunk_speaker = {chunk_index, speaker_index};
-        std::vector<Int32Pair> this_speaker_samples;
+    Matrix2DInt32 tmp = label.transpose();
+    // tmp: (num_speakers, num_frames)
+    int32_t num_frames = tmp.cols();
 
-        bool is_active = false;
-        int32_t start_index;
+    for (int32_t speaker_index = 0; speaker_index != num_speakers;
+         ++speaker_index) {
+      auto d = tmp.row(speaker_index);
+      if (d.sum() < 10) {
+        // skip segments less than 10 frames
+        continue;
+      }
 
-        for (int32_t k = 0; k != num_frames; ++k) {
-          if (d[k] != 0) {
-            if (!is_active) {
-              is_active = true;
-              start_index = k;
-            }
-          } else if (is_active) {
-            is_active = false;
+      Int32Pair this_chunk_speaker = {chunk_index, speaker_index};
+      std::vector<Int32Pair> this_speaker_samples;
 
-            int32_t start_samples =
-                static_cast<float>(start_index) / num_frames * window_size +
-                sample_offset;
-            int32_t end_samples =
-                static_cast<float>(k) / num_frames * window_size +
-                sample_offset;
+      bool is_active = false;
+      int32_t start_index;
 
-            this_speaker_samples.emplace_back(start_samples, end_samples);
+      for (int32_t k = 0; k != num_frames; ++k) {
+        if (d[k] != 0) {
+          if (!is_active) {
+            is_active = true;
+            start_index = k;
           }
-        }
+        } else if (is_active) {
+          is_active = false;
 
-        if (is_active) {
           int32_t start_samples =
               static_cast<float>(start_index) / num_frames * window_size +
               sample_offset;
           int32_t end_samples =
-              static_cast<float>(num_frames - 1) / num_frames * window_size +
-              sample_offset;
+              static_cast<float>(k) / num_frames * window_size + sample_offset;
+
           this_speaker_samples.emplace_back(start_samples, end_samples);
         }
+      }
 
-        chunk_speaker_list.push_back(std::move(this_chunk_speaker));
-        samples_index_list.push_back(std::move(this_speaker_samples));
-      }  // for (int32_t speaker_index = 0;
-      chunk_index += 1;
-    }  // for (const auto &label : new_labels)
+      if (is_active) {
+        int32_t start_samples =
+            static_cast<float>(start_index) / num_frames * window_size +
+            sample_offset;
+        int32_t end_samples =
+            static_cast<float>(num_frames - 1) / num_frames * window_size +
+            sample_offset;
+        this_speaker_samples.emplace_back(start_samples, end_samples);
+      }
 
-    return {chunk_speaker_list, samples_index_list};
+      chunk_speaker_list->push_back(std::move(this_chunk_speaker));
+      samples_index_list->push_back(std::move(this_speaker_samples));
+    }  // for (int32_t speaker_index = 0;
   }
 
   // If there are multiple speakers at a frame, then this frame is excluded.
-  std::vector<Matrix2DInt32> ExcludeOverlap(
-      const std::vector<Matrix2DInt32> &labels) const {
-    int32_t num_chunks = labels.size();
-    std::vector<Matrix2DInt32> ans;
-    ans.reserve(num_chunks);
-
-    for (const auto &label : labels) {
-      Matrix2DInt32 new_label(label.rows(), label.cols());
-      new_label.setZero();
-      Int32RowVector v = label.rowwise().sum();
-
-      for (int32_t i = 0; i != v.cols(); ++i) {
-        if (v[i] < 2) {
-          new_label.row(i) = label.row(i);
-        }
+  Matrix2DInt32 ExcludeOverlap(const Matrix2DInt32 &label) const {
+    Matrix2DInt32 new_label(label.rows(), label.cols());
+    new_label.setZero();
+    Int32RowVector v = label.rowwise().sum();
+
+    for (int32_t i = 0; i != v.cols(); ++i) {
+      if (v[i] < 2) {
+        new_label.row(i) = label.row(i);
       }
-
-      ans.push_back(std::move(new_label));
     }
 
-    return ans;
+    return new_label;
   }
 
   /**
@@ -466,48 +600,92 @@ class OfflineSpeakerDiarizationPyannoteImpl
       void *callback_arg) const {
     const auto &meta_data = segmentation_model_.GetModelMetaData();
     int32_t sample_rate = meta_data.sample_rate;
-    Matrix2D ans(sample_indexes.size(), embedding_extractor_.Dim());
-
-    auto IsNaNWrapper = [](float f) -> bool { return std::isnan(f); };
+    int32_t num_embeddings = static_cast<int32_t>(sample_indexes.size());
 
-    int32_t k = 0;
-    int32_t cur_row_index = 0;
-    for (const auto &v : sample_indexes) {
-      auto stream = embedding_extractor_.CreateStream();
-      for (const auto &p : v) {
+    // Process embeddings of similar lengths in a batch to reduce padding.
+    std::vector<int32_t> num_samples(num_embeddings);
+    for (int32_t i = 0; i != num_embeddings; ++i) {
+      for (const auto &p : sample_indexes[i]) {
         int32_t end = (p.second <= n) ? p.second : n;
-        int32_t num_samples = end - p.first;
+        num_samples[i] += std::max(0, end - p.first);
+      }
+    }
 
-        if (num_samples > 0) {
-          stream->AcceptWaveform(sample_rate, audio + p.first, num_samples);
+    std::vector<int32_t> order(num_embeddings);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&num_samples](int32_t a, int32_t b) {
+                       return num_samples[a] < num_samples[b];
+                     });
+
+    std::vector<std::vector<float>> embeddings(num_embeddings);
+
+    // Streams are created one batch at a time since the features of all
+    // of them may take a lot of memory for long audio
+    int32_t batch_size = config_.embedding.batch_size;
+    std::vector<std::unique_ptr<OnlineStream>> streams;
+    std::vector<OnlineStream *> ss;
+    for (int32_t start = 0; start < num_embeddings; start += batch_size) {
+      int32_t k = std::min(batch_size, num_embeddings - start);
+
+      streams.resize(k);
+      ParallelFor(k, [&](int32_t i) {
+        const auto &v = sample_indexes[order[start + i]];
+
+        auto stream = embedding_extractor_.CreateStream();
+        for (const auto &p : v) {
+          int32_t end = (p.second <= n) ? p.second : n;
+          int32_t count = end - p.first;
+
+          if (count > 0) {
+            stream->AcceptWaveform(sample_rate, audio + p.first, count);
+          }
+        }
+
+        stream->InputFinished();
+        if (!embedding_extractor_.IsReady(stream.get())) {
+          SHERPA_ONNX_LOGE(
+              "This segment is too short, which should not happen since we "
+              "have already filtered short segments");
+          SHERPA_ONNX_EXIT(-1);
         }
+
+        streams[i] = std::move(stream);
+      });
+
+      ss.clear();
+      for (const auto &s : streams) {
+        ss.push_back(s.get());
       }
 
-      stream->InputFinished();
-      if (!embedding_extractor_.IsReady(stream.get())) {
-        SHERPA_ONNX_LOGE(
-            "This segment is too short, which should not happen since we have "
-            "already filtered short segments");
-        SHERPA_ONNX_EXIT(-1);
+      auto batch = embedding_extractor_.ComputeBatch(ss.data(), k);
+      for (int32_t i = 0; i != k; ++i) {
+        embeddings[order[start + i]] = std::move(batch[i]);
       }
 
-      std::vector<float> embedding = embedding_extractor_.Compute(stream.get());
+      if (callback) {
+        callback(start + k, num_embeddings, callback_arg);
+      }
+    }
+
+    streams.clear();
+
+    Matrix2D ans(num_embeddings, embedding_extractor_.Dim());
+
+    auto IsNaNWrapper = [](float f) -> bool { return std::isnan(f); };
 
+    int32_t cur_row_index = 0;
+    for (int32_t k = 0; k != num_embeddings; ++k) {
+      const auto &embedding = embeddings[k];
       if (std::none_of(embedding.begin(), embedding.end(), IsNaNWrapper)) {
         // a valid embedding
         std::copy(embedding.begin(), embedding.end(), &ans(cur_row_index, 0));
         cur_row_index += 1;
         valid_indexes->push_back(k);
       }
-
-      k += 1;
-
-      if (callback) {
-        callback(k, ans.rows(), callback_arg);
-      }
     }
 
-    if (k != cur_row_index) {
+    if (num_embeddings != cur_row_index) {
       auto seq = Eigen::seqN(0, cur_row_index);
       ans = ans(seq, Eigen::all);
     }
@@ -737,7 +915,316 @@ class OfflineSpeakerDiarizationPyannoteImpl
   SpeakerEmbeddingExtractor embedding_extractor_;
   std::unique_ptr<FastClustering> clustering_;
   Matrix2DInt32 powerset_mapping_;
+
+  // It is false if the segmentation model rejected a batch of windows,
+  // e.g., if it was exported with a fixed batch size of 1
+  mutable std::atomic<bool> batch_supported_{true};
+
+  // It is not null if config_.segmentation.num_parallel_batches > 1.
+  // It runs segmentation batches and computes features for embeddings.
+  std::unique_ptr<ThreadPool> pool_;
+};
+
+class OfflineSpeakerDiarizationPyannoteStream
+    : public OfflineSpeakerDiarizationStream {
+ public:
+  explicit OfflineSpeakerDiarizationPyannoteStream(
+      const OfflineSpeakerDiarizationPyannoteImpl *impl)
+      : impl_(impl) {
+    const auto &meta_data = impl_->segmentation_model_.GetModelMetaData();
+    window_size_ = meta_data.window_size;
+    window_shift_ = meta_data.window_shift;
+    receptive_field_shift_ = meta_data.receptive_field_shift;
+    num_speakers_ = meta_data.num_speakers;
+
+    if (num_speakers_ > 8) {
+      SHERPA_ONNX_LOGE(
+          "Only up to 8 speakers per chunk are supported. Given %d",
+          num_speakers_);
+      SHERPA_ONNX_EXIT(-1);
+    }
+  }
+
+  void AcceptWaveform(const float *samples, int32_t n) override {
+    if (finalized_) {
+      SHERPA_ONNX_LOGE("Don't call AcceptWaveform() after Finalize()");
+      return;
+    }
+
+    buffer_.insert(buffer_.end(), samples, samples + n);
+    num_samples_ += n;
+
+    // Wait until a full batch is available
+    int32_t batch_size = impl_->config_.segmentation.batch_size;
+    while (NumAvailableWindows() >= batch_size) {
+      ProcessWindows(batch_size);
+    }
+  }
+
+  OfflineSpeakerDiarizationResult Flush() override {
+    ProcessAvailableWindows();
+
+    int32_t num_samples =
+        num_chunks_ > 0 ? window_size_ + (num_chunks_ - 1) * window_shift_ : 0;
+    return GetResult(num_samples);
+  }
+
+  OfflineSpeakerDiarizationResult Finalize() override {
+    if (!finalized_) {
+      finalized_ = true;
+
+      ProcessAvailableWindows();
+
+      // See RunSpeakerSegmentationModel() for the last chunk
+      int32_t n = num_samples_;
+      if (n > 0 &&
+          (n < window_size_ || (n - window_size_) % window_shift_ > 0)) {
+        std::vector<float> last_chunk(window_size_);
+        std::copy(buffer_.begin(), buffer_.end(), last_chunk.begin());
+        ProcessChunks(1, last_chunk.data());
+      }
+
+      buffer_.clear();
+      buffer_.shrink_to_fit();
+    }
+
+    return GetResult(num_samples_);
+  }
+
+ private:
+  int32_t NumAvailableWindows() const {
+    int32_t n = static_cast<int32_t>(buffer_.size());
+    return n < window_size_ ? 0 : (n - window_size_) / window_shift_ + 1;
+  }
+
+  void ProcessAvailableWindows() {
+    int32_t batch_size = impl_->config_.segmentation.batch_size;
+    int32_t k = NumAvailableWindows();
+    while (k > 0) {
+      ProcessWindows(std::min(k, batch_size));
+      k = NumAvailableWindows();
+    }
+  }
+
+  // Process the first k windows of buffer_ and remove their samples
+  void ProcessWindows(int32_t k) {
+    ProcessChunks(k, nullptr);
+
+    buffer_.erase(buffer_.begin(), buffer_.begin() + k * window_shift_);
+  }
+
+  /* Run segmentation and compute embeddings of k chunks.
+   *
+   * @param k Number of chunks. The i-th chunk starts at sample
+   *          i * window_shift_ of buffer_.
+   * @param last_chunk If not null, k must be 1 and it contains the samples
+   *                   of buffer_ padded with zeros to window_size_.
+   */
+  void ProcessChunks(int32_t k, const float *last_chunk) {
+    std::vector<const float *> chunks(k);
+    for (int32_t i = 0; i != k; ++i) {
+      chunks[i] = last_chunk ? last_chunk : buffer_.data() + i * window_shift_;
+    }
+
+    std::vector<Matrix2D> segmentations(k);
+    impl_->ProcessChunks(chunks.data(), k, segmentations.data());
+
+    std::vector<Int32Pair> chunk_speaker;
+    std::vector<std::vector<Int32Pair>> sample_indexes;
+
+    for (int32_t i = 0; i != k; ++i) {
+      Matrix2DInt32 label = impl_->ToMultiLabel(segmentations[i]);
+      segmentations[i] = {};
+
+      AddLabel(label, num_chunks_ + i);
+
+      impl_->GetSpeakerSampleIndexes(impl_->ExcludeOverlap(label),
+                                     num_chunks_ + i, i * window_shift_,
+                                     &chunk_speaker, &sample_indexes);
+    }
+
+    std::vector<int32_t> valid_indexes;
+    Matrix2D embeddings = impl_->ComputeEmbeddings(
+        buffer_.data(), buffer_.size(), sample_indexes, &valid_indexes,
+        nullptr, nullptr);
+
+    for (int32_t i = 0; i != static_cast<int32_t>(valid_indexes.size());
+         ++i) {
+      chunk_speaker_.push_back(chunk_speaker[valid_indexes[i]]);
+      embeddings_.insert(embeddings_.end(), &embeddings(i, 0),
+                         &embeddings(i, 0) + embeddings.cols());
+    }
+
+    if (embeddings.cols() > 0) {
+      embedding_dim_ = embeddings.cols();
+    }
+
+    num_chunks_ += k;
+  }
+
+  // Save the label of the next chunk as one bit per speaker and frame, and
+  // update the speaker count per frame. See ComputeSpeakersPerFrame()
+  void AddLabel(const Matrix2DInt32 &label, int32_t chunk_index) {
+    int32_t num_frames = label.rows();
+    num_frames_per_chunk_ = num_frames;
+
+    for (int32_t f = 0; f != num_frames; ++f) {
+      uint8_t mask = 0;
+      for (int32_t j = 0; j != num_speakers_; ++j) {
+        if (label(f, j)) {
+          mask |= 1 << j;
+        }
+      }
+      labels_.push_back(mask);
+    }
+
+    int32_t start = static_cast<float>(chunk_index) * window_shift_ /
+                        receptive_field_shift_ +
+                    0.5;
+
+    if (static_cast<int32_t>(count_.size()) < start + num_frames) {
+      count_.resize(start + num_frames);
+      weight_.resize(start + num_frames);
+    }
+
+    Int32RowVector v = label.rowwise().sum();
+    for (int32_t f = 0; f != num_frames; ++f) {
+      count_[start + f] += v[f];
+      weight_[start + f] += 1;
+    }
+  }
+
+  // Return the label of the given chunk as a matrix of shape
+  // (num_frames, num_speakers)
+  Matrix2DInt32 GetLabel(int32_t chunk_index) const {
+    Matrix2DInt32 ans(num_frames_per_chunk_, num_speakers_);
+    const uint8_t *p = labels_.data() + static_cast<size_t>(chunk_index) *
+                                            num_frames_per_chunk_;
+
+    for (int32_t f = 0; f != num_frames_per_chunk_; ++f) {
+      for (int32_t j = 0; j != num_speakers_; ++j) {
+        ans(f, j) = (p[f] >> j) & 1;
+      }
+    }
+
+    return ans;
+  }
+
+  /* It follows OfflineSpeakerDiarizationPyannoteImpl::Process() but
+   * it relabels one chunk at a time.
+   *
+   * @param num_samples Number of samples covered by the processed chunks.
+   */
+  OfflineSpeakerDiarizationResult GetResult(int32_t num_samples) {
+    if (num_chunks_ == 0) {
+      return {};
+    }
+
+    if (num_chunks_ == 1) {
+      return impl_->HandleOneChunkSpecialCase(GetLabel(0), num_samples);
+    }
+
+    // See ComputeSpeakersPerFrame()
+    int32_t num_frames =
+        (window_size_ + (num_chunks_ - 1) * window_shift_) /
+            receptive_field_shift_ +
+        1;
+
+    Int32RowVector speakers_per_frame(num_frames);
+    for (int32_t f = 0; f != num_frames; ++f) {
+      float c = f < static_cast<int32_t>(count_.size()) ? count_[f] : 0;
+      float w = f < static_cast<int32_t>(weight_.size()) ? weight_[f] : 0;
+      speakers_per_frame[f] = c / (w + 1e-12f) + 0.5;
+    }
+
+    if (speakers_per_frame.maxCoeff() == 0 || chunk_speaker_.empty()) {
+      SHERPA_ONNX_LOGE("No speakers found in the audio samples");
+      return {};
+    }
+
+    int32_t num_embeddings = chunk_speaker_.size();
+
+    // Cluster() normalizes the rows, which does not change the embeddings
+    // for later calls
+    std::vector<int32_t> cluster_labels = impl_->clustering_->Cluster(
+        embeddings_.data(), num_embeddings, embedding_dim_);
+
+    int32_t num_clusters =
+        *std::max_element(cluster_labels.begin(), cluster_labels.end()) + 1;
+
+    auto chunk_speaker_to_cluster =
+        impl_->ConvertChunkSpeakerToCluster(chunk_speaker_, cluster_labels);
+
+    // See ReLabel() and ComputeSpeakerCount()
+    Matrix2DInt32 count(num_frames, num_clusters);
+    count.setZero();
+
+    for (int32_t i = 0; i != num_chunks_; ++i) {
+      Matrix2DInt32 label = GetLabel(i);
+
+      int32_t start =
+          static_cast<float>(i) * window_shift_ / receptive_field_shift_ + 0.5;
+
+      for (int32_t j = 0; j != num_speakers_; ++j) {
+        auto it = chunk_speaker_to_cluster.find({i, j});
+        if (it == chunk_speaker_to_cluster.end()) {
+          continue;
+        }
+
+        for (int32_t f = 0; f != label.rows(); ++f) {
+          if (label(f, j) == 1) {
+            count(start + f, it->second) += 1;
+          }
+        }
+      }
+    }
+
+    bool has_last_chunk = ((num_samples - window_size_) % window_shift_) > 0;
+    if (has_last_chunk) {
+      int32_t last_frame = num_samples / receptive_field_shift_;
+      count = Matrix2DInt32(count(Eigen::seq(0, last_frame), Eigen::all));
+    }
+
+    Matrix2DInt32 final_labels =
+        impl_->FinalizeLabels(count, speakers_per_frame);
+
+    return impl_->ComputeResult(final_labels);
+  }
+
+ private:
+  const OfflineSpeakerDiarizationPyannoteImpl *impl_;
+
+  int32_t window_size_;
+  int32_t window_shift_;
+  int32_t receptive_field_shift_;
+  int32_t num_speakers_;
+
+  // Samples not yet processed. buffer_[0] is the first sample of the
+  // chunk num_chunks_.
+  std::vector<float> buffer_;
+  int32_t num_samples_ = 0;
+  int32_t num_chunks_ = 0;
+  bool finalized_ = false;
+
+  // labels_[c * num_frames_per_chunk_ + f] is a bit mask of the active
+  // speakers of frame f in chunk c
+  std::vector<uint8_t> labels_;
+  int32_t num_frames_per_chunk_ = 0;
+
+  // Sum of active speakers and number of chunks of each frame
+  std::vector<float> count_;
+  std::vector<float> weight_;
+
+  // Valid embeddings in row major and their (chunk, speaker) pairs
+  std::vector<float> embeddings_;
+  std::vector<Int32Pair> chunk_speaker_;
+  int32_t embedding_dim_ = 0;
 };
 
+inline std::unique_ptr<OfflineSpeakerDiarizationStream>
+OfflineSpeakerDiarizationPyannoteImpl::CreateStream() const {
+  return std::make_unique<OfflineSpeakerDiarizationPyannoteStream>(this);
+}
+
 }  // namespace sherpa_onnx
 #endif  // SHERPA_ONNX_CSRC_OFFLINE_SPEAKER_DIARIZATION_PYANNOTE_IMPL_H_
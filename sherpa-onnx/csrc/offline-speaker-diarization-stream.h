@@ -0,0 +1,49 @@
+// sherpa-onnx/csrc/offline-speaker-diarization-stream.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_SPEAKER_DIARIZATION_STREAM_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_SPEAKER_DIARIZATION_STREAM_H_
+
+#include <cstdint>
+
+#include "sherpa-onnx/csrc/offline-speaker-diarization-result.h"
+
+namespace sherpa_onnx {
+
+/** Speaker diarization of long audio that is given block by block.
+ *
+ * Segmentation and embedding extraction run as soon as enough samples
+ * arrive. The stream keeps only the samples of the windows not processed
+ * yet, a speaker mask per frame and chunk, and one embedding per
+ * (chunk, speaker) pair. Clustering runs in Flush() and Finalize().
+ *
+ * Finalize() returns the same result as OfflineSpeakerDiarization::Process()
+ * on all of the samples.
+ *
+ * Use OfflineSpeakerDiarization::CreateStream() to create it. The
+ * OfflineSpeakerDiarization object must outlive the stream.
+ */
+class OfflineSpeakerDiarizationStream {
+ public:
+  virtual ~OfflineSpeakerDiarizationStream() = default;
+
+  /**
+   * @param samples Samples at OfflineSpeakerDiarization::SampleRate().
+   * @param n Number of samples.
+   */
+  virtual void AcceptWaveform(const float *samples, int32_t n) = 0;
+
+  // Process all complete windows received so far and return interim
+  // speaker labels for them. Speaker IDs may change in later calls since
+  // clustering is redone with all embeddings.
+  virtual OfflineSpeakerDiarizationResult Flush() = 0;
+
+  // Process the remaining samples and return the final result. Do not
+  // call AcceptWaveform() afterwards.
+  virtual OfflineSpeakerDiarizationResult Finalize() = 0;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_SPEAKER_DIARIZATION_STREAM_H_
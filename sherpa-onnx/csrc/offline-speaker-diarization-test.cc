@@ -0,0 +1,178 @@
+// sherpa-onnx/csrc/offline-speaker-diarization-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-speaker-diarization.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-speaker-diarization-stream.h"
+#include "sherpa-onnx/csrc/offline-speaker-segmentation-pyannote-model.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace sherpa_onnx {
+
+// Please download the models and the test wave from
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/speaker-segmentation-models/sherpa-onnx-pyannote-segmentation-3-0.tar.bz2
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/speaker-recongition-models/3dspeaker_speech_eres2net_base_sv_zh-cn_3dspeaker_16k.onnx
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/speaker-segmentation-models/0-four-speakers-zh.wav
+const char *const kSegmentationModel =
+    "./sherpa-onnx-pyannote-segmentation-3-0/model.onnx";
+const char *const kEmbeddingModel =
+    "./3dspeaker_speech_eres2net_base_sv_zh-cn_3dspeaker_16k.onnx";
+const char *const kWave = "./0-four-speakers-zh.wav";
+
+static OfflineSpeakerDiarizationConfig GetConfig(
+    int32_t batch_size, int32_t num_parallel_batches) {
+  OfflineSpeakerDiarizationConfig config;
+  config.segmentation.pyannote.model = kSegmentationModel;
+  config.segmentation.batch_size = batch_size;
+  config.segmentation.num_parallel_batches = num_parallel_batches;
+  config.embedding.model = kEmbeddingModel;
+  config.clustering.num_clusters = 4;
+
+  return config;
+}
+
+static std::vector<OfflineSpeakerDiarizationSegment> Diarize(
+    const std::vector<float> &samples, int32_t batch_size,
+    int32_t num_parallel_batches) {
+  OfflineSpeakerDiarization sd(GetConfig(batch_size, num_parallel_batches));
+  return sd.Process(samples.data(), samples.size()).SortByStartTime();
+}
+
+// Feed samples to a stream in blocks of uneven sizes. None of them is a
+// multiple of the window shift, so windows start and end inside blocks.
+static std::vector<OfflineSpeakerDiarizationSegment> DiarizeStream(
+    const OfflineSpeakerDiarization &sd, const std::vector<float> &samples,
+    bool flush) {
+  const int32_t kBlockSizes[] = {1, 3001, 47000, 160001, 12345};
+
+  std::unique_ptr<OfflineSpeakerDiarizationStream> stream = sd.CreateStream();
+
+  int32_t n = samples.size();
+  int32_t k = 0;
+  for (int32_t i = 0; i < n; ++k) {
+    int32_t m = std::min(kBlockSizes[k % 5], n - i);
+    stream->AcceptWaveform(samples.data() + i, m);
+    i += m;
+
+    if (flush && k % 2 == 0) {
+      // Interim results must not change the final one
+      stream->Flush();
+    }
+  }
+
+  return stream->Finalize().SortByStartTime();
+}
+
+static void ExpectSameSegments(
+    const std::vector<OfflineSpeakerDiarizationSegment> &segments,
+    const std::vector<OfflineSpeakerDiarizationSegment> &expected) {
+  ASSERT_EQ(segments.size(), expected.size());
+
+  for (size_t i = 0; i != segments.size(); ++i) {
+    EXPECT_NEAR(segments[i].Start(), expected[i].Start(), 1e-3) << i;
+    EXPECT_NEAR(segments[i].End(), expected[i].End(), 1e-3) << i;
+    EXPECT_EQ(segments[i].Speaker(), expected[i].Speaker()) << i;
+  }
+}
+
+// Batches of windows give the same result as processing the windows one
+// by one
+TEST(OfflineSpeakerDiarization, SegmentationBatch) {
+  for (const char *f : {kSegmentationModel, kEmbeddingModel, kWave}) {
+    if (!FileExists(f)) {
+      SHERPA_ONNX_LOGE("%s does not exist. Skipping test", f);
+      return;
+    }
+  }
+
+  int32_t sample_rate = 0;
+  bool is_ok = false;
+  std::vector<float> samples = ReadWave(kWave, &sample_rate, &is_ok);
+  ASSERT_TRUE(is_ok);
+
+  auto expected = Diarize(samples, 1, 1);
+  ASSERT_FALSE(expected.empty());
+
+  // 7 does not divide the number of windows, so the last batch is partial
+  for (int32_t batch_size : {7, 32}) {
+    for (int32_t num_parallel_batches : {1, 3}) {
+      auto segments = Diarize(samples, batch_size, num_parallel_batches);
+      ASSERT_EQ(segments.size(), expected.size())
+          << batch_size << " " << num_parallel_batches;
+
+      for (size_t i = 0; i != segments.size(); ++i) {
+        EXPECT_NEAR(segments[i].Start(), expected[i].Start(), 1e-3);
+        EXPECT_NEAR(segments[i].End(), expected[i].End(), 1e-3);
+        EXPECT_EQ(segments[i].Speaker(), expected[i].Speaker());
+      }
+    }
+  }
+}
+
+// Finalize() of a stream gives the same result as Process() on all of the
+// samples. This checks the per-frame speaker masks, the speaker count per
+// frame of overlapping chunks and the chunks that span blocks.
+TEST(OfflineSpeakerDiarization, Stream) {
+  for (const char *f : {kSegmentationModel, kEmbeddingModel, kWave}) {
+    if (!FileExists(f)) {
+      SHERPA_ONNX_LOGE("%s does not exist. Skipping test", f);
+      return;
+    }
+  }
+
+  int32_t sample_rate = 0;
+  bool is_ok = false;
+  std::vector<float> samples = ReadWave(kWave, &sample_rate, &is_ok);
+  ASSERT_TRUE(is_ok);
+
+  int32_t window_size = 0;
+  int32_t window_shift = 0;
+  {
+    OfflineSpeakerSegmentationPyannoteModel model(GetConfig(1, 1).segmentation);
+    window_size = model.GetModelMetaData().window_size;
+    window_shift = model.GetModelMetaData().window_shift;
+  }
+
+  int32_t n = samples.size();
+  ASSERT_GT(n, window_size + 3 * window_shift + 100);
+
+  // The whole wave, a single chunk, chunks that end exactly at the last
+  // sample and a zero padded last chunk
+  std::vector<int32_t> lengths = {n, window_size / 2, window_size,
+                                  window_size + 3 * window_shift,
+                                  window_size + 3 * window_shift + 100};
+
+  for (int32_t batch_size : {1, 7}) {
+    OfflineSpeakerDiarizationConfig config = GetConfig(batch_size, 1);
+    // The number of clusters is unknown for the shorter inputs
+    config.clustering.num_clusters = -1;
+
+    OfflineSpeakerDiarization sd(config);
+
+    for (int32_t len : lengths) {
+      std::vector<float> s(samples.begin(), samples.begin() + len);
+
+      auto expected = sd.Process(s.data(), s.size()).SortByStartTime();
+      if (len == n) {
+        ASSERT_FALSE(expected.empty());
+      }
+
+      for (bool flush : {false, true}) {
+        SCOPED_TRACE(std::to_string(batch_size) + " " + std::to_string(len) +
+                     " " + std::to_string(flush));
+        ExpectSameSegments(DiarizeStream(sd, s, flush), expected);
+      }
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -106,6 +106,11 @@ OfflineSpeakerDiarizationResult OfflineSpeakerDiarization::Process(
   return impl_->Process(audio, n, std::move(callback), callback_arg);
 }
 
+std::unique_ptr<OfflineSpeakerDiarizationStream>
+OfflineSpeakerDiarization::CreateStream() const {
+  return impl_->CreateStream();
+}
+
 #if __ANDROID_API__ >= 9
 template OfflineSpeakerDiarization::OfflineSpeakerDiarization(
     AAssetManager *mgr, const OfflineSpeakerDiarizationConfig &config);
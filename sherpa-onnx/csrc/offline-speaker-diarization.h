@@ -11,6 +11,7 @@
 
 #include "sherpa-onnx/csrc/fast-clustering-config.h"
 #include "sherpa-onnx/csrc/offline-speaker-diarization-result.h"
+#include "sherpa-onnx/csrc/offline-speaker-diarization-stream.h"
 #include "sherpa-onnx/csrc/offline-speaker-segmentation-model-config.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
 
@@ -75,6 +76,11 @@ class OfflineSpeakerDiarization {
       OfflineSpeakerDiarizationProgressCallback callback = nullptr,
       void *callback_arg = nullptr) const;
 
+  // Create a stream to process long audio block by block. Its memory does
+  // not grow with the number of samples. See
+  // offline-speaker-diarization-stream.h
+  std::unique_ptr<OfflineSpeakerDiarizationStream> CreateStream() const;
+
  private:
   std::unique_ptr<OfflineSpeakerDiarizationImpl> impl_;
 };
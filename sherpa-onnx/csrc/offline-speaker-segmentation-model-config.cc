@@ -21,6 +21,15 @@ void OfflineSpeakerSegmentationModelConfig::Register(ParseOptions *po) {
 
   po->Register("provider", &provider,
                "Specify a provider to use: cpu, cuda, coreml");
+
+  po->Register("batch-size", &batch_size,
+               "Number of windows processed by the segmentation model in a "
+               "single call. Use 1 if your model does not support batches.");
+
+  po->Register("num-parallel-batches", &num_parallel_batches,
+               "Number of batches run concurrently. Each of them uses "
+               "--num-threads threads. It is also the number of threads "
+               "computing features for speaker embeddings.");
 }
 
 bool OfflineSpeakerSegmentationModelConfig::Validate() const {
@@ -29,6 +38,17 @@ bool OfflineSpeakerSegmentationModelConfig::Validate() const {
     return false;
   }
 
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("batch_size should be > 0. Given %d", batch_size);
+    return false;
+  }
+
+  if (num_parallel_batches < 1) {
+    SHERPA_ONNX_LOGE("num_parallel_batches should be > 0. Given %d",
+                     num_parallel_batches);
+    return false;
+  }
+
   if (!pyannote.model.empty()) {
     return pyannote.Validate();
   }
@@ -49,7 +69,9 @@ std::string OfflineSpeakerSegmentationModelConfig::ToString() const {
   os << "pyannote=" << pyannote.ToString() << ", ";
   os << "num_threads=" << num_threads << ", ";
   os << "debug=" << (debug ? "True" : "False") << ", ";
-  os << "provider=\"" << provider << "\")";
+  os << "provider=\"" << provider << "\", ";
+  os << "batch_size=" << batch_size << ", ";
+  os << "num_parallel_batches=" << num_parallel_batches << ")";
 
   return os.str();
 }
@@ -18,6 +18,16 @@ struct OfflineSpeakerSegmentationModelConfig {
   bool debug = false;
   std::string provider = "cpu";
 
+  // Number of windows processed by the model in a single call. If the
+  // model rejects a batch, e.g., because it was exported with a fixed batch
+  // size of 1, an error is logged and windows are processed one by one.
+  int32_t batch_size = 32;
+
+  // Number of batches run concurrently. Note that each of them uses
+  // num_threads threads. It is also the number of threads computing
+  // features for speaker embeddings in diarization.
+  int32_t num_parallel_batches = 1;
+
   OfflineSpeakerSegmentationModelConfig() = default;
 
   explicit OfflineSpeakerSegmentationModelConfig(
@@ -29,7 +29,7 @@ class OfflineSpeakerSegmentationPyannoteModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto buf = ReadFile(config_.pyannote.model);
+    auto buf = MapModelFile(config_.pyannote.model, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -56,9 +56,8 @@ class OfflineSpeakerSegmentationPyannoteModel::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
@@ -28,7 +28,7 @@ class OfflineTeleSpeechCtcModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto buf = ReadFile(config_.telespeech_ctc);
+    auto buf = MapModelFile(config_.telespeech_ctc, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -80,9 +80,8 @@ class OfflineTeleSpeechCtcModel::Impl {
   OrtAllocator *Allocator() { return allocator_; }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
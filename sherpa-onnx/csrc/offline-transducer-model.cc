@@ -21,6 +21,7 @@
 #include "sherpa-onnx/csrc/offline-transducer-decoder.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
@@ -31,20 +32,29 @@ class OfflineTransducerModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    {
-      auto buf = ReadFile(config.transducer.encoder_filename);
-      InitEncoder(buf.data(), buf.size());
-    }
-
-    {
-      auto buf = ReadFile(config.transducer.decoder_filename);
-      InitDecoder(buf.data(), buf.size());
-    }
-
-    {
-      auto buf = ReadFile(config.transducer.joiner_filename);
-      InitJoiner(buf.data(), buf.size());
-    }
+    // The models are independent, so they are loaded concurrently. Each
+    // of them uses a copy of the session options since MapModelFile()
+    // modifies them.
+    RunConcurrently({
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf =
+              MapModelFile(config.transducer.encoder_filename, &sess_opts);
+          InitEncoder(buf.data(), buf.size(), sess_opts);
+        },
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf =
+              MapModelFile(config.transducer.decoder_filename, &sess_opts);
+          InitDecoder(buf.data(), buf.size(), sess_opts);
+        },
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf =
+              MapModelFile(config.transducer.joiner_filename, &sess_opts);
+          InitJoiner(buf.data(), buf.size(), sess_opts);
+        }
+    });
   }
 
   template <typename Manager>
@@ -55,17 +65,17 @@ class OfflineTransducerModel::Impl {
         allocator_{} {
     {
       auto buf = ReadFile(mgr, config.transducer.encoder_filename);
-      InitEncoder(buf.data(), buf.size());
+      InitEncoder(buf.data(), buf.size(), sess_opts_);
     }
 
     {
       auto buf = ReadFile(mgr, config.transducer.decoder_filename);
-      InitDecoder(buf.data(), buf.size());
+      InitDecoder(buf.data(), buf.size(), sess_opts_);
     }
 
     {
       auto buf = ReadFile(mgr, config.transducer.joiner_filename);
-      InitJoiner(buf.data(), buf.size());
+      InitJoiner(buf.data(), buf.size(), sess_opts_);
     }
   }
 
@@ -153,9 +163,10 @@ class OfflineTransducerModel::Impl {
   }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length) {
-    encoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitEncoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts) {
+    encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts);
 
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
@@ -177,9 +188,10 @@ class OfflineTransducerModel::Impl {
     }
   }
 
-  void InitDecoder(void *model_data, size_t model_data_length) {
-    decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitDecoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts) {
+    decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts);
 
     GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                   &decoder_input_names_ptr_);
@@ -201,9 +213,10 @@ class OfflineTransducerModel::Impl {
     SHERPA_ONNX_READ_META_DATA(context_size_, "context_size");
   }
 
-  void InitJoiner(void *model_data, size_t model_data_length) {
-    joiner_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitJoiner(const void *model_data, size_t model_data_length,
+                  const Ort::SessionOptions &sess_opts) {
+    joiner_sess_ = CreateSession(env_, model_data, model_data_length,
+                                 sess_opts);
 
     GetInputNames(joiner_sess_.get(), &joiner_input_names_,
                   &joiner_input_names_ptr_);
@@ -22,6 +22,7 @@
 #include "sherpa-onnx/csrc/offline-transducer-decoder.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/transpose.h"
 
 namespace sherpa_onnx {
@@ -33,20 +34,29 @@ class OfflineTransducerNeMoModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    {
-      auto buf = ReadFile(config.transducer.encoder_filename);
-      InitEncoder(buf.data(), buf.size());
-    }
-
-    {
-      auto buf = ReadFile(config.transducer.decoder_filename);
-      InitDecoder(buf.data(), buf.size());
-    }
-
-    {
-      auto buf = ReadFile(config.transducer.joiner_filename);
-      InitJoiner(buf.data(), buf.size());
-    }
+    // The models are independent, so they are loaded concurrently. Each
+    // of them uses a copy of the session options since MapModelFile()
+    // modifies them.
+    RunConcurrently({
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf =
+              MapModelFile(config.transducer.encoder_filename, &sess_opts);
+          InitEncoder(buf.data(), buf.size(), sess_opts);
+        },
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf =
+              MapModelFile(config.transducer.decoder_filename, &sess_opts);
+          InitDecoder(buf.data(), buf.size(), sess_opts);
+        },
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf =
+              MapModelFile(config.transducer.joiner_filename, &sess_opts);
+          InitJoiner(buf.data(), buf.size(), sess_opts);
+        }
+    });
   }
 
   template <typename Manager>
@@ -57,17 +67,17 @@ class OfflineTransducerNeMoModel::Impl {
         allocator_{} {
     {
       auto buf = ReadFile(mgr, config.transducer.encoder_filename);
-      InitEncoder(buf.data(), buf.size());
+      InitEncoder(buf.data(), buf.size(), sess_opts_);
     }
 
     {
       auto buf = ReadFile(mgr, config.transducer.decoder_filename);
-      InitDecoder(buf.data(), buf.size());
+      InitDecoder(buf.data(), buf.size(), sess_opts_);
     }
 
     {
       auto buf = ReadFile(mgr, config.transducer.joiner_filename);
-      InitJoiner(buf.data(), buf.size());
+      InitJoiner(buf.data(), buf.size(), sess_opts_);
     }
   }
 
@@ -164,9 +174,10 @@ class OfflineTransducerNeMoModel::Impl {
   bool IsGigaAM() const { return is_giga_am_; }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length) {
-    encoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitEncoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts) {
+    encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts);
 
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
@@ -206,9 +217,10 @@ class OfflineTransducerNeMoModel::Impl {
     }
   }
 
-  void InitDecoder(void *model_data, size_t model_data_length) {
-    decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitDecoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts) {
+    decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts);
 
     GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                   &decoder_input_names_ptr_);
@@ -217,9 +229,10 @@ class OfflineTransducerNeMoModel::Impl {
                    &decoder_output_names_ptr_);
   }
 
-  void InitJoiner(void *model_data, size_t model_data_length) {
-    joiner_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitJoiner(const void *model_data, size_t model_data_length,
+                  const Ort::SessionOptions &sess_opts) {
+    joiner_sess_ = CreateSession(env_, model_data, model_data_length,
+                                 sess_opts);
 
     GetInputNames(joiner_sess_.get(), &joiner_input_names_,
                   &joiner_input_names_ptr_);
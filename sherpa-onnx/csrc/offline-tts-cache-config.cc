@@ -0,0 +1,74 @@
+// sherpa-onnx/csrc/offline-tts-cache-config.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-cache-config.h"
+
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void OfflineTtsCacheConfig::Register(ParseOptions *po) {
+  po->Register("tts-token-cache-size", &token_cache_size,
+               "Maximum number of texts whose token IDs are cached so that "
+               "repeated text skips text normalization and the frontend. "
+               "0 to disable it.");
+
+  po->Register("tts-audio-cache-size", &audio_cache_size_mb,
+               "Maximum size in MB of generated audio cached for (text, sid, "
+               "speed) so that repeated requests skip synthesis. 0 to "
+               "disable it.");
+
+  po->Register("tts-audio-cache-file", &audio_cache_file,
+               "If not empty, the audio cache is loaded from this file on "
+               "startup and saved to it on exit.");
+
+  po->Register("tts-tn-cache-size", &tn_cache_size,
+               "Maximum number of sentences whose output of --tts-rule-fsts "
+               "and --tts-rule-fars is cached. 0 to disable it.");
+}
+
+bool OfflineTtsCacheConfig::Validate() const {
+  if (token_cache_size < 0) {
+    SHERPA_ONNX_LOGE("--tts-token-cache-size should be >= 0. Given: %d",
+                     token_cache_size);
+    return false;
+  }
+
+  if (audio_cache_size_mb < 0) {
+    SHERPA_ONNX_LOGE("--tts-audio-cache-size should be >= 0. Given: %d",
+                     audio_cache_size_mb);
+    return false;
+  }
+
+  if (tn_cache_size < 0) {
+    SHERPA_ONNX_LOGE("--tts-tn-cache-size should be >= 0. Given: %d",
+                     tn_cache_size);
+    return false;
+  }
+
+  if (!audio_cache_file.empty() && audio_cache_size_mb == 0) {
+    SHERPA_ONNX_LOGE(
+        "Please provide --tts-audio-cache-size to use --tts-audio-cache-file");
+    return false;
+  }
+
+  return true;
+}
+
+std::string OfflineTtsCacheConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "OfflineTtsCacheConfig(";
+  os << "token_cache_size=" << token_cache_size << ", ";
+  os << "audio_cache_size_mb=" << audio_cache_size_mb << ", ";
+  os << "audio_cache_file=\"" << audio_cache_file << "\", ";
+  os << "tn_cache_size=" << tn_cache_size << ")";
+
+  return os.str();
+}
+
+}  // namespace sherpa_onnx
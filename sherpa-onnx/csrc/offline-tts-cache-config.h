@@ -0,0 +1,54 @@
+// sherpa-onnx/csrc/offline-tts-cache-config.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_CACHE_CONFIG_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_CACHE_CONFIG_H_
+
+#include <cstdint>
+#include <string>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+// Caches for repeated TTS input, e.g., greetings and menu prompts.
+// All of them are disabled by default.
+struct OfflineTtsCacheConfig {
+  // Maximum number of texts whose token IDs are cached. It skips text
+  // normalization and the frontend for repeated text. 0 to disable it.
+  int32_t token_cache_size = 0;
+
+  // Maximum size in MB of the generated audio cached for
+  // (text, sid, speed). It skips synthesis for repeated requests.
+  // 0 to disable it.
+  int32_t audio_cache_size_mb = 0;
+
+  // If not empty, the audio cache is loaded from this file on startup and
+  // saved to it when OfflineTts is destroyed or OfflineTts::SaveCache()
+  // is called.
+  std::string audio_cache_file;
+
+  // Maximum number of sentences whose output of the rule FSTs is cached.
+  // It helps if texts differ but share sentences. 0 to disable it.
+  int32_t tn_cache_size = 0;
+
+  OfflineTtsCacheConfig() = default;
+
+  OfflineTtsCacheConfig(int32_t token_cache_size, int32_t audio_cache_size_mb,
+                        const std::string &audio_cache_file,
+                        int32_t tn_cache_size)
+      : token_cache_size(token_cache_size),
+        audio_cache_size_mb(audio_cache_size_mb),
+        audio_cache_file(audio_cache_file),
+        tn_cache_size(tn_cache_size) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_CACHE_CONFIG_H_
@@ -0,0 +1,163 @@
+// sherpa-onnx/csrc/offline-tts-impl-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-impl.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fst/fstlib.h"
+#include "gtest/gtest.h"
+#include "kaldifst/csrc/text-normalizer.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+
+namespace sherpa_onnx {
+
+// It has no model. It is used to test the text normalization and the
+// caches of OfflineTtsImpl. The generated audio has one sample per byte of
+// the text.
+class TestOfflineTtsImpl : public OfflineTtsImpl {
+ public:
+  explicit TestOfflineTtsImpl(const OfflineTtsConfig &config,
+                              int32_t sample_rate = 16000)
+      : sample_rate_(sample_rate) {
+    InitCache(config);
+  }
+
+  GeneratedAudio Generate(
+      const std::string &text, int64_t /*sid*/, float /*speed*/,
+      GeneratedAudioCallback /*callback*/) const override {
+    ++num_generate_calls_;
+
+    GeneratedAudio ans;
+    ans.sample_rate = sample_rate_;
+    for (char c : text) {
+      ans.samples.push_back(static_cast<unsigned char>(c) / 256.0f);
+    }
+    return ans;
+  }
+
+  int32_t SampleRate() const override { return sample_rate_; }
+
+  int32_t NumSpeakers() const override { return 1; }
+
+  using OfflineTtsImpl::NormalizeText;
+
+  int32_t NumGenerateCalls() const { return num_generate_calls_; }
+
+ protected:
+  SentenceTokens RunFrontend(const std::string & /*text*/) const override {
+    return {};
+  }
+
+ private:
+  int32_t sample_rate_;
+  mutable int32_t num_generate_calls_ = 0;
+};
+
+// A rule FST that replaces every "1" with "one" and copies other bytes
+static std::unique_ptr<kaldifst::TextNormalizer> CreateTextNormalizer() {
+  fst::StdVectorFst rule;
+  auto start = rule.AddState();
+  auto n = rule.AddState();
+  auto e = rule.AddState();
+  rule.SetStart(start);
+  rule.SetFinal(start, fst::TropicalWeight::One());
+
+  for (int32_t i = 1; i != 256; ++i) {
+    if (i != '1') {
+      rule.AddArc(start, fst::StdArc(i, i, fst::TropicalWeight::One(), start));
+    }
+  }
+
+  rule.AddArc(start, fst::StdArc('1', 'o', fst::TropicalWeight::One(), n));
+  rule.AddArc(n, fst::StdArc(0, 'n', fst::TropicalWeight::One(), e));
+  rule.AddArc(e, fst::StdArc(0, 'e', fst::TropicalWeight::One(), start));
+
+  fst::ArcSort(&rule, fst::StdILabelCompare());
+
+  return std::make_unique<kaldifst::TextNormalizer>(
+      std::make_unique<fst::StdConstFst>(rule));
+}
+
+TEST(OfflineTtsImpl, NormalizeText) {
+  std::vector<std::unique_ptr<kaldifst::TextNormalizer>> tn_list;
+  tn_list.push_back(CreateTextNormalizer());
+
+  std::string text = "I have 1 apple.  You have 2!\nI have 1 apple. Room 1";
+  std::string expected =
+      "I have one apple.  You have 2!\nI have one apple. Room one";
+
+  // Without the cache
+  TestOfflineTtsImpl tts(OfflineTtsConfig{});
+  EXPECT_EQ(tts.NormalizeText(text, tn_list, false), expected);
+  EXPECT_EQ(tts.GetCacheStats().tn_cache_hits, 0);
+  EXPECT_EQ(tts.GetCacheStats().tn_cache_misses, 0);
+
+  // Without rules
+  EXPECT_EQ(tts.NormalizeText(text, {}, false), text);
+
+  OfflineTtsConfig config;
+  config.cache.tn_cache_size = 10;
+  TestOfflineTtsImpl cached_tts(config);
+
+  // The repeated sentence is normalized only once
+  EXPECT_EQ(cached_tts.NormalizeText(text, tn_list, false), expected);
+  OfflineTtsCacheStats stats = cached_tts.GetCacheStats();
+  EXPECT_EQ(stats.tn_cache_hits, 1);
+  EXPECT_EQ(stats.tn_cache_misses, 3);
+
+  // Sentences are cached across texts
+  EXPECT_EQ(cached_tts.NormalizeText("You have 2! It is 1.", tn_list, false),
+            "You have 2! It is one.");
+  stats = cached_tts.GetCacheStats();
+  EXPECT_EQ(stats.tn_cache_hits, 2);
+  EXPECT_EQ(stats.tn_cache_misses, 4);
+}
+
+// The audio cache is saved when the impl is destroyed and loaded by the
+// next one with the same model
+TEST(OfflineTtsImpl, AudioCacheFile) {
+  std::string filename = "offline-tts-impl-test-cache.bin";
+  std::remove(filename.c_str());
+
+  OfflineTtsConfig config;
+  config.cache.audio_cache_size_mb = 1;
+  config.cache.audio_cache_file = filename;
+
+  GeneratedAudio expected;
+  {
+    TestOfflineTtsImpl tts(config);
+    expected = tts.GenerateWithCache("hello", 1, 1.0);
+    EXPECT_EQ(tts.NumGenerateCalls(), 1);
+  }
+  ASSERT_TRUE(FileExists(filename));
+
+  {
+    TestOfflineTtsImpl tts(config);
+    GeneratedAudio audio = tts.GenerateWithCache("hello", 1, 1.0);
+    EXPECT_EQ(tts.NumGenerateCalls(), 0);
+    EXPECT_EQ(tts.GetCacheStats().audio_cache_hits, 1);
+    EXPECT_EQ(audio.sample_rate, expected.sample_rate);
+    EXPECT_EQ(audio.samples, expected.samples);
+
+    // A different sid is not cached
+    tts.GenerateWithCache("hello", 2, 1.0);
+    EXPECT_EQ(tts.NumGenerateCalls(), 1);
+  }
+
+  {
+    // The file is ignored for a model with a different sample rate
+    TestOfflineTtsImpl tts(config, 22050);
+    tts.GenerateWithCache("hello", 1, 1.0);
+    EXPECT_EQ(tts.NumGenerateCalls(), 1);
+    EXPECT_EQ(tts.GetCacheStats().audio_cache_hits, 0);
+  }
+
+  std::remove(filename.c_str());
+}
+
+}  // namespace sherpa_onnx
@@ -4,7 +4,16 @@
 
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>  // NOLINT
 #include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #if __ANDROID_API__ >= 9
@@ -16,11 +25,82 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
+#include "kaldifst/csrc/text-normalizer.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/model-cache.h"
 #include "sherpa-onnx/csrc/offline-tts-matcha-impl.h"
 #include "sherpa-onnx/csrc/offline-tts-vits-impl.h"
+#include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
 
+namespace {
+
+// The audio cache file starts with kAudioCacheMagic, the version (int32_t),
+// the model hash (uint64_t, see AudioCacheModelHash()), the sample rate
+// (int32_t) and the number of entries (int32_t). Each entry is
+//
+//   key size, key, sample rate, number of samples, samples
+//
+// where the sizes and the sample rate are in int32_t and the samples in
+// float. Entries are saved from the least recently used one.
+constexpr char kAudioCacheMagic[8] = {'S', 'H', 'E', 'R', 'P', 'A', 'T', 'C'};
+constexpr int32_t kAudioCacheVersion = 2;
+
+std::string AudioCacheKey(const std::string &text, int64_t sid,
+                          float speed) {
+  std::string ans = text;
+  ans.push_back('\0');
+  ans.append(reinterpret_cast<const char *>(&sid), sizeof(sid));
+  ans.append(reinterpret_cast<const char *>(&speed), sizeof(speed));
+  return ans;
+}
+
+// Hash of the model options and of the size and modification time of the
+// model files. A cache file saved with a different model is rejected.
+uint64_t AudioCacheModelHash(const OfflineTtsConfig &config) {
+  std::ostringstream os;
+  os << config.model.vits.ToString() << config.model.matcha.ToString()
+     << config.rule_fsts << config.rule_fars;
+
+  for (const auto &f : {config.model.vits.model,
+                        config.model.matcha.acoustic_model,
+                        config.model.matcha.vocoder}) {
+    int64_t size = 0;
+    int64_t mtime = 0;
+    if (!f.empty() && GetFileSizeAndMtime(f, &size, &mtime)) {
+      os << "|" << size << "|" << mtime;
+    }
+  }
+
+  std::string s = os.str();
+  return HashBytes(s.data(), s.size());
+}
+
+size_t AudioCacheCost(const std::string &key, const GeneratedAudio &audio) {
+  return key.size() + audio.samples.size() * sizeof(float);
+}
+
+template <typename T>
+void WriteValue(std::ostream &os, T value) {
+  os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ReadValue(std::istream &is, T *value) {
+  return static_cast<bool>(
+      is.read(reinterpret_cast<char *>(value), sizeof(*value)));
+}
+
+}  // namespace
+
+OfflineTtsImpl::~OfflineTtsImpl() {
+  if (!audio_cache_file_.empty()) {
+    SaveCache();
+  }
+}
+
 std::vector<int64_t> OfflineTtsImpl::AddBlank(const std::vector<int64_t> &x,
                                               int32_t blank_id /*= 0*/) const {
   // we assume the blank ID is 0
@@ -33,22 +113,486 @@ std::vector<int64_t> OfflineTtsImpl::AddBlank(const std::vector<int64_t> &x,
   return buffer;
 }
 
+GeneratedAudio OfflineTtsImpl::GeneratePipelined(
+    const std::string &text, int32_t max_num_sentences, int32_t num_threads,
+    const std::function<SentenceTokens(const std::string &)> &frontend,
+    const std::function<GeneratedAudio(
+        const SentenceTokens &, const GeneratedAudioCallback &)> &synthesize,
+    GeneratedAudioCallback callback) const {
+  std::vector<std::string> sentences = SplitTextIntoSentences(text);
+  int32_t num_sentences = static_cast<int32_t>(sentences.size());
+
+  // batches[b] is the text of the b-th batch. The first batch contains
+  // only the first sentence to reduce the time to the first audio.
+  std::vector<std::string> batches;
+  int32_t batch_size = max_num_sentences > 0 ? max_num_sentences
+                                             : std::max(1, num_sentences);
+  for (int32_t i = 0; i < num_sentences;) {
+    int32_t n = i == 0 ? 1 : std::min(batch_size, num_sentences - i);
+
+    std::string s = sentences[i];
+    for (int32_t k = 1; k < n; ++k) {
+      s.append(" ").append(sentences[i + k]);
+    }
+    batches.push_back(std::move(s));
+
+    i += n;
+  }
+
+  int32_t num_batches = static_cast<int32_t>(batches.size());
+
+  GeneratedAudio ans;
+  ans.sample_rate = SampleRate();
+
+  if (num_threads > 1 && num_batches > 1) {
+    ans.samples = GenerateInParallel(batches, num_threads, frontend,
+                                     synthesize, callback);
+    if (ans.samples.empty()) {
+      SHERPA_ONNX_LOGE("Failed to convert the text to token IDs");
+      return {};
+    }
+
+    return ans;
+  }
+
+  std::future<SentenceTokens> next;
+  if (num_batches > 0) {
+    next = std::async(std::launch::async, frontend, batches[0]);
+  }
+
+  int32_t should_continue = 1;
+  for (int32_t b = 0; b != num_batches && should_continue; ++b) {
+    SentenceTokens tokens = next.get();
+
+    if (b + 1 < num_batches) {
+      next = std::async(std::launch::async, frontend, batches[b + 1]);
+    }
+
+    if (tokens.tokens.empty()) {
+      // e.g., a sentence containing only punctuations
+      continue;
+    }
+
+    // Number of samples of this batch passed to the callback by synthesize
+    int32_t num_sent = 0;
+    GeneratedAudioCallback partial_callback;
+    if (callback) {
+      partial_callback = [&](const float *samples, int32_t n,
+                             float progress) -> int32_t {
+        num_sent += n;
+        should_continue = callback(samples, n, (b + progress) / num_batches);
+        return should_continue;
+      };
+    }
+
+    auto audio = synthesize(tokens, partial_callback);
+    ans.samples.insert(ans.samples.end(), audio.samples.begin(),
+                       audio.samples.end());
+
+    int32_t num_samples = static_cast<int32_t>(audio.samples.size());
+    if (callback && should_continue && num_sent < num_samples) {
+      should_continue =
+          callback(audio.samples.data() + num_sent, num_samples - num_sent,
+                   (b + 1) * 1.0 / num_batches);
+      // Caution(fangjun): audio is freed when the callback returns, so users
+      // should copy the data if they want to access the data after
+      // the callback returns to avoid segmentation fault.
+    }
+  }
+
+  if (next.valid()) {
+    // Wait for the frontend if the callback has stopped generating
+    next.wait();
+  }
+
+  if (ans.samples.empty()) {
+    SHERPA_ONNX_LOGE("Failed to convert the text to token IDs");
+    return {};
+  }
+
+  return ans;
+}
+
+std::vector<float> OfflineTtsImpl::GenerateInParallel(
+    const std::vector<std::string> &batches, int32_t num_threads,
+    const std::function<SentenceTokens(const std::string &)> &frontend,
+    const std::function<GeneratedAudio(
+        const SentenceTokens &, const GeneratedAudioCallback &)> &synthesize,
+    const GeneratedAudioCallback &callback) const {
+  auto run = [&frontend, &synthesize](const std::string &s) -> GeneratedAudio {
+    SentenceTokens tokens = frontend(s);
+    if (tokens.tokens.empty()) {
+      // e.g., a sentence containing only punctuations
+      return {};
+    }
+
+    return synthesize(tokens, nullptr);
+  };
+
+  int32_t num_batches = static_cast<int32_t>(batches.size());
+
+  // Batches in flight, in order. Batch b + num_threads is started once
+  // batch b is done and passed to the callback, so at most num_threads of
+  // them run at a time.
+  std::deque<std::future<GeneratedAudio>> pending;
+  int32_t num_started = 0;
+  for (; num_started < std::min(num_threads, num_batches); ++num_started) {
+    pending.push_back(
+        std::async(std::launch::async, run, batches[num_started]));
+  }
+
+  std::vector<float> ans;
+
+  int32_t should_continue = 1;
+  for (int32_t b = 0; b != num_batches && should_continue; ++b) {
+    GeneratedAudio audio = pending.front().get();
+    pending.pop_front();
+
+    if (!audio.samples.empty()) {
+      ans.insert(ans.end(), audio.samples.begin(), audio.samples.end());
+
+      if (callback) {
+        should_continue = callback(audio.samples.data(), audio.samples.size(),
+                                   (b + 1) * 1.0 / num_batches);
+      }
+    }
+
+    // The next batch is started after the callback so that no batch is
+    // started once it has returned 0
+    if (should_continue && num_started < num_batches) {
+      pending.push_back(
+          std::async(std::launch::async, run, batches[num_started]));
+      ++num_started;
+    }
+  }
+
+  // Wait for the batches that were already running when the callback
+  // stopped generating
+  for (auto &f : pending) {
+    f.wait();
+  }
+
+  return ans;
+}
+
+std::string OfflineTtsImpl::NormalizeText(
+    const std::string &text,
+    const std::vector<std::unique_ptr<kaldifst::TextNormalizer>> &tn_list,
+    bool debug) const {
+  if (tn_list.empty()) {
+    return text;
+  }
+
+  std::string ans;
+  ans.reserve(text.size());
+
+  int32_t prev_end = 0;
+  for (const auto &span : SplitTextIntoSentenceSpans(text)) {
+    ans.append(text, prev_end, span.first - prev_end);
+    prev_end = span.second;
+
+    std::string sentence = text.substr(span.first, span.second - span.first);
+
+    std::string normalized;
+    if (tn_cache_ && tn_cache_->Get(sentence, &normalized)) {
+      ans.append(normalized);
+      continue;
+    }
+
+    normalized = sentence;
+    for (const auto &tn : tn_list) {
+      normalized = tn->Normalize(normalized);
+    }
+
+    ans.append(normalized);
+
+    if (tn_cache_) {
+      tn_cache_->Put(sentence, std::move(normalized));
+    }
+  }
+
+  ans.append(text, prev_end, std::string::npos);
+
+  if (debug) {
+#if __OHOS__
+    SHERPA_ONNX_LOGE("After normalizing: %{public}s", ans.c_str());
+#else
+    SHERPA_ONNX_LOGE("After normalizing: %s", ans.c_str());
+#endif
+  }
+
+  return ans;
+}
+
+OfflineTtsImpl::SentenceTokens OfflineTtsImpl::RunFrontendWithCache(
+    const std::string &text) const {
+  if (!token_cache_) {
+    return RunFrontend(text);
+  }
+
+  SentenceTokens ans;
+  if (token_cache_->Get(text, &ans)) {
+    return ans;
+  }
+
+  ans = RunFrontend(text);
+  if (!ans.tokens.empty()) {
+    token_cache_->Put(text, ans);
+  }
+
+  return ans;
+}
+
+GeneratedAudio OfflineTtsImpl::GenerateWithCache(
+    const std::string &text, int64_t sid /*= 0*/, float speed /*= 1.0*/,
+    GeneratedAudioCallback callback /*= nullptr*/) const {
+  if (!audio_cache_) {
+    return Generate(text, sid, speed, std::move(callback));
+  }
+
+  std::string key = AudioCacheKey(text, sid, speed);
+
+  GeneratedAudio ans;
+  if (audio_cache_->Get(key, &ans)) {
+    if (callback) {
+      callback(ans.samples.data(), ans.samples.size(), 1.0);
+    }
+    return ans;
+  }
+
+  // Don't cache incomplete audio if the callback stops generating
+  bool stopped = false;
+  GeneratedAudioCallback callback_wrapper;
+  if (callback) {
+    callback_wrapper = [&callback, &stopped](const float *samples, int32_t n,
+                                             float progress) -> int32_t {
+      int32_t ans = callback(samples, n, progress);
+      stopped = stopped || !ans;
+      return ans;
+    };
+  }
+
+  ans = Generate(text, sid, speed, callback_wrapper);
+
+  if (!stopped && !ans.samples.empty()) {
+    audio_cache_->Put(key, ans, AudioCacheCost(key, ans));
+  }
+
+  return ans;
+}
+
+OfflineTtsCacheStats OfflineTtsImpl::GetCacheStats() const {
+  OfflineTtsCacheStats ans;
+  if (token_cache_) {
+    ans.token_cache_hits = token_cache_->NumHits();
+    ans.token_cache_misses = token_cache_->NumMisses();
+  }
+
+  if (audio_cache_) {
+    ans.audio_cache_hits = audio_cache_->NumHits();
+    ans.audio_cache_misses = audio_cache_->NumMisses();
+    ans.audio_cache_entries = audio_cache_->Size();
+    ans.audio_cache_bytes = audio_cache_->Cost();
+  }
+
+  if (tn_cache_) {
+    ans.tn_cache_hits = tn_cache_->NumHits();
+    ans.tn_cache_misses = tn_cache_->NumMisses();
+  }
+
+  return ans;
+}
+
+bool OfflineTtsImpl::SaveCache() const {
+  if (!audio_cache_ || audio_cache_file_.empty()) {
+    return false;
+  }
+
+  // Write to a temporary file and rename it so that an interrupted save
+  // never leaves a partially written cache. rename() replaces the existing
+  // file atomically on POSIX systems. On Windows, the existing file has to
+  // be removed first, so a crash between the two steps loses the cache.
+  std::string tmp = audio_cache_file_ + ".tmp";
+  {
+    std::ofstream os(tmp, std::ios::binary);
+    if (!os) {
+      SHERPA_ONNX_LOGE("Failed to open '%s' for writing", tmp.c_str());
+      return false;
+    }
+
+    os.write(kAudioCacheMagic, sizeof(kAudioCacheMagic));
+    WriteValue<int32_t>(os, kAudioCacheVersion);
+    WriteValue<uint64_t>(os, audio_cache_model_hash_);
+    WriteValue<int32_t>(os, audio_cache_sample_rate_);
+
+    // The number of entries is written after them since the cache may be
+    // modified by other threads before ForEach() locks it
+    auto num_entries_pos = os.tellp();
+    WriteValue<int32_t>(os, 0);
+
+    int32_t num_entries = 0;
+    audio_cache_->ForEach(
+        [&os, &num_entries](const std::string &key, const GeneratedAudio &a) {
+          WriteValue<int32_t>(os, key.size());
+          os.write(key.data(), key.size());
+          WriteValue<int32_t>(os, a.sample_rate);
+          WriteValue<int32_t>(os, a.samples.size());
+          os.write(reinterpret_cast<const char *>(a.samples.data()),
+                   a.samples.size() * sizeof(float));
+          ++num_entries;
+        });
+
+    os.seekp(num_entries_pos);
+    WriteValue<int32_t>(os, num_entries);
+
+    if (!os) {
+      SHERPA_ONNX_LOGE("Failed to write '%s'", tmp.c_str());
+      return false;
+    }
+  }
+
+#if defined(_WIN32)
+  std::remove(audio_cache_file_.c_str());
+#endif
+
+  if (std::rename(tmp.c_str(), audio_cache_file_.c_str()) != 0) {
+    SHERPA_ONNX_LOGE("Failed to rename '%s' to '%s'", tmp.c_str(),
+                     audio_cache_file_.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+void OfflineTtsImpl::InitCache(const OfflineTtsConfig &tts_config) {
+  const auto &config = tts_config.cache;
+
+  if (config.token_cache_size > 0) {
+    token_cache_ = std::make_unique<LruCache<std::string, SentenceTokens>>(
+        config.token_cache_size);
+  }
+
+  if (config.tn_cache_size > 0) {
+    tn_cache_ = std::make_unique<LruCache<std::string, std::string>>(
+        config.tn_cache_size);
+  }
+
+  if (config.audio_cache_size_mb > 0) {
+    audio_cache_ = std::make_unique<LruCache<std::string, GeneratedAudio>>(
+        static_cast<size_t>(config.audio_cache_size_mb) * 1024 * 1024);
+
+    audio_cache_file_ = config.audio_cache_file;
+    if (!audio_cache_file_.empty()) {
+      audio_cache_model_hash_ = AudioCacheModelHash(tts_config);
+      audio_cache_sample_rate_ = SampleRate();
+      LoadAudioCache();
+    }
+  }
+}
+
+void OfflineTtsImpl::LoadAudioCache() {
+  std::ifstream is(audio_cache_file_, std::ios::binary);
+  if (!is) {
+    // It is created on exit
+    return;
+  }
+
+  is.seekg(0, std::ios::end);
+  int64_t file_size = is.tellg();
+  is.seekg(0, std::ios::beg);
+
+  // Number of bytes after the current position
+  auto remaining = [&is, file_size]() -> int64_t {
+    return file_size - static_cast<int64_t>(is.tellg());
+  };
+
+  char magic[sizeof(kAudioCacheMagic)];
+  int32_t version = 0;
+  uint64_t model_hash = 0;
+  int32_t sample_rate = 0;
+  int32_t num_entries = 0;
+  if (!is.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kAudioCacheMagic, sizeof(magic)) != 0 ||
+      !ReadValue(is, &version) || version != kAudioCacheVersion ||
+      !ReadValue(is, &model_hash) || !ReadValue(is, &sample_rate) ||
+      !ReadValue(is, &num_entries)) {
+    SHERPA_ONNX_LOGE("'%s' is not a valid TTS audio cache. Ignore it",
+                     audio_cache_file_.c_str());
+    return;
+  }
+
+  if (model_hash != audio_cache_model_hash_ ||
+      sample_rate != audio_cache_sample_rate_) {
+    SHERPA_ONNX_LOGE(
+        "'%s' was saved with a different model (sample rate %d, expected "
+        "%d). Ignore it",
+        audio_cache_file_.c_str(), sample_rate, audio_cache_sample_rate_);
+    return;
+  }
+
+  for (int32_t i = 0; i != num_entries; ++i) {
+    int32_t key_size = 0;
+    int32_t num_samples = 0;
+    std::string key;
+    GeneratedAudio audio;
+
+    bool ok =
+        ReadValue(is, &key_size) && key_size >= 0 && key_size <= remaining();
+    if (ok) {
+      key.resize(key_size);
+      ok = static_cast<bool>(is.read(&key[0], key_size)) &&
+           ReadValue(is, &audio.sample_rate) &&
+           audio.sample_rate == sample_rate && ReadValue(is, &num_samples) &&
+           num_samples >= 0 &&
+           static_cast<int64_t>(sizeof(float)) * num_samples <= remaining();
+    }
+
+    if (ok) {
+      audio.samples.resize(num_samples);
+      ok = static_cast<bool>(
+          is.read(reinterpret_cast<char *>(audio.samples.data()),
+                  num_samples * sizeof(float)));
+    }
+
+    if (!ok) {
+      SHERPA_ONNX_LOGE(
+          "'%s' is truncated or corrupted. Loaded %d of %d entries",
+          audio_cache_file_.c_str(), i, num_entries);
+      return;
+    }
+
+    size_t cost = AudioCacheCost(key, audio);
+    audio_cache_->Put(key, std::move(audio), cost);
+  }
+}
+
 std::unique_ptr<OfflineTtsImpl> OfflineTtsImpl::Create(
     const OfflineTtsConfig &config) {
+  std::unique_ptr<OfflineTtsImpl> ans;
   if (!config.model.vits.model.empty()) {
-    return std::make_unique<OfflineTtsVitsImpl>(config);
+    ans = std::make_unique<OfflineTtsVitsImpl>(config);
+  } else {
+    ans = std::make_unique<OfflineTtsMatchaImpl>(config);
   }
-  return std::make_unique<OfflineTtsMatchaImpl>(config);
+
+  ans->InitCache(config);
+
+  return ans;
 }
 
 template <typename Manager>
 std::unique_ptr<OfflineTtsImpl> OfflineTtsImpl::Create(
     Manager *mgr, const OfflineTtsConfig &config) {
+  std::unique_ptr<OfflineTtsImpl> ans;
   if (!config.model.vits.model.empty()) {
-    return std::make_unique<OfflineTtsVitsImpl>(mgr, config);
+    ans = std::make_unique<OfflineTtsVitsImpl>(mgr, config);
+  } else {
+    ans = std::make_unique<OfflineTtsMatchaImpl>(mgr, config);
   }
 
-  return std::make_unique<OfflineTtsMatchaImpl>(mgr, config);
+  ans->InitCache(config);
+
+  return ans;
 }
 
 #if __ANDROID_API__ >= 9
@@ -5,17 +5,25 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_TTS_IMPL_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "sherpa-onnx/csrc/lru-cache.h"
 #include "sherpa-onnx/csrc/offline-tts.h"
 
+namespace kaldifst {
+class TextNormalizer;
+}
+
 namespace sherpa_onnx {
 
 class OfflineTtsImpl {
  public:
-  virtual ~OfflineTtsImpl() = default;
+  // It saves the audio cache if config.cache.audio_cache_file is given
+  virtual ~OfflineTtsImpl();
 
   static std::unique_ptr<OfflineTtsImpl> Create(const OfflineTtsConfig &config);
 
@@ -36,6 +44,126 @@ class OfflineTtsImpl {
 
   std::vector<int64_t> AddBlank(const std::vector<int64_t> &x,
                                 int32_t blank_id = 0) const;
+
+  // Like Generate() but return cached audio for repeated (text, sid, speed)
+  // if the audio cache is enabled. For cached audio, the callback is
+  // invoked once with all samples.
+  GeneratedAudio GenerateWithCache(
+      const std::string &text, int64_t sid = 0, float speed = 1.0,
+      GeneratedAudioCallback callback = nullptr) const;
+
+  OfflineTtsCacheStats GetCacheStats() const;
+
+  bool SaveCache() const;
+
+ protected:
+  // Token IDs of one or more sentences
+  struct SentenceTokens {
+    std::vector<std::vector<int64_t>> tokens;
+
+    // Used only in MeloTTS
+    std::vector<std::vector<int64_t>> tones;
+
+    // Used only in Matcha. Output of the acoustic model of shape
+    // (num_mels, num_frames) in row major
+    std::vector<float> mel;
+    int32_t num_mels = 0;
+  };
+
+  // Run text normalization and the frontend on the text of one or more
+  // sentences. Return empty tokens on failure.
+  virtual SentenceTokens RunFrontend(const std::string &text) const = 0;
+
+  // Like RunFrontend() but use the token cache if it is enabled
+  SentenceTokens RunFrontendWithCache(const std::string &text) const;
+
+  /* Apply the rule FSTs in tn_list from left to right.
+   *
+   * They are applied to each sentence separately, so the cost grows with
+   * the length of the sentences rather than that of the whole text, and
+   * the output of each sentence is cached if the TN cache is enabled.
+   * Text between sentences is kept as it is.
+   */
+  std::string NormalizeText(
+      const std::string &text,
+      const std::vector<std::unique_ptr<kaldifst::TextNormalizer>> &tn_list,
+      bool debug) const;
+
+  /* Generate audio sentence by sentence for low latency.
+   *
+   * The text is split into sentences. The first sentence is synthesized
+   * alone and the others in batches of max_num_sentences. The frontend of
+   * the next batch runs in a separate thread while the current batch is
+   * synthesized, and the callback is invoked as soon as a batch is ready
+   * or whenever synthesize invokes the callback passed to it.
+   *
+   * If num_threads is greater than 1, up to num_threads batches are
+   * processed concurrently, each running the frontend and synthesize in its
+   * own thread. The audio of each batch is passed to the callback in order
+   * once it and all batches before it are ready. No new batch is started
+   * after the callback returns 0.
+   *
+   * @param text The input text.
+   * @param max_num_sentences Maximum number of sentences per batch. If it
+   *                          is not positive, all sentences after the first
+   *                          one are in a single batch.
+   * @param num_threads Maximum number of batches processed concurrently.
+   * @param frontend It runs text normalization and converts the text of one
+   *                 or more sentences to token IDs. Return empty tokens on
+   *                 failure. It may also run the first stage of a model,
+   *                 e.g., the acoustic model of Matcha, which then overlaps
+   *                 with the synthesis of the previous batch.
+   * @param synthesize It runs the model on the token IDs of a batch. It may
+   *                   pass parts of the audio to the given callback, whose
+   *                   progress is relative to the batch, as soon as they are
+   *                   ready. The remaining samples of the returned audio are
+   *                   passed to the callback afterwards. The given callback
+   *                   is empty if batches are processed concurrently.
+   * @param callback It is called after each batch. It stops generating if
+   *                 it returns 0.
+   */
+  GeneratedAudio GeneratePipelined(
+      const std::string &text, int32_t max_num_sentences, int32_t num_threads,
+      const std::function<SentenceTokens(const std::string &)> &frontend,
+      const std::function<GeneratedAudio(
+          const SentenceTokens &, const GeneratedAudioCallback &)> &synthesize,
+      GeneratedAudioCallback callback) const;
+
+  // Create the caches enabled in config.cache. It is called by Create()
+  // after the model is loaded since it calls SampleRate().
+  void InitCache(const OfflineTtsConfig &config);
+
+ private:
+  // Used by GeneratePipelined() if num_threads > 1. Return the samples of
+  // all batches processed before the callback returns 0.
+  std::vector<float> GenerateInParallel(
+      const std::vector<std::string> &batches, int32_t num_threads,
+      const std::function<SentenceTokens(const std::string &)> &frontend,
+      const std::function<GeneratedAudio(
+          const SentenceTokens &, const GeneratedAudioCallback &)> &synthesize,
+      const GeneratedAudioCallback &callback) const;
+
+  void LoadAudioCache();
+
+ private:
+  // Key: text
+  std::unique_ptr<LruCache<std::string, SentenceTokens>> token_cache_;
+
+  // Key: text, sid and speed. See AudioCacheKey() in offline-tts-impl.cc
+  std::unique_ptr<LruCache<std::string, GeneratedAudio>> audio_cache_;
+
+  // Key: a sentence before text normalization
+  std::unique_ptr<LruCache<std::string, std::string>> tn_cache_;
+
+  std::string audio_cache_file_;
+
+  // Saved in audio_cache_file_. See AudioCacheModelHash() in
+  // offline-tts-impl.cc
+  uint64_t audio_cache_model_hash_ = 0;
+
+  // Sample rate of the model, saved in audio_cache_file_. SaveCache() is
+  // called by the destructor, where SampleRate() can no longer be called.
+  int32_t audio_cache_sample_rate_ = 0;
 };
 
 }  // namespace sherpa_onnx
@@ -13,6 +13,7 @@
 #include "fst/extensions/far/far.h"
 #include "kaldifst/csrc/kaldi-fst-io.h"
 #include "kaldifst/csrc/text-normalizer.h"
+#include "sherpa-onnx/csrc/chunked-vocoder.h"
 #include "sherpa-onnx/csrc/hifigan-vocoder.h"
 #include "sherpa-onnx/csrc/jieba-lexicon.h"
 #include "sherpa-onnx/csrc/lexicon.h"
@@ -191,62 +192,35 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
       sid = 0;
     }
 
-    std::string text = _text;
-    if (config_.model.debug) {
-#if __OHOS__
-      SHERPA_ONNX_LOGE("Raw text: %{public}s", text.c_str());
-#else
-      SHERPA_ONNX_LOGE("Raw text: %s", text.c_str());
-#endif
-    }
-
-    if (!tn_list_.empty()) {
-      for (const auto &tn : tn_list_) {
-        text = tn->Normalize(text);
-        if (config_.model.debug) {
-#if __OHOS__
-          SHERPA_ONNX_LOGE("After normalizing: %{public}s", text.c_str());
-#else
-          SHERPA_ONNX_LOGE("After normalizing: %s", text.c_str());
-#endif
-        }
-      }
+    if (callback || config_.num_sentence_threads > 1) {
+      return GeneratePipelined(
+          _text, config_.max_num_sentences, config_.num_sentence_threads,
+          [this, sid, speed](const std::string &text) {
+            // The acoustic model of the next batch runs while the current
+            // batch is vocoded
+            SentenceTokens t = RunFrontendWithCache(text);
+            if (!t.tokens.empty()) {
+              RunAcousticModel(&t, sid, speed);
+            }
+            return t;
+          },
+          [this](const SentenceTokens &t,
+                 const GeneratedAudioCallback &callback) {
+            return Vocode(t, callback);
+          },
+          callback);
     }
 
-    std::vector<TokenIDs> token_ids =
-        frontend_->ConvertTextToTokenIds(text, "en-US");
-
-    if (token_ids.empty() ||
-        (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
-#if __OHOS__
-      SHERPA_ONNX_LOGE("Failed to convert '%{public}s' to token IDs",
-                       text.c_str());
-#else
-      SHERPA_ONNX_LOGE("Failed to convert '%s' to token IDs", text.c_str());
-#endif
+    std::vector<std::vector<int64_t>> x =
+        RunFrontendWithCache(_text).tokens;
+    if (x.empty()) {
       return {};
     }
 
-    std::vector<std::vector<int64_t>> x;
-
-    x.reserve(token_ids.size());
-
-    for (auto &i : token_ids) {
-      x.push_back(std::move(i.tokens));
-    }
-
-    for (auto &k : x) {
-      k = AddBlank(k, meta_data.pad_id);
-    }
-
     int32_t x_size = static_cast<int32_t>(x.size());
 
     if (config_.max_num_sentences <= 0 || x_size <= config_.max_num_sentences) {
-      auto ans = Process(x, sid, speed);
-      if (callback) {
-        callback(ans.samples.data(), ans.samples.size(), 1.0);
-      }
-      return ans;
+      return Process(x, sid, speed);
     }
 
     // the input text is too long, we process sentences within it in batches
@@ -273,11 +247,9 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
 
     GeneratedAudio ans;
 
-    int32_t should_continue = 1;
-
     int32_t k = 0;
 
-    for (int32_t b = 0; b != num_batches && should_continue; ++b) {
+    for (int32_t b = 0; b != num_batches; ++b) {
       batch_x.clear();
       for (int32_t i = 0; i != batch_size; ++i, ++k) {
         batch_x.push_back(std::move(x[k]));
@@ -287,17 +259,10 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
       ans.sample_rate = audio.sample_rate;
       ans.samples.insert(ans.samples.end(), audio.samples.begin(),
                          audio.samples.end());
-      if (callback) {
-        should_continue = callback(audio.samples.data(), audio.samples.size(),
-                                   (b + 1) * 1.0 / num_batches);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
     }
 
     batch_x.clear();
-    while (k < static_cast<int32_t>(x.size()) && should_continue) {
+    while (k < static_cast<int32_t>(x.size())) {
       batch_x.push_back(std::move(x[k]));
 
       ++k;
@@ -308,18 +273,58 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
       ans.sample_rate = audio.sample_rate;
       ans.samples.insert(ans.samples.end(), audio.samples.begin(),
                          audio.samples.end());
-      if (callback) {
-        callback(audio.samples.data(), audio.samples.size(), 1.0);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
     }
 
     return ans;
   }
 
  private:
+  // Run text normalization and the frontend, and add blanks.
+  // Return empty tokens on failure.
+  SentenceTokens RunFrontend(const std::string &_text) const override {
+    const auto &meta_data = model_->GetMetaData();
+
+    std::string text = _text;
+    if (config_.model.debug) {
+#if __OHOS__
+      SHERPA_ONNX_LOGE("Raw text: %{public}s", text.c_str());
+#else
+      SHERPA_ONNX_LOGE("Raw text: %s", text.c_str());
+#endif
+    }
+
+    text = NormalizeText(text, tn_list_, config_.model.debug);
+
+    std::vector<TokenIDs> token_ids =
+        frontend_->ConvertTextToTokenIds(text, "en-US");
+
+    if (token_ids.empty() ||
+        (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
+#if __OHOS__
+      SHERPA_ONNX_LOGE("Failed to convert '%{public}s' to token IDs",
+                       text.c_str());
+#else
+      SHERPA_ONNX_LOGE("Failed to convert '%s' to token IDs", text.c_str());
+#endif
+      return {};
+    }
+
+    SentenceTokens ans;
+    std::vector<std::vector<int64_t>> &x = ans.tokens;
+
+    x.reserve(token_ids.size());
+
+    for (auto &i : token_ids) {
+      x.push_back(std::move(i.tokens));
+    }
+
+    for (auto &k : x) {
+      k = AddBlank(k, meta_data.pad_id);
+    }
+
+    return ans;
+  }
+
   template <typename Manager>
   void InitFrontend(Manager *mgr) {
     // for piper phonemizer
@@ -335,9 +340,12 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
           mgr, config_.model.matcha.lexicon, config_.model.matcha.tokens,
           config_.model.matcha.dict_dir, config_.model.debug);
     } else if (meta_data.has_espeak && !meta_data.jieba) {
-      frontend_ = std::make_unique<PiperPhonemizeLexicon>(
+      auto lexicon = std::make_unique<PiperPhonemizeLexicon>(
           mgr, config_.model.matcha.tokens, config_.model.matcha.data_dir,
           meta_data);
+      lexicon->UseWordCache(config_.model.espeak_word_cache,
+                            config_.model.espeak_word_cache_size);
+      frontend_ = std::move(lexicon);
     } else {
       SHERPA_ONNX_LOGE("jieba + espeaker-ng is not supported yet");
       SHERPA_ONNX_EXIT(-1);
@@ -352,9 +360,12 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
           config_.model.matcha.lexicon, config_.model.matcha.tokens,
           config_.model.matcha.dict_dir, config_.model.debug);
     } else if (meta_data.has_espeak && !meta_data.jieba) {
-      frontend_ = std::make_unique<PiperPhonemizeLexicon>(
+      auto lexicon = std::make_unique<PiperPhonemizeLexicon>(
           config_.model.matcha.tokens, config_.model.matcha.data_dir,
           meta_data);
+      lexicon->UseWordCache(config_.model.espeak_word_cache,
+                            config_.model.espeak_word_cache_size);
+      frontend_ = std::move(lexicon);
     } else {
       SHERPA_ONNX_LOGE("jieba + espeaker-ng is not supported yet");
       SHERPA_ONNX_EXIT(-1);
@@ -363,14 +374,23 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
 
   GeneratedAudio Process(const std::vector<std::vector<int64_t>> &tokens,
                          int32_t sid, float speed) const {
+    SentenceTokens t;
+    t.tokens = tokens;
+    RunAcousticModel(&t, sid, speed);
+
+    return Vocode(t, nullptr);
+  }
+
+  // Run the acoustic model on t->tokens and save the output to t->mel
+  void RunAcousticModel(SentenceTokens *t, int32_t sid, float speed) const {
     int32_t num_tokens = 0;
-    for (const auto &k : tokens) {
+    for (const auto &k : t->tokens) {
       num_tokens += k.size();
     }
 
     std::vector<int64_t> x;
     x.reserve(num_tokens);
-    for (const auto &k : tokens) {
+    for (const auto &k : t->tokens) {
       x.insert(x.end(), k.begin(), k.end());
     }
 
@@ -382,22 +402,62 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
         memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
 
     Ort::Value mel = model_->Run(std::move(x_tensor), sid, speed);
-    Ort::Value audio = vocoder_->Run(std::move(mel));
 
-    std::vector<int64_t> audio_shape =
-        audio.GetTensorTypeAndShapeInfo().GetShape();
+    // (1, num_mels, num_frames)
+    std::vector<int64_t> mel_shape = mel.GetTensorTypeAndShapeInfo().GetShape();
+    const float *p = mel.GetTensorData<float>();
 
-    int64_t total = 1;
-    // The output shape may be (1, 1, total) or (1, total) or (total,)
-    for (auto i : audio_shape) {
-      total *= i;
+    t->num_mels = mel_shape[1];
+    t->mel.assign(p, p + mel_shape[1] * mel_shape[2]);
+  }
+
+  /* Run the vocoder on t.mel.
+   *
+   * If callback is not empty, the mel spectrogram is vocoded in chunks of
+   * config_.model.matcha.vocoder_chunk_size frames and the callback is
+   * invoked after each chunk.
+   */
+  GeneratedAudio Vocode(const SentenceTokens &t,
+                        const GeneratedAudioCallback &callback) const {
+    if (t.mel.empty()) {
+      return {};
     }
 
-    const float *p = audio.GetTensorData<float>();
+    const auto &matcha = config_.model.matcha;
+    int32_t num_frames = t.mel.size() / t.num_mels;
+
+    auto vocoder = [this](const float *mel, int32_t num_mels,
+                          int32_t num_frames) {
+      auto memory_info =
+          Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+      std::array<int64_t, 3> mel_shape = {1, num_mels, num_frames};
+      Ort::Value mel_tensor = Ort::Value::CreateTensor(
+          memory_info, const_cast<float *>(mel), num_mels * num_frames,
+          mel_shape.data(), mel_shape.size());
+
+      Ort::Value audio = vocoder_->Run(std::move(mel_tensor));
+
+      std::vector<int64_t> audio_shape =
+          audio.GetTensorTypeAndShapeInfo().GetShape();
+
+      int64_t total = 1;
+      // The output shape may be (1, 1, total) or (1, total) or (total,)
+      for (auto i : audio_shape) {
+        total *= i;
+      }
+
+      const float *p = audio.GetTensorData<float>();
+      return std::vector<float>(p, p + total);
+    };
 
     GeneratedAudio ans;
     ans.sample_rate = model_->GetMetaData().sample_rate;
-    ans.samples = std::vector<float>(p, p + total);
+    ans.samples = RunVocoderInChunks(
+        vocoder, t.mel.data(), t.num_mels, num_frames,
+        callback ? matcha.vocoder_chunk_size : 0, matcha.vocoder_chunk_overlap,
+        callback);
+
     return ans;
   }
 
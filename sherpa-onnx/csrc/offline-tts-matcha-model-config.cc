@@ -16,7 +16,8 @@ void OfflineTtsMatchaModelConfig::Register(ParseOptions *po) {
                "Path to matcha acoustic model");
   po->Register("matcha-vocoder", &vocoder, "Path to matcha vocoder");
   po->Register("matcha-lexicon", &lexicon,
-               "Path to lexicon.txt for Matcha models");
+               "Path to lexicon.txt for Matcha models. It can also be a "
+               "binary lexicon from sherpa-onnx-compile-lexicon");
   po->Register("matcha-tokens", &tokens,
                "Path to tokens.txt for Matcha models");
   po->Register("matcha-data-dir", &data_dir,
@@ -29,6 +30,13 @@ void OfflineTtsMatchaModelConfig::Register(ParseOptions *po) {
                "noise_scale for Matcha models");
   po->Register("matcha-length-scale", &length_scale,
                "Speech speed. Larger->Slower; Smaller->faster.");
+  po->Register("matcha-vocoder-chunk-size", &vocoder_chunk_size,
+               "When a callback is given, run the vocoder over chunks of this "
+               "number of mel frames to output audio earlier. 0 to vocode "
+               "all frames at once");
+  po->Register("matcha-vocoder-chunk-overlap", &vocoder_chunk_overlap,
+               "Number of mel frames of context on each side of a vocoder "
+               "chunk. Neighboring chunks are crossfaded over them");
 }
 
 bool OfflineTtsMatchaModelConfig::Validate() const {
@@ -63,6 +71,16 @@ bool OfflineTtsMatchaModelConfig::Validate() const {
     return false;
   }
 
+  if (vocoder_chunk_size > 0 &&
+      (vocoder_chunk_overlap < 0 ||
+       vocoder_chunk_overlap >= vocoder_chunk_size)) {
+    SHERPA_ONNX_LOGE(
+        "--matcha-vocoder-chunk-overlap should be in the range [0, %d). "
+        "Given: %d",
+        vocoder_chunk_size, vocoder_chunk_overlap);
+    return false;
+  }
+
   if (!data_dir.empty()) {
     if (!FileExists(data_dir + "/phontab")) {
       SHERPA_ONNX_LOGE(
@@ -135,7 +153,9 @@ std::string OfflineTtsMatchaModelConfig::ToString() const {
   os << "data_dir=\"" << data_dir << "\", ";
   os << "dict_dir=\"" << dict_dir << "\", ";
   os << "noise_scale=" << noise_scale << ", ";
-  os << "length_scale=" << length_scale << ")";
+  os << "length_scale=" << length_scale << ", ";
+  os << "vocoder_chunk_size=" << vocoder_chunk_size << ", ";
+  os << "vocoder_chunk_overlap=" << vocoder_chunk_overlap << ")";
 
   return os.str();
 }
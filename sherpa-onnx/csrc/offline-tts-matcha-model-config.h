@@ -27,6 +27,15 @@ struct OfflineTtsMatchaModelConfig {
   float noise_scale = 1;
   float length_scale = 1;
 
+  // When audio is generated with a callback, the vocoder runs over chunks of
+  // this number of mel frames so that audio is available before the whole
+  // sentence is vocoded. 0 means to vocode all frames at once.
+  int32_t vocoder_chunk_size = 100;
+
+  // Number of mel frames of context on each side of a vocoder chunk.
+  // Neighboring chunks are crossfaded over this number of frames.
+  int32_t vocoder_chunk_overlap = 16;
+
   OfflineTtsMatchaModelConfig() = default;
 
   OfflineTtsMatchaModelConfig(const std::string &acoustic_model,
@@ -31,7 +31,7 @@ class OfflineTtsMatchaModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto buf = ReadFile(config.matcha.acoustic_model);
+    auto buf = MapModelFile(config.matcha.acoustic_model, &sess_opts_);
     Init(buf.data(), buf.size());
   }
 
@@ -102,9 +102,8 @@ class OfflineTtsMatchaModel::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
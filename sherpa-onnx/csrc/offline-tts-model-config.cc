@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/csrc/offline-tts-model-config.h"
 
+#include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 
 namespace sherpa_onnx {
@@ -20,6 +21,17 @@ void OfflineTtsModelConfig::Register(ParseOptions *po) {
 
   po->Register("provider", &provider,
                "Specify a provider to use: cpu, cuda, coreml");
+
+  po->Register("espeak-word-cache", &espeak_word_cache,
+               "For models using espeak-ng. Path to a word phoneme cache built "
+               "by sherpa-onnx-build-word-phoneme-cache. If given, text is "
+               "phonemized word by word and espeak-ng is called only for "
+               "words not in the cache.");
+
+  po->Register("espeak-word-cache-size", &espeak_word_cache_size,
+               "For models using espeak-ng. If positive, text is phonemized "
+               "word by word and up to this number of words phonemized by "
+               "espeak-ng are cached.");
 }
 
 bool OfflineTtsModelConfig::Validate() const {
@@ -28,6 +40,18 @@ bool OfflineTtsModelConfig::Validate() const {
     return false;
   }
 
+  if (!espeak_word_cache.empty() && !FileExists(espeak_word_cache)) {
+    SHERPA_ONNX_LOGE("--espeak-word-cache: '%s' does not exist",
+                     espeak_word_cache.c_str());
+    return false;
+  }
+
+  if (espeak_word_cache_size < 0) {
+    SHERPA_ONNX_LOGE("--espeak-word-cache-size should be >= 0. Given: %d",
+                     espeak_word_cache_size);
+    return false;
+  }
+
   if (!vits.model.empty()) {
     return vits.Validate();
   }
@@ -43,7 +67,9 @@ std::string OfflineTtsModelConfig::ToString() const {
   os << "matcha=" << matcha.ToString() << ", ";
   os << "num_threads=" << num_threads << ", ";
   os << "debug=" << (debug ? "True" : "False") << ", ";
-  os << "provider=\"" << provider << "\")";
+  os << "provider=\"" << provider << "\", ";
+  os << "espeak_word_cache=\"" << espeak_word_cache << "\", ";
+  os << "espeak_word_cache_size=" << espeak_word_cache_size << ")";
 
   return os.str();
 }
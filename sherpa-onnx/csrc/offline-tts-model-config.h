@@ -21,6 +21,16 @@ struct OfflineTtsModelConfig {
   bool debug = false;
   std::string provider = "cpu";
 
+  // For models using espeak-ng. If one of them is given, text is
+  // phonemized word by word and espeak-ng is called only for words missing
+  // from the caches. See PiperPhonemizeLexicon::UseWordCache().
+  //
+  // Path to a file built by sherpa-onnx-build-word-phoneme-cache
+  std::string espeak_word_cache;
+
+  // Maximum number of other words cached after calling espeak-ng
+  int32_t espeak_word_cache_size = 0;
+
   OfflineTtsModelConfig() = default;
 
   OfflineTtsModelConfig(const OfflineTtsVitsModelConfig &vits,
@@ -184,73 +184,31 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       sid = 0;
     }
 
-    std::string text = _text;
-    if (config_.model.debug) {
-#if __OHOS__
-      SHERPA_ONNX_LOGE("Raw text: %{public}s", text.c_str());
-#else
-      SHERPA_ONNX_LOGE("Raw text: %s", text.c_str());
-#endif
+    if (callback || config_.num_sentence_threads > 1) {
+      return GeneratePipelined(
+          _text, config_.max_num_sentences, config_.num_sentence_threads,
+          [this](const std::string &text) {
+            return RunFrontendWithCache(text);
+          },
+          [this, sid, speed](const SentenceTokens &t,
+                             const GeneratedAudioCallback & /*callback*/) {
+            return Process(t.tokens, t.tones, sid, speed);
+          },
+          callback);
     }
 
-    if (!tn_list_.empty()) {
-      for (const auto &tn : tn_list_) {
-        text = tn->Normalize(text);
-        if (config_.model.debug) {
-#if __OHOS__
-          SHERPA_ONNX_LOGE("After normalizing: %{public}s", text.c_str());
-#else
-          SHERPA_ONNX_LOGE("After normalizing: %s", text.c_str());
-#endif
-        }
-      }
-    }
-
-    std::vector<TokenIDs> token_ids =
-        frontend_->ConvertTextToTokenIds(text, meta_data.voice);
-
-    if (token_ids.empty() ||
-        (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
-      SHERPA_ONNX_LOGE("Failed to convert %s to token IDs", text.c_str());
+    SentenceTokens t = RunFrontendWithCache(_text);
+    if (t.tokens.empty()) {
       return {};
     }
 
-    std::vector<std::vector<int64_t>> x;
-    std::vector<std::vector<int64_t>> tones;
-
-    x.reserve(token_ids.size());
-
-    for (auto &i : token_ids) {
-      x.push_back(std::move(i.tokens));
-    }
-
-    if (!token_ids[0].tones.empty()) {
-      tones.reserve(token_ids.size());
-      for (auto &i : token_ids) {
-        tones.push_back(std::move(i.tones));
-      }
-    }
-
-    // TODO(fangjun): add blank inside the frontend, not here
-    if (meta_data.add_blank && config_.model.vits.data_dir.empty() &&
-        meta_data.frontend != "characters") {
-      for (auto &k : x) {
-        k = AddBlank(k);
-      }
-
-      for (auto &k : tones) {
-        k = AddBlank(k);
-      }
-    }
+    std::vector<std::vector<int64_t>> x = std::move(t.tokens);
+    std::vector<std::vector<int64_t>> tones = std::move(t.tones);
 
     int32_t x_size = static_cast<int32_t>(x.size());
 
     if (config_.max_num_sentences <= 0 || x_size <= config_.max_num_sentences) {
-      auto ans = Process(x, tones, sid, speed);
-      if (callback) {
-        callback(ans.samples.data(), ans.samples.size(), 1.0);
-      }
-      return ans;
+      return Process(x, tones, sid, speed);
     }
 
     // the input text is too long, we process sentences within it in batches
@@ -279,11 +237,9 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
 
     GeneratedAudio ans;
 
-    int32_t should_continue = 1;
-
     int32_t k = 0;
 
-    for (int32_t b = 0; b != num_batches && should_continue; ++b) {
+    for (int32_t b = 0; b != num_batches; ++b) {
       batch_x.clear();
       batch_tones.clear();
       for (int32_t i = 0; i != batch_size; ++i, ++k) {
@@ -298,18 +254,11 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       ans.sample_rate = audio.sample_rate;
       ans.samples.insert(ans.samples.end(), audio.samples.begin(),
                          audio.samples.end());
-      if (callback) {
-        should_continue = callback(audio.samples.data(), audio.samples.size(),
-                                   (b + 1) * 1.0 / num_batches);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
     }
 
     batch_x.clear();
     batch_tones.clear();
-    while (k < static_cast<int32_t>(x.size()) && should_continue) {
+    while (k < static_cast<int32_t>(x.size())) {
       batch_x.push_back(std::move(x[k]));
       if (!tones.empty()) {
         batch_tones.push_back(std::move(tones[k]));
@@ -323,18 +272,69 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       ans.sample_rate = audio.sample_rate;
       ans.samples.insert(ans.samples.end(), audio.samples.begin(),
                          audio.samples.end());
-      if (callback) {
-        callback(audio.samples.data(), audio.samples.size(), 1.0);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
     }
 
     return ans;
   }
 
  private:
+  // Run text normalization and the frontend. Blanks are added if the model
+  // requires them. Return empty tokens on failure.
+  SentenceTokens RunFrontend(const std::string &_text) const override {
+    const auto &meta_data = model_->GetMetaData();
+
+    std::string text = _text;
+    if (config_.model.debug) {
+#if __OHOS__
+      SHERPA_ONNX_LOGE("Raw text: %{public}s", text.c_str());
+#else
+      SHERPA_ONNX_LOGE("Raw text: %s", text.c_str());
+#endif
+    }
+
+    text = NormalizeText(text, tn_list_, config_.model.debug);
+
+    std::vector<TokenIDs> token_ids =
+        frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+
+    if (token_ids.empty() ||
+        (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
+      SHERPA_ONNX_LOGE("Failed to convert %s to token IDs", text.c_str());
+      return {};
+    }
+
+    SentenceTokens ans;
+    std::vector<std::vector<int64_t>> &x = ans.tokens;
+    std::vector<std::vector<int64_t>> &tones = ans.tones;
+
+    x.reserve(token_ids.size());
+
+    for (auto &i : token_ids) {
+      x.push_back(std::move(i.tokens));
+    }
+
+    if (!token_ids[0].tones.empty()) {
+      tones.reserve(token_ids.size());
+      for (auto &i : token_ids) {
+        tones.push_back(std::move(i.tones));
+      }
+    }
+
+    // TODO(fangjun): add blank inside the frontend, not here
+    if (meta_data.add_blank && config_.model.vits.data_dir.empty() &&
+        meta_data.frontend != "characters") {
+      for (auto &k : x) {
+        k = AddBlank(k);
+      }
+
+      for (auto &k : tones) {
+        k = AddBlank(k);
+      }
+    }
+
+    return ans;
+  }
+
   template <typename Manager>
   void InitFrontend(Manager *mgr) {
     const auto &meta_data = model_->GetMetaData();
@@ -359,9 +359,12 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     } else if ((meta_data.is_piper || meta_data.is_coqui ||
                 meta_data.is_icefall) &&
                !config_.model.vits.data_dir.empty()) {
-      frontend_ = std::make_unique<PiperPhonemizeLexicon>(
+      auto lexicon = std::make_unique<PiperPhonemizeLexicon>(
           mgr, config_.model.vits.tokens, config_.model.vits.data_dir,
           meta_data);
+      lexicon->UseWordCache(config_.model.espeak_word_cache,
+                            config_.model.espeak_word_cache_size);
+      frontend_ = std::move(lexicon);
     } else {
       if (config_.model.vits.lexicon.empty()) {
         SHERPA_ONNX_LOGE(
@@ -411,9 +414,12 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     } else if ((meta_data.is_piper || meta_data.is_coqui ||
                 meta_data.is_icefall) &&
                !config_.model.vits.data_dir.empty()) {
-      frontend_ = std::make_unique<PiperPhonemizeLexicon>(
+      auto lexicon = std::make_unique<PiperPhonemizeLexicon>(
           config_.model.vits.tokens, config_.model.vits.data_dir,
           model_->GetMetaData());
+      lexicon->UseWordCache(config_.model.espeak_word_cache,
+                            config_.model.espeak_word_cache_size);
+      frontend_ = std::move(lexicon);
     } else {
       if (config_.model.vits.lexicon.empty()) {
         SHERPA_ONNX_LOGE(
@@ -4,8 +4,13 @@
 
 #include "sherpa-onnx/csrc/offline-tts.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -20,11 +25,13 @@
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
 void OfflineTtsConfig::Register(ParseOptions *po) {
   model.Register(po);
+  cache.Register(po);
 
   po->Register("tts-rule-fsts", &rule_fsts,
                "It not empty, it contains a list of rule FST filenames."
@@ -44,6 +51,17 @@ void OfflineTtsConfig::Register(ParseOptions *po) {
       "Maximum number of sentences that we process at a time. "
       "This is to avoid OOM for very long input text. "
       "If you set it to -1, then we process all sentences in a single batch.");
+
+  po->Register("tts-num-batch-threads", &num_batch_threads,
+               "Number of threads synthesizing requests concurrently in "
+               "OfflineTts::GenerateBatch(). Each of them uses "
+               "--num-threads intra-op threads");
+
+  po->Register("tts-num-sentence-threads", &num_sentence_threads,
+               "Number of groups of --tts-max-num-sentences sentences of one "
+               "text synthesized concurrently. Each of them uses "
+               "--num-threads intra-op threads. The audio is still generated "
+               "in order");
 }
 
 bool OfflineTtsConfig::Validate() const {
@@ -69,6 +87,23 @@ bool OfflineTtsConfig::Validate() const {
     }
   }
 
+  if (num_batch_threads < 1) {
+    SHERPA_ONNX_LOGE("--tts-num-batch-threads should be positive. Given: %d",
+                     num_batch_threads);
+    return false;
+  }
+
+  if (num_sentence_threads < 1) {
+    SHERPA_ONNX_LOGE(
+        "--tts-num-sentence-threads should be positive. Given: %d",
+        num_sentence_threads);
+    return false;
+  }
+
+  if (!cache.Validate()) {
+    return false;
+  }
+
   return model.Validate();
 }
 
@@ -79,30 +114,135 @@ std::string OfflineTtsConfig::ToString() const {
   os << "model=" << model.ToString() << ", ";
   os << "rule_fsts=\"" << rule_fsts << "\", ";
   os << "rule_fars=\"" << rule_fars << "\", ";
-  os << "max_num_sentences=" << max_num_sentences << ")";
+  os << "max_num_sentences=" << max_num_sentences << ", ";
+  os << "num_batch_threads=" << num_batch_threads << ", ";
+  os << "num_sentence_threads=" << num_sentence_threads << ", ";
+  os << "cache=" << cache.ToString() << ")";
+
+  return os.str();
+}
+
+float OfflineTtsCacheStats::TokenCacheHitRate() const {
+  int64_t n = token_cache_hits + token_cache_misses;
+  return n > 0 ? static_cast<float>(token_cache_hits) / n : 0;
+}
+
+float OfflineTtsCacheStats::AudioCacheHitRate() const {
+  int64_t n = audio_cache_hits + audio_cache_misses;
+  return n > 0 ? static_cast<float>(audio_cache_hits) / n : 0;
+}
+
+float OfflineTtsCacheStats::TnCacheHitRate() const {
+  int64_t n = tn_cache_hits + tn_cache_misses;
+  return n > 0 ? static_cast<float>(tn_cache_hits) / n : 0;
+}
+
+std::string OfflineTtsCacheStats::ToString() const {
+  std::ostringstream os;
+
+  os << "OfflineTtsCacheStats(";
+  os << "token_cache_hits=" << token_cache_hits << ", ";
+  os << "token_cache_misses=" << token_cache_misses << ", ";
+  os << "token_cache_hit_rate=" << TokenCacheHitRate() << ", ";
+  os << "audio_cache_hits=" << audio_cache_hits << ", ";
+  os << "audio_cache_misses=" << audio_cache_misses << ", ";
+  os << "audio_cache_hit_rate=" << AudioCacheHitRate() << ", ";
+  os << "audio_cache_entries=" << audio_cache_entries << ", ";
+  os << "audio_cache_bytes=" << audio_cache_bytes << ", ";
+  os << "tn_cache_hits=" << tn_cache_hits << ", ";
+  os << "tn_cache_misses=" << tn_cache_misses << ", ";
+  os << "tn_cache_hit_rate=" << TnCacheHitRate() << ")";
 
   return os.str();
 }
 
 OfflineTts::OfflineTts(const OfflineTtsConfig &config)
-    : impl_(OfflineTtsImpl::Create(config)) {}
+    : impl_(OfflineTtsImpl::Create(config)) {
+  if (config.num_batch_threads > 1) {
+    pool_ = std::make_unique<ThreadPool>(config.num_batch_threads);
+  }
+}
 
 template <typename Manager>
 OfflineTts::OfflineTts(Manager *mgr, const OfflineTtsConfig &config)
-    : impl_(OfflineTtsImpl::Create(mgr, config)) {}
+    : impl_(OfflineTtsImpl::Create(mgr, config)) {
+  if (config.num_batch_threads > 1) {
+    pool_ = std::make_unique<ThreadPool>(config.num_batch_threads);
+  }
+}
 
 OfflineTts::~OfflineTts() = default;
 
 GeneratedAudio OfflineTts::Generate(
     const std::string &text, int64_t sid /*=0*/, float speed /*= 1.0*/,
     GeneratedAudioCallback callback /*= nullptr*/) const {
-  return impl_->Generate(text, sid, speed, std::move(callback));
+  return impl_->GenerateWithCache(text, sid, speed, std::move(callback));
+}
+
+std::vector<GeneratedAudio> OfflineTts::GenerateBatch(
+    const std::vector<std::string> &texts,
+    const std::vector<int64_t> &sids /*= {}*/,
+    const std::vector<float> &speeds /*= {}*/) const {
+  int32_t n = static_cast<int32_t>(texts.size());
+
+  if (sids.size() > 1 && static_cast<int32_t>(sids.size()) != n) {
+    SHERPA_ONNX_LOGE("Number of sids %d does not match number of texts %d",
+                     static_cast<int32_t>(sids.size()), n);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  if (speeds.size() > 1 && static_cast<int32_t>(speeds.size()) != n) {
+    SHERPA_ONNX_LOGE("Number of speeds %d does not match number of texts %d",
+                     static_cast<int32_t>(speeds.size()), n);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  // Start with the longest requests so that a long request submitted last
+  // does not keep a single thread busy after the others have finished
+  std::vector<int32_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&texts](int32_t a, int32_t b) {
+    return texts[a].size() > texts[b].size();
+  });
+
+  std::vector<GeneratedAudio> ans(n);
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(n);
+
+  for (int32_t i : order) {
+    int64_t sid = sids.empty() ? 0 : sids.size() == 1 ? sids[0] : sids[i];
+    float speed =
+        speeds.empty() ? 1.0 : speeds.size() == 1 ? speeds[0] : speeds[i];
+
+    tasks.push_back([this, &texts, &ans, i, sid, speed]() {
+      ans[i] = impl_->GenerateWithCache(texts[i], sid, speed);
+    });
+  }
+
+  if (!pool_) {
+    for (const auto &t : tasks) {
+      t();
+    }
+    return ans;
+  }
+
+  // It returns only after all tasks have finished since they reference
+  // texts and ans, even if some of them throw
+  RunConcurrently(pool_.get(), tasks);
+
+  return ans;
 }
 
 int32_t OfflineTts::SampleRate() const { return impl_->SampleRate(); }
 
 int32_t OfflineTts::NumSpeakers() const { return impl_->NumSpeakers(); }
 
+OfflineTtsCacheStats OfflineTts::GetCacheStats() const {
+  return impl_->GetCacheStats();
+}
+
+bool OfflineTts::SaveCache() const { return impl_->SaveCache(); }
+
 #if __ANDROID_API__ >= 9
 template OfflineTts::OfflineTts(AAssetManager *mgr,
                                 const OfflineTtsConfig &config);
@@ -35,12 +35,12 @@ class OfflineWhisperModel::Impl {
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.whisper.encoder);
+      auto buf = MapModelFile(config.whisper.encoder, &sess_opts_);
       InitEncoder(buf.data(), buf.size());
     }
 
     {
-      auto buf = ReadFile(config.whisper.decoder);
+      auto buf = MapModelFile(config.whisper.decoder, &sess_opts_);
       InitDecoder(buf.data(), buf.size());
     }
   }
@@ -51,12 +51,12 @@ class OfflineWhisperModel::Impl {
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.whisper.encoder);
+      auto buf = MapModelFile(config.whisper.encoder, &sess_opts_);
       InitEncoder(buf.data(), buf.size());
     }
 
     {
-      auto buf = ReadFile(config.whisper.decoder);
+      auto buf = MapModelFile(config.whisper.decoder, &sess_opts_);
       InitDecoder(buf.data(), buf.size());
     }
   }
@@ -230,9 +230,9 @@ class OfflineWhisperModel::Impl {
   bool IsMultiLingual() const { return is_multilingual_; }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length) {
-    encoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitEncoder(const void *model_data, size_t model_data_length) {
+    encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts_);
 
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
@@ -289,9 +289,9 @@ class OfflineWhisperModel::Impl {
     }
   }
 
-  void InitDecoder(void *model_data, size_t model_data_length) {
-    decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitDecoder(const void *model_data, size_t model_data_length) {
+    decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts_);
 
     GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                   &decoder_input_names_ptr_);
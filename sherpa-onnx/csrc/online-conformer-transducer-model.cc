@@ -28,6 +28,7 @@
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/unbind.h"
 
 namespace sherpa_onnx {
@@ -38,20 +39,26 @@ OnlineConformerTransducerModel::OnlineConformerTransducerModel(
       config_(config),
       sess_opts_(GetSessionOptions(config)),
       allocator_{} {
-  {
-    auto buf = ReadFile(config.transducer.encoder);
-    InitEncoder(buf.data(), buf.size());
-  }
-
-  {
-    auto buf = ReadFile(config.transducer.decoder);
-    InitDecoder(buf.data(), buf.size());
-  }
-
-  {
-    auto buf = ReadFile(config.transducer.joiner);
-    InitJoiner(buf.data(), buf.size());
-  }
+  // The models are independent, so they are loaded concurrently. Each
+  // of them uses a copy of the session options since MapModelFile()
+  // modifies them.
+  RunConcurrently({
+      [this, &config]() {
+        auto sess_opts = sess_opts_.Clone();
+        auto buf = MapModelFile(config.transducer.encoder, &sess_opts);
+        InitEncoder(buf.data(), buf.size(), sess_opts);
+      },
+      [this, &config]() {
+        auto sess_opts = sess_opts_.Clone();
+        auto buf = MapModelFile(config.transducer.decoder, &sess_opts);
+        InitDecoder(buf.data(), buf.size(), sess_opts);
+      },
+      [this, &config]() {
+        auto sess_opts = sess_opts_.Clone();
+        auto buf = MapModelFile(config.transducer.joiner, &sess_opts);
+        InitJoiner(buf.data(), buf.size(), sess_opts);
+      }
+  });
 }
 
 template <typename Manager>
@@ -63,24 +70,24 @@ OnlineConformerTransducerModel::OnlineConformerTransducerModel(
       allocator_{} {
   {
     auto buf = ReadFile(mgr, config.transducer.encoder);
-    InitEncoder(buf.data(), buf.size());
+    InitEncoder(buf.data(), buf.size(), sess_opts_);
   }
 
   {
     auto buf = ReadFile(mgr, config.transducer.decoder);
-    InitDecoder(buf.data(), buf.size());
+    InitDecoder(buf.data(), buf.size(), sess_opts_);
   }
 
   {
     auto buf = ReadFile(mgr, config.transducer.joiner);
-    InitJoiner(buf.data(), buf.size());
+    InitJoiner(buf.data(), buf.size(), sess_opts_);
   }
 }
 
-void OnlineConformerTransducerModel::InitEncoder(void *model_data,
-                                                 size_t model_data_length) {
-  encoder_sess_ = std::make_unique<Ort::Session>(env_, model_data,
-                                                 model_data_length, sess_opts_);
+void OnlineConformerTransducerModel::InitEncoder(
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts) {
+  encoder_sess_ = CreateSession(env_, model_data, model_data_length, sess_opts);
 
   GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                 &encoder_input_names_ptr_);
@@ -111,10 +118,10 @@ void OnlineConformerTransducerModel::InitEncoder(void *model_data,
   SHERPA_ONNX_READ_META_DATA(cnn_module_kernel_, "cnn_module_kernel");
 }
 
-void OnlineConformerTransducerModel::InitDecoder(void *model_data,
-                                                 size_t model_data_length) {
-  decoder_sess_ = std::make_unique<Ort::Session>(env_, model_data,
-                                                 model_data_length, sess_opts_);
+void OnlineConformerTransducerModel::InitDecoder(
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts) {
+  decoder_sess_ = CreateSession(env_, model_data, model_data_length, sess_opts);
 
   GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                 &decoder_input_names_ptr_);
@@ -140,10 +147,10 @@ void OnlineConformerTransducerModel::InitDecoder(void *model_data,
   SHERPA_ONNX_READ_META_DATA(context_size_, "context_size");
 }
 
-void OnlineConformerTransducerModel::InitJoiner(void *model_data,
-                                                size_t model_data_length) {
-  joiner_sess_ = std::make_unique<Ort::Session>(env_, model_data,
-                                                model_data_length, sess_opts_);
+void OnlineConformerTransducerModel::InitJoiner(
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts) {
+  joiner_sess_ = CreateSession(env_, model_data, model_data_length, sess_opts);
 
   GetInputNames(joiner_sess_.get(), &joiner_input_names_,
                 &joiner_input_names_ptr_);
@@ -49,9 +49,12 @@ class OnlineConformerTransducerModel : public OnlineTransducerModel {
   OrtAllocator *Allocator() override { return allocator_; }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length);
-  void InitDecoder(void *model_data, size_t model_data_length);
-  void InitJoiner(void *model_data, size_t model_data_length);
+  void InitEncoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts);
+  void InitDecoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts);
+  void InitJoiner(const void *model_data, size_t model_data_length,
+                  const Ort::SessionOptions &sess_opts);
 
  private:
   Ort::Env env_;
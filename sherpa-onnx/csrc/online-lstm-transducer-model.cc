@@ -26,6 +26,7 @@
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/unbind.h"
 
 namespace sherpa_onnx {
@@ -36,20 +37,26 @@ OnlineLstmTransducerModel::OnlineLstmTransducerModel(
       config_(config),
       sess_opts_(GetSessionOptions(config)),
       allocator_{} {
-  {
-    auto buf = ReadFile(config.transducer.encoder);
-    InitEncoder(buf.data(), buf.size());
-  }
-
-  {
-    auto buf = ReadFile(config.transducer.decoder);
-    InitDecoder(buf.data(), buf.size());
-  }
-
-  {
-    auto buf = ReadFile(config.transducer.joiner);
-    InitJoiner(buf.data(), buf.size());
-  }
+  // The models are independent, so they are loaded concurrently. Each
+  // of them uses a copy of the session options since MapModelFile()
+  // modifies them.
+  RunConcurrently({
+      [this, &config]() {
+        auto sess_opts = sess_opts_.Clone();
+        auto buf = MapModelFile(config.transducer.encoder, &sess_opts);
+        InitEncoder(buf.data(), buf.size(), sess_opts);
+      },
+      [this, &config]() {
+        auto sess_opts = sess_opts_.Clone();
+        auto buf = MapModelFile(config.transducer.decoder, &sess_opts);
+        InitDecoder(buf.data(), buf.size(), sess_opts);
+      },
+      [this, &config]() {
+        auto sess_opts = sess_opts_.Clone();
+        auto buf = MapModelFile(config.transducer.joiner, &sess_opts);
+        InitJoiner(buf.data(), buf.size(), sess_opts);
+      }
+  });
 }
 
 template <typename Manager>
@@ -61,24 +68,24 @@ OnlineLstmTransducerModel::OnlineLstmTransducerModel(
       allocator_{} {
   {
     auto buf = ReadFile(mgr, config.transducer.encoder);
-    InitEncoder(buf.data(), buf.size());
+    InitEncoder(buf.data(), buf.size(), sess_opts_);
   }
 
   {
     auto buf = ReadFile(mgr, config.transducer.decoder);
-    InitDecoder(buf.data(), buf.size());
+    InitDecoder(buf.data(), buf.size(), sess_opts_);
   }
 
   {
     auto buf = ReadFile(mgr, config.transducer.joiner);
-    InitJoiner(buf.data(), buf.size());
+    InitJoiner(buf.data(), buf.size(), sess_opts_);
   }
 }
 
-void OnlineLstmTransducerModel::InitEncoder(void *model_data,
-                                            size_t model_data_length) {
-  encoder_sess_ = std::make_unique<Ort::Session>(env_, model_data,
-                                                 model_data_length, sess_opts_);
+void OnlineLstmTransducerModel::InitEncoder(
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts) {
+  encoder_sess_ = CreateSession(env_, model_data, model_data_length, sess_opts);
 
   GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                 &encoder_input_names_ptr_);
@@ -107,10 +114,10 @@ void OnlineLstmTransducerModel::InitEncoder(void *model_data,
   SHERPA_ONNX_READ_META_DATA(d_model_, "d_model");
 }
 
-void OnlineLstmTransducerModel::InitDecoder(void *model_data,
-                                            size_t model_data_length) {
-  decoder_sess_ = std::make_unique<Ort::Session>(env_, model_data,
-                                                 model_data_length, sess_opts_);
+void OnlineLstmTransducerModel::InitDecoder(
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts) {
+  decoder_sess_ = CreateSession(env_, model_data, model_data_length, sess_opts);
 
   GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                 &decoder_input_names_ptr_);
@@ -132,10 +139,10 @@ void OnlineLstmTransducerModel::InitDecoder(void *model_data,
   SHERPA_ONNX_READ_META_DATA(context_size_, "context_size");
 }
 
-void OnlineLstmTransducerModel::InitJoiner(void *model_data,
-                                           size_t model_data_length) {
-  joiner_sess_ = std::make_unique<Ort::Session>(env_, model_data,
-                                                model_data_length, sess_opts_);
+void OnlineLstmTransducerModel::InitJoiner(
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts) {
+  joiner_sess_ = CreateSession(env_, model_data, model_data_length, sess_opts);
 
   GetInputNames(joiner_sess_.get(), &joiner_input_names_,
                 &joiner_input_names_ptr_);
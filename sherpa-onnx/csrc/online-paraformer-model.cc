@@ -32,12 +32,12 @@ class OnlineParaformerModel::Impl {
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.paraformer.encoder);
+      auto buf = MapModelFile(config.paraformer.encoder, &sess_opts_);
       InitEncoder(buf.data(), buf.size());
     }
 
     {
-      auto buf = ReadFile(config.paraformer.decoder);
+      auto buf = MapModelFile(config.paraformer.decoder, &sess_opts_);
       InitDecoder(buf.data(), buf.size());
     }
   }
@@ -111,9 +111,9 @@ class OnlineParaformerModel::Impl {
   OrtAllocator *Allocator() { return allocator_; }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length) {
-    encoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitEncoder(const void *model_data, size_t model_data_length) {
+    encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts_);
 
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
@@ -150,9 +150,9 @@ class OnlineParaformerModel::Impl {
     }
   }
 
-  void InitDecoder(void *model_data, size_t model_data_length) {
-    decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitDecoder(const void *model_data, size_t model_data_length) {
+    decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts_);
 
     GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                   &decoder_input_names_ptr_);
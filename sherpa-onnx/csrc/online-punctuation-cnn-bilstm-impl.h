@@ -8,7 +8,10 @@
 #include <math.h>
 
 #include <algorithm>
+#include <array>
+#include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -67,55 +70,69 @@ class OnlinePunctuationCNNBiLSTMImpl : public OnlinePunctuationImpl {
 
     EncodeSentences(text, tokens_list, valids_list, label_len_list);
 
-    const auto &meta_data = model_.GetModelMetadata();
-
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    std::vector<int32_t> case_pred;
+    std::vector<int32_t> punct_pred;
 
     int32_t n = label_len_list.size();
+    Run(tokens_list.data(), valids_list.data(), label_len_list.data(), n,
+        &case_pred, &punct_pred);
 
-    std::array<int64_t, 2> token_ids_shape = {n, kMaxSeqLen};
-    Ort::Value token_ids = Ort::Value::CreateTensor(
-        memory_info, tokens_list.data(), tokens_list.size(),
-        token_ids_shape.data(), token_ids_shape.size());
+    std::string ans = DecodeSentences(text, case_pred, punct_pred);
 
-    std::array<int64_t, 2> valid_ids_shape = {n, kMaxSeqLen};
-    Ort::Value valid_ids = Ort::Value::CreateTensor(
-        memory_info, valids_list.data(), valids_list.size(),
-        valid_ids_shape.data(), valid_ids_shape.size());
+    return ans;
+  }
 
-    std::array<int64_t, 1> label_len_shape = {n};
-    Ort::Value label_len = Ort::Value::CreateTensor(
-        memory_info, label_len_list.data(), label_len_list.size(),
-        label_len_shape.data(), label_len_shape.size());
+  std::vector<std::string> AddPunctuationWithCaseBatch(
+      const std::vector<std::string> &texts) const override {
+    std::vector<int32_t> tokens_list;     // N * kMaxSeqLen
+    std::vector<int32_t> valids_list;     // N * kMaxSeqLen
+    std::vector<int32_t> label_len_list;  // N
 
-    auto pair = model_.Forward(std::move(token_ids), std::move(valid_ids),
-                               std::move(label_len));
+    // Sentences of all texts are put into the same list
+    for (const auto &text : texts) {
+      if (!text.empty()) {
+        EncodeSentences(text, tokens_list, valids_list, label_len_list);
+      }
+    }
 
     std::vector<int32_t> case_pred;
     std::vector<int32_t> punct_pred;
-    const float *active_case_logits = pair.first.GetTensorData<float>();
-    const float *active_punct_logits = pair.second.GetTensorData<float>();
-    std::vector<int64_t> case_logits_shape =
-        pair.first.GetTensorTypeAndShapeInfo().GetShape();
-
-    for (int32_t i = 0; i < case_logits_shape[0]; ++i) {
-      const float *p_cur_case = active_case_logits + i * meta_data.num_cases;
-      auto index_case = static_cast<int32_t>(std::distance(
-          p_cur_case,
-          std::max_element(p_cur_case, p_cur_case + meta_data.num_cases)));
-      case_pred.push_back(index_case);
 
-      const float *p_cur_punct =
-          active_punct_logits + i * meta_data.num_punctuations;
-      auto index_punct = static_cast<int32_t>(std::distance(
-          p_cur_punct,
-          std::max_element(p_cur_punct,
-                           p_cur_punct + meta_data.num_punctuations)));
-      punct_pred.push_back(index_punct);
+    int32_t n = label_len_list.size();
+    int32_t batch_size = std::max(config_.model.batch_size, 1);
+    for (int32_t i = 0; i < n; i += batch_size) {
+      int32_t this_batch_size = std::min(batch_size, n - i);
+      Run(tokens_list.data() + i * kMaxSeqLen,
+          valids_list.data() + i * kMaxSeqLen, label_len_list.data() + i,
+          this_batch_size, &case_pred, &punct_pred);
     }
 
-    std::string ans = DecodeSentences(text, case_pred, punct_pred);
+    // There is one prediction per word and predictions of all texts are
+    // concatenated
+    std::vector<std::string> ans;
+    ans.reserve(texts.size());
+
+    auto case_begin = case_pred.begin();
+    auto punct_begin = punct_pred.begin();
+
+    for (const auto &text : texts) {
+      if (text.empty()) {
+        ans.emplace_back();
+        continue;
+      }
+
+      std::istringstream iss(text);
+      int32_t num_words = std::distance(std::istream_iterator<std::string>(iss),
+                                        std::istream_iterator<std::string>());
+
+      std::vector<int32_t> this_case_pred(case_begin, case_begin + num_words);
+      std::vector<int32_t> this_punct_pred(punct_begin,
+                                           punct_begin + num_words);
+      case_begin += num_words;
+      punct_begin += num_words;
+
+      ans.push_back(DecodeSentences(text, this_case_pred, this_punct_pred));
+    }
 
     return ans;
   }
@@ -193,6 +210,56 @@ class OnlinePunctuationCNNBiLSTMImpl : public OnlinePunctuationImpl {
     }
   }
 
+  // Run the model on n sentences, each of which has kMaxSeqLen tokens.
+  // Predictions are appended to case_pred and punct_pred.
+  void Run(int32_t *tokens, int32_t *valids, int32_t *label_lens, int32_t n,
+           std::vector<int32_t> *case_pred,
+           std::vector<int32_t> *punct_pred) const {
+    const auto &meta_data = model_.GetModelMetadata();
+
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+    std::array<int64_t, 2> token_ids_shape = {n, kMaxSeqLen};
+    Ort::Value token_ids = Ort::Value::CreateTensor(
+        memory_info, tokens, n * kMaxSeqLen, token_ids_shape.data(),
+        token_ids_shape.size());
+
+    std::array<int64_t, 2> valid_ids_shape = {n, kMaxSeqLen};
+    Ort::Value valid_ids = Ort::Value::CreateTensor(
+        memory_info, valids, n * kMaxSeqLen, valid_ids_shape.data(),
+        valid_ids_shape.size());
+
+    std::array<int64_t, 1> label_len_shape = {n};
+    Ort::Value label_len = Ort::Value::CreateTensor(
+        memory_info, label_lens, n, label_len_shape.data(),
+        label_len_shape.size());
+
+    auto pair = model_.Forward(std::move(token_ids), std::move(valid_ids),
+                               std::move(label_len));
+
+    const float *active_case_logits = pair.first.GetTensorData<float>();
+    const float *active_punct_logits = pair.second.GetTensorData<float>();
+    std::vector<int64_t> case_logits_shape =
+        pair.first.GetTensorTypeAndShapeInfo().GetShape();
+
+    for (int32_t i = 0; i < case_logits_shape[0]; ++i) {
+      const float *p_cur_case = active_case_logits + i * meta_data.num_cases;
+      auto index_case = static_cast<int32_t>(std::distance(
+          p_cur_case,
+          std::max_element(p_cur_case, p_cur_case + meta_data.num_cases)));
+      case_pred->push_back(index_case);
+
+      const float *p_cur_punct =
+          active_punct_logits + i * meta_data.num_punctuations;
+      auto index_punct = static_cast<int32_t>(std::distance(
+          p_cur_punct,
+          std::max_element(p_cur_punct,
+                           p_cur_punct + meta_data.num_punctuations)));
+      punct_pred->push_back(index_punct);
+    }
+  }
+
   std::string DecodeSentences(const std::string &raw_text,
                               const std::vector<int32_t> &case_pred,
                               const std::vector<int32_t> &punct_pred) const {
@@ -30,6 +30,16 @@ class OnlinePunctuationImpl {
 #endif
 
   virtual std::string AddPunctuationWithCase(const std::string &text) const = 0;
+
+  virtual std::vector<std::string> AddPunctuationWithCaseBatch(
+      const std::vector<std::string> &texts) const {
+    std::vector<std::string> ans;
+    ans.reserve(texts.size());
+    for (const auto &text : texts) {
+      ans.push_back(AddPunctuationWithCase(text));
+    }
+    return ans;
+  }
 };
 
 }  // namespace sherpa_onnx
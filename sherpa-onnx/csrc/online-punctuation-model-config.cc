@@ -23,6 +23,10 @@ void OnlinePunctuationModelConfig::Register(ParseOptions *po) {
 
   po->Register("provider", &provider,
                "Specify a provider to use: cpu, cuda, coreml");
+
+  po->Register("batch-size", &batch_size,
+               "Number of sentences processed by the model in a single call "
+               "when punctuating many texts at once");
 }
 
 bool OnlinePunctuationModelConfig::Validate() const {
@@ -46,6 +50,11 @@ bool OnlinePunctuationModelConfig::Validate() const {
     return false;
   }
 
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("batch_size should be > 0. Given %d", batch_size);
+    return false;
+  }
+
   return true;
 }
 
@@ -57,7 +66,8 @@ std::string OnlinePunctuationModelConfig::ToString() const {
   os << "bpe_vocab=\"" << bpe_vocab << "\", ";
   os << "num_threads=" << num_threads << ", ";
   os << "debug=" << (debug ? "True" : "False") << ", ";
-  os << "provider=\"" << provider << "\")";
+  os << "provider=\"" << provider << "\", ";
+  os << "batch_size=" << batch_size << ")";
 
   return os.str();
 }
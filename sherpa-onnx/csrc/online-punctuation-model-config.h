@@ -19,6 +19,10 @@ struct OnlinePunctuationModelConfig {
   bool debug = false;
   std::string provider = "cpu";
 
+  // Number of sentences processed by the model in a single call when
+  // punctuating many texts at once
+  int32_t batch_size = 32;
+
   OnlinePunctuationModelConfig() = default;
 
   OnlinePunctuationModelConfig(const std::string &cnn_bilstm,
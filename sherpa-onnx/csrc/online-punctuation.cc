@@ -49,4 +49,9 @@ std::string OnlinePunctuation::AddPunctuationWithCase(
   return impl_->AddPunctuationWithCase(text);
 }
 
+std::vector<std::string> OnlinePunctuation::AddPunctuationWithCaseBatch(
+    const std::vector<std::string> &texts) const {
+  return impl_->AddPunctuationWithCaseBatch(texts);
+}
+
 }  // namespace sherpa_onnx
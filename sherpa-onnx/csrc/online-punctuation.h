@@ -48,6 +48,12 @@ class OnlinePunctuation {
   // Add punctuation and casing to the input text and return it.
   std::string AddPunctuationWithCase(const std::string &text) const;
 
+  // Like AddPunctuationWithCase() but for many texts at once. Sentences of
+  // all texts are packed into batches of --batch-size so that the model
+  // is run fewer times. ans[i] is the result of texts[i].
+  std::vector<std::string> AddPunctuationWithCaseBatch(
+      const std::vector<std::string> &texts) const;
+
  private:
   std::unique_ptr<OnlinePunctuationImpl> impl_;
 };
@@ -4,8 +4,12 @@
 
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 
+#include <functional>
+#include <memory>
+#include <string>
 #include <strstream>
 #include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -19,29 +23,38 @@
 #include "fst/extensions/far/far.h"
 #include "kaldifst/csrc/kaldi-fst-io.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/mapped-file.h"
+#include "sherpa-onnx/csrc/model-cache.h"
 #include "sherpa-onnx/csrc/online-recognizer-ctc-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer-paraformer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer-transducer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer-transducer-nemo-impl.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/shared-runtime.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
 std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
     const OnlineRecognizerConfig &config) {
-  if (!config.model_config.transducer.encoder.empty()) {
-    Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  if (config.shared_runtime.enabled) {
+    // Before any Ort::Env is created below
+    SharedRuntime::Init(config.shared_runtime);
+  }
 
-    Ort::SessionOptions sess_opts;
-    sess_opts.SetIntraOpNumThreads(1);
-    sess_opts.SetInterOpNumThreads(1);
+  if (config.model_cache.enabled) {
+    SetModelCacheConfig(config.model_cache);
+  }
 
-    auto decoder_model = ReadFile(config.model_config.transducer.decoder);
-    auto sess = std::make_unique<Ort::Session>(env, decoder_model.data(),
-                                               decoder_model.size(), sess_opts);
+  if (!config.model_config.transducer.encoder.empty()) {
+    MappedFile decoder_model(config.model_config.transducer.decoder);
 
-    size_t node_count = sess->GetOutputCount();
+    // The NeMo decoder has more than one output. They are read without
+    // creating a session so that external data is not needed here.
+    size_t node_count =
+        GetOnnxModelInfo(decoder_model.data(), decoder_model.size())
+            .outputs.size();
 
     if (node_count == 1) {
       return std::make_unique<OnlineRecognizerTransducerImpl>(config);
@@ -67,18 +80,23 @@ std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
 template <typename Manager>
 std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
     Manager *mgr, const OnlineRecognizerConfig &config) {
-  if (!config.model_config.transducer.encoder.empty()) {
-    Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  if (config.shared_runtime.enabled) {
+    // Before any Ort::Env is created below
+    SharedRuntime::Init(config.shared_runtime);
+  }
 
-    Ort::SessionOptions sess_opts;
-    sess_opts.SetIntraOpNumThreads(1);
-    sess_opts.SetInterOpNumThreads(1);
+  if (config.model_cache.enabled) {
+    SetModelCacheConfig(config.model_cache);
+  }
 
+  if (!config.model_config.transducer.encoder.empty()) {
     auto decoder_model = ReadFile(mgr, config.model_config.transducer.decoder);
-    auto sess = std::make_unique<Ort::Session>(env, decoder_model.data(),
-                                               decoder_model.size(), sess_opts);
 
-    size_t node_count = sess->GetOutputCount();
+    // The NeMo decoder has more than one output. They are read without
+    // creating a session so that external data is not needed here.
+    size_t node_count =
+        GetOnnxModelInfo(decoder_model.data(), decoder_model.size())
+            .outputs.size();
 
     if (node_count == 1) {
       return std::make_unique<OnlineRecognizerTransducerImpl>(mgr, config);
@@ -103,46 +121,61 @@ std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
 
 OnlineRecognizerImpl::OnlineRecognizerImpl(const OnlineRecognizerConfig &config)
     : config_(config) {
+  std::vector<std::string> fsts;
   if (!config.rule_fsts.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
-    itn_list_.reserve(files.size());
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-      }
-      itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
-    }
+    SplitStringToVector(config.rule_fsts, ",", false, &fsts);
   }
 
+  std::vector<std::string> fars;
   if (!config.rule_fars.empty()) {
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("Loading FST archives");
-    }
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
+    SplitStringToVector(config.rule_fars, ",", false, &fars);
+  }
 
-    itn_list_.reserve(files.size() + itn_list_.size());
+  // The files are loaded concurrently. loaded[i] contains the rules of the
+  // i-th file, so the rules are applied in the given order.
+  std::vector<std::vector<std::unique_ptr<kaldifst::TextNormalizer>>> loaded(
+      fsts.size() + fars.size());
 
-    for (const auto &f : files) {
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(loaded.size());
+
+  for (size_t i = 0; i != fsts.size(); ++i) {
+    tasks.push_back([&config, &fsts, &loaded, i]() {
       if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
+        SHERPA_ONNX_LOGE("rule fst: %s", fsts[i].c_str());
+      }
+      loaded[i].push_back(std::make_unique<kaldifst::TextNormalizer>(fsts[i]));
+    });
+  }
+
+  for (size_t i = 0; i != fars.size(); ++i) {
+    tasks.push_back([&config, &fars, &loaded, i, offset = fsts.size()]() {
+      if (config.model_config.debug) {
+        SHERPA_ONNX_LOGE("rule far: %s", fars[i].c_str());
       }
       std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-          fst::FarReader<fst::StdArc>::Open(f));
+          fst::FarReader<fst::StdArc>::Open(fars[i]));
       for (; !reader->Done(); reader->Next()) {
         std::unique_ptr<fst::StdConstFst> r(
             fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
 
-        itn_list_.push_back(
+        loaded[offset + i].push_back(
             std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
       }
-    }
+    });
+  }
+
+  RunConcurrently(tasks);
 
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("FST archives loaded!");
+  for (auto &rules : loaded) {
+    for (auto &r : rules) {
+      itn_list_.push_back(std::move(r));
     }
   }
+
+  if (!fars.empty() && config.model_config.debug) {
+    SHERPA_ONNX_LOGE("FST archives loaded!");
+  }
 }
 
 template <typename Manager>
@@ -6,9 +6,9 @@
 #define SHERPA_ONNX_CSRC_ONLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 
 #include <algorithm>
+#include <functional>
 #include <ios>
 #include <memory>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <utility>
@@ -25,6 +25,7 @@
 #include "sherpa-onnx/csrc/online-transducer-modified-beam-search-decoder.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/utils.h"
 #include "ssentencepiece/csrc/ssentencepiece.h"
 
@@ -84,37 +85,54 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
   explicit OnlineRecognizerTransducerImpl(const OnlineRecognizerConfig &config)
       : OnlineRecognizerImpl(config),
         config_(config),
-        model_(OnlineTransducerModel::Create(config.model_config)),
         endpoint_(config_.endpoint_config) {
-    if (!config.model_config.tokens_buf.empty()) {
-      sym_ = SymbolTable(config.model_config.tokens_buf, false);
-    } else {
-      /// assuming tokens_buf and tokens are guaranteed not being both empty
-      sym_ = SymbolTable(config.model_config.tokens, true);
+    bool is_modified_beam_search =
+        config.decoding_method == "modified_beam_search";
+
+    // The model, the tokens, the BPE vocabulary and the LM are independent,
+    // so they are loaded concurrently. Hotwords need the tokens and the BPE
+    // vocabulary and are loaded afterwards.
+    std::vector<std::function<void()>> tasks;
+    tasks.push_back([this, &config]() {
+      model_ = OnlineTransducerModel::Create(config.model_config);
+    });
+
+    tasks.push_back([this, &config]() {
+      if (!config.model_config.tokens_buf.empty()) {
+        sym_ = SymbolTable(config.model_config.tokens_buf, false);
+      } else {
+        /// assuming tokens_buf and tokens are guaranteed not being both empty
+        sym_ = SymbolTable(config.model_config.tokens, true);
+      }
+    });
+
+    if (is_modified_beam_search && !config.model_config.bpe_vocab.empty()) {
+      tasks.push_back([this, &config]() {
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
+            config.model_config.bpe_vocab);
+      });
     }
 
+    if (is_modified_beam_search && !config.lm_config.model.empty()) {
+      tasks.push_back(
+          [this, &config]() { lm_ = OnlineLM::Create(config.lm_config); });
+    }
+
+    RunConcurrently(tasks);
+
     if (sym_.Contains("<unk>")) {
       unk_id_ = sym_["<unk>"];
     }
 
     model_->SetFeatureDim(config.feat_config.feature_dim);
 
-    if (config.decoding_method == "modified_beam_search") {
-      if (!config_.model_config.bpe_vocab.empty()) {
-        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
-            config_.model_config.bpe_vocab);
-      }
-
+    if (is_modified_beam_search) {
       if (!config_.hotwords_buf.empty()) {
         InitHotwordsFromBufStr();
       } else if (!config_.hotwords_file.empty()) {
         InitHotwords();
       }
 
-      if (!config_.lm_config.model.empty()) {
-        lm_ = OnlineLM::Create(config.lm_config);
-      }
-
       decoder_ = std::make_unique<OnlineTransducerModifiedBeamSearchDecoder>(
           model_.get(), lm_.get(), config_.max_active_paths,
           config_.lm_config.scale, config_.lm_config.shallow_fusion, unk_id_,
@@ -190,7 +208,8 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
 
   std::unique_ptr<OnlineStream> CreateStream(
       const std::string &hotwords) const override {
-    auto hws = std::regex_replace(hotwords, std::regex("/"), "\n");
+    std::string hws = hotwords;
+    std::replace(hws.begin(), hws.end(), '/', '\n');
     std::istringstream is(hws);
     std::vector<std::vector<int32_t>> current;
     std::vector<float> current_scores;
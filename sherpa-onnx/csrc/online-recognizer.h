@@ -11,12 +11,14 @@
 
 #include "sherpa-onnx/csrc/endpoint.h"
 #include "sherpa-onnx/csrc/features.h"
+#include "sherpa-onnx/csrc/model-cache.h"
 #include "sherpa-onnx/csrc/online-ctc-fst-decoder-config.h"
 #include "sherpa-onnx/csrc/online-lm-config.h"
 #include "sherpa-onnx/csrc/online-model-config.h"
 #include "sherpa-onnx/csrc/online-stream.h"
 #include "sherpa-onnx/csrc/online-transducer-model-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/shared-runtime-config.h"
 
 namespace sherpa_onnx {
 
@@ -101,6 +103,14 @@ struct OnlineRecognizerConfig {
   // If there are multiple FST archives, they are applied from left to right.
   std::string rule_fars;
 
+  // If enabled, all models of the process run on shared onnxruntime
+  // thread pools. See shared-runtime.h
+  SharedRuntimeConfig shared_runtime;
+
+  // If enabled, optimized models are saved and reused by later runs.
+  // See model-cache.h
+  ModelCacheConfig model_cache;
+
   /// used only for modified_beam_search, if hotwords_buf is non-empty,
   /// the hotwords will be loaded from the buffered string instead of from the
   /// "hotwords_file"
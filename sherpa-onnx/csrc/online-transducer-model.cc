@@ -15,10 +15,10 @@
 
 #include <algorithm>
 #include <memory>
-#include <sstream>
 #include <string>
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/mapped-file.h"
 #include "sherpa-onnx/csrc/online-conformer-transducer-model.h"
 #include "sherpa-onnx/csrc/online-lstm-transducer-model.h"
 #include "sherpa-onnx/csrc/online-zipformer-transducer-model.h"
@@ -39,30 +39,20 @@ enum class ModelType : std::uint8_t {
 
 namespace sherpa_onnx {
 
-static ModelType GetModelType(char *model_data, size_t model_data_length,
+static ModelType GetModelType(const char *model_data, size_t model_data_length,
                               bool debug) {
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
-  Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(1);
-  sess_opts.SetInterOpNumThreads(1);
-
-  auto sess = std::make_unique<Ort::Session>(env, model_data, model_data_length,
-                                             sess_opts);
-
-  Ort::ModelMetadata meta_data = sess->GetModelMetadata();
+  // Read the metadata without creating a session so that external data
+  // is not needed here
+  OnnxModelInfo info = GetOnnxModelInfo(model_data, model_data_length);
   if (debug) {
-    std::ostringstream os;
-    PrintModelMetadata(os, meta_data);
 #if __OHOS__
-    SHERPA_ONNX_LOGE("%{public}s", os.str().c_str());
+    SHERPA_ONNX_LOGE("%{public}s", info.ToString().c_str());
 #else
-    SHERPA_ONNX_LOGE("%s", os.str().c_str());
+    SHERPA_ONNX_LOGE("%s", info.ToString().c_str());
 #endif
   }
 
-  Ort::AllocatorWithDefaultOptions allocator;
-  auto model_type =
-      LookupCustomModelMetaData(meta_data, "model_type", allocator);
+  auto model_type = info.LookupMetadata("model_type");
   if (model_type.empty()) {
     SHERPA_ONNX_LOGE(
         "No model_type in the metadata!\n"
@@ -106,7 +96,7 @@ std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
   ModelType model_type = ModelType::kUnknown;
 
   {
-    auto buffer = ReadFile(config.transducer.encoder);
+    MappedFile buffer(config.transducer.encoder);
 
     model_type = GetModelType(buffer.data(), buffer.size(), config.debug);
   }
@@ -30,6 +30,7 @@
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/transpose.h"
 #include "sherpa-onnx/csrc/unbind.h"
 
@@ -42,20 +43,29 @@ class OnlineTransducerNeMoModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    {
-      auto buf = ReadFile(config.transducer.encoder);
-      InitEncoder(buf.data(), buf.size());
-    }
-
-    {
-      auto buf = ReadFile(config.transducer.decoder);
-      InitDecoder(buf.data(), buf.size());
-    }
-
-    {
-      auto buf = ReadFile(config.transducer.joiner);
-      InitJoiner(buf.data(), buf.size());
-    }
+    // The models are independent, so they are loaded concurrently. Each
+    // of them uses a copy of the session options since MapModelFile()
+    // modifies them.
+    RunConcurrently({
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf = MapModelFile(config.transducer.encoder, &sess_opts);
+          InitEncoder(buf.data(), buf.size(), sess_opts);
+        },
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf = MapModelFile(config.transducer.decoder, &sess_opts);
+          InitDecoder(buf.data(), buf.size(), sess_opts);
+        },
+        [this, &config]() {
+          auto sess_opts = sess_opts_.Clone();
+          auto buf = MapModelFile(config.transducer.joiner, &sess_opts);
+          InitJoiner(buf.data(), buf.size(), sess_opts);
+        }
+    });
+
+    // It uses the meta data of the encoder
+    InitDecoderStates();
   }
 
   template <typename Manager>
@@ -66,18 +76,20 @@ class OnlineTransducerNeMoModel::Impl {
         allocator_{} {
     {
       auto buf = ReadFile(mgr, config.transducer.encoder);
-      InitEncoder(buf.data(), buf.size());
+      InitEncoder(buf.data(), buf.size(), sess_opts_);
     }
 
     {
       auto buf = ReadFile(mgr, config.transducer.decoder);
-      InitDecoder(buf.data(), buf.size());
+      InitDecoder(buf.data(), buf.size(), sess_opts_);
     }
 
     {
       auto buf = ReadFile(mgr, config.transducer.joiner);
-      InitJoiner(buf.data(), buf.size());
+      InitJoiner(buf.data(), buf.size(), sess_opts_);
     }
+
+    InitDecoderStates();
   }
 
   std::vector<Ort::Value> RunEncoder(Ort::Value features,
@@ -289,9 +301,10 @@ class OnlineTransducerNeMoModel::Impl {
   }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length) {
-    encoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitEncoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts) {
+    encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts);
 
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
@@ -369,17 +382,16 @@ class OnlineTransducerNeMoModel::Impl {
     cache_last_channel_len_.GetTensorMutableData<int64_t>()[0] = 0;
   }
 
-  void InitDecoder(void *model_data, size_t model_data_length) {
-    decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitDecoder(const void *model_data, size_t model_data_length,
+                   const Ort::SessionOptions &sess_opts) {
+    decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts);
 
     GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                   &decoder_input_names_ptr_);
 
     GetOutputNames(decoder_sess_.get(), &decoder_output_names_,
                    &decoder_output_names_ptr_);
-
-    InitDecoderStates();
   }
 
   void InitDecoderStates() {
@@ -398,9 +410,10 @@ class OnlineTransducerNeMoModel::Impl {
     Fill<float>(&lstm1_, 0);
   }
 
-  void InitJoiner(void *model_data, size_t model_data_length) {
-    joiner_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitJoiner(const void *model_data, size_t model_data_length,
+                  const Ort::SessionOptions &sess_opts) {
+    joiner_sess_ = CreateSession(env_, model_data, model_data_length,
+                                 sess_opts);
 
     GetInputNames(joiner_sess_.get(), &joiner_input_names_,
                   &joiner_input_names_ptr_);
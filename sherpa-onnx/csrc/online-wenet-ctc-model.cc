@@ -32,7 +32,7 @@ class OnlineWenetCtcModel::Impl {
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.wenet_ctc.model);
+      auto buf = MapModelFile(config.wenet_ctc.model, &sess_opts_);
       Init(buf.data(), buf.size());
     }
   }
@@ -129,9 +129,8 @@ class OnlineWenetCtcModel::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
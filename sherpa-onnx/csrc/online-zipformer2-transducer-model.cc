@@ -30,6 +30,7 @@
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/unbind.h"
 
 namespace sherpa_onnx {
@@ -42,20 +43,22 @@ OnlineZipformer2TransducerModel::OnlineZipformer2TransducerModel(
       joiner_sess_opts_(GetSessionOptions(config, "joiner")),
       config_(config),
       allocator_{} {
-  {
-    auto buf = ReadFile(config.transducer.encoder);
-    InitEncoder(buf.data(), buf.size());
-  }
-
-  {
-    auto buf = ReadFile(config.transducer.decoder);
-    InitDecoder(buf.data(), buf.size());
-  }
-
-  {
-    auto buf = ReadFile(config.transducer.joiner);
-    InitJoiner(buf.data(), buf.size());
-  }
+  // The models are independent and each of them has its own session
+  // options, so they are loaded concurrently.
+  RunConcurrently({
+      [this, &config]() {
+        auto buf = MapModelFile(config.transducer.encoder, &encoder_sess_opts_);
+        InitEncoder(buf.data(), buf.size());
+      },
+      [this, &config]() {
+        auto buf = MapModelFile(config.transducer.decoder, &decoder_sess_opts_);
+        InitDecoder(buf.data(), buf.size());
+      },
+      [this, &config]() {
+        auto buf = MapModelFile(config.transducer.joiner, &joiner_sess_opts_);
+        InitJoiner(buf.data(), buf.size());
+      }
+  });
 }
 
 template <typename Manager>
@@ -83,10 +86,10 @@ OnlineZipformer2TransducerModel::OnlineZipformer2TransducerModel(
   }
 }
 
-void OnlineZipformer2TransducerModel::InitEncoder(void *model_data,
+void OnlineZipformer2TransducerModel::InitEncoder(const void *model_data,
                                                   size_t model_data_length) {
-  encoder_sess_ = std::make_unique<Ort::Session>(
-      env_, model_data, model_data_length, encoder_sess_opts_);
+  encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                encoder_sess_opts_);
 
   GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                 &encoder_input_names_ptr_);
@@ -150,10 +153,10 @@ void OnlineZipformer2TransducerModel::InitEncoder(void *model_data,
   }
 }
 
-void OnlineZipformer2TransducerModel::InitDecoder(void *model_data,
+void OnlineZipformer2TransducerModel::InitDecoder(const void *model_data,
                                                   size_t model_data_length) {
-  decoder_sess_ = std::make_unique<Ort::Session>(
-      env_, model_data, model_data_length, decoder_sess_opts_);
+  decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                decoder_sess_opts_);
 
   GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                 &decoder_input_names_ptr_);
@@ -175,10 +178,10 @@ void OnlineZipformer2TransducerModel::InitDecoder(void *model_data,
   SHERPA_ONNX_READ_META_DATA(context_size_, "context_size");
 }
 
-void OnlineZipformer2TransducerModel::InitJoiner(void *model_data,
+void OnlineZipformer2TransducerModel::InitJoiner(const void *model_data,
                                                  size_t model_data_length) {
-  joiner_sess_ = std::make_unique<Ort::Session>(
-      env_, model_data, model_data_length, joiner_sess_opts_);
+  joiner_sess_ = CreateSession(env_, model_data, model_data_length,
+                               joiner_sess_opts_);
 
   GetInputNames(joiner_sess_.get(), &joiner_input_names_,
                 &joiner_input_names_ptr_);
@@ -53,9 +53,9 @@ class OnlineZipformer2TransducerModel : public OnlineTransducerModel {
   OrtAllocator *Allocator() override { return allocator_; }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length);
-  void InitDecoder(void *model_data, size_t model_data_length);
-  void InitJoiner(void *model_data, size_t model_data_length);
+  void InitEncoder(const void *model_data, size_t model_data_length);
+  void InitDecoder(const void *model_data, size_t model_data_length);
+  void InitJoiner(const void *model_data, size_t model_data_length);
 
  private:
   Ort::Env env_;
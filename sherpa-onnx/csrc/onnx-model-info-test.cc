@@ -0,0 +1,117 @@
+// sherpa-onnx/csrc/onnx-model-info-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/onnx-model-info.h"
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+// Encoders for the protobuf wire format
+static std::string Varint(uint64_t v) {
+  std::string ans;
+  while (v >= 0x80) {
+    ans.push_back(static_cast<char>((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+  ans.push_back(static_cast<char>(v));
+  return ans;
+}
+
+static std::string VarintField(uint32_t field, uint64_t v) {
+  return Varint(field << 3) + Varint(v);
+}
+
+static std::string BytesField(uint32_t field, const std::string &s) {
+  return Varint((field << 3) | 2) + Varint(s.size()) + s;
+}
+
+static std::string MetadataProp(const std::string &key,
+                                const std::string &value) {
+  return BytesField(14, BytesField(1, key) + BytesField(2, value));
+}
+
+// A ModelProto with a node, a large initializer, two outputs and
+// metadata. Fields of other wire types are included so that they are
+// skipped.
+static std::string CreateModel() {
+  std::string node = BytesField(1, "x") + BytesField(2, "y") +
+                     BytesField(4, "Relu");
+
+  std::string initializer = VarintField(1, 2) + VarintField(2, 1) +
+                            BytesField(8, "w") +
+                            BytesField(9, std::string(100000, '\x3f'));
+
+  std::string value_info_type = BytesField(1, VarintField(1, 1));
+
+  std::string graph = BytesField(1, node) + BytesField(2, "main") +
+                      BytesField(5, initializer) +
+                      BytesField(11, BytesField(1, "x") + value_info_type) +
+                      BytesField(12, BytesField(1, "logits")) +
+                      BytesField(12, value_info_type + BytesField(1, "state"));
+
+  // fixed32 and fixed64 fields that are not in onnx.proto
+  std::string unknown = Varint((100 << 3) | 5) + std::string(4, '\0') +
+                        Varint((101 << 3) | 1) + std::string(8, '\0');
+
+  return VarintField(1, 8) + BytesField(2, "pytorch") +
+         BytesField(8, VarintField(2, 17)) + BytesField(7, graph) + unknown +
+         MetadataProp("model_type", "zipformer2") +
+         MetadataProp("vocab_size", "500") +
+         MetadataProp("model_type", "zipformer2_ctc");
+}
+
+TEST(OnnxModelInfo, Parse) {
+  std::string model = CreateModel();
+
+  OnnxModelInfo info;
+  ASSERT_TRUE(ParseOnnxModelInfo(model.data(), model.size(), &info));
+
+  ASSERT_EQ(info.outputs.size(), 2);
+  EXPECT_EQ(info.outputs[0], "logits");
+  EXPECT_EQ(info.outputs[1], "state");
+
+  ASSERT_EQ(info.metadata.size(), 3);
+  EXPECT_EQ(info.LookupMetadata("vocab_size"), "500");
+
+  // The last value of a duplicated key is used
+  EXPECT_EQ(info.LookupMetadata("model_type"), "zipformer2_ctc");
+  EXPECT_EQ(info.LookupMetadata("not_exist"), "");
+
+  EXPECT_EQ(info.ToString(),
+            "model_type=zipformer2\nvocab_size=500\n"
+            "model_type=zipformer2_ctc\n");
+}
+
+TEST(OnnxModelInfo, Invalid) {
+  OnnxModelInfo info;
+  EXPECT_FALSE(ParseOnnxModelInfo("", 0, &info));
+
+  // The ORT format
+  std::string ort = std::string(4, '\x14') + "ORTM" + std::string(16, '\0');
+  EXPECT_FALSE(ParseOnnxModelInfo(ort.data(), ort.size(), &info));
+
+  // No graph
+  std::string model = VarintField(1, 8) + MetadataProp("model_type", "a");
+  EXPECT_FALSE(ParseOnnxModelInfo(model.data(), model.size(), &info));
+
+  // Truncated inside the graph and inside the metadata
+  model = CreateModel();
+  for (size_t n : {size_t(5), model.size() / 2, model.size() - 3}) {
+    EXPECT_FALSE(ParseOnnxModelInfo(model.data(), n, &info)) << n;
+  }
+
+  // A length past the end
+  model = VarintField(1, 8) + Varint((7 << 3) | 2) + Varint(1000) + "abc";
+  EXPECT_FALSE(ParseOnnxModelInfo(model.data(), model.size(), &info));
+
+  // A varint that does not end
+  model = VarintField(1, 8) + std::string(12, '\xff');
+  EXPECT_FALSE(ParseOnnxModelInfo(model.data(), model.size(), &info));
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,268 @@
+// sherpa-onnx/csrc/onnx-model-info.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/onnx-model-info.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+namespace {
+
+// Field numbers in onnx.proto
+constexpr uint32_t kModelIrVersion = 1;
+constexpr uint32_t kModelGraph = 7;
+constexpr uint32_t kModelMetadataProps = 14;
+constexpr uint32_t kGraphOutput = 12;
+constexpr uint32_t kValueInfoName = 1;
+constexpr uint32_t kStringEntryKey = 1;
+constexpr uint32_t kStringEntryValue = 2;
+
+// Wire types of the protobuf encoding
+constexpr uint32_t kVarint = 0;
+constexpr uint32_t kFixed64 = 1;
+constexpr uint32_t kLengthDelimited = 2;
+constexpr uint32_t kFixed32 = 5;
+
+// It reads the fields of a protobuf message one by one. All methods
+// return false if the message is malformed.
+class ProtoReader {
+ public:
+  ProtoReader(const char *data, size_t size)
+      : p_(reinterpret_cast<const uint8_t *>(data)), end_(p_ + size) {}
+
+  bool Done() const { return p_ == end_; }
+
+  bool ReadTag(uint32_t *field, uint32_t *wire_type) {
+    uint64_t tag = 0;
+    if (!ReadVarint(&tag) || (tag >> 3) == 0 || (tag >> 3) > UINT32_MAX) {
+      return false;
+    }
+
+    *field = static_cast<uint32_t>(tag >> 3);
+    *wire_type = static_cast<uint32_t>(tag & 7);
+    return true;
+  }
+
+  bool ReadVarint(uint64_t *value) {
+    *value = 0;
+    for (int32_t shift = 0; shift < 64 && p_ != end_; shift += 7) {
+      uint8_t b = *p_++;
+      *value |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool ReadBytes(const char **data, size_t *size) {
+    uint64_t n = 0;
+    if (!ReadVarint(&n) || n > static_cast<uint64_t>(end_ - p_)) {
+      return false;
+    }
+
+    *data = reinterpret_cast<const char *>(p_);
+    *size = static_cast<size_t>(n);
+    p_ += n;
+    return true;
+  }
+
+  bool ReadString(std::string *s) {
+    const char *data = nullptr;
+    size_t size = 0;
+    if (!ReadBytes(&data, &size)) {
+      return false;
+    }
+
+    s->assign(data, size);
+    return true;
+  }
+
+  bool Skip(uint32_t wire_type) {
+    switch (wire_type) {
+      case kVarint: {
+        uint64_t v = 0;
+        return ReadVarint(&v);
+      }
+      case kFixed64:
+        return Advance(8);
+      case kLengthDelimited: {
+        const char *data = nullptr;
+        size_t size = 0;
+        return ReadBytes(&data, &size);
+      }
+      case kFixed32:
+        return Advance(4);
+      default:
+        // Groups are not used in onnx.proto
+        return false;
+    }
+  }
+
+ private:
+  bool Advance(size_t n) {
+    if (n > static_cast<size_t>(end_ - p_)) {
+      return false;
+    }
+
+    p_ += n;
+    return true;
+  }
+
+ private:
+  const uint8_t *p_;
+  const uint8_t *end_;
+};
+
+bool ParseStringEntry(const char *data, size_t size,
+                      std::pair<std::string, std::string> *entry) {
+  ProtoReader r(data, size);
+  while (!r.Done()) {
+    uint32_t field = 0;
+    uint32_t wire_type = 0;
+    if (!r.ReadTag(&field, &wire_type)) {
+      return false;
+    }
+
+    bool ok = false;
+    if (field == kStringEntryKey && wire_type == kLengthDelimited) {
+      ok = r.ReadString(&entry->first);
+    } else if (field == kStringEntryValue && wire_type == kLengthDelimited) {
+      ok = r.ReadString(&entry->second);
+    } else {
+      ok = r.Skip(wire_type);
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ParseValueInfoName(const char *data, size_t size, std::string *name) {
+  ProtoReader r(data, size);
+  while (!r.Done()) {
+    uint32_t field = 0;
+    uint32_t wire_type = 0;
+    if (!r.ReadTag(&field, &wire_type)) {
+      return false;
+    }
+
+    bool ok = (field == kValueInfoName && wire_type == kLengthDelimited)
+                  ? r.ReadString(name)
+                  : r.Skip(wire_type);
+    if (!ok) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Nodes and initializers are skipped by their length
+bool ParseGraphOutputs(const char *data, size_t size,
+                       std::vector<std::string> *outputs) {
+  ProtoReader r(data, size);
+  while (!r.Done()) {
+    uint32_t field = 0;
+    uint32_t wire_type = 0;
+    if (!r.ReadTag(&field, &wire_type)) {
+      return false;
+    }
+
+    if (field == kGraphOutput && wire_type == kLengthDelimited) {
+      const char *p = nullptr;
+      size_t n = 0;
+      std::string name;
+      if (!r.ReadBytes(&p, &n) || !ParseValueInfoName(p, n, &name)) {
+        return false;
+      }
+
+      outputs->push_back(std::move(name));
+    } else if (!r.Skip(wire_type)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+std::string OnnxModelInfo::LookupMetadata(const std::string &key) const {
+  // onnxruntime keeps the last value of a duplicated key
+  for (auto it = metadata.rbegin(); it != metadata.rend(); ++it) {
+    if (it->first == key) {
+      return it->second;
+    }
+  }
+
+  return {};
+}
+
+std::string OnnxModelInfo::ToString() const {
+  std::ostringstream os;
+  for (const auto &p : metadata) {
+    os << p.first << "=" << p.second << "\n";
+  }
+
+  return os.str();
+}
+
+bool ParseOnnxModelInfo(const char *data, size_t size, OnnxModelInfo *info) {
+  OnnxModelInfo ans;
+  bool has_ir_version = false;
+  bool has_graph = false;
+
+  ProtoReader r(data, size);
+  while (!r.Done()) {
+    uint32_t field = 0;
+    uint32_t wire_type = 0;
+    if (!r.ReadTag(&field, &wire_type)) {
+      return false;
+    }
+
+    bool ok = false;
+    if (field == kModelIrVersion && wire_type == kVarint) {
+      uint64_t v = 0;
+      ok = r.ReadVarint(&v);
+      has_ir_version = true;
+    } else if (field == kModelGraph && wire_type == kLengthDelimited) {
+      const char *p = nullptr;
+      size_t n = 0;
+      ok = r.ReadBytes(&p, &n) && ParseGraphOutputs(p, n, &ans.outputs);
+      has_graph = true;
+    } else if (field == kModelMetadataProps &&
+               wire_type == kLengthDelimited) {
+      const char *p = nullptr;
+      size_t n = 0;
+      std::pair<std::string, std::string> entry;
+      ok = r.ReadBytes(&p, &n) && ParseStringEntry(p, n, &entry);
+      ans.metadata.push_back(std::move(entry));
+    } else {
+      ok = r.Skip(wire_type);
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  if (!has_ir_version || !has_graph) {
+    return false;
+  }
+
+  *info = std::move(ans);
+  return true;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,47 @@
+// sherpa-onnx/csrc/onnx-model-info.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_ONNX_MODEL_INFO_H_
+#define SHERPA_ONNX_CSRC_ONNX_MODEL_INFO_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Information used to find the type of a model before loading it
+struct OnnxModelInfo {
+  // Custom metadata, i.e., ModelProto.metadata_props, in file order
+  std::vector<std::pair<std::string, std::string>> metadata;
+
+  // Names of the outputs of the main graph
+  std::vector<std::string> outputs;
+
+  // Return the value of the given key in metadata. Return an empty string
+  // if it does not exist.
+  std::string LookupMetadata(const std::string &key) const;
+
+  // Return the metadata as lines of key=value
+  std::string ToString() const;
+};
+
+/** Read OnnxModelInfo from a model in the ONNX format.
+ *
+ * It decodes only the fields it needs from the protobuf and skips the
+ * others by their length, so the weights are never read and no session is
+ * created. Weights saved as external data are not needed either.
+ *
+ * @param data The content of an .onnx file.
+ * @param size Number of bytes of data.
+ * @param info On return, it contains the information of the model.
+ * @return Return false if data is not a valid ONNX model, e.g., if it is
+ *         a model in the ORT format.
+ */
+bool ParseOnnxModelInfo(const char *data, size_t size, OnnxModelInfo *info);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONNX_MODEL_INFO_H_
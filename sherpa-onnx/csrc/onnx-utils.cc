@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/model-cache.h"
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -130,6 +131,48 @@ void PrintModelMetadata(std::ostream &os, const Ort::ModelMetadata &meta_data) {
 #endif
 }
 
+OnnxModelInfo GetOnnxModelInfo(const char *model_data,
+                               size_t model_data_length) {
+  OnnxModelInfo ans;
+  if (!IsOrtFormatModel(model_data, model_data_length) &&
+      ParseOnnxModelInfo(model_data, model_data_length, &ans)) {
+    return ans;
+  }
+
+  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  Ort::SessionOptions sess_opts;
+  sess_opts.SetIntraOpNumThreads(1);
+  sess_opts.SetInterOpNumThreads(1);
+
+  Ort::Session sess(env, model_data, model_data_length, sess_opts);
+
+  Ort::ModelMetadata meta_data = sess.GetModelMetadata();
+  Ort::AllocatorWithDefaultOptions allocator;
+#if ORT_API_VERSION >= 12
+  std::vector<Ort::AllocatedStringPtr> v =
+      meta_data.GetCustomMetadataMapKeysAllocated(allocator);
+  for (const auto &key : v) {
+    auto p = meta_data.LookupCustomMetadataMapAllocated(key.get(), allocator);
+    ans.metadata.emplace_back(key.get(), p.get());
+  }
+#else
+  int64_t num_keys = 0;
+  char **keys = meta_data.GetCustomMetadataMapKeys(allocator, num_keys);
+  for (int32_t i = 0; i < num_keys; ++i) {
+    ans.metadata.emplace_back(
+        keys[i], LookupCustomModelMetaData(meta_data, keys[i], allocator));
+    allocator.Free(keys[i]);
+  }
+
+  allocator.Free(keys);
+#endif
+
+  std::vector<const char *> output_names_ptr;
+  GetOutputNames(&sess, &ans.outputs, &output_names_ptr);
+
+  return ans;
+}
+
 Ort::Value Clone(OrtAllocator *allocator, const Ort::Value *v) {
   auto type_and_shape = v->GetTensorTypeAndShapeInfo();
   std::vector<int64_t> shape = type_and_shape.GetShape();
@@ -317,7 +360,7 @@ std::vector<char> ReadFile(AAssetManager *mgr, const std::string &filename) {
   if (!asset) {
     __android_log_print(ANDROID_LOG_FATAL, "sherpa-onnx",
                         "Read binary file: Load %s failed", filename.c_str());
-    exit(-1);
+    SHERPA_ONNX_EXIT(-1);
   }
 
   auto p = reinterpret_cast<const char *>(AAsset_getBuffer(asset));
@@ -27,6 +27,7 @@
 #endif
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/onnx-model-info.h"
 
 namespace sherpa_onnx {
 
@@ -69,6 +70,16 @@ std::string LookupCustomModelMetaData(const Ort::ModelMetadata &meta_data,
 void PrintModelMetadata(std::ostream &os,
                         const Ort::ModelMetadata &meta_data);  // NOLINT
 
+/** Return the metadata and the output names of a model to find its type.
+ *
+ * For a model in the ONNX format, they are read by ParseOnnxModelInfo()
+ * without creating a session, so the probe does not depend on where
+ * external data is and does not load the weights. For other models, e.g.,
+ * in the ORT format, a session is created from model_data.
+ */
+OnnxModelInfo GetOnnxModelInfo(const char *model_data,
+                               size_t model_data_length);
+
 // Return a deep copy of v
 Ort::Value Clone(OrtAllocator *allocator, const Ort::Value *v);
 
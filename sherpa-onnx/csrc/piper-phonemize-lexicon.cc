@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/csrc/piper-phonemize-lexicon.h"
 
+#include <cctype>
 #include <codecvt>
 #include <fstream>
 #include <locale>
@@ -29,6 +30,7 @@
 #include "phonemize.hpp"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
 
@@ -44,6 +46,52 @@ static void CallPhonemizeEspeak(
   piper::phonemize_eSpeak(text, config, *phonemes);
 }
 
+static std::u32string PhonemizeWordLocked(const std::string &word,
+                                          const std::string &voice) {
+  piper::eSpeakPhonemeConfig config;
+  config.voice = voice;
+
+  std::vector<std::vector<piper::Phoneme>> phonemes;
+  CallPhonemizeEspeak(word, config, &phonemes);
+
+  std::u32string ans;
+  for (const auto &p : phonemes) {
+    ans.append(p.begin(), p.end());
+  }
+
+  // Remove punctuations and spaces added by piper::phonemize_eSpeak() at
+  // the end of a clause
+  const char32_t *kTrimmed = U" .,;:!?";
+  size_t begin = ans.find_first_not_of(kTrimmed);
+  if (begin == std::u32string::npos) {
+    return {};
+  }
+
+  size_t end = ans.find_last_not_of(kTrimmed);
+  return ans.substr(begin, end + 1 - begin);
+}
+
+// Punctuations after which piper::phonemize_eSpeak() ends a sentence
+static bool IsSentencePunctuation(char c) {
+  return c == '.' || c == '!' || c == '?';
+}
+
+// Return true if only the first byte is an uppercase ASCII letter, e.g.,
+// for a word starting a sentence
+static bool IsCapitalized(const std::string &word) {
+  if (word.empty() || !std::isupper(static_cast<unsigned char>(word[0]))) {
+    return false;
+  }
+
+  for (size_t i = 1; i < word.size(); ++i) {
+    if (std::isupper(static_cast<unsigned char>(word[i]))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 static std::unordered_map<char32_t, int32_t> ReadTokens(std::istream &is) {
   std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> conv;
   std::unordered_map<char32_t, int32_t> token2id;
@@ -228,6 +276,13 @@ static void InitEspeak(const std::string &data_dir) {
   });
 }
 
+std::u32string PhonemizeWordWithEspeak(const std::string &data_dir,
+                                       const std::string &word,
+                                       const std::string &voice) {
+  InitEspeak(data_dir);
+  return PhonemizeWordLocked(word, voice);
+}
+
 PiperPhonemizeLexicon::PiperPhonemizeLexicon(
     const std::string &tokens, const std::string &data_dir,
     const OfflineTtsVitsModelMetaData &vits_meta_data)
@@ -295,8 +350,31 @@ std::vector<TokenIDs> PiperPhonemizeLexicon::ConvertTextToTokenIds(
   }
 }
 
-std::vector<TokenIDs> PiperPhonemizeLexicon::ConvertTextToTokenIdsMatcha(
-    const std::string &text, const std::string &voice /*= ""*/) const {
+void PiperPhonemizeLexicon::UseWordCache(const std::string &filename,
+                                         int32_t max_num_words) {
+  if (filename.empty() && max_num_words <= 0) {
+    return;
+  }
+
+  use_word_cache_ = true;
+
+  if (!filename.empty()) {
+    word_cache_ = std::make_unique<WordPhonemeCache>(filename);
+  }
+
+  if (max_num_words > 0) {
+    espeak_word_cache_ =
+        std::make_unique<LruCache<std::string, std::u32string>>(
+            max_num_words);
+  }
+}
+
+std::vector<std::vector<char32_t>> PiperPhonemizeLexicon::Phonemize(
+    const std::string &text, const std::string &voice) const {
+  if (use_word_cache_) {
+    return PhonemizeByWords(text, voice);
+  }
+
   piper::eSpeakPhonemeConfig config;
 
   // ./bin/espeak-ng-bin --path  ./install/share/espeak-ng-data/ --voices
@@ -307,6 +385,89 @@ std::vector<TokenIDs> PiperPhonemizeLexicon::ConvertTextToTokenIdsMatcha(
 
   CallPhonemizeEspeak(text, config, &phonemes);
 
+  return phonemes;
+}
+
+// It follows piper::phonemize_eSpeak(): words are separated by spaces and
+// a clause ends with its punctuation, which is followed by a space unless
+// it also ends the sentence.
+std::vector<std::vector<char32_t>> PiperPhonemizeLexicon::PhonemizeByWords(
+    const std::string &text, const std::string &voice) const {
+  std::vector<std::vector<char32_t>> ans;
+  std::vector<char32_t> sentence;
+  bool need_space = false;
+
+  std::istringstream is(text);
+  std::string token;
+  std::string word;
+  while (is >> token) {
+    char punct = SplitWordAndPunctuation(token, &word);
+
+    if (!word.empty()) {
+      std::u32string p = PhonemizeWord(word, voice);
+      if (!p.empty()) {
+        if (need_space) {
+          sentence.push_back(U' ');
+        }
+
+        sentence.insert(sentence.end(), p.begin(), p.end());
+        need_space = true;
+      }
+    }
+
+    if (punct && !sentence.empty()) {
+      sentence.push_back(punct);
+      if (IsSentencePunctuation(punct)) {
+        ans.push_back(std::move(sentence));
+        sentence.clear();
+      } else {
+        sentence.push_back(U' ');
+      }
+      need_space = false;
+    }
+  }
+
+  if (!sentence.empty()) {
+    ans.push_back(std::move(sentence));
+  }
+
+  return ans;
+}
+
+std::u32string PiperPhonemizeLexicon::PhonemizeWord(
+    const std::string &word, const std::string &voice) const {
+  std::u32string ans;
+  if (word_cache_) {
+    if (word_cache_->Lookup(word, &ans)) {
+      return ans;
+    }
+
+    if (IsCapitalized(word) && word_cache_->Lookup(ToLowerCase(word), &ans)) {
+      return ans;
+    }
+  }
+
+  std::string key = voice;
+  key.push_back('\0');
+  key.append(word);
+
+  if (espeak_word_cache_ && espeak_word_cache_->Get(key, &ans)) {
+    return ans;
+  }
+
+  ans = PhonemizeWordLocked(word, voice);
+
+  if (espeak_word_cache_) {
+    espeak_word_cache_->Put(key, ans);
+  }
+
+  return ans;
+}
+
+std::vector<TokenIDs> PiperPhonemizeLexicon::ConvertTextToTokenIdsMatcha(
+    const std::string &text, const std::string &voice /*= ""*/) const {
+  std::vector<std::vector<piper::Phoneme>> phonemes = Phonemize(text, voice);
+
   std::vector<TokenIDs> ans;
 
   std::vector<int64_t> phoneme_ids;
@@ -322,15 +483,7 @@ std::vector<TokenIDs> PiperPhonemizeLexicon::ConvertTextToTokenIdsMatcha(
 
 std::vector<TokenIDs> PiperPhonemizeLexicon::ConvertTextToTokenIdsVits(
     const std::string &text, const std::string &voice /*= ""*/) const {
-  piper::eSpeakPhonemeConfig config;
-
-  // ./bin/espeak-ng-bin --path  ./install/share/espeak-ng-data/ --voices
-  // to list available voices
-  config.voice = voice;  // e.g., voice is en-us
-
-  std::vector<std::vector<piper::Phoneme>> phonemes;
-
-  CallPhonemizeEspeak(text, config, &phonemes);
+  std::vector<std::vector<piper::Phoneme>> phonemes = Phonemize(text, voice);
 
   std::vector<TokenIDs> ans;
 
@@ -5,16 +5,26 @@
 #ifndef SHERPA_ONNX_CSRC_PIPER_PHONEMIZE_LEXICON_H_
 #define SHERPA_ONNX_CSRC_PIPER_PHONEMIZE_LEXICON_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "sherpa-onnx/csrc/lru-cache.h"
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-matcha-model-metadata.h"
 #include "sherpa-onnx/csrc/offline-tts-vits-model-metadata.h"
+#include "sherpa-onnx/csrc/word-phoneme-cache.h"
 
 namespace sherpa_onnx {
 
+// Phonemes of a single word from espeak-ng, without punctuations and
+// spaces at the ends. data_dir is the espeak-ng-data directory.
+// It is used to build the word cache of PiperPhonemizeLexicon.
+std::u32string PhonemizeWordWithEspeak(const std::string &data_dir,
+                                       const std::string &word,
+                                       const std::string &voice);
+
 class PiperPhonemizeLexicon : public OfflineTtsFrontend {
  public:
   PiperPhonemizeLexicon(const std::string &tokens, const std::string &data_dir,
@@ -36,6 +46,25 @@ class PiperPhonemizeLexicon : public OfflineTtsFrontend {
   std::vector<TokenIDs> ConvertTextToTokenIds(
       const std::string &text, const std::string &voice = "") const override;
 
+  /* Phonemize text word by word instead of calling espeak-ng on the whole
+   * text.
+   *
+   * espeak-ng has global state, so calls into it are serialized by a
+   * mutex. With word caches, espeak-ng is called only for words missing
+   * from the caches and requests in different threads phonemize
+   * concurrently. Since each word is phonemized on its own, context
+   * dependent pronunciations across words are lost.
+   *
+   * @param filename If not empty, a file saved by WordPhonemeCache::Save()
+   *                 with words phonemized by PhonemizeWordWithEspeak() for
+   *                 the voice of the model.
+   * @param max_num_words Maximum number of words not in the file that are
+   *                      cached after phonemizing them with espeak-ng.
+   *
+   * It does nothing if filename is empty and max_num_words is 0.
+   */
+  void UseWordCache(const std::string &filename, int32_t max_num_words);
+
  private:
   std::vector<TokenIDs> ConvertTextToTokenIdsVits(
       const std::string &text, const std::string &voice = "") const;
@@ -43,7 +72,23 @@ class PiperPhonemizeLexicon : public OfflineTtsFrontend {
   std::vector<TokenIDs> ConvertTextToTokenIdsMatcha(
       const std::string &text, const std::string &voice = "") const;
 
+  // Phonemes of each sentence of the text
+  std::vector<std::vector<char32_t>> Phonemize(const std::string &text,
+                                               const std::string &voice) const;
+
+  std::vector<std::vector<char32_t>> PhonemizeByWords(
+      const std::string &text, const std::string &voice) const;
+
+  std::u32string PhonemizeWord(const std::string &word,
+                               const std::string &voice) const;
+
  private:
+  bool use_word_cache_ = false;
+  std::unique_ptr<WordPhonemeCache> word_cache_;
+
+  // Words phonemized by espeak-ng. The key is the voice and the word.
+  std::unique_ptr<LruCache<std::string, std::u32string>> espeak_word_cache_;
+
   // map unicode codepoint to an integer ID
   std::unordered_map<char32_t, int32_t> token2id_;
   OfflineTtsVitsModelMetaData vits_meta_data_;
@@ -5,12 +5,28 @@
 #include "sherpa-onnx/csrc/session.h"
 
 #include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/model-cache.h"
 #include "sherpa-onnx/csrc/provider.h"
+#include "sherpa-onnx/csrc/shared-runtime.h"
 #if defined(__APPLE__)
 #include "coreml_provider_factory.h"  // NOLINT
 #endif
@@ -25,6 +41,17 @@
 
 namespace sherpa_onnx {
 
+// Entries of the session config used by the model cache. onnxruntime
+// ignores config entries it does not know.
+static constexpr const char *kModelCacheOptionsKey =
+    "sherpa_onnx.model_cache.options";
+static constexpr const char *kModelCachePathKey =
+    "sherpa_onnx.model_cache.path";
+static constexpr const char *kModelCacheTmpPathKey =
+    "sherpa_onnx.model_cache.tmp_path";
+static constexpr const char *kModelCacheStampPathKey =
+    "sherpa_onnx.model_cache.stamp_path";
+
 static void OrtStatusFailure(OrtStatus *status, const char *s) {
   const auto &api = Ort::GetApi();
   const char *msg = api.GetErrorMessage(status);
@@ -45,6 +72,15 @@ Ort::SessionOptions GetSessionOptionsImpl(
 
   sess_opts.SetInterOpNumThreads(num_threads);
 
+  // Optimized graphs containing nodes assigned to other providers cannot
+  // always be saved, so the model cache is used only for the cpu provider.
+  if (p == Provider::kCPU && GetModelCacheConfig().enabled) {
+    std::ostringstream key;
+    key << "provider=" << provider_str << ";num_threads=" << num_threads
+        << ";onnxruntime=" << OrtGetApiBase()->GetVersionString();
+    sess_opts.AddConfigEntry(kModelCacheOptionsKey, key.str().c_str());
+  }
+
   std::vector<std::string> available_providers = Ort::GetAvailableProviders();
   std::ostringstream os;
   for (const auto &ep : available_providers) {
@@ -80,7 +116,7 @@ Ort::SessionOptions GetSessionOptionsImpl(
         SHERPA_ONNX_LOGE(
             "Tensorrt support for Online models ony,"
             "Must be extended for offline and others");
-        exit(1);
+        SHERPA_ONNX_EXIT(1);
       }
       auto trt_config = provider_config->trt_config;
       struct TrtPairs {
@@ -278,4 +314,352 @@ Ort::SessionOptions GetSessionOptions(int32_t num_threads,
   return GetSessionOptionsImpl(num_threads, provider_str);
 }
 
+#if defined(_WIN32)
+// Model paths are UTF-8
+static std::wstring ToOrtPath(const std::string &s) {
+  int32_t n = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, nullptr, 0);
+  if (n <= 0) {
+    SHERPA_ONNX_LOGE("Invalid UTF-8 path: %s", s.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  std::wstring ans(n, L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, &ans[0], n);
+  ans.resize(n - 1);  // Remove the trailing 0
+  return ans;
+}
+#else
+static const std::string &ToOrtPath(const std::string &s) { return s; }
+#endif
+
+// A file that is removed when the object is destroyed
+class TempFile {
+ public:
+  TempFile() = default;
+  explicit TempFile(std::string filename) : filename_(std::move(filename)) {}
+
+  ~TempFile() {
+    if (!filename_.empty()) {
+      std::remove(filename_.c_str());
+    }
+  }
+
+  TempFile(const TempFile &) = delete;
+  TempFile &operator=(const TempFile &) = delete;
+
+  TempFile(TempFile &&other) noexcept : filename_(std::move(other.filename_)) {
+    other.filename_.clear();
+  }
+
+  TempFile &operator=(TempFile &&other) noexcept {
+    std::swap(filename_, other.filename_);
+    return *this;
+  }
+
+ private:
+  std::string filename_;
+};
+
+struct ModelFile::State {
+  std::string filename;
+  MappedFile file;
+  bool ort_format = false;
+
+  // The optimized model is saved into it while creating the session. It
+  // has been renamed by CommitCachedModel() if the session was created
+  // successfully; otherwise it is removed together with the ModelFile.
+  TempFile tmp;
+};
+
+const char *ModelFile::data() const {
+  return state_ ? state_->file.data() : nullptr;
+}
+
+size_t ModelFile::size() const { return state_ ? state_->file.size() : 0; }
+
+static std::mutex g_model_files_mutex;
+
+// Model files returned by MapModelFile(). CreateSession() finds the file of
+// a model by the address of its data as long as the ModelFile is alive.
+static std::vector<std::weak_ptr<const ModelFile::State>> g_model_files;
+
+// Models in the ORT format. Sessions use their bytes in place, so they are
+// never released. The key contains the filename, the size and the
+// modification time.
+static std::unordered_map<std::string,
+                          std::shared_ptr<const ModelFile::State>>
+    g_ort_models;
+
+static ModelFile OpenModelFile(const std::string &filename,
+                               TempFile tmp = TempFile()) {
+  int64_t size = 0;
+  int64_t mtime = 0;
+  GetFileSizeAndMtime(filename, &size, &mtime);
+
+  std::ostringstream os;
+  os << filename << ":" << size << ":" << mtime;
+  std::string key = os.str();
+
+  std::lock_guard<std::mutex> lock(g_model_files_mutex);
+
+  auto it = g_ort_models.find(key);
+  if (it != g_ort_models.end()) {
+    return ModelFile(it->second);
+  }
+
+  auto state = std::make_shared<ModelFile::State>();
+  state->filename = filename;
+  state->file = MappedFile(filename);
+  state->ort_format =
+      IsOrtFormatModel(state->file.data(), state->file.size());
+  state->tmp = std::move(tmp);
+
+  if (state->file.empty()) {
+    return ModelFile(std::move(state));
+  }
+
+  if (state->ort_format) {
+    g_ort_models[key] = state;
+  }
+
+  g_model_files.erase(
+      std::remove_if(g_model_files.begin(), g_model_files.end(),
+                     [](const std::weak_ptr<const ModelFile::State> &p) {
+                       return p.expired();
+                     }),
+      g_model_files.end());
+
+  g_model_files.push_back(state);
+
+  return ModelFile(std::move(state));
+}
+
+static std::shared_ptr<const ModelFile::State> FindModelFile(
+    const void *model_data, size_t model_data_length) {
+  if (model_data == nullptr) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(g_model_files_mutex);
+  for (const auto &p : g_model_files) {
+    auto state = p.lock();
+    if (state && state->file.data() == model_data &&
+        state->file.size() == model_data_length) {
+      return state;
+    }
+  }
+
+  return nullptr;
+}
+
+static bool IsValidCachedModel(const std::string &path) {
+  if (path.empty() || !FileExists(path)) {
+    return false;
+  }
+
+  MappedFile cached(path);
+  if (!IsOrtFormatModel(cached.data(), cached.size())) {
+    SHERPA_ONNX_LOGE("Ignore invalid cached model '%s'", path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+// The options set by MapCachedModelFile() are overwritten on each call
+// since a session options object is often reused for several models.
+//
+// Return the path of the model to load. It is the cached model if it
+// exists; otherwise it is filename and the optimized model is saved into
+// tmp_file while creating the session.
+static std::string MapCachedModelFile(const std::string &filename,
+                                      Ort::SessionOptions *sess_opts,
+                                      TempFile *tmp_file) {
+  int64_t size = 0;
+  int64_t mtime = 0;
+  if (!GetFileSizeAndMtime(filename, &size, &mtime)) {
+    return filename;
+  }
+
+  auto cache_config = GetModelCacheConfig();
+  std::string options = sess_opts->GetConfigEntry(kModelCacheOptionsKey);
+
+  sess_opts->AddConfigEntry(kModelCachePathKey, "");
+  sess_opts->AddConfigEntry(kModelCacheTmpPathKey, "");
+  sess_opts->AddConfigEntry(kModelCacheStampPathKey, "");
+  sess_opts->SetOptimizedModelFilePath(ToOrtPath("").c_str());
+
+  // Look up the stamp first so that the model is not hashed on every
+  // start. The stamp changes if the model is modified.
+  std::string stamp =
+      GetModelStampPath(cache_config, filename, size, mtime, options);
+  std::string path = ReadModelStamp(stamp);
+  bool found = IsValidCachedModel(path);
+
+  if (!found) {
+    MappedFile model(filename);
+    path = GetOptimizedModelPath(cache_config, filename, model.data(),
+                                 model.size(), options);
+
+    found = IsValidCachedModel(path);
+    if (found) {
+      WriteModelStamp(stamp, path);
+    }
+  }
+
+  if (found) {
+    // All optimizations have been applied before it was saved
+    sess_opts->AddConfigEntry("session.load_model_format", "ORT");
+    sess_opts->SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+    return path;
+  }
+
+  sess_opts->AddConfigEntry("session.load_model_format", "ONNX");
+  sess_opts->SetGraphOptimizationLevel(ORT_ENABLE_ALL);
+
+  // onnxruntime writes the optimized model while creating the session.
+  // Write it to a temporary file first so that other processes never see
+  // an incomplete file. See CreateSession().
+  std::ostringstream os;
+  os << path << ".tmp"
+     << std::hash<std::thread::id>()(std::this_thread::get_id())
+     << std::chrono::steady_clock::now().time_since_epoch().count();
+  std::string tmp = os.str();
+
+  // Removed if creating the session fails
+  TempFile guard(tmp);
+
+  if (!std::ofstream(tmp).good()) {
+    SHERPA_ONNX_LOGE("Cannot write '%s'. Skip caching the optimized model",
+                     tmp.c_str());
+    return filename;
+  }
+
+  sess_opts->AddConfigEntry("session.save_model_format", "ORT");
+  sess_opts->SetOptimizedModelFilePath(ToOrtPath(tmp).c_str());
+  sess_opts->AddConfigEntry(kModelCachePathKey, path.c_str());
+  sess_opts->AddConfigEntry(kModelCacheTmpPathKey, tmp.c_str());
+  sess_opts->AddConfigEntry(kModelCacheStampPathKey, stamp.c_str());
+
+  *tmp_file = std::move(guard);
+
+  return filename;
+}
+
+// Move the optimized model saved while creating a session to its final
+// place in the cache
+static void CommitCachedModel(const Ort::SessionOptions &sess_opts) {
+  if (!sess_opts.HasConfigEntry(kModelCacheTmpPathKey)) {
+    return;
+  }
+
+  std::string tmp = sess_opts.GetConfigEntry(kModelCacheTmpPathKey);
+  if (tmp.empty()) {
+    return;
+  }
+
+  std::string path = sess_opts.GetConfigEntry(kModelCachePathKey);
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    // e.g., another process has just saved it on Windows
+    std::remove(tmp.c_str());
+  }
+
+  if (FileExists(path)) {
+    WriteModelStamp(sess_opts.GetConfigEntry(kModelCacheStampPathKey), path);
+  }
+}
+
+ModelFile MapModelFile(const std::string &filename,
+                       Ort::SessionOptions *sess_opts) {
+  if (!sess_opts->HasConfigEntry(kModelCacheOptionsKey)) {
+    return OpenModelFile(filename);
+  }
+
+  TempFile tmp;
+  std::string path = MapCachedModelFile(filename, sess_opts, &tmp);
+
+  return OpenModelFile(path, std::move(tmp));
+}
+
+// If model is not nullptr, the session is created from model->filename for
+// the ONNX format, or from model_data in place for the ORT format.
+static std::unique_ptr<Ort::Session> NewSession(
+    const Ort::Env &env, const void *model_data, size_t model_data_length,
+    const ModelFile::State *model, const Ort::SessionOptions &sess_opts,
+    OrtPrepackedWeightsContainer *prepacked_weights) {
+  if (model && !model->ort_format) {
+    auto path = ToOrtPath(model->filename);
+    if (prepacked_weights) {
+      return std::make_unique<Ort::Session>(env, path.c_str(), sess_opts,
+                                            prepacked_weights);
+    }
+
+    return std::make_unique<Ort::Session>(env, path.c_str(), sess_opts);
+  }
+
+  if (model) {
+    // The bytes of the model are kept until the process exits. See
+    // OpenModelFile().
+    Ort::SessionOptions opts = sess_opts.Clone();
+    opts.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+    opts.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+
+    return NewSession(env, model_data, model_data_length, nullptr, opts,
+                      prepacked_weights);
+  }
+
+  if (prepacked_weights) {
+    return std::make_unique<Ort::Session>(env, model_data, model_data_length,
+                                          sess_opts, prepacked_weights);
+  }
+
+  return std::make_unique<Ort::Session>(env, model_data, model_data_length,
+                                        sess_opts);
+}
+
+std::unique_ptr<Ort::Session> CreateSession(
+    Ort::Env &env,  // NOLINT
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts) {
+  auto model = FindModelFile(model_data, model_data_length);
+
+  SharedRuntime *runtime = SharedRuntime::Get();
+  if (!runtime) {
+    auto sess = NewSession(env, model_data, model_data_length, model.get(),
+                           sess_opts, nullptr);
+    CommitCachedModel(sess_opts);
+    return sess;
+  }
+
+  OrtPrepackedWeightsContainer *prepacked_weights =
+      runtime->GetPrepackedWeightsContainer();
+
+  Ort::SessionOptions opts = sess_opts.Clone();
+  opts.DisablePerSessionThreads();
+  opts.AddConfigEntry("session.use_env_allocators", "1");
+
+  try {
+    auto sess = NewSession(runtime->GetEnv(), model_data, model_data_length,
+                           model.get(), opts, prepacked_weights);
+    CommitCachedModel(sess_opts);
+    return sess;
+  } catch (const Ort::Exception &e) {
+    // The env has been created before SharedRuntime::Init() and has no
+    // global thread pools.
+    static std::once_flag flag;
+    std::call_once(flag, [&e]() {
+      SHERPA_ONNX_LOGE(
+          "Failed to use the shared thread pools: %s. Please call "
+          "SharedRuntime::Init() before loading any model. Use "
+          "per-session thread pools",
+          e.what());
+    });
+  }
+
+  auto sess = NewSession(runtime->GetEnv(), model_data, model_data_length,
+                         model.get(), sess_opts, prepacked_weights);
+  CommitCachedModel(sess_opts);
+  return sess;
+}
+
 }  // namespace sherpa_onnx
@@ -5,9 +5,12 @@
 #ifndef SHERPA_ONNX_CSRC_SESSION_H_
 #define SHERPA_ONNX_CSRC_SESSION_H_
 
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/mapped-file.h"
 #include "sherpa-onnx/csrc/offline-lm-config.h"
 #include "sherpa-onnx/csrc/online-lm-config.h"
 #include "sherpa-onnx/csrc/online-model-config.h"
@@ -34,6 +37,66 @@ Ort::SessionOptions GetSessionOptions(const T &config) {
   return GetSessionOptionsImpl(config.num_threads, config.provider);
 }
 
+/** A model file returned by MapModelFile().
+ *
+ * Pass data() and size() to CreateSession(), which recognizes them and
+ * loads the model in the way described in MapModelFile().
+ */
+class ModelFile {
+ public:
+  struct State;
+
+  ModelFile() = default;
+  explicit ModelFile(std::shared_ptr<const State> state)
+      : state_(std::move(state)) {}
+
+  const char *data() const;
+  size_t size() const;
+
+ private:
+  std::shared_ptr<const State> state_;
+};
+
+/** Open a model file for creating a session from it with CreateSession().
+ *
+ * No private copy of the model is made, so the peak memory while loading
+ * is no longer twice the model size.
+ *
+ *  - A model in the ONNX format is loaded by onnxruntime from its path.
+ *    Weights saved as external data next to the .onnx file are thus
+ *    found relative to it. onnxruntime copies the weights of such
+ *    models into each session.
+ *  - A model in the ORT format, e.g., one saved by the model cache (see
+ *    model-cache.h) or converted by onnxruntime's convert_onnx_models_to_ort,
+ *    is memory-mapped and onnxruntime uses its initializers in place.
+ *    The weights are thus shared by all sessions of the file and by all
+ *    processes through the page cache. The mapping is kept until the
+ *    process exits since sessions refer to it.
+ *
+ * @param filename Path to the model.
+ * @param sess_opts The options that will be used to create the session.
+ */
+ModelFile MapModelFile(const std::string &filename,
+                       Ort::SessionOptions *sess_opts);
+
+/** Create a session from a model in memory.
+ *
+ * If model_data is the data() of a ModelFile returned by MapModelFile()
+ * and still alive, the model is loaded as described in MapModelFile().
+ *
+ * If SharedRuntime::Init() has been called (see shared-runtime.h), the
+ * session runs on the shared thread pools, allocates from the shared arena
+ * and shares its prepacked weights with other sessions of the same model.
+ * Otherwise, it is the same as
+ *
+ *    std::make_unique<Ort::Session>(env, model_data, model_data_length,
+ *                                   sess_opts);
+ */
+std::unique_ptr<Ort::Session> CreateSession(
+    Ort::Env &env,  // NOLINT
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &sess_opts);
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_SESSION_H_
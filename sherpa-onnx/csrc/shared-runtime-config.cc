@@ -0,0 +1,69 @@
+// sherpa-onnx/csrc/shared-runtime-config.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/shared-runtime-config.h"
+
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void SharedRuntimeConfig::Register(ParseOptions *po) {
+  po->Register("shared-runtime", &enabled,
+               "true to run all models of this process on a single set of "
+               "onnxruntime thread pools instead of creating thread pools "
+               "for each model. Identical weights of different sessions are "
+               "also shared.");
+
+  po->Register("shared-runtime-intra-op-threads", &intra_op_num_threads,
+               "Number of threads of the shared intra-op thread pool. "
+               "0 means to use the number of physical cores. Used only when "
+               "--shared-runtime is true.");
+
+  po->Register("shared-runtime-inter-op-threads", &inter_op_num_threads,
+               "Number of threads of the shared inter-op thread pool. Used "
+               "only when --shared-runtime is true.");
+
+  po->Register("shared-runtime-allow-spinning", &allow_spinning,
+               "false to let idle threads of the shared thread pools sleep "
+               "instead of spinning. Used only when --shared-runtime is true.");
+}
+
+bool SharedRuntimeConfig::Validate() const {
+  if (!enabled) {
+    return true;
+  }
+
+  if (intra_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE(
+        "--shared-runtime-intra-op-threads should be >= 0. Given: %d",
+        intra_op_num_threads);
+    return false;
+  }
+
+  if (inter_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE(
+        "--shared-runtime-inter-op-threads should be >= 0. Given: %d",
+        inter_op_num_threads);
+    return false;
+  }
+
+  return true;
+}
+
+std::string SharedRuntimeConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "SharedRuntimeConfig(";
+  os << "enabled=" << (enabled ? "True" : "False") << ", ";
+  os << "intra_op_num_threads=" << intra_op_num_threads << ", ";
+  os << "inter_op_num_threads=" << inter_op_num_threads << ", ";
+  os << "allow_spinning=" << (allow_spinning ? "True" : "False") << ")";
+
+  return os.str();
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,47 @@
+// sherpa-onnx/csrc/shared-runtime-config.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_SHARED_RUNTIME_CONFIG_H_
+#define SHERPA_ONNX_CSRC_SHARED_RUNTIME_CONFIG_H_
+
+#include <string>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+struct SharedRuntimeConfig {
+  // true to run all sessions of this process on a single set of
+  // onnxruntime thread pools
+  bool enabled = false;
+
+  // Number of threads of the global intra-op thread pool.
+  // 0 means to use the number of physical cores.
+  int32_t intra_op_num_threads = 0;
+
+  // Number of threads of the global inter-op thread pool
+  int32_t inter_op_num_threads = 1;
+
+  // false to let idle threads sleep instead of spinning. It reduces the
+  // CPU usage when many small models share the pools.
+  bool allow_spinning = true;
+
+  SharedRuntimeConfig() = default;
+
+  SharedRuntimeConfig(bool enabled, int32_t intra_op_num_threads,
+                      int32_t inter_op_num_threads, bool allow_spinning)
+      : enabled(enabled),
+        intra_op_num_threads(intra_op_num_threads),
+        inter_op_num_threads(inter_op_num_threads),
+        allow_spinning(allow_spinning) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_SHARED_RUNTIME_CONFIG_H_
@@ -0,0 +1,48 @@
+// sherpa-onnx/csrc/shared-runtime.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/shared-runtime.h"
+
+#include <mutex>  // NOLINT
+
+namespace sherpa_onnx {
+
+static Ort::Env CreateEnv(const SharedRuntimeConfig &config) {
+  Ort::ThreadingOptions tp_options;
+  tp_options.SetGlobalIntraOpNumThreads(config.intra_op_num_threads);
+  tp_options.SetGlobalInterOpNumThreads(config.inter_op_num_threads);
+  tp_options.SetGlobalSpinControl(config.allow_spinning ? 1 : 0);
+
+  return Ort::Env(tp_options, ORT_LOGGING_LEVEL_ERROR, "sherpa-onnx");
+}
+
+static std::mutex g_runtime_mutex;
+static SharedRuntime *g_runtime = nullptr;
+
+SharedRuntime::SharedRuntime(const SharedRuntimeConfig &config)
+    : config_(config), env_(CreateEnv(config)) {
+  // Sessions opt into it with "session.use_env_allocators"
+  Ort::MemoryInfo mem_info =
+      Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::ArenaCfg arena_cfg(0, -1, -1, -1);  // use the defaults
+  env_.CreateAndRegisterAllocator(mem_info, arena_cfg);
+}
+
+void SharedRuntime::Init(const SharedRuntimeConfig &config) {
+  std::lock_guard<std::mutex> lock(g_runtime_mutex);
+  if (g_runtime) {
+    return;
+  }
+
+  // It is never freed since sessions may be destroyed during static
+  // destruction and they need the env and the prepacked weights.
+  g_runtime = new SharedRuntime(config);
+}
+
+SharedRuntime *SharedRuntime::Get() {
+  std::lock_guard<std::mutex> lock(g_runtime_mutex);
+  return g_runtime;
+}
+
+}  // namespace sherpa_onnx
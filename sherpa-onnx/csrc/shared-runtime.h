@@ -0,0 +1,57 @@
+// sherpa-onnx/csrc/shared-runtime.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_SHARED_RUNTIME_H_
+#define SHERPA_ONNX_CSRC_SHARED_RUNTIME_H_
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/shared-runtime-config.h"
+
+namespace sherpa_onnx {
+
+/** Process-wide onnxruntime resources shared by all sessions.
+ *
+ * It owns
+ *   - an Ort::Env with global intra-op and inter-op thread pools. Sessions
+ *     created by CreateSession() (see session.h) disable their per-session
+ *     thread pools and run on the global ones instead;
+ *   - a CPU arena allocator registered with the env, shared by all sessions;
+ *   - a PrepackedWeightsContainer, so that sessions whose weights are
+ *     identical (e.g., the same model loaded twice) share the prepacked
+ *     weights instead of keeping a copy each.
+ *
+ * onnxruntime uses a single env per process and applies the thread pool
+ * options only when the env is created for the first time. Therefore
+ * Init() should be called before any model is loaded. If it is called
+ * later, CreateSession() falls back to per-session thread pools but still
+ * shares the prepacked weights.
+ */
+class SharedRuntime {
+ public:
+  // Create the runtime. Calls after the first one are ignored.
+  static void Init(const SharedRuntimeConfig &config);
+
+  // Return nullptr if Init() has not been called
+  static SharedRuntime *Get();
+
+  const SharedRuntimeConfig &GetConfig() const { return config_; }
+
+  Ort::Env &GetEnv() { return env_; }
+
+  Ort::PrepackedWeightsContainer &GetPrepackedWeightsContainer() {
+    return prepacked_weights_;
+  }
+
+ private:
+  explicit SharedRuntime(const SharedRuntimeConfig &config);
+
+ private:
+  SharedRuntimeConfig config_;
+  Ort::Env env_;
+  Ort::PrepackedWeightsContainer prepacked_weights_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_SHARED_RUNTIME_H_
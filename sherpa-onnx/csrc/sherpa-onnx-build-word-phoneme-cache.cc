@@ -0,0 +1,94 @@
+// sherpa-onnx/csrc/sherpa-onnx-build-word-phoneme-cache.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/piper-phonemize-lexicon.h"
+#include "sherpa-onnx/csrc/word-phoneme-cache.h"
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Build a word phoneme cache for TTS models using espeak-ng, e.g., piper
+models. Pass it to --espeak-word-cache of sherpa-onnx-offline-tts so that
+espeak-ng is called only for words not in the cache.
+
+Usage example:
+
+./bin/sherpa-onnx-build-word-phoneme-cache \
+ --espeak-data-dir=./vits-piper-en_US-amy-low/espeak-ng-data \
+ --voice=en-us \
+ --words=./words.txt \
+ --output=./word-phonemes.bin
+
+where words.txt contains one word per line. The voice must match the
+voice of the model, which you can find in its meta data.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  std::string data_dir;
+  std::string voice = "en-us";
+  std::string words_filename;
+  std::string output;
+
+  po.Register("espeak-data-dir", &data_dir,
+              "Path to the directory espeak-ng-data");
+
+  po.Register("voice", &voice, "The espeak-ng voice of the model");
+
+  po.Register("words", &words_filename,
+              "Path to a text file containing one word per line");
+
+  po.Register("output", &output, "Path to save the word phoneme cache");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 0 || data_dir.empty() || words_filename.empty() ||
+      output.empty()) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::ifstream is(words_filename);
+  if (!is) {
+    fprintf(stderr, "Failed to open '%s'\n", words_filename.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> words;
+
+  std::string word;
+  while (is >> word) {
+    words.push_back(word);
+  }
+
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+
+  std::vector<std::pair<std::string, std::u32string>> entries;
+  entries.reserve(words.size());
+  for (auto &w : words) {
+    auto phonemes = sherpa_onnx::PhonemizeWordWithEspeak(data_dir, w, voice);
+    if (phonemes.empty()) {
+      fprintf(stderr, "Skip '%s' since it has no phonemes\n", w.c_str());
+      continue;
+    }
+
+    entries.emplace_back(std::move(w), std::move(phonemes));
+  }
+
+  int32_t num_words = entries.size();
+  if (!sherpa_onnx::WordPhonemeCache::Save(output, std::move(entries))) {
+    fprintf(stderr, "Failed to save '%s'\n", output.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "Saved %d words to %s\n", num_words, output.c_str());
+
+  return 0;
+}
@@ -0,0 +1,206 @@
+// sherpa-onnx/csrc/sherpa-onnx-clustering-benchmark.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sherpa-onnx/csrc/fast-clustering.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+// Generate rows in turns of turn_length rows of the same speaker, like the
+// embeddings of a recording in speaker diarization.
+static std::vector<float> Generate(int32_t num_rows, int32_t dim,
+                                   int32_t num_speakers, int32_t turn_length,
+                                   float noise,
+                                   std::vector<int32_t> *speakers) {
+  std::mt19937 gen(0);
+  std::normal_distribution<float> normal;
+  std::uniform_int_distribution<int32_t> pick(0, num_speakers - 1);
+
+  std::vector<float> centers(num_speakers * dim);
+  for (auto &f : centers) {
+    f = normal(gen);
+  }
+
+  std::vector<float> ans(static_cast<size_t>(num_rows) * dim);
+  speakers->resize(num_rows);
+
+  int32_t s = 0;
+  for (int32_t i = 0; i != num_rows; ++i) {
+    if (i % turn_length == 0) {
+      s = pick(gen);
+    }
+
+    (*speakers)[i] = s;
+    for (int32_t d = 0; d != dim; ++d) {
+      ans[static_cast<size_t>(i) * dim + d] =
+          centers[s * dim + d] + noise * normal(gen);
+    }
+  }
+
+  return ans;
+}
+
+// Fraction of rows whose label maps to their speaker under the best
+// one-to-one mapping found greedily from the most frequent pairs
+static float Accuracy(const std::vector<int32_t> &labels,
+                      const std::vector<int32_t> &speakers) {
+  std::unordered_map<int64_t, int32_t> count;
+  for (size_t i = 0; i != labels.size(); ++i) {
+    count[(static_cast<int64_t>(labels[i]) << 32) | speakers[i]] += 1;
+  }
+
+  std::vector<std::pair<int32_t, int64_t>> pairs;
+  pairs.reserve(count.size());
+  for (const auto &p : count) {
+    pairs.emplace_back(p.second, p.first);
+  }
+  std::sort(pairs.rbegin(), pairs.rend());
+
+  std::unordered_map<int32_t, bool> used_label;
+  std::unordered_map<int32_t, bool> used_speaker;
+  int64_t correct = 0;
+  for (const auto &p : pairs) {
+    int32_t label = p.second >> 32;
+    int32_t speaker = p.second & 0xffffffff;
+    if (used_label[label] || used_speaker[speaker]) {
+      continue;
+    }
+
+    used_label[label] = true;
+    used_speaker[speaker] = true;
+    correct += p.first;
+  }
+
+  return static_cast<float>(correct) / labels.size();
+}
+
+static std::vector<int32_t> ParseNumRows(const std::string &s) {
+  std::vector<int32_t> ans;
+  std::istringstream is(s);
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    ans.push_back(atoi(item.c_str()));
+  }
+
+  return ans;
+}
+
+static void Run(const sherpa_onnx::FastClusteringConfig &config,
+                const std::string &name, const std::vector<float> &features,
+                int32_t num_rows, int32_t dim,
+                const std::vector<int32_t> &speakers) {
+  // Cluster() normalizes the input in-place
+  std::vector<float> f = features;
+
+  sherpa_onnx::FastClustering clustering(config);
+
+  const auto begin = std::chrono::steady_clock::now();
+  std::vector<int32_t> labels = clustering.Cluster(f.data(), num_rows, dim);
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  int32_t num_clusters = *std::max_element(labels.begin(), labels.end()) + 1;
+
+  fprintf(stderr, "%8d %-10s %10.3f %12d %10.4f\n", num_rows, name.c_str(),
+          elapsed_seconds, num_clusters, Accuracy(labels, speakers));
+}
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Benchmark FastClustering on synthetic speaker embeddings.
+
+For each number of rows, it clusters the same input twice: once in a single
+stage with all pairwise distances (if they fit into --single-stage-max-memory)
+and once with the given clustering options. It prints the elapsed time, the
+memory of the pairwise distances of the single stage, the number of clusters
+and the accuracy against the generated speakers.
+
+Usage:
+
+./bin/sherpa-onnx-clustering-benchmark \
+  --num-rows=1000,5000,10000,20000,50000 \
+  --dim=192 \
+  --num-speakers=8 \
+  --cluster-threshold=0.5 \
+  --cluster-max-memory=512
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::FastClusteringConfig config;
+  config.Register(&po);
+
+  std::string num_rows_str = "1000,5000,10000";
+  int32_t dim = 192;
+  int32_t num_speakers = 8;
+  int32_t turn_length = 20;
+  float noise = 0.05;
+  int32_t single_stage_max_memory_mb = 4096;
+
+  po.Register("num-rows", &num_rows_str,
+              "Comma separated list of the number of rows to benchmark");
+  po.Register("dim", &dim, "Dimension of each row");
+  po.Register("num-speakers", &num_speakers, "Number of speakers");
+  po.Register("turn-length", &turn_length,
+              "Number of consecutive rows of the same speaker");
+  po.Register("noise", &noise, "Standard deviation of the noise of a row");
+  po.Register("single-stage-max-memory", &single_stage_max_memory_mb,
+              "Skip single-stage clustering if its pairwise distances need "
+              "more memory in MB than this value");
+
+  po.Read(argc, argv);
+  if (po.NumArgs() != 0) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  sherpa_onnx::FastClusteringConfig single_stage_config = config;
+  single_stage_config.block_size = 0;
+  single_stage_config.max_memory_mb = 0;
+
+  fprintf(stderr, "%8s %-10s %10s %12s %10s\n", "rows", "mode", "seconds",
+          "num_clusters", "accuracy");
+
+  for (int32_t num_rows : ParseNumRows(num_rows_str)) {
+    std::vector<int32_t> speakers;
+    std::vector<float> features =
+        Generate(num_rows, dim, num_speakers, turn_length, noise, &speakers);
+
+    double distance_mb =
+        static_cast<double>(num_rows) * (num_rows - 1) / 2 * sizeof(double) /
+        (1024 * 1024);
+
+    if (distance_mb <= single_stage_max_memory_mb) {
+      Run(single_stage_config, "single", features, num_rows, dim, speakers);
+    } else {
+      fprintf(stderr, "%8d %-10s skipped: it needs %.0f MB\n", num_rows,
+              "single", distance_mb);
+    }
+
+    Run(config, "configured", features, num_rows, dim, speakers);
+
+    fprintf(stderr, "%8d distances of a single stage: %.1f MB\n", num_rows,
+            distance_mb);
+  }
+
+  return 0;
+}
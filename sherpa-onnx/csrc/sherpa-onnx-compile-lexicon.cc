@@ -0,0 +1,63 @@
+// sherpa-onnx/csrc/sherpa-onnx-compile-lexicon.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include <fstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/binary-lexicon.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Compile lexicon.txt of a TTS model into a binary lexicon, which loads much
+faster, uses less memory and can be shared by processes via mmap.
+
+Usage example:
+
+./bin/sherpa-onnx-compile-lexicon \
+  ./vits-icefall-zh-aishell3/lexicon.txt \
+  ./vits-icefall-zh-aishell3/lexicon.bin
+
+For MeloTTS models, whose lexicons also contain tones, use
+
+./bin/sherpa-onnx-compile-lexicon --with-tones \
+  ./vits-melo-tts-zh_en/lexicon.txt \
+  ./vits-melo-tts-zh_en/lexicon.bin
+
+Then pass lexicon.bin in place of lexicon.txt, e.g., to --vits-lexicon or
+--matcha-lexicon. tokens.txt is still required.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  bool with_tones = false;
+
+  po.Register("with-tones", &with_tones,
+              "true if each line of the lexicon contains tones after the "
+              "tokens, as in MeloTTS models");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 2) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::string input = po.GetArg(1);
+  std::string output = po.GetArg(2);
+
+  std::ifstream is(input);
+  if (!is) {
+    fprintf(stderr, "Failed to open '%s'\n", input.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  if (!sherpa_onnx::BinaryLexicon::Compile(is, with_tones, output)) {
+    fprintf(stderr, "Failed to compile '%s'\n", input.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "Saved to %s\n", output.c_str());
+
+  return 0;
+}
@@ -4,38 +4,15 @@
 
 #include <stdio.h>
 
-#include <atomic>
 #include <chrono>  // NOLINT
 #include <fstream>
-#include <mutex>  // NOLINT
+#include <sstream>
 #include <string>
-#include <thread>  // NOLINT
 #include <vector>
 
+#include "sherpa-onnx/csrc/offline-batch-decoder.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/parse-options.h"
-#include "sherpa-onnx/csrc/wave-reader.h"
-
-std::atomic<int> wav_index(0);
-std::mutex mtx;
-
-std::vector<std::vector<std::string>> SplitToBatches(
-    const std::vector<std::string> &input, int32_t batch_size) {
-  std::vector<std::vector<std::string>> outputs;
-  auto itr = input.cbegin();
-  int32_t process_num = 0;
-
-  while (process_num + batch_size <= static_cast<int32_t>(input.size())) {
-    auto chunk_end = itr + batch_size;
-    outputs.emplace_back(itr, chunk_end);
-    itr = chunk_end;
-    process_num += batch_size;
-  }
-  if (itr != input.cend()) {
-    outputs.emplace_back(itr, input.cend());
-  }
-  return outputs;
-}
 
 std::vector<std::string> LoadScpFile(const std::string &wav_scp_path) {
   std::vector<std::string> wav_paths;
@@ -54,84 +31,6 @@ std::vector<std::string> LoadScpFile(const std::string &wav_scp_path) {
   return wav_paths;
 }
 
-void AsrInference(const std::vector<std::vector<std::string>> &chunk_wav_paths,
-                  sherpa_onnx::OfflineRecognizer *recognizer,
-                  float *total_length, float *total_time) {
-  std::vector<std::unique_ptr<sherpa_onnx::OfflineStream>> ss;
-  std::vector<sherpa_onnx::OfflineStream *> ss_pointers;
-  float duration = 0.0f;
-  float elapsed_seconds_batch = 0.0f;
-
-  // warm up
-  for (const auto &wav_filename : chunk_wav_paths[0]) {
-    int32_t sampling_rate = -1;
-    bool is_ok = false;
-    const std::vector<float> samples =
-        sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-    if (!is_ok) {
-      fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
-      continue;
-    }
-    duration += samples.size() / static_cast<float>(sampling_rate);
-    auto s = recognizer->CreateStream();
-    s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
-
-    ss.push_back(std::move(s));
-    ss_pointers.push_back(ss.back().get());
-  }
-  recognizer->DecodeStreams(ss_pointers.data(), ss_pointers.size());
-  ss_pointers.clear();
-  ss.clear();
-
-  while (true) {
-    int chunk = wav_index.fetch_add(1);
-    if (chunk >= static_cast<int32_t>(chunk_wav_paths.size())) {
-      break;
-    }
-    const auto &wav_paths = chunk_wav_paths[chunk];
-    const auto begin = std::chrono::steady_clock::now();
-    for (const auto &wav_filename : wav_paths) {
-      int32_t sampling_rate = -1;
-      bool is_ok = false;
-      const std::vector<float> samples =
-          sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-      if (!is_ok) {
-        fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
-        continue;
-      }
-      duration += samples.size() / static_cast<float>(sampling_rate);
-      auto s = recognizer->CreateStream();
-      s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
-
-      ss.push_back(std::move(s));
-      ss_pointers.push_back(ss.back().get());
-    }
-    recognizer->DecodeStreams(ss_pointers.data(), ss_pointers.size());
-    const auto end = std::chrono::steady_clock::now();
-    float elapsed_seconds =
-        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
-            .count() /
-        1000.;
-    elapsed_seconds_batch += elapsed_seconds;
-    int i = 0;
-    for (const auto &wav_filename : wav_paths) {
-      fprintf(stderr, "%s\n%s\n----\n", wav_filename.c_str(),
-              ss[i]->GetResult().AsJsonString().c_str());
-      i = i + 1;
-    }
-    ss_pointers.clear();
-    ss.clear();
-  }
-
-  {
-    std::lock_guard<std::mutex> guard(mtx);
-    *total_length += duration;
-    if (*total_time < elapsed_seconds_batch) {
-      *total_time = elapsed_seconds_batch;
-    }
-  }
-}
-
 int main(int32_t argc, char *argv[]) {
   const char *kUsageMessage = R"usage(
 Speech recognition using non-streaming models with sherpa-onnx.
@@ -212,7 +111,14 @@ See https://k2-fsa.github.io/sherpa/onnx/pretrained_models/offline-ctc/yesno/ind
     ./sherpa-onnx-tdnn-yesno/test_wavs/0_0_0_1_0_0_0_1.wav \
     ./sherpa-onnx-tdnn-yesno/test_wavs/0_0_1_0_0_0_1_0.wav
 
-Note: It supports decoding multiple files in batches
+Note: It supports decoding multiple files in batches. Files are read ahead
+of decoding (--prefetch, --num-io-threads), files of similar length are
+grouped into batches (--batch-size, --max-batch-duration) and the batches
+are decoded by --nj threads sharing a single recognizer. Results are printed
+in the order of the input files.
+
+It prints the real time factor (RTF) and the throughput at the end, so it
+can also be used as a benchmark.
 
 foo.wav should be of single channel, 16-bit PCM encoded wave file; its
 sampling rate can be arbitrary and does not need to be 16kHz.
@@ -222,20 +128,16 @@ https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html
 for a list of pre-trained models to download.
 )usage";
   std::string wav_scp = "";  // file path, kaldi style wav list.
-  int32_t nj = 1;            // thread number
-  int32_t batch_size = 1;    // number of wav files processed at once.
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::OfflineRecognizerConfig config;
+  sherpa_onnx::OfflineBatchDecoderConfig decoder_config;
   config.Register(&po);
+  decoder_config.Register(&po);
   po.Register("wav-scp", &wav_scp,
               "a file including wav-id and wav-path, kaldi style wav list."
               "default="
               ". when it is not empty, wav files which positional "
               "parameters provide are invalid.");
-  po.Register("nj", &nj, "multi-thread num for decoding, default=1");
-  po.Register("batch-size", &batch_size,
-              "number of wav files processed at once during the decoding"
-              "process. default=1");
 
   po.Read(argc, argv);
   if (po.NumArgs() < 1 && wav_scp.empty()) {
@@ -245,12 +147,13 @@ for a list of pre-trained models to download.
   }
 
   fprintf(stderr, "%s\n", config.ToString().c_str());
+  fprintf(stderr, "%s\n", decoder_config.ToString().c_str());
 
-  if (!config.Validate()) {
+  if (!config.Validate() || !decoder_config.Validate()) {
     fprintf(stderr, "Errors in config!\n");
     return -1;
   }
-  std::this_thread::sleep_for(std::chrono::seconds(10));  // sleep 10s
+
   fprintf(stderr, "Creating recognizer ...\n");
   const auto begin = std::chrono::steady_clock::now();
   sherpa_onnx::OfflineRecognizer recognizer(config);
@@ -259,11 +162,8 @@ for a list of pre-trained models to download.
       std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
           .count() /
       1000.;
-  fprintf(stderr,
-          "Started nj: %d, batch_size: %d, wav_path: %s. recognizer init time: "
-          "%.6f\n",
-          nj, batch_size, wav_scp.c_str(), elapsed_seconds);
-  std::this_thread::sleep_for(std::chrono::seconds(10));  // sleep 10s
+  fprintf(stderr, "Recognizer init time: %.3f s\n", elapsed_seconds);
+
   std::vector<std::string> wav_paths;
   if (!wav_scp.empty()) {
     wav_paths = LoadScpFile(wav_scp);
@@ -276,30 +176,41 @@ for a list of pre-trained models to download.
     fprintf(stderr, "wav files is empty.\n");
     return -1;
   }
-  std::vector<std::thread> threads;
-  std::vector<std::vector<std::string>> batch_wav_paths =
-      SplitToBatches(wav_paths, batch_size);
-  float total_length = 0.0f;
-  float total_time = 0.0f;
-  for (int i = 0; i < nj; i++) {
-    threads.emplace_back(std::thread(AsrInference, batch_wav_paths, &recognizer,
-                                     &total_length, &total_time));
-  }
 
-  for (auto &thread : threads) {
-    thread.join();
-  }
+  sherpa_onnx::OfflineBatchDecoder decoder(&recognizer, decoder_config);
+
+  auto stats = decoder.Decode(
+      wav_paths, [](const sherpa_onnx::OfflineBatchDecoderResult &r) {
+        if (!r.is_ok) {
+          return;
+        }
+
+        fprintf(stderr, "%s\n%s\n----\n", r.filename.c_str(),
+                r.result.AsJsonString().c_str());
+      });
 
   fprintf(stderr, "num threads: %d\n", config.model_config.num_threads);
+  fprintf(stderr, "nj: %d\n", decoder_config.num_threads);
+  fprintf(stderr, "batch size: %d\n", decoder_config.batch_size);
   fprintf(stderr, "decoding method: %s\n", config.decoding_method.c_str());
   if (config.decoding_method == "modified_beam_search") {
     fprintf(stderr, "max active paths: %d\n", config.max_active_paths);
   }
-  fprintf(stderr, "Elapsed seconds: %.3f s\n", total_time);
-  float rtf = total_time / total_length;
-  fprintf(stderr, "Real time factor (RTF): %.6f / %.6f = %.4f\n", total_time,
-          total_length, rtf);
-  fprintf(stderr, "SPEEDUP: %.4f\n", 1.0 / rtf);
+  fprintf(stderr, "Number of files: %d (failed: %d)\n", stats.num_files,
+          stats.num_failed);
+  fprintf(stderr, "Number of batches: %d\n", stats.num_batches);
+  fprintf(stderr, "Elapsed seconds: %.3f s\n", stats.elapsed_seconds);
+  float rtf = stats.RealTimeFactor();
+  fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.4f\n",
+          stats.elapsed_seconds, stats.total_duration, rtf);
+  if (rtf > 0) {
+    fprintf(stderr, "SPEEDUP: %.4f\n", 1.0 / rtf);
+  }
+  fprintf(stderr, "Throughput: %.3f files/s, %.3f audio seconds/s\n",
+          stats.Throughput(),
+          stats.elapsed_seconds > 0
+              ? stats.total_duration / stats.elapsed_seconds
+              : 0);
 
   return 0;
 }
@@ -0,0 +1,150 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-tts-batch-benchmark.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#include <stdio.h>
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+static float ElapsedSeconds(std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - begin)
+             .count() /
+         1000.;
+}
+
+static float Duration(const std::vector<sherpa_onnx::GeneratedAudio> &audio) {
+  float ans = 0;
+  for (const auto &a : audio) {
+    ans += a.samples.size() / static_cast<float>(a.sample_rate);
+  }
+  return ans;
+}
+
+static void Print(const char *name, int32_t num_requests, float seconds,
+                  float duration) {
+  fprintf(stderr, "%s\n", name);
+  fprintf(stderr, "  Elapsed seconds: %.3f s\n", seconds);
+  fprintf(stderr, "  Requests per second: %.3f\n", num_requests / seconds);
+  fprintf(stderr, "  Audio seconds per second: %.3f\n", duration / seconds);
+}
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Benchmark the throughput of OfflineTts::GenerateBatch().
+
+It synthesizes the given requests twice: once by calling Generate() for
+each request in turn and once with GenerateBatch() using
+--tts-num-batch-threads threads. It prints requests per second and
+seconds of generated audio per second of both runs.
+
+Usage:
+
+wget https://github.com/k2-fsa/sherpa-onnx/releases/download/tts-models/vits-piper-en_US-amy-low.tar.bz2
+tar xf vits-piper-en_US-amy-low.tar.bz2
+
+./bin/sherpa-onnx-offline-tts-batch-benchmark \
+  --vits-model=./vits-piper-en_US-amy-low/en_US-amy-low.onnx \
+  --vits-tokens=./vits-piper-en_US-amy-low/tokens.txt \
+  --vits-data-dir=./vits-piper-en_US-amy-low/espeak-ng-data \
+  --num-threads=1 \
+  --tts-num-batch-threads=4 \
+  --num-requests=32 \
+  ./requests.txt
+
+requests.txt contains one request per line. The requests are repeated
+until there are --num-requests of them. Disable the audio cache
+(--tts-audio-cache-size=0) so that repeated requests are synthesized again.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  int32_t num_requests = 32;
+
+  po.Register("num-requests", &num_requests,
+              "Number of requests. Lines of the input file are repeated "
+              "until there are this many requests");
+
+  sherpa_onnx::OfflineTtsConfig config;
+  config.Register(&po);
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr, "Error: Please provide exactly 1 text file.\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  if (num_requests < 1) {
+    fprintf(stderr, "--num-requests should be positive. Given: %d\n",
+            num_requests);
+    return -1;
+  }
+
+  std::ifstream is(po.GetArg(1));
+  if (!is) {
+    fprintf(stderr, "Failed to open '%s'\n", po.GetArg(1).c_str());
+    return -1;
+  }
+
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(is, line)) {
+    if (!line.empty()) {
+      lines.push_back(line);
+    }
+  }
+
+  if (lines.empty()) {
+    fprintf(stderr, "No requests in '%s'\n", po.GetArg(1).c_str());
+    return -1;
+  }
+
+  std::vector<std::string> texts;
+  texts.reserve(num_requests);
+  for (int32_t i = 0; i != num_requests; ++i) {
+    texts.push_back(lines[i % lines.size()]);
+  }
+
+  sherpa_onnx::OfflineTts tts(config);
+
+  // Warm up so that the first run does not pay for lazy initialization
+  tts.Generate(texts[0]);
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<sherpa_onnx::GeneratedAudio> sequential;
+  sequential.reserve(texts.size());
+  for (const auto &t : texts) {
+    sequential.push_back(tts.Generate(t));
+  }
+  float sequential_seconds = ElapsedSeconds(begin);
+
+  begin = std::chrono::steady_clock::now();
+  std::vector<sherpa_onnx::GeneratedAudio> batch = tts.GenerateBatch(texts);
+  float batch_seconds = ElapsedSeconds(begin);
+
+  float duration = Duration(sequential);
+
+  fprintf(stderr, "Number of requests: %d\n", num_requests);
+  fprintf(stderr, "Audio duration: %.3f s\n", duration);
+  Print("Generate()", num_requests, sequential_seconds, duration);
+  Print("GenerateBatch()", num_requests, batch_seconds, Duration(batch));
+
+  if (batch_seconds > 0) {
+    fprintf(stderr, "Speedup: %.2fx\n", sequential_seconds / batch_seconds);
+  }
+
+  return 0;
+}
@@ -9,12 +9,6 @@
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/wave-writer.h"
 
-static int32_t AudioCallback(const float * /*samples*/, int32_t n,
-                             float progress) {
-  printf("sample=%d, progress=%f\n", n, progress);
-  return 1;
-}
-
 int main(int32_t argc, char *argv[]) {
   const char *kUsageMessage = R"usage(
 Offline/Non-streaming text-to-speech with sherpa-onnx
@@ -84,7 +78,25 @@ or details.
   sherpa_onnx::OfflineTts tts(config);
 
   const auto begin = std::chrono::steady_clock::now();
-  auto audio = tts.Generate(po.GetArg(1), sid, 1.0, AudioCallback);
+
+  // Time from the start to the first generated audio
+  float first_audio_seconds = -1;
+  auto audio_callback = [&begin, &first_audio_seconds](
+                            const float * /*samples*/, int32_t n,
+                            float progress) -> int32_t {
+    if (first_audio_seconds < 0) {
+      first_audio_seconds =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - begin)
+              .count() /
+          1000.;
+    }
+
+    printf("sample=%d, progress=%f\n", n, progress);
+    return 1;
+  };
+
+  auto audio = tts.Generate(po.GetArg(1), sid, 1.0, audio_callback);
   const auto end = std::chrono::steady_clock::now();
 
   if (audio.samples.empty()) {
@@ -102,6 +114,7 @@ or details.
 
   float rtf = elapsed_seconds / duration;
   fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+  fprintf(stderr, "Time to first audio: %.3f s\n", first_audio_seconds);
   fprintf(stderr, "Audio duration: %.3f s\n", duration);
   fprintf(stderr, "Real-time factor (RTF): %.3f/%.3f = %.3f\n", elapsed_seconds,
           duration, rtf);
@@ -0,0 +1,153 @@
+// sherpa-onnx/csrc/sherpa-onnx-speaker-search-benchmark.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#include <stdio.h>
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/speaker-embedding-manager.h"
+
+static std::vector<int32_t> ParseList(const std::string &s) {
+  std::vector<int32_t> ans;
+  std::istringstream is(s);
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    ans.push_back(atoi(item.c_str()));
+  }
+
+  return ans;
+}
+
+static float ElapsedSeconds(std::chrono::steady_clock::time_point begin) {
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+             .count() /
+         1e6;
+}
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Benchmark speaker search of SpeakerEmbeddingManager on random embeddings.
+
+For each number of speakers, it enrolls the speakers with AddMany() and
+searches noisy copies of randomly chosen speakers with exact search,
+with SearchMany(), and with the approximate index given by the options.
+It prints the time per query and the recall of the approximate index,
+i.e., how often it returns the same speaker as the exact search.
+
+Usage:
+
+./bin/sherpa-onnx-speaker-search-benchmark \
+  --num-speakers=10000,100000,1000000 \
+  --dim=192 \
+  --speaker-index-num-lists=1024 \
+  --speaker-index-num-probes=16
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::SpeakerEmbeddingManagerConfig config;
+  config.Register(&po);
+
+  std::string num_speakers_str = "10000,100000";
+  int32_t dim = 192;
+  int32_t num_queries = 1000;
+  float noise = 0.5;
+
+  po.Register("num-speakers", &num_speakers_str,
+              "Comma separated list of the number of speakers to benchmark");
+  po.Register("dim", &dim, "Embedding dimension");
+  po.Register("num-queries", &num_queries, "Number of queries");
+  po.Register("noise", &noise,
+              "Standard deviation of the noise added to each dimension of "
+              "a query, relative to that of the embeddings");
+
+  po.Read(argc, argv);
+  if (po.NumArgs() != 0) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  // Use the index for any number of speakers given on the command line
+  if (config.index_num_lists > 0) {
+    config.index_min_num_speakers = 1;
+  }
+
+  fprintf(stderr, "%10s %10s %12s %12s %12s %10s\n", "speakers", "add(s)",
+          "exact(ms)", "batch(ms)", "index(ms)", "recall");
+
+  for (int32_t n : ParseList(num_speakers_str)) {
+    std::mt19937 gen(0);
+    std::normal_distribution<float> normal;
+
+    std::vector<std::string> names(n);
+    std::vector<float> embeddings(static_cast<size_t>(n) * dim);
+    for (int32_t i = 0; i != n; ++i) {
+      names[i] = "speaker-" + std::to_string(i);
+    }
+
+    for (auto &f : embeddings) {
+      f = normal(gen);
+    }
+
+    std::uniform_int_distribution<int32_t> pick(0, n - 1);
+    std::vector<float> queries(static_cast<size_t>(num_queries) * dim);
+    for (int32_t i = 0; i != num_queries; ++i) {
+      const float *p = embeddings.data() + static_cast<size_t>(pick(gen)) * dim;
+      for (int32_t d = 0; d != dim; ++d) {
+        queries[i * dim + d] = p[d] + noise * normal(gen);
+      }
+    }
+
+    sherpa_onnx::SpeakerEmbeddingManager exact(dim);
+    auto begin = std::chrono::steady_clock::now();
+    exact.AddMany(names, embeddings.data());
+    float add_seconds = ElapsedSeconds(begin);
+
+    std::vector<std::string> expected(num_queries);
+    begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i != num_queries; ++i) {
+      expected[i] = exact.Search(queries.data() + i * dim, 0);
+    }
+    float exact_ms = ElapsedSeconds(begin) * 1000 / num_queries;
+
+    begin = std::chrono::steady_clock::now();
+    exact.SearchMany(queries.data(), num_queries, 0);
+    float batch_ms = ElapsedSeconds(begin) * 1000 / num_queries;
+
+    float index_ms = 0;
+    float recall = 1;
+    if (config.index_num_lists > 0) {
+      sherpa_onnx::SpeakerEmbeddingManager approximate(dim, config);
+      begin = std::chrono::steady_clock::now();
+      approximate.AddMany(names, embeddings.data());
+      add_seconds = ElapsedSeconds(begin);
+
+      int32_t num_correct = 0;
+      begin = std::chrono::steady_clock::now();
+      for (int32_t i = 0; i != num_queries; ++i) {
+        num_correct +=
+            approximate.Search(queries.data() + i * dim, 0) == expected[i];
+      }
+      index_ms = ElapsedSeconds(begin) * 1000 / num_queries;
+      recall = static_cast<float>(num_correct) / num_queries;
+    }
+
+    fprintf(stderr, "%10d %10.3f %12.4f %12.4f %12.4f %10.4f\n", n,
+            add_seconds, exact_ms, batch_ms, index_ms, recall);
+  }
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+// sherpa-onnx/csrc/sherpa-onnx-vad-benchmark.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+struct Segment {
+  int32_t start;
+  int32_t end;
+};
+
+static std::vector<Segment> Run(const sherpa_onnx::VadModelConfig &config,
+                                const std::vector<float> &samples,
+                                float *elapsed_seconds) {
+  sherpa_onnx::VoiceActivityDetector vad(config);
+  int32_t window_size = config.silero_vad.window_size;
+
+  std::vector<Segment> ans;
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  for (int32_t i = 0; i < static_cast<int32_t>(samples.size());
+       i += window_size) {
+    int32_t n = std::min<int32_t>(window_size, samples.size() - i);
+    vad.AcceptWaveform(samples.data() + i, n);
+
+    while (!vad.Empty()) {
+      const auto &s = vad.Front();
+      int32_t num_samples = static_cast<int32_t>(s.samples.size());
+      ans.push_back({s.start, s.start + num_samples});
+      vad.Pop();
+    }
+  }
+
+  vad.Flush();
+  while (!vad.Empty()) {
+    const auto &s = vad.Front();
+    int32_t n = static_cast<int32_t>(s.samples.size());
+    ans.push_back({s.start, s.start + n});
+    vad.Pop();
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  *elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  return ans;
+}
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Benchmark the VAD pre-gate (--vad-pre-gate).
+
+It runs VAD over the given wave files twice: once without the pre-gate and
+once with it. It prints the elapsed time of both runs and compares the
+detected speech segments.
+
+Usage:
+
+wget https://github.com/snakers4/silero-vad/raw/master/src/silero_vad/data/silero_vad.onnx
+
+./bin/sherpa-onnx-vad-benchmark \
+  --silero-vad-model=./silero_vad.onnx \
+  --vad-pre-gate-low-energy-db=-60 \
+  --vad-pre-gate-high-energy-db=-50 \
+  /path/to/foo.wav \
+  /path/to/bar.wav
+
+The wave files should be 16 kHz, single channel. Audio with long
+stretches of silence, e.g., call-center recordings, benefits the most.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::VadModelConfig config;
+  config.Register(&po);
+  po.Read(argc, argv);
+  if (po.NumArgs() < 1) {
+    fprintf(stderr, "Error: Please provide at least 1 wave file.\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  sherpa_onnx::VadModelConfig gated_config = config;
+  gated_config.pre_gate.enabled = true;
+
+  sherpa_onnx::VadModelConfig baseline_config = config;
+  baseline_config.pre_gate.enabled = false;
+
+  float total_duration = 0;
+  float total_baseline = 0;
+  float total_gated = 0;
+
+  for (int32_t i = 1; i <= po.NumArgs(); ++i) {
+    std::string wav_filename = po.GetArg(i);
+
+    int32_t sampling_rate = -1;
+    bool is_ok = false;
+    std::vector<float> samples =
+        sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
+      return -1;
+    }
+
+    if (sampling_rate != config.sample_rate) {
+      fprintf(stderr, "Expected sample rate %d. Given: %d for '%s'\n",
+              config.sample_rate, sampling_rate, wav_filename.c_str());
+      return -1;
+    }
+
+    float duration = samples.size() / static_cast<float>(sampling_rate);
+
+    float baseline_seconds = 0;
+    auto baseline = Run(baseline_config, samples, &baseline_seconds);
+
+    float gated_seconds = 0;
+    auto gated = Run(gated_config, samples, &gated_seconds);
+
+    // Largest difference of segment boundaries, in samples
+    int32_t max_diff = 0;
+    if (baseline.size() == gated.size()) {
+      for (size_t k = 0; k != baseline.size(); ++k) {
+        max_diff = std::max(max_diff,
+                            std::abs(baseline[k].start - gated[k].start));
+        max_diff =
+            std::max(max_diff, std::abs(baseline[k].end - gated[k].end));
+      }
+    }
+
+    fprintf(stderr, "%s\n", wav_filename.c_str());
+    fprintf(stderr, "  Duration: %.3f s\n", duration);
+    fprintf(stderr, "  Without the pre-gate: %.3f s, %d segments\n",
+            baseline_seconds, static_cast<int32_t>(baseline.size()));
+    fprintf(stderr, "  With the pre-gate:    %.3f s, %d segments\n",
+            gated_seconds, static_cast<int32_t>(gated.size()));
+
+    if (baseline.size() == gated.size()) {
+      fprintf(stderr, "  Max boundary difference: %.3f s\n",
+              max_diff / static_cast<float>(sampling_rate));
+    } else {
+      fprintf(stderr, "  Number of segments differs\n");
+    }
+
+    total_duration += duration;
+    total_baseline += baseline_seconds;
+    total_gated += gated_seconds;
+  }
+
+  fprintf(stderr, "Total duration: %.3f s\n", total_duration);
+  fprintf(stderr, "RTF without the pre-gate: %.5f\n",
+          total_baseline / total_duration);
+  fprintf(stderr, "RTF with the pre-gate:    %.5f\n",
+          total_gated / total_duration);
+
+  if (total_baseline > 0) {
+    fprintf(stderr, "CPU time saved: %.1f%%\n",
+            100 * (total_baseline - total_gated) / total_baseline);
+  }
+
+  return 0;
+}
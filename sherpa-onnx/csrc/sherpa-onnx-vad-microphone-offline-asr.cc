@@ -14,7 +14,7 @@
 #include "sherpa-onnx/csrc/microphone.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/resample.h"
-#include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/csrc/vad-offline-asr-pipeline.h"
 
 bool stop = false;
 std::mutex mutex;
@@ -84,9 +84,11 @@ to download models for offline ASR.
   sherpa_onnx::VadModelConfig vad_config;
 
   sherpa_onnx::OfflineRecognizerConfig asr_config;
+  sherpa_onnx::VadOfflineAsrPipelineConfig pipeline_config;
 
   vad_config.Register(&po);
   asr_config.Register(&po);
+  pipeline_config.Register(&po);
 
   po.Read(argc, argv);
   if (po.NumArgs() != 0) {
@@ -96,6 +98,7 @@ to download models for offline ASR.
 
   fprintf(stderr, "%s\n", vad_config.ToString().c_str());
   fprintf(stderr, "%s\n", asr_config.ToString().c_str());
+  fprintf(stderr, "%s\n", pipeline_config.ToString().c_str());
 
   if (!vad_config.Validate()) {
     fprintf(stderr, "Errors in vad_config!\n");
@@ -107,6 +110,11 @@ to download models for offline ASR.
     return -1;
   }
 
+  if (!pipeline_config.Validate()) {
+    fprintf(stderr, "Errors in pipeline_config!\n");
+    return -1;
+  }
+
   fprintf(stderr, "Creating recognizer ...\n");
   sherpa_onnx::OfflineRecognizer recognizer(asr_config);
   fprintf(stderr, "Recognizer created!\n");
@@ -192,12 +200,20 @@ to download models for offline ASR.
     exit(EXIT_FAILURE);
   }
 
-  auto vad = std::make_unique<sherpa_onnx::VoiceActivityDetector>(vad_config);
+  int32_t index = 0;
+  sherpa_onnx::VadOfflineAsrPipeline pipeline(
+      vad_config, &recognizer, pipeline_config,
+      [&index](const sherpa_onnx::VadOfflineAsrResult &r) {
+        if (!r.result.text.empty()) {
+          fprintf(stderr, "%2d: %s\n", index, r.result.text.c_str());
+          ++index;
+        }
+      });
+  int32_t channel = pipeline.AddChannel();
 
   fprintf(stderr, "Started. Please speak\n");
 
   int32_t window_size = vad_config.silero_vad.window_size;
-  int32_t index = 0;
 
   while (!stop) {
     {
@@ -213,22 +229,10 @@ to download models for offline ASR.
           samples = std::move(tmp);
         }
 
-        vad->AcceptWaveform(samples.data(), samples.size());
-      }
-    }
-
-    while (!vad->Empty()) {
-      const auto &segment = vad->Front();
-      auto s = recognizer.CreateStream();
-      s->AcceptWaveform(sample_rate, segment.samples.data(),
-                        segment.samples.size());
-      recognizer.DecodeStream(s.get());
-      const auto &result = s->GetResult();
-      if (!result.text.empty()) {
-        fprintf(stderr, "%2d: %s\n", index, result.text.c_str());
-        ++index;
+        // It only copies the samples. The VAD and decoding run in
+        // background threads.
+        pipeline.AcceptWaveform(channel, samples.data(), samples.size());
       }
-      vad->Pop();
     }
 
     Pa_Sleep(100);  // sleep for 100ms
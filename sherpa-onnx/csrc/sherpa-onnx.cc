@@ -93,7 +93,15 @@ for a list of pre-trained models to download.
     return -1;
   }
 
+  const auto init_begin = std::chrono::steady_clock::now();
   sherpa_onnx::OnlineRecognizer recognizer(config);
+  const auto init_end = std::chrono::steady_clock::now();
+  const float init_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(init_end -
+                                                            init_begin)
+          .count() /
+      1000.;
+  fprintf(stderr, "Recognizer init time: %.3f s\n", init_seconds);
 
   std::vector<Stream> ss;
 
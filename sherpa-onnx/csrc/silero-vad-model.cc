@@ -17,9 +17,11 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
+#include "sherpa-onnx/csrc/cat.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
+#include "sherpa-onnx/csrc/unbind.h"
 
 namespace sherpa_onnx {
 
@@ -31,7 +33,7 @@ class SileroVadModel::Impl {
         sess_opts_(GetSessionOptions(config)),
         allocator_{},
         sample_rate_(config.sample_rate) {
-    auto buf = ReadFile(config.silero_vad.model);
+    auto buf = MapModelFile(config.silero_vad.model, &sess_opts_);
     Init(buf.data(), buf.size());
 
     if (sample_rate_ != 16000) {
@@ -69,11 +71,7 @@ class SileroVadModel::Impl {
   }
 
   void Reset() {
-    if (is_v5_) {
-      ResetV5();
-    } else {
-      ResetV4();
-    }
+    states_ = GetInitStates();
 
     triggered_ = false;
     current_sample_ = 0;
@@ -175,10 +173,88 @@ class SileroVadModel::Impl {
     return Run(samples, n);  // This directly returns the probability
   }
 
+  std::vector<Ort::Value> GetInitStates() {
+    if (is_v5_) {
+      return GetInitStatesV5();
+    } else {
+      return GetInitStatesV4();
+    }
+  }
+
+  std::vector<float> GetProbBatch(
+      const float *samples, int32_t batch_size, int32_t n,
+      std::vector<std::vector<Ort::Value>> *states) {
+    if (n != WindowSize()) {
+      SHERPA_ONNX_LOGE("n: %d != window_size: %d", n, WindowSize());
+      exit(-1);
+    }
+
+    if (static_cast<int32_t>(states->size()) != batch_size) {
+      SHERPA_ONNX_LOGE("Number of states: %d != batch_size: %d",
+                       static_cast<int32_t>(states->size()), batch_size);
+      exit(-1);
+    }
+
+    // Stack the states of all streams along the batch dim, i.e., dim 1
+    int32_t num_states = static_cast<int32_t>((*states)[0].size());
+    std::vector<Ort::Value> batched_states;
+    batched_states.reserve(num_states);
+
+    std::vector<const Ort::Value *> buf(batch_size);
+    for (int32_t k = 0; k != num_states; ++k) {
+      for (int32_t b = 0; b != batch_size; ++b) {
+        buf[b] = &(*states)[b][k];
+      }
+      batched_states.push_back(Cat(allocator_, buf, 1));
+    }
+
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+    std::array<int64_t, 2> x_shape = {batch_size, n};
+
+    Ort::Value x = Ort::Value::CreateTensor(
+        memory_info, const_cast<float *>(samples), batch_size * n,
+        x_shape.data(), x_shape.size());
+
+    int64_t sr_shape = 1;
+    Ort::Value sr =
+        Ort::Value::CreateTensor(memory_info, &sample_rate_, 1, &sr_shape, 1);
+
+    std::vector<Ort::Value> inputs;
+    inputs.reserve(input_names_.size());
+    inputs.push_back(std::move(x));
+
+    if (is_v5_) {
+      inputs.push_back(std::move(batched_states[0]));
+      inputs.push_back(std::move(sr));
+    } else {
+      inputs.push_back(std::move(sr));
+      inputs.push_back(std::move(batched_states[0]));
+      inputs.push_back(std::move(batched_states[1]));
+    }
+
+    auto out =
+        sess_->Run({}, input_names_ptr_.data(), inputs.data(), inputs.size(),
+                   output_names_ptr_.data(), output_names_ptr_.size());
+
+    // out[0]: (batch_size, 1)
+    const float *p = out[0].GetTensorData<float>();
+    std::vector<float> probs(p, p + batch_size);
+
+    for (int32_t k = 0; k != num_states; ++k) {
+      std::vector<Ort::Value> unbound = Unbind(allocator_, &out[k + 1], 1);
+      for (int32_t b = 0; b != batch_size; ++b) {
+        (*states)[b][k] = std::move(unbound[b]);
+      }
+    }
+
+    return probs;
+  }
+
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
     GetOutputNames(sess_.get(), &output_names_, &output_names_ptr_);
@@ -207,7 +283,7 @@ class SileroVadModel::Impl {
     Reset();
   }
 
-  void ResetV5() {
+  std::vector<Ort::Value> GetInitStatesV5() {
     // 2 - number of LSTM layer
     // 1 - batch size
     // 128 - hidden dim
@@ -217,11 +293,13 @@ class SileroVadModel::Impl {
         Ort::Value::CreateTensor<float>(allocator_, shape.data(), shape.size());
 
     Fill<float>(&s, 0);
-    states_.clear();
-    states_.push_back(std::move(s));
+
+    std::vector<Ort::Value> states;
+    states.push_back(std::move(s));
+    return states;
   }
 
-  void ResetV4() {
+  std::vector<Ort::Value> GetInitStatesV4() {
     // 2 - number of LSTM layer
     // 1 - batch size
     // 64 - hidden dim
@@ -236,11 +314,11 @@ class SileroVadModel::Impl {
     Fill<float>(&h, 0);
     Fill<float>(&c, 0);
 
-    states_.clear();
-
-    states_.reserve(2);
-    states_.push_back(std::move(h));
-    states_.push_back(std::move(c));
+    std::vector<Ort::Value> states;
+    states.reserve(2);
+    states.push_back(std::move(h));
+    states.push_back(std::move(c));
+    return states;
   }
 
   void Check() const {
@@ -481,6 +559,16 @@ float SileroVadModel::GetProb(const float *samples, int32_t n) {
   return impl_->GetProb(samples, n);
 }
 
+std::vector<Ort::Value> SileroVadModel::GetInitStates() {
+  return impl_->GetInitStates();
+}
+
+std::vector<float> SileroVadModel::GetProbBatch(
+    const float *samples, int32_t batch_size, int32_t n,
+    std::vector<std::vector<Ort::Value>> *states) {
+  return impl_->GetProbBatch(samples, batch_size, n, states);
+}
+
 #if __ANDROID_API__ >= 9
 template SileroVadModel::SileroVadModel(AAssetManager *mgr,
                                         const VadModelConfig &config);
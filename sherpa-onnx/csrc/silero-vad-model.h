@@ -5,6 +5,7 @@
 #define SHERPA_ONNX_CSRC_SILERO_VAD_MODEL_H_
 
 #include <memory>
+#include <vector>
 
 #include "sherpa-onnx/csrc/vad-model.h"
 
@@ -46,6 +47,12 @@ class SileroVadModel : public VadModel {
   void SetThreshold(float threshold) override;
   float GetProb(const float *samples, int32_t n) override;  // override 키워드 사용
 
+  std::vector<Ort::Value> GetInitStates() override;
+
+  std::vector<float> GetProbBatch(
+      const float *samples, int32_t batch_size, int32_t n,
+      std::vector<std::vector<Ort::Value>> *states) override;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
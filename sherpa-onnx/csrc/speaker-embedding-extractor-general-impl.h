@@ -20,12 +20,12 @@ class SpeakerEmbeddingExtractorGeneralImpl
  public:
   explicit SpeakerEmbeddingExtractorGeneralImpl(
       const SpeakerEmbeddingExtractorConfig &config)
-      : model_(config) {}
+      : model_(config), batch_size_(config.batch_size) {}
 
   template <typename Manager>
   SpeakerEmbeddingExtractorGeneralImpl(
       Manager *mgr, const SpeakerEmbeddingExtractorConfig &config)
-      : model_(mgr, config) {}
+      : model_(mgr, config), batch_size_(config.batch_size) {}
 
   int32_t Dim() const override { return model_.GetMetaData().output_dim; }
 
@@ -43,31 +43,100 @@ class SpeakerEmbeddingExtractorGeneralImpl
   }
 
   std::vector<float> Compute(OnlineStream *s) const override {
-    int32_t num_frames = s->NumFramesReady() - s->GetNumProcessedFrames();
-    if (num_frames <= 0) {
+    int32_t num_frames = 0;
+    std::vector<float> features = GetFeatures(s, &num_frames);
+    if (features.empty()) {
+      return {};
+    }
+
+    std::vector<std::vector<float>> ans = Run(&features, 1, num_frames);
+    return std::move(ans[0]);
+  }
+
+  std::vector<std::vector<float>> ComputeBatch(OnlineStream **ss,
+                                               int32_t n) const override {
+    std::vector<std::vector<float>> features(n);
+    std::vector<int32_t> num_frames(n);
+    for (int32_t i = 0; i != n; ++i) {
+      features[i] = GetFeatures(ss[i], &num_frames[i]);
+    }
+
+    // The model does not accept the number of frames of each input, so
+    // padding would change the result. Only inputs with the same number of
+    // frames are put into a batch.
+    std::vector<int32_t> indexes;
+    indexes.reserve(n);
+    for (int32_t i = 0; i != n; ++i) {
+      if (!features[i].empty()) {
+        indexes.push_back(i);
+      }
+    }
+
+    std::stable_sort(indexes.begin(), indexes.end(),
+                     [&num_frames](int32_t a, int32_t b) {
+                       return num_frames[a] < num_frames[b];
+                     });
+
+    std::vector<std::vector<float>> ans(n);
+
+    int32_t batch_size = batch_size_;
+    int32_t num_indexes = static_cast<int32_t>(indexes.size());
+    std::vector<float> buf;
+    for (int32_t start = 0; start < num_indexes;) {
+      int32_t t = num_frames[indexes[start]];
+      int32_t end = start + 1;
+      while (end < num_indexes && end - start < batch_size &&
+             num_frames[indexes[end]] == t) {
+        ++end;
+      }
+
+      int32_t k = end - start;
+      buf.clear();
+      for (int32_t i = start; i != end; ++i) {
+        const auto &f = features[indexes[i]];
+        buf.insert(buf.end(), f.begin(), f.end());
+      }
+
+      std::vector<std::vector<float>> embeddings = Run(&buf, k, t);
+      for (int32_t i = 0; i != k; ++i) {
+        ans[indexes[start + i]] = std::move(embeddings[i]);
+      }
+
+      start = end;
+    }
+
+    return ans;
+  }
+
+ private:
+  // Return the normalized features of the unprocessed frames of s and mark
+  // them as processed. It returns an empty vector if there are no frames.
+  std::vector<float> GetFeatures(OnlineStream *s, int32_t *num_frames) const {
+    *num_frames = s->NumFramesReady() - s->GetNumProcessedFrames();
+    if (*num_frames <= 0) {
 #if __OHOS__
       SHERPA_ONNX_LOGE(
           "Please make sure IsReady(s) returns true. num_frames: %{public}d",
-          num_frames);
+          *num_frames);
 #else
       SHERPA_ONNX_LOGE(
           "Please make sure IsReady(s) returns true. num_frames: %d",
-          num_frames);
+          *num_frames);
 #endif
       return {};
     }
 
     std::vector<float> features =
-        s->GetFrames(s->GetNumProcessedFrames(), num_frames);
+        s->GetFrames(s->GetNumProcessedFrames(), *num_frames);
 
-    s->GetNumProcessedFrames() += num_frames;
+    s->GetNumProcessedFrames() += *num_frames;
 
-    int32_t feat_dim = features.size() / num_frames;
+    int32_t feat_dim = features.size() / *num_frames;
 
     const auto &meta_data = model_.GetMetaData();
     if (!meta_data.feature_normalize_type.empty()) {
       if (meta_data.feature_normalize_type == "global-mean") {
-        SubtractGlobalMean(features.data(), num_frames, feat_dim);
+        SubtractGlobalMean(features.data(), *num_frames, feat_dim);
       } else {
 #if __OHOS__
         SHERPA_ONNX_LOGE("Unsupported feature_normalize_type: %{public}s",
@@ -80,25 +149,43 @@ class SpeakerEmbeddingExtractorGeneralImpl
       }
     }
 
+    return features;
+  }
+
+  /* Run the model.
+   *
+   * @param features Features of n inputs, each of which has num_frames
+   *                 frames.
+   * @param n Number of inputs.
+   * @param num_frames Number of frames of each input.
+   * @return Return n embeddings.
+   */
+  std::vector<std::vector<float>> Run(std::vector<float> *features,
+                                      int32_t n, int32_t num_frames) const {
+    int32_t feat_dim = features->size() / (n * num_frames);
+
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    std::array<int64_t, 3> x_shape{1, num_frames, feat_dim};
-    Ort::Value x =
-        Ort::Value::CreateTensor(memory_info, features.data(), features.size(),
-                                 x_shape.data(), x_shape.size());
+    std::array<int64_t, 3> x_shape{n, num_frames, feat_dim};
+    Ort::Value x = Ort::Value::CreateTensor(memory_info, features->data(),
+                                            features->size(), x_shape.data(),
+                                            x_shape.size());
     Ort::Value embedding = model_.Compute(std::move(x));
     std::vector<int64_t> embedding_shape =
         embedding.GetTensorTypeAndShapeInfo().GetShape();
 
-    std::vector<float> ans(embedding_shape[1]);
-    std::copy(embedding.GetTensorData<float>(),
-              embedding.GetTensorData<float>() + ans.size(), ans.begin());
+    int32_t dim = embedding_shape[1];
+    const float *p = embedding.GetTensorData<float>();
+
+    std::vector<std::vector<float>> ans(n);
+    for (int32_t i = 0; i != n; ++i, p += dim) {
+      ans[i].assign(p, p + dim);
+    }
 
     return ans;
   }
 
- private:
   void SubtractGlobalMean(float *p, int32_t num_frames,
                           int32_t feat_dim) const {
     auto m = Eigen::Map<
@@ -110,6 +197,7 @@ class SpeakerEmbeddingExtractorGeneralImpl
 
  private:
   SpeakerEmbeddingExtractorModel model_;
+  int32_t batch_size_;
 };
 
 }  // namespace sherpa_onnx
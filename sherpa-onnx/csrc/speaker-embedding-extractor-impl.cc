@@ -13,6 +13,7 @@
 #endif
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/mapped-file.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor-general-impl.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor-nemo-impl.h"
@@ -30,30 +31,20 @@ enum class ModelType : std::uint8_t {
 
 }  // namespace
 
-static ModelType GetModelType(char *model_data, size_t model_data_length,
+static ModelType GetModelType(const char *model_data, size_t model_data_length,
                               bool debug) {
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
-  Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(1);
-  sess_opts.SetInterOpNumThreads(1);
-
-  auto sess = std::make_unique<Ort::Session>(env, model_data, model_data_length,
-                                             sess_opts);
-
-  Ort::ModelMetadata meta_data = sess->GetModelMetadata();
+  // Read the metadata without creating a session so that external data
+  // is not needed here
+  OnnxModelInfo info = GetOnnxModelInfo(model_data, model_data_length);
   if (debug) {
-    std::ostringstream os;
-    PrintModelMetadata(os, meta_data);
 #if __OHOS__
-    SHERPA_ONNX_LOGE("%{public}s", os.str().c_str());
+    SHERPA_ONNX_LOGE("%{public}s", info.ToString().c_str());
 #else
-    SHERPA_ONNX_LOGE("%s", os.str().c_str());
+    SHERPA_ONNX_LOGE("%s", info.ToString().c_str());
 #endif
   }
 
-  Ort::AllocatorWithDefaultOptions allocator;
-  auto model_type =
-      LookupCustomModelMetaData(meta_data, "framework", allocator);
+  auto model_type = info.LookupMetadata("framework");
   if (model_type.empty()) {
     SHERPA_ONNX_LOGE(
         "No model_type in the metadata!\n"
@@ -87,7 +78,7 @@ SpeakerEmbeddingExtractorImpl::Create(
   ModelType model_type = ModelType::kUnknown;
 
   {
-    auto buffer = ReadFile(config.model);
+    MappedFile buffer(config.model);
 
     model_type = GetModelType(buffer.data(), buffer.size(), config.debug);
   }
@@ -138,6 +129,18 @@ SpeakerEmbeddingExtractorImpl::Create(
   return nullptr;
 }
 
+std::vector<std::vector<float>> SpeakerEmbeddingExtractorImpl::ComputeBatch(
+    OnlineStream **ss, int32_t n) const {
+  std::vector<std::vector<float>> ans;
+  ans.reserve(n);
+
+  for (int32_t i = 0; i != n; ++i) {
+    ans.push_back(Compute(ss[i]));
+  }
+
+  return ans;
+}
+
 #if __ANDROID_API__ >= 9
 template std::unique_ptr<SpeakerEmbeddingExtractorImpl>
 SpeakerEmbeddingExtractorImpl::Create(
@@ -31,6 +31,10 @@ class SpeakerEmbeddingExtractorImpl {
   virtual bool IsReady(OnlineStream *s) const = 0;
 
   virtual std::vector<float> Compute(OnlineStream *s) const = 0;
+
+  // The default implementation calls Compute() for each stream
+  virtual std::vector<std::vector<float>> ComputeBatch(OnlineStream **ss,
+                                                       int32_t n) const;
 };
 
 }  // namespace sherpa_onnx
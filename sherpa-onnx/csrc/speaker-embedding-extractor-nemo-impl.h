@@ -20,12 +20,12 @@ class SpeakerEmbeddingExtractorNeMoImpl : public SpeakerEmbeddingExtractorImpl {
  public:
   explicit SpeakerEmbeddingExtractorNeMoImpl(
       const SpeakerEmbeddingExtractorConfig &config)
-      : model_(config) {}
+      : model_(config), batch_size_(config.batch_size) {}
 
   template <typename Manager>
   SpeakerEmbeddingExtractorNeMoImpl(
       Manager *mgr, const SpeakerEmbeddingExtractorConfig &config)
-      : model_(mgr, config) {}
+      : model_(mgr, config), batch_size_(config.batch_size) {}
 
   int32_t Dim() const override { return model_.GetMetaData().output_dim; }
 
@@ -51,31 +51,93 @@ class SpeakerEmbeddingExtractorNeMoImpl : public SpeakerEmbeddingExtractorImpl {
   }
 
   std::vector<float> Compute(OnlineStream *s) const override {
-    int32_t num_frames = s->NumFramesReady() - s->GetNumProcessedFrames();
-    if (num_frames <= 0) {
+    int32_t num_frames = 0;
+    std::vector<float> features = GetFeatures(s, &num_frames);
+    if (features.empty()) {
+      return {};
+    }
+
+    const float *p = features.data();
+    std::vector<std::vector<float>> ans = Run(&p, &num_frames, 1);
+    return std::move(ans[0]);
+  }
+
+  std::vector<std::vector<float>> ComputeBatch(OnlineStream **ss,
+                                               int32_t n) const override {
+    std::vector<std::vector<float>> features(n);
+    std::vector<int32_t> num_frames(n);
+    for (int32_t i = 0; i != n; ++i) {
+      features[i] = GetFeatures(ss[i], &num_frames[i]);
+    }
+
+    // Sort by length so that inputs in a batch need little padding
+    std::vector<int32_t> indexes;
+    indexes.reserve(n);
+    for (int32_t i = 0; i != n; ++i) {
+      if (!features[i].empty()) {
+        indexes.push_back(i);
+      }
+    }
+
+    std::stable_sort(indexes.begin(), indexes.end(),
+                     [&num_frames](int32_t a, int32_t b) {
+                       return num_frames[a] < num_frames[b];
+                     });
+
+    std::vector<std::vector<float>> ans(n);
+
+    int32_t num_indexes = static_cast<int32_t>(indexes.size());
+    std::vector<const float *> p;
+    std::vector<int32_t> lens;
+    for (int32_t start = 0; start < num_indexes; start += batch_size_) {
+      int32_t k = std::min(batch_size_, num_indexes - start);
+
+      p.clear();
+      lens.clear();
+      for (int32_t i = start; i != start + k; ++i) {
+        p.push_back(features[indexes[i]].data());
+        lens.push_back(num_frames[indexes[i]]);
+      }
+
+      std::vector<std::vector<float>> embeddings =
+          Run(p.data(), lens.data(), k);
+      for (int32_t i = 0; i != k; ++i) {
+        ans[indexes[start + i]] = std::move(embeddings[i]);
+      }
+    }
+
+    return ans;
+  }
+
+ private:
+  // Return the normalized features of the unprocessed frames of s and mark
+  // them as processed. It returns an empty vector if there are no frames.
+  std::vector<float> GetFeatures(OnlineStream *s, int32_t *num_frames) const {
+    *num_frames = s->NumFramesReady() - s->GetNumProcessedFrames();
+    if (*num_frames <= 0) {
 #if __OHOS__
       SHERPA_ONNX_LOGE(
           "Please make sure IsReady(s) returns true. num_frames: %{public}d",
-          num_frames);
+          *num_frames);
 #else
       SHERPA_ONNX_LOGE(
           "Please make sure IsReady(s) returns true. num_frames: %d",
-          num_frames);
+          *num_frames);
 #endif
       return {};
     }
 
     std::vector<float> features =
-        s->GetFrames(s->GetNumProcessedFrames(), num_frames);
+        s->GetFrames(s->GetNumProcessedFrames(), *num_frames);
 
-    s->GetNumProcessedFrames() += num_frames;
+    s->GetNumProcessedFrames() += *num_frames;
 
-    int32_t feat_dim = features.size() / num_frames;
+    int32_t feat_dim = features.size() / *num_frames;
 
     const auto &meta_data = model_.GetMetaData();
     if (!meta_data.feature_normalize_type.empty()) {
       if (meta_data.feature_normalize_type == "per_feature") {
-        NormalizePerFeature(features.data(), num_frames, feat_dim);
+        NormalizePerFeature(features.data(), *num_frames, feat_dim);
       } else {
 #if __OHOS__
         SHERPA_ONNX_LOGE("Unsupported feature_normalize_type: %{public}s",
@@ -89,39 +151,65 @@ class SpeakerEmbeddingExtractorNeMoImpl : public SpeakerEmbeddingExtractorImpl {
       }
     }
 
-    if (num_frames % 16 != 0) {
-      int32_t pad = 16 - num_frames % 16;
-      features.resize((num_frames + pad) * feat_dim);
+    return features;
+  }
+
+  /* Run the model.
+   *
+   * @param features features[i] contains num_frames[i] frames of the i-th
+   *                 input.
+   * @param num_frames Number of frames of each input.
+   * @param n Number of inputs.
+   * @return Return n embeddings.
+   */
+  std::vector<std::vector<float>> Run(const float *const *features,
+                                      const int32_t *num_frames,
+                                      int32_t n) const {
+    int32_t feat_dim = model_.GetMetaData().feat_dim;
+    int32_t max_num_frames = *std::max_element(num_frames, num_frames + n);
+
+    // Inputs are padded with zeros to the longest one
+    std::vector<float> x_buf(static_cast<size_t>(n) * max_num_frames *
+                             feat_dim);
+    std::vector<int64_t> x_lens(n);
+    for (int32_t i = 0; i != n; ++i) {
+      std::copy(features[i], features[i] + num_frames[i] * feat_dim,
+                x_buf.data() +
+                    static_cast<size_t>(i) * max_num_frames * feat_dim);
+      x_lens[i] = num_frames[i];
     }
 
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    std::array<int64_t, 3> x_shape{1, num_frames, feat_dim};
+    std::array<int64_t, 3> x_shape{n, max_num_frames, feat_dim};
     Ort::Value x =
-        Ort::Value::CreateTensor(memory_info, features.data(), features.size(),
+        Ort::Value::CreateTensor(memory_info, x_buf.data(), x_buf.size(),
                                  x_shape.data(), x_shape.size());
 
     x = Transpose12(model_.Allocator(), &x);
 
-    int64_t x_lens = num_frames;
-    std::array<int64_t, 1> x_lens_shape{1};
-    Ort::Value x_lens_tensor = Ort::Value::CreateTensor(
-        memory_info, &x_lens, 1, x_lens_shape.data(), x_lens_shape.size());
+    std::array<int64_t, 1> x_lens_shape{n};
+    Ort::Value x_lens_tensor =
+        Ort::Value::CreateTensor(memory_info, x_lens.data(), n,
+                                 x_lens_shape.data(), x_lens_shape.size());
 
     Ort::Value embedding =
         model_.Compute(std::move(x), std::move(x_lens_tensor));
     std::vector<int64_t> embedding_shape =
         embedding.GetTensorTypeAndShapeInfo().GetShape();
 
-    std::vector<float> ans(embedding_shape[1]);
-    std::copy(embedding.GetTensorData<float>(),
-              embedding.GetTensorData<float>() + ans.size(), ans.begin());
+    int32_t dim = embedding_shape[1];
+    const float *p = embedding.GetTensorData<float>();
+
+    std::vector<std::vector<float>> ans(n);
+    for (int32_t i = 0; i != n; ++i, p += dim) {
+      ans[i].assign(p, p + dim);
+    }
 
     return ans;
   }
 
- private:
   void NormalizePerFeature(float *p, int32_t num_frames,
                            int32_t feat_dim) const {
     auto m = Eigen::Map<
@@ -138,6 +226,7 @@ class SpeakerEmbeddingExtractorNeMoImpl : public SpeakerEmbeddingExtractorImpl {
 
  private:
   SpeakerEmbeddingExtractorNeMoModel model_;
+  int32_t batch_size_;
 };
 
 }  // namespace sherpa_onnx
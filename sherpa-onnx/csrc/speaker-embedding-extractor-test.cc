@@ -0,0 +1,107 @@
+// sherpa-onnx/csrc/speaker-embedding-extractor-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace sherpa_onnx {
+
+// Please download the models and the test wave from
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/speaker-recongition-models/3dspeaker_speech_eres2net_base_sv_zh-cn_3dspeaker_16k.onnx
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/speaker-recongition-models/nemo_en_titanet_small.onnx
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/speaker-segmentation-models/0-four-speakers-zh.wav
+const char *const kWave = "./0-four-speakers-zh.wav";
+
+static float CosineSimilarity(const std::vector<float> &a,
+                              const std::vector<float> &b) {
+  float ab = 0;
+  float aa = 0;
+  float bb = 0;
+  for (size_t i = 0; i != a.size(); ++i) {
+    ab += a[i] * b[i];
+    aa += a[i] * a[i];
+    bb += b[i] * b[i];
+  }
+
+  return ab / std::sqrt(aa * bb);
+}
+
+// ComputeBatch() gives the same embeddings as Compute() for each stream
+static void TestComputeBatch(const std::string &model) {
+  if (!FileExists(model) || !FileExists(kWave)) {
+    SHERPA_ONNX_LOGE("%s or %s does not exist. Skipping test", model.c_str(),
+                     kWave);
+    return;
+  }
+
+  int32_t sample_rate = 0;
+  bool is_ok = false;
+  std::vector<float> samples = ReadWave(kWave, &sample_rate, &is_ok);
+  ASSERT_TRUE(is_ok);
+
+  SpeakerEmbeddingExtractorConfig config;
+  config.model = model;
+  config.batch_size = 3;
+  SpeakerEmbeddingExtractor extractor(config);
+
+  // Segments of different lengths. Some of them have the same length so
+  // that they can share a batch with every kind of model.
+  std::vector<std::pair<int32_t, int32_t>> segments;
+  for (int32_t i = 0; i != 8; ++i) {
+    int32_t start = i * sample_rate;
+    int32_t n = (1 + i % 3) * sample_rate / 2;
+    if (start + n <= static_cast<int32_t>(samples.size())) {
+      segments.emplace_back(start, n);
+    }
+  }
+  ASSERT_FALSE(segments.empty());
+
+  auto create_stream = [&](const std::pair<int32_t, int32_t> &seg) {
+    auto s = extractor.CreateStream();
+    s->AcceptWaveform(sample_rate, samples.data() + seg.first, seg.second);
+    s->InputFinished();
+    EXPECT_TRUE(extractor.IsReady(s.get()));
+    return s;
+  };
+
+  std::vector<std::unique_ptr<OnlineStream>> streams;
+  std::vector<OnlineStream *> ss;
+  for (const auto &seg : segments) {
+    streams.push_back(create_stream(seg));
+    ss.push_back(streams.back().get());
+  }
+
+  auto embeddings =
+      extractor.ComputeBatch(ss.data(), static_cast<int32_t>(ss.size()));
+  ASSERT_EQ(embeddings.size(), segments.size());
+
+  for (size_t i = 0; i != segments.size(); ++i) {
+    auto s = create_stream(segments[i]);
+    std::vector<float> expected = extractor.Compute(s.get());
+
+    ASSERT_EQ(embeddings[i].size(), expected.size());
+    EXPECT_GT(CosineSimilarity(embeddings[i], expected), 0.999f) << i;
+  }
+}
+
+TEST(SpeakerEmbeddingExtractor, ComputeBatchGeneral) {
+  TestComputeBatch(
+      "./3dspeaker_speech_eres2net_base_sv_zh-cn_3dspeaker_16k.onnx");
+}
+
+TEST(SpeakerEmbeddingExtractor, ComputeBatchNeMo) {
+  TestComputeBatch("./nemo_en_titanet_small.onnx");
+}
+
+}  // namespace sherpa_onnx
@@ -31,6 +31,10 @@ void SpeakerEmbeddingExtractorConfig::Register(ParseOptions *po) {
 
   po->Register("provider", &provider,
                "Specify a provider to use: cpu, cuda, coreml");
+
+  po->Register("batch-size", &batch_size,
+               "Maximum number of streams processed by the model in a single "
+               "call when computing embeddings of many streams.");
 }
 
 bool SpeakerEmbeddingExtractorConfig::Validate() const {
@@ -45,6 +49,11 @@ bool SpeakerEmbeddingExtractorConfig::Validate() const {
     return false;
   }
 
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("batch_size should be > 0. Given %d", batch_size);
+    return false;
+  }
+
   return true;
 }
 
@@ -55,7 +64,8 @@ std::string SpeakerEmbeddingExtractorConfig::ToString() const {
   os << "model=\"" << model << "\", ";
   os << "num_threads=" << num_threads << ", ";
   os << "debug=" << (debug ? "True" : "False") << ", ";
-  os << "provider=\"" << provider << "\")";
+  os << "provider=\"" << provider << "\", ";
+  os << "batch_size=" << batch_size << ")";
 
   return os.str();
 }
@@ -85,6 +95,11 @@ std::vector<float> SpeakerEmbeddingExtractor::Compute(OnlineStream *s) const {
   return impl_->Compute(s);
 }
 
+std::vector<std::vector<float>> SpeakerEmbeddingExtractor::ComputeBatch(
+    OnlineStream **ss, int32_t n) const {
+  return impl_->ComputeBatch(ss, n);
+}
+
 #if __ANDROID_API__ >= 9
 template SpeakerEmbeddingExtractor::SpeakerEmbeddingExtractor(
     AAssetManager *mgr, const SpeakerEmbeddingExtractorConfig &config);
@@ -20,6 +20,10 @@ struct SpeakerEmbeddingExtractorConfig {
   bool debug = false;
   std::string provider = "cpu";
 
+  // Maximum number of streams processed by the model in a single call
+  // in ComputeBatch()
+  int32_t batch_size = 16;
+
   SpeakerEmbeddingExtractorConfig() = default;
   SpeakerEmbeddingExtractorConfig(const std::string &model, int32_t num_threads,
                                   bool debug, const std::string &provider)
@@ -62,6 +66,19 @@ class SpeakerEmbeddingExtractor {
   // You have to ensure IsReady(s) returns true before you call this method.
   std::vector<float> Compute(OnlineStream *s) const;
 
+  /** Compute the speaker embeddings of n streams.
+   *
+   * Streams are grouped by the number of feature frames and processed in
+   * batches of at most config.batch_size, so the result is the same as
+   * calling Compute() for each stream.
+   *
+   * You have to ensure IsReady(ss[i]) returns true for all i.
+   *
+   * @return Return a vector of size n. ans[i] is the embedding of ss[i].
+   */
+  std::vector<std::vector<float>> ComputeBatch(OnlineStream **ss,
+                                               int32_t n) const;
+
  private:
   std::unique_ptr<SpeakerEmbeddingExtractorImpl> impl_;
 };
@@ -0,0 +1,61 @@
+// sherpa-onnx/csrc/speaker-embedding-manager-config.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/speaker-embedding-manager-config.h"
+
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void SpeakerEmbeddingManagerConfig::Register(ParseOptions *po) {
+  po->Register("speaker-index-num-lists", &index_num_lists,
+               "If positive, use an approximate index with this number of "
+               "lists to search speakers. 0 means exact search.");
+
+  po->Register("speaker-index-num-probes", &index_num_probes,
+               "Number of lists of the approximate index to search for each "
+               "query.");
+
+  po->Register("speaker-index-min-num-speakers", &index_min_num_speakers,
+               "Use the approximate index only if there are at least this "
+               "number of speakers.");
+}
+
+bool SpeakerEmbeddingManagerConfig::Validate() const {
+  if (index_num_lists < 0) {
+    SHERPA_ONNX_LOGE("index_num_lists should be >= 0. Given: %d",
+                     index_num_lists);
+    return false;
+  }
+
+  if (index_num_probes < 1) {
+    SHERPA_ONNX_LOGE("index_num_probes should be > 0. Given: %d",
+                     index_num_probes);
+    return false;
+  }
+
+  if (index_min_num_speakers < 1) {
+    SHERPA_ONNX_LOGE("index_min_num_speakers should be > 0. Given: %d",
+                     index_min_num_speakers);
+    return false;
+  }
+
+  return true;
+}
+
+std::string SpeakerEmbeddingManagerConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "SpeakerEmbeddingManagerConfig(";
+  os << "index_num_lists=" << index_num_lists << ", ";
+  os << "index_num_probes=" << index_num_probes << ", ";
+  os << "index_min_num_speakers=" << index_min_num_speakers << ")";
+
+  return os.str();
+}
+
+}  // namespace sherpa_onnx
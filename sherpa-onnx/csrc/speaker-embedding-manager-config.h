@@ -0,0 +1,46 @@
+// sherpa-onnx/csrc/speaker-embedding-manager-config.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_MANAGER_CONFIG_H_
+#define SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_MANAGER_CONFIG_H_
+
+#include <string>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+struct SpeakerEmbeddingManagerConfig {
+  // If greater than 0, an inverted file (IVF) index with this number of
+  // lists is used to search large registries approximately. A value
+  // around sqrt(number of speakers) works well, e.g., 1024 for 1 million
+  // speakers. 0 means every search compares with all speakers.
+  int32_t index_num_lists = 0;
+
+  // Number of lists of the index searched for each query. Larger values
+  // are slower but find the exact best match more often.
+  int32_t index_num_probes = 16;
+
+  // The index is built and used only if there are at least this number
+  // of speakers. Exact search is fast enough for smaller registries.
+  int32_t index_min_num_speakers = 100000;
+
+  SpeakerEmbeddingManagerConfig() = default;
+
+  SpeakerEmbeddingManagerConfig(int32_t index_num_lists,
+                                int32_t index_num_probes,
+                                int32_t index_min_num_speakers)
+      : index_num_lists(index_num_lists),
+        index_num_probes(index_num_probes),
+        index_min_num_speakers(index_min_num_speakers) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_MANAGER_CONFIG_H_
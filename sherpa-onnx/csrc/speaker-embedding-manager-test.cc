@@ -4,10 +4,40 @@
 
 #include "sherpa-onnx/csrc/speaker-embedding-manager.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace sherpa_onnx {
 
+static std::vector<float> RandomEmbeddings(int32_t n, int32_t dim,
+                                           int32_t seed) {
+  std::mt19937 gen(seed);
+  std::normal_distribution<float> normal;
+
+  std::vector<float> ans(n * dim);
+  for (auto &f : ans) {
+    f = normal(gen);
+  }
+
+  return ans;
+}
+
+static std::vector<std::string> SpeakerNames(int32_t n) {
+  std::vector<std::string> ans;
+  for (int32_t i = 0; i != n; ++i) {
+    ans.push_back("speaker-" + std::to_string(i));
+  }
+
+  return ans;
+}
+
 TEST(SpeakerEmbeddingManager, AddAndRemove) {
   int32_t dim = 2;
   SpeakerEmbeddingManager manager(dim);
@@ -144,4 +174,255 @@ TEST(SpeakerEmbeddingManager, Verify) {
   ASSERT_FALSE(status);
 }
 
+TEST(SpeakerEmbeddingManager, AddMany) {
+  int32_t dim = 8;
+  int32_t n = 100;
+  SpeakerEmbeddingManager manager(dim);
+
+  std::vector<std::string> names = SpeakerNames(n);
+  std::vector<float> embeddings = RandomEmbeddings(n, dim, 0);
+
+  ASSERT_TRUE(manager.Add(names[0], embeddings.data()));
+  EXPECT_EQ(manager.AddMany(names, embeddings.data()), n - 1);
+  EXPECT_EQ(manager.NumSpeakers(), n);
+
+  for (int32_t i = 0; i != n; ++i) {
+    EXPECT_EQ(manager.Search(embeddings.data() + i * dim, 0.99), names[i]);
+  }
+}
+
+TEST(SpeakerEmbeddingManager, RemoveKeepsOtherSpeakers) {
+  int32_t dim = 8;
+  int32_t n = 50;
+  SpeakerEmbeddingManager manager(dim);
+
+  std::vector<std::string> names = SpeakerNames(n);
+  std::vector<float> embeddings = RandomEmbeddings(n, dim, 1);
+  manager.AddMany(names, embeddings.data());
+
+  for (int32_t i = 0; i < n; i += 3) {
+    ASSERT_TRUE(manager.Remove(names[i]));
+  }
+
+  for (int32_t i = 0; i != n; ++i) {
+    const float *p = embeddings.data() + i * dim;
+    if (i % 3 == 0) {
+      EXPECT_FALSE(manager.Contains(names[i]));
+      EXPECT_NE(manager.Search(p, 0.99), names[i]);
+    } else {
+      EXPECT_TRUE(manager.Verify(names[i], p, 0.99));
+      EXPECT_EQ(manager.Search(p, 0.99), names[i]);
+    }
+  }
+}
+
+TEST(SpeakerEmbeddingManager, SearchMany) {
+  int32_t dim = 16;
+  int32_t n = 200;
+  int32_t num_queries = 300;
+  SpeakerEmbeddingManager manager(dim);
+
+  std::vector<std::string> names = SpeakerNames(n);
+  std::vector<float> embeddings = RandomEmbeddings(n, dim, 2);
+  manager.AddMany(names, embeddings.data());
+
+  std::vector<float> queries = RandomEmbeddings(num_queries, dim, 3);
+
+  float threshold = 0.5;
+  std::vector<std::string> results =
+      manager.SearchMany(queries.data(), num_queries, threshold);
+  ASSERT_EQ(static_cast<int32_t>(results.size()), num_queries);
+
+  for (int32_t i = 0; i != num_queries; ++i) {
+    EXPECT_EQ(results[i], manager.Search(queries.data() + i * dim, threshold));
+  }
+}
+
+TEST(SpeakerEmbeddingManager, Index) {
+  int32_t dim = 16;
+  int32_t n = 2000;
+  int32_t num_lists = 20;
+  int32_t num_queries = 200;
+
+  std::vector<std::string> names = SpeakerNames(n);
+  std::vector<float> embeddings = RandomEmbeddings(n, dim, 4);
+  std::vector<float> queries = RandomEmbeddings(num_queries, dim, 5);
+
+  SpeakerEmbeddingManager exact(dim);
+  exact.AddMany(names, embeddings.data());
+
+  // Searching all lists gives the exact result
+  SpeakerEmbeddingManagerConfig config(num_lists, num_lists, 1000);
+  SpeakerEmbeddingManager manager(dim, config);
+  for (int32_t i = 0; i != n; ++i) {
+    manager.Add(names[i], embeddings.data() + i * dim);
+  }
+
+  for (int32_t i = 0; i < n; i += 7) {
+    exact.Remove(names[i]);
+    manager.Remove(names[i]);
+  }
+
+  for (int32_t i = 0; i != num_queries; ++i) {
+    const float *p = queries.data() + i * dim;
+    EXPECT_EQ(manager.Search(p, 0), exact.Search(p, 0));
+  }
+
+  // With fewer probes most results are still exact
+  config.index_num_probes = 5;
+  SpeakerEmbeddingManager approximate(dim, config);
+  approximate.AddMany(names, embeddings.data());
+
+  int32_t num_correct = 0;
+  for (int32_t i = 0; i != num_queries; ++i) {
+    const float *p = queries.data() + i * dim;
+    num_correct += approximate.Search(p, 0) == exact.Search(p, 0);
+  }
+  EXPECT_GT(num_correct, num_queries * 0.6);
+
+  // Each speaker finds itself
+  for (int32_t i = 0; i != n; ++i) {
+    EXPECT_EQ(approximate.Search(embeddings.data() + i * dim, 0.99),
+              names[i]);
+  }
+}
+
+TEST(SpeakerEmbeddingManager, SaveAndLoad) {
+  std::string filename = "speaker-embedding-manager-test.bin";
+  int32_t dim = 8;
+  int32_t n = 100;
+
+  std::vector<std::string> names = SpeakerNames(n);
+  std::vector<float> embeddings = RandomEmbeddings(n, dim, 6);
+
+  {
+    SpeakerEmbeddingManager manager(dim);
+    manager.AddMany(names, embeddings.data());
+    manager.Remove(names[0]);
+    ASSERT_TRUE(manager.Save(filename));
+  }
+
+  SpeakerEmbeddingManager manager(dim);
+  ASSERT_TRUE(manager.Add("to-be-replaced", embeddings.data()));
+  ASSERT_TRUE(manager.Load(filename));
+  EXPECT_EQ(manager.NumSpeakers(), n - 1);
+  EXPECT_FALSE(manager.Contains("to-be-replaced"));
+  EXPECT_FALSE(manager.Contains(names[0]));
+
+  for (int32_t i = 1; i != n; ++i) {
+    const float *p = embeddings.data() + i * dim;
+    EXPECT_EQ(manager.Search(p, 0.99), names[i]);
+    EXPECT_TRUE(manager.Verify(names[i], p, 0.99));
+  }
+
+  // Modify the loaded registry and append the changes
+  ASSERT_TRUE(manager.Add(names[0], embeddings.data()));
+  ASSERT_TRUE(manager.Remove(names[1]));
+  ASSERT_TRUE(manager.Remove(names[2]));
+  ASSERT_TRUE(manager.Add(names[2], embeddings.data() + 3 * dim));
+  ASSERT_TRUE(manager.Append(filename));
+
+  SpeakerEmbeddingManager loaded(dim);
+  ASSERT_TRUE(loaded.Load(filename));
+  EXPECT_EQ(loaded.GetAllSpeakers(), manager.GetAllSpeakers());
+  EXPECT_TRUE(loaded.Verify(names[0], embeddings.data(), 0.99));
+  EXPECT_FALSE(loaded.Contains(names[1]));
+  EXPECT_TRUE(loaded.Verify(names[2], embeddings.data() + 3 * dim, 0.99));
+
+  // Compact the file
+  ASSERT_TRUE(loaded.Save(filename));
+
+  SpeakerEmbeddingManager compacted(dim);
+  ASSERT_TRUE(compacted.Load(filename));
+  EXPECT_EQ(compacted.GetAllSpeakers(), manager.GetAllSpeakers());
+
+  // A different dim
+  SpeakerEmbeddingManager other(dim + 1);
+  EXPECT_FALSE(other.Load(filename));
+
+  std::remove(filename.c_str());
+
+  EXPECT_FALSE(other.Load(filename));
+}
+
+static std::string ReadFile(const std::string &filename) {
+  std::ifstream is(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(is), {});
+}
+
+static void WriteFile(const std::string &filename, const std::string &s) {
+  std::ofstream os(filename, std::ios::binary);
+  os.write(s.data(), s.size());
+}
+
+TEST(SpeakerEmbeddingManager, LoadInvalidFile) {
+  std::string filename = "speaker-embedding-manager-test-invalid.bin";
+  int32_t dim = 4;
+  int32_t n = 3;
+
+  std::vector<std::string> names = SpeakerNames(n);
+  std::vector<float> embeddings = RandomEmbeddings(n, dim, 7);
+
+  std::string valid;
+  {
+    SpeakerEmbeddingManager manager(dim);
+    manager.AddMany(names, embeddings.data());
+    ASSERT_TRUE(manager.Save(filename));
+    valid = ReadFile(filename);
+  }
+
+  // Header: 8 + 4 * 4 bytes. The name offsets follow the embeddings.
+  size_t offsets = 24 + n * dim * sizeof(float);
+
+  SpeakerEmbeddingManager manager(dim);
+  ASSERT_TRUE(manager.Add("existing", embeddings.data()));
+
+  auto expect_unchanged = [&]() {
+    EXPECT_EQ(manager.NumSpeakers(), 1);
+    EXPECT_TRUE(manager.Contains("existing"));
+  };
+
+  // Decreasing name offsets
+  std::string s = valid;
+  uint32_t v = 3;
+  std::memcpy(&s[offsets + 2 * sizeof(uint32_t)], &v, sizeof(v));
+  WriteFile(filename, s);
+  EXPECT_FALSE(manager.Load(filename));
+  expect_unchanged();
+
+  // Name offsets beyond the end of the file
+  s = valid;
+  v = 1000;
+  std::memcpy(&s[offsets + n * sizeof(uint32_t)], &v, sizeof(v));
+  WriteFile(filename, s);
+  EXPECT_FALSE(manager.Load(filename));
+  expect_unchanged();
+
+  // A valid record followed by a truncated one
+  s = valid;
+  int32_t op = 2;  // remove
+  int32_t len = static_cast<int32_t>(names[0].size());
+  s.append(reinterpret_cast<const char *>(&op), sizeof(op));
+  s.append(reinterpret_cast<const char *>(&len), sizeof(len));
+  s.append(names[0]);
+  op = 1;  // add
+  s.append(reinterpret_cast<const char *>(&op), sizeof(op));
+  s.append(reinterpret_cast<const char *>(&len), sizeof(len));
+  s.append(names[0]);
+  WriteFile(filename, s);
+  EXPECT_FALSE(manager.Load(filename));
+  expect_unchanged();
+
+  // Append() needs a preceding Save() or Load()
+  WriteFile(filename, valid);
+  SpeakerEmbeddingManager fresh(dim);
+  ASSERT_TRUE(fresh.Add("new", embeddings.data()));
+  EXPECT_FALSE(fresh.Append(filename));
+
+  ASSERT_TRUE(manager.Load(filename));
+  EXPECT_EQ(manager.GetAllSpeakers(), names);
+
+  std::remove(filename.c_str());
+}
+
 }  // namespace sherpa_onnx
@@ -5,41 +5,265 @@
 #include "sherpa-onnx/csrc/speaker-embedding-manager.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <numeric>
+#include <random>
 #include <unordered_map>
 #include <utility>
 
 #include "Eigen/Dense"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/mapped-file.h"
 
 namespace sherpa_onnx {
 
 using FloatMatrix =
     Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
+namespace {
+
+// Maximum number of entries of a temporary score matrix
+constexpr int32_t kMaxScoreBlockSize = 1 << 22;
+
+// Number of rows per list used to train the index
+constexpr int32_t kNumTrainRowsPerList = 64;
+
+constexpr int32_t kNumTrainIterations = 10;
+
+/* Layout of a registry file. All values are in the byte order of the host.
+ *
+ *   RegistryHeader
+ *   float embeddings[num_speakers][dim]  // each row has unit length
+ *   uint32_t name_offsets[num_speakers + 1]
+ *   char names[name_offsets[num_speakers]]
+ *
+ * followed by zero or more records written by Append():
+ *
+ *   int32_t op  // kRecordAdd or kRecordRemove
+ *   int32_t name_length
+ *   char name[name_length]
+ *   float embedding[dim]  // only for kRecordAdd
+ */
+constexpr char kRegistryMagic[8] = {'S', 'H', 'E', 'R', 'P', 'A', 'S', 'R'};
+constexpr int32_t kRegistryVersion = 1;
+
+constexpr int32_t kRecordAdd = 1;
+constexpr int32_t kRecordRemove = 2;
+
+struct RegistryHeader {
+  char magic[8];
+  int32_t version;
+  int32_t dim;
+  int32_t num_speakers;
+  int32_t reserved;
+};
+
+template <typename T>
+void WriteValue(std::ostream &os, const T &v) {  // NOLINT
+  os.write(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+// Return false if there are not enough bytes
+template <typename T>
+bool ReadValue(const char **p, const char *end, T *v) {
+  if (end - *p < static_cast<std::ptrdiff_t>(sizeof(T))) {
+    return false;
+  }
+
+  std::memcpy(v, *p, sizeof(T));
+  *p += sizeof(T);
+
+  return true;
+}
+
+// Return the index of the largest entry of each row of m * c^T
+template <typename Derived>
+std::vector<int32_t> NearestRows(const Eigen::MatrixBase<Derived> &m,
+                                 const FloatMatrix &c) {
+  int32_t num_rows = m.rows();
+  std::vector<int32_t> ans(num_rows);
+
+  int32_t block_size =
+      std::max<int32_t>(1, kMaxScoreBlockSize / std::max<int32_t>(1, c.rows()));
+
+  FloatMatrix scores;
+  for (int32_t i = 0; i < num_rows; i += block_size) {
+    int32_t b = std::min(block_size, num_rows - i);
+    scores.noalias() = m.middleRows(i, b) * c.transpose();
+
+    for (int32_t r = 0; r != b; ++r) {
+      Eigen::Index k = 0;
+      scores.row(r).maxCoeff(&k);
+      ans[i + r] = k;
+    }
+  }
+
+  return ans;
+}
+
+/* An inverted file index for cosine similarity.
+ *
+ * Rows are assigned to the nearest of num_lists centroids found with
+ * k-means. A query is compared only with the rows of the lists of its
+ * num_probes nearest centroids.
+ */
+class InvertedFileIndex {
+ public:
+  // Train the index on the rows of m and add them.
+  // Rows of m must have unit length.
+  void Build(const Eigen::Ref<const FloatMatrix> &m, int32_t num_lists) {
+    int32_t num_rows = m.rows();
+    num_lists = std::min(num_lists, num_rows);
+
+    int32_t num_train_rows =
+        std::min(num_rows, num_lists * kNumTrainRowsPerList);
+
+    std::vector<int32_t> indexes(num_rows);
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    std::mt19937 gen(0);
+    std::shuffle(indexes.begin(), indexes.end(), gen);
+    indexes.resize(num_train_rows);
+
+    FloatMatrix x(num_train_rows, m.cols());
+    for (int32_t i = 0; i != num_train_rows; ++i) {
+      x.row(i) = m.row(indexes[i]);
+    }
+
+    // Spherical k-means initialized with random rows
+    centroids_ = x.topRows(num_lists);
+    for (int32_t iter = 0; iter != kNumTrainIterations; ++iter) {
+      std::vector<int32_t> labels = NearestRows(x, centroids_);
+
+      FloatMatrix sum = FloatMatrix::Zero(num_lists, m.cols());
+      std::vector<int32_t> count(num_lists);
+      for (int32_t i = 0; i != num_train_rows; ++i) {
+        sum.row(labels[i]) += x.row(i);
+        count[labels[i]] += 1;
+      }
+
+      for (int32_t k = 0; k != num_lists; ++k) {
+        // An empty list keeps its centroid
+        if (count[k] > 0) {
+          centroids_.row(k) = sum.row(k).normalized();
+        }
+      }
+    }
+
+    lists_.assign(num_lists, {});
+    row2list_.clear();
+    row2pos_.clear();
+
+    std::vector<int32_t> labels = NearestRows(m, centroids_);
+    for (int32_t i = 0; i != num_rows; ++i) {
+      Insert(i, labels[i]);
+    }
+  }
+
+  bool Empty() const { return lists_.empty(); }
+
+  // Add row i, whose embedding is v. It must be the last row.
+  void Add(int32_t i, const Eigen::RowVectorXf &v) {
+    Eigen::Index k = 0;
+    (centroids_ * v.transpose()).maxCoeff(&k);
+    Insert(i, k);
+  }
+
+  // Remove row i and then rename the row from to i. It follows the
+  // swap-remove of the rows of the embedding matrix.
+  void Remove(int32_t i, int32_t from) {
+    auto &list = lists_[row2list_[i]];
+    int32_t pos = row2pos_[i];
+
+    list[pos] = list.back();
+    row2pos_[list[pos]] = pos;
+    list.pop_back();
+
+    if (from != i) {
+      lists_[row2list_[from]][row2pos_[from]] = i;
+      row2list_[i] = row2list_[from];
+      row2pos_[i] = row2pos_[from];
+    }
+
+    row2list_.pop_back();
+    row2pos_.pop_back();
+  }
+
+  // Return the rows to compare with the query v, which has unit length
+  std::vector<int32_t> Candidates(const Eigen::VectorXf &v,
+                                  int32_t num_probes) const {
+    Eigen::VectorXf scores = centroids_ * v;
+    int32_t num_lists = scores.size();
+    num_probes = std::min(num_probes, num_lists);
+
+    std::vector<int32_t> order(num_lists);
+    std::iota(order.begin(), order.end(), 0);
+    std::partial_sort(
+        order.begin(), order.begin() + num_probes, order.end(),
+        [&scores](int32_t a, int32_t b) { return scores[a] > scores[b]; });
+
+    std::vector<int32_t> ans;
+    for (int32_t k = 0; k != num_probes; ++k) {
+      const auto &list = lists_[order[k]];
+      ans.insert(ans.end(), list.begin(), list.end());
+    }
+
+    return ans;
+  }
+
+ private:
+  void Insert(int32_t i, int32_t list_index) {
+    row2list_.push_back(list_index);
+    row2pos_.push_back(lists_[list_index].size());
+    lists_[list_index].push_back(i);
+  }
+
+ private:
+  // (num_lists, dim). Each row has unit length.
+  FloatMatrix centroids_;
+
+  // lists_[k] contains the rows whose nearest centroid is k
+  std::vector<std::vector<int32_t>> lists_;
+
+  // Row i is lists_[row2list_[i]][row2pos_[i]]
+  std::vector<int32_t> row2list_;
+  std::vector<int32_t> row2pos_;
+};
+
+}  // namespace
+
 class SpeakerEmbeddingManager::Impl {
  public:
-  explicit Impl(int32_t dim) : dim_(dim) {}
+  explicit Impl(int32_t dim, const SpeakerEmbeddingManagerConfig &config)
+      : dim_(dim), config_(config) {}
 
   bool Add(const std::string &name, const float *p) {
+    Materialize();
+
     if (name2row_.count(name)) {
       // a speaker with the same name already exists
       return false;
     }
 
-    embedding_matrix_.conservativeResize(embedding_matrix_.rows() + 1, dim_);
+    Reserve(num_rows_ + 1);
 
-    std::copy(p, p + dim_, &embedding_matrix_.bottomRows(1)(0, 0));
+    Eigen::Map<const Eigen::RowVectorXf> v(p, dim_);
+    AddRow(name, v.normalized());
 
-    embedding_matrix_.bottomRows(1).normalize();  // inplace
-
-    name2row_[name] = embedding_matrix_.rows() - 1;
-    row2name_[embedding_matrix_.rows() - 1] = name;
+    MaybeBuildIndex();
 
     return true;
   }
 
   bool Add(const std::string &name,
            const std::vector<std::vector<float>> &embedding_list) {
+    Materialize();
+
     if (name2row_.count(name)) {
       // a speaker with the same name already exists
       return false;
@@ -75,45 +299,72 @@ class SpeakerEmbeddingManager::Impl {
 
     v.normalize();
 
-    embedding_matrix_.conservativeResize(embedding_matrix_.rows() + 1, dim_);
-    embedding_matrix_.bottomRows(1) = v;
+    Reserve(num_rows_ + 1);
+    AddRow(name, v);
 
-    name2row_[name] = embedding_matrix_.rows() - 1;
-    row2name_[embedding_matrix_.rows() - 1] = name;
+    MaybeBuildIndex();
 
     return true;
   }
 
+  int32_t AddMany(const std::vector<std::string> &names, const float *p) {
+    Materialize();
+
+    int32_t n = static_cast<int32_t>(names.size());
+    Reserve(num_rows_ + n);
+
+    int32_t num_added = 0;
+    for (int32_t i = 0; i != n; ++i) {
+      if (name2row_.count(names[i])) {
+        continue;
+      }
+
+      Eigen::Map<const Eigen::RowVectorXf> v(
+          p + static_cast<size_t>(i) * dim_, dim_);
+      AddRow(names[i], v.normalized());
+      num_added += 1;
+    }
+
+    MaybeBuildIndex();
+
+    return num_added;
+  }
+
   bool Remove(const std::string &name) {
-    if (!name2row_.count(name)) {
+    Materialize();
+
+    auto it = name2row_.find(name);
+    if (it == name2row_.end()) {
       return false;
     }
 
-    int32_t row_idx = name2row_.at(name);
-
-    int32_t num_rows = embedding_matrix_.rows();
+    int32_t row_idx = it->second;
+    int32_t last = num_rows_ - 1;
 
-    if (row_idx < num_rows - 1) {
-      embedding_matrix_.block(row_idx, 0, num_rows - 1 - row_idx, dim_) =
-          embedding_matrix_.bottomRows(num_rows - 1 - row_idx);
+    // Move the last row into the removed one so that no other rows move
+    if (row_idx != last) {
+      embedding_matrix_.row(row_idx) = embedding_matrix_.row(last);
+      row2name_[row_idx] = std::move(row2name_[last]);
+      name2row_[row2name_[row_idx]] = row_idx;
     }
 
-    embedding_matrix_.conservativeResize(num_rows - 1, dim_);
-    for (auto &p : name2row_) {
-      if (p.second > row_idx) {
-        p.second -= 1;
-        row2name_[p.second] = p.first;
-      }
+    if (!index_.Empty()) {
+      index_.Remove(row_idx, last);
     }
 
-    name2row_.erase(name);
-    row2name_.erase(num_rows - 1);
+    name2row_.erase(it);
+    row2name_.pop_back();
+    num_rows_ -= 1;
+
+    if (track_changes_) {
+      changes_.emplace_back(kRecordRemove, name);
+    }
 
     return true;
   }
 
   std::string Search(const float *p, float threshold) {
-    if (embedding_matrix_.rows() == 0) {
+    if (num_rows_ == 0) {
       return {};
     }
 
@@ -121,7 +372,11 @@ class SpeakerEmbeddingManager::Impl {
         Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
     v.normalize();
 
-    Eigen::VectorXf scores = embedding_matrix_ * v;
+    std::vector<int32_t> rows;
+    Eigen::VectorXf scores = ComputeScores(v, &rows);
+    if (scores.size() == 0) {
+      return {};
+    }
 
     Eigen::VectorXf::Index max_index = 0;
     float max_score = scores.maxCoeff(&max_index);
@@ -129,14 +384,51 @@ class SpeakerEmbeddingManager::Impl {
       return {};
     }
 
-    return row2name_.at(max_index);
+    return Name(rows.empty() ? max_index : rows[max_index]);
+  }
+
+  std::vector<std::string> SearchMany(const float *p, int32_t n,
+                                      float threshold) {
+    std::vector<std::string> ans(n);
+    if (num_rows_ == 0) {
+      return ans;
+    }
+
+    if (UseIndex()) {
+      for (int32_t i = 0; i != n; ++i) {
+        ans[i] = Search(p + static_cast<size_t>(i) * dim_, threshold);
+      }
+      return ans;
+    }
+
+    FloatMatrix queries =
+        Eigen::Map<const FloatMatrix>(p, n, dim_).rowwise().normalized();
+
+    // Queries are processed in blocks to limit the memory of the scores
+    int32_t block_size = std::max(1, kMaxScoreBlockSize / num_rows_);
+
+    FloatMatrix scores;
+    for (int32_t i = 0; i < n; i += block_size) {
+      int32_t b = std::min(block_size, n - i);
+      scores.noalias() = queries.middleRows(i, b) * Embeddings().transpose();
+
+      for (int32_t r = 0; r != b; ++r) {
+        Eigen::Index max_index = 0;
+        float max_score = scores.row(r).maxCoeff(&max_index);
+        if (max_score >= threshold) {
+          ans[i + r] = Name(max_index);
+        }
+      }
+    }
+
+    return ans;
   }
 
   std::vector<SpeakerMatch> GetBestMatches(const float *p, float threshold,
                                            int32_t n) {
     std::vector<SpeakerMatch> matches;
 
-    if (embedding_matrix_.rows() == 0) {
+    if (num_rows_ == 0) {
       return matches;
     }
 
@@ -144,12 +436,13 @@ class SpeakerEmbeddingManager::Impl {
         Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
     v.normalize();
 
-    Eigen::VectorXf scores = embedding_matrix_ * v;
+    std::vector<int32_t> rows;
+    Eigen::VectorXf scores = ComputeScores(v, &rows);
 
     std::vector<std::pair<float, int>> score_indices;
     for (int i = 0; i < scores.size(); ++i) {
       if (scores[i] >= threshold) {
-        score_indices.emplace_back(scores[i], i);
+        score_indices.emplace_back(scores[i], rows.empty() ? i : rows[i]);
       }
     }
 
@@ -160,24 +453,23 @@ class SpeakerEmbeddingManager::Impl {
     for (int i = 0; i < std::min(n, static_cast<int32_t>(score_indices.size()));
          ++i) {
       const auto &pair = score_indices[i];
-      matches.push_back({row2name_.at(pair.second), pair.first});
+      matches.push_back({Name(pair.second), pair.first});
     }
 
     return matches;
   }
 
   bool Verify(const std::string &name, const float *p, float threshold) {
-    if (!name2row_.count(name)) {
+    int32_t row_idx = FindRow(name);
+    if (row_idx == -1) {
       return false;
     }
 
-    int32_t row_idx = name2row_.at(name);
-
     Eigen::VectorXf v =
         Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
     v.normalize();
 
-    float score = embedding_matrix_.row(row_idx) * v;
+    float score = Embeddings().row(row_idx) * v;
 
     if (score < threshold) {
       return false;
@@ -187,50 +479,485 @@ class SpeakerEmbeddingManager::Impl {
   }
 
   float Score(const std::string &name, const float *p) {
-    if (!name2row_.count(name)) {
+    int32_t row_idx = FindRow(name);
+    if (row_idx == -1) {
       // Setting a default value if the name is not found
       return -2.0;
     }
 
-    int32_t row_idx = name2row_.at(name);
-
     Eigen::VectorXf v =
         Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
     v.normalize();
 
-    float score = embedding_matrix_.row(row_idx) * v;
+    float score = Embeddings().row(row_idx) * v;
 
     return score;
   }
 
-  bool Contains(const std::string &name) const {
-    return name2row_.count(name) > 0;
-  }
+  bool Contains(const std::string &name) { return FindRow(name) != -1; }
 
-  int32_t NumSpeakers() const { return embedding_matrix_.rows(); }
+  int32_t NumSpeakers() const { return num_rows_; }
 
   int32_t Dim() const { return dim_; }
 
   std::vector<std::string> GetAllSpeakers() const {
     std::vector<std::string> all_speakers;
-    all_speakers.reserve(name2row_.size());
-    for (const auto &p : name2row_) {
-      all_speakers.push_back(p.first);
+    all_speakers.reserve(num_rows_);
+    for (int32_t i = 0; i != num_rows_; ++i) {
+      all_speakers.push_back(Name(i));
     }
 
     std::sort(all_speakers.begin(), all_speakers.end());
     return all_speakers;
   }
 
+  bool Save(const std::string &filename) {
+    // Write to a temporary file and rename it so that readers never see
+    // a partially written registry
+    std::string tmp = filename + ".tmp";
+    {
+      std::ofstream os(tmp, std::ios::binary);
+      if (!os) {
+        SHERPA_ONNX_LOGE("Failed to open '%s' for writing", tmp.c_str());
+        return false;
+      }
+
+      RegistryHeader header{};
+      std::memcpy(header.magic, kRegistryMagic, sizeof(header.magic));
+      header.version = kRegistryVersion;
+      header.dim = dim_;
+      header.num_speakers = num_rows_;
+      WriteValue(os, header);
+
+      os.write(reinterpret_cast<const char *>(Embeddings().data()),
+               static_cast<std::streamsize>(num_rows_) * dim_ *
+                   sizeof(float));
+
+      uint32_t offset = 0;
+      WriteValue(os, offset);
+      for (int32_t i = 0; i != num_rows_; ++i) {
+        offset += NameLength(i);
+        WriteValue(os, offset);
+      }
+
+      for (int32_t i = 0; i != num_rows_; ++i) {
+        std::string name = Name(i);
+        os.write(name.data(), name.size());
+      }
+
+      if (!os) {
+        SHERPA_ONNX_LOGE("Failed to write '%s'", tmp.c_str());
+        return false;
+      }
+    }
+
+#if defined(_WIN32)
+    // rename() does not replace an existing file on Windows
+    std::remove(filename.c_str());
+#endif
+
+    if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+      SHERPA_ONNX_LOGE("Failed to rename '%s' to '%s'", tmp.c_str(),
+                       filename.c_str());
+      return false;
+    }
+
+    changes_.clear();
+    track_changes_ = true;
+
+    return true;
+  }
+
+  bool Append(const std::string &filename) {
+    if (!track_changes_) {
+      // Otherwise we don't know which changes the file already contains
+      SHERPA_ONNX_LOGE(
+          "Please call Save() or Load() before Append() for '%s'",
+          filename.c_str());
+      return false;
+    }
+
+    if (changes_.empty()) {
+      return true;
+    }
+
+    {
+      std::ifstream is(filename, std::ios::binary);
+      RegistryHeader header{};
+      if (!is.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+          !CheckHeader(header, filename)) {
+        return false;
+      }
+    }
+
+    std::ofstream os(filename, std::ios::binary | std::ios::app);
+    if (!os) {
+      SHERPA_ONNX_LOGE("Failed to open '%s' for appending", filename.c_str());
+      return false;
+    }
+
+    for (const auto &c : changes_) {
+      // The embedding of an added speaker is the one at the time of
+      // Append(). If the speaker has been removed since then, the remove
+      // record that follows makes it a no-op.
+      int32_t row_idx = FindRow(c.second);
+      if (c.first == kRecordAdd && row_idx == -1) {
+        continue;
+      }
+
+      WriteValue(os, c.first);
+      WriteValue(os, static_cast<int32_t>(c.second.size()));
+      os.write(c.second.data(), c.second.size());
+
+      if (c.first == kRecordAdd) {
+        const float *p =
+            Embeddings().data() + static_cast<size_t>(row_idx) * dim_;
+        os.write(reinterpret_cast<const char *>(p), dim_ * sizeof(float));
+      }
+    }
+
+    if (!os) {
+      SHERPA_ONNX_LOGE("Failed to write '%s'", filename.c_str());
+      return false;
+    }
+
+    changes_.clear();
+    track_changes_ = true;
+
+    return true;
+  }
+
+  bool Load(const std::string &filename) {
+    auto file = std::make_unique<MappedFile>(filename);
+    if (file->empty()) {
+      SHERPA_ONNX_LOGE("Failed to load '%s'", filename.c_str());
+      return false;
+    }
+
+    const char *p = file->data();
+    const char *end = p + file->size();
+
+    RegistryHeader header{};
+    if (!ReadValue(&p, end, &header) || !CheckHeader(header, filename)) {
+      return false;
+    }
+
+    int32_t n = header.num_speakers;
+    size_t embedding_bytes = static_cast<size_t>(n) * dim_ * sizeof(float);
+    size_t offset_bytes = (static_cast<size_t>(n) + 1) * sizeof(uint32_t);
+    if (static_cast<size_t>(end - p) < embedding_bytes + offset_bytes) {
+      SHERPA_ONNX_LOGE("'%s' is truncated", filename.c_str());
+      return false;
+    }
+
+    const float *embeddings = reinterpret_cast<const float *>(p);
+    const uint32_t *name_offsets =
+        reinterpret_cast<const uint32_t *>(p + embedding_bytes);
+    const char *names = p + embedding_bytes + offset_bytes;
+
+    size_t names_bytes = end - names;
+    if (name_offsets[0] != 0) {
+      SHERPA_ONNX_LOGE("Invalid name offsets in '%s'", filename.c_str());
+      return false;
+    }
+
+    for (int32_t i = 0; i != n; ++i) {
+      if (name_offsets[i + 1] < name_offsets[i] ||
+          name_offsets[i + 1] > names_bytes) {
+        SHERPA_ONNX_LOGE("Invalid name offsets in '%s'", filename.c_str());
+        return false;
+      }
+    }
+
+    // Parse everything before changing the state so that a corrupted file
+    // leaves the speakers unchanged
+    std::vector<std::pair<int32_t, std::string>> records;
+    std::vector<float> record_embeddings;
+    if (!ParseRecords(names + name_offsets[n], end, filename, &records,
+                      &record_embeddings)) {
+      return false;
+    }
+
+    embedding_matrix_ = FloatMatrix();
+    row2name_.clear();
+    name2row_.clear();
+    index_ = InvertedFileIndex();
+    num_indexed_rows_ = 0;
+
+    file_ = std::move(file);
+    mapped_embeddings_ = embeddings;
+    name_offsets_ = name_offsets;
+    names_ = names;
+    num_rows_ = n;
+    name2row_ready_ = false;
+
+    // The first record copies the registry into memory and unmaps the file
+    track_changes_ = false;
+    const float *e = record_embeddings.data();
+    for (const auto &r : records) {
+      if (r.first == kRecordAdd) {
+        Add(r.second, e);
+        e += dim_;
+      } else {
+        Remove(r.second);
+      }
+    }
+
+    changes_.clear();
+    track_changes_ = true;
+
+    MaybeBuildIndex();
+
+    return true;
+  }
+
+ private:
+  bool CheckHeader(const RegistryHeader &header,
+                   const std::string &filename) const {
+    if (std::memcmp(header.magic, kRegistryMagic, sizeof(header.magic)) !=
+        0) {
+      SHERPA_ONNX_LOGE("'%s' is not a speaker registry", filename.c_str());
+      return false;
+    }
+
+    if (header.version != kRegistryVersion) {
+      SHERPA_ONNX_LOGE("Unsupported version %d of '%s'. Expected: %d",
+                       header.version, filename.c_str(), kRegistryVersion);
+      return false;
+    }
+
+    if (header.dim != dim_) {
+      SHERPA_ONNX_LOGE("Embedding dim of '%s' is %d. Expected: %d",
+                       filename.c_str(), header.dim, dim_);
+      return false;
+    }
+
+    if (header.num_speakers < 0) {
+      SHERPA_ONNX_LOGE("Invalid number of speakers %d in '%s'",
+                       header.num_speakers, filename.c_str());
+      return false;
+    }
+
+    return true;
+  }
+
+  // Parse the records appended to a registry file by Append(). The
+  // embeddings of the kRecordAdd records are appended to embeddings.
+  bool ParseRecords(const char *p, const char *end,
+                    const std::string &filename,
+                    std::vector<std::pair<int32_t, std::string>> *records,
+                    std::vector<float> *embeddings) const {
+    while (p != end) {
+      int32_t op = 0;
+      int32_t name_length = 0;
+      if (!ReadValue(&p, end, &op) || !ReadValue(&p, end, &name_length) ||
+          name_length < 0 || end - p < name_length) {
+        SHERPA_ONNX_LOGE("Invalid record in '%s'", filename.c_str());
+        return false;
+      }
+
+      records->emplace_back(op, std::string(p, name_length));
+      p += name_length;
+
+      if (op == kRecordAdd) {
+        size_t bytes = dim_ * sizeof(float);
+        if (static_cast<size_t>(end - p) < bytes) {
+          SHERPA_ONNX_LOGE("Invalid record in '%s'", filename.c_str());
+          return false;
+        }
+
+        embeddings->resize(embeddings->size() + dim_);
+        std::memcpy(embeddings->data() + embeddings->size() - dim_, p,
+                    bytes);
+        p += bytes;
+      } else if (op != kRecordRemove) {
+        SHERPA_ONNX_LOGE("Unknown record type %d in '%s'", op,
+                         filename.c_str());
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Embeddings of all speakers. Each row has unit length.
+  Eigen::Map<const FloatMatrix> Embeddings() const {
+    const float *p =
+        mapped_embeddings_ ? mapped_embeddings_ : embedding_matrix_.data();
+    return Eigen::Map<const FloatMatrix>(p, num_rows_, dim_);
+  }
+
+  std::string Name(int32_t row) const {
+    if (names_) {
+      return std::string(names_ + name_offsets_[row], NameLength(row));
+    }
+
+    return row2name_[row];
+  }
+
+  int32_t NameLength(int32_t row) const {
+    if (names_) {
+      return name_offsets_[row + 1] - name_offsets_[row];
+    }
+
+    return row2name_[row].size();
+  }
+
+  // Return -1 if there is no such speaker
+  int32_t FindRow(const std::string &name) {
+    if (names_) {
+      // The map of a loaded registry is built on first use so that
+      // loading does not depend on the number of speakers
+      std::lock_guard<std::mutex> lock(name2row_mutex_);
+      if (!name2row_ready_) {
+        name2row_.reserve(num_rows_);
+        for (int32_t i = 0; i != num_rows_; ++i) {
+          name2row_[Name(i)] = i;
+        }
+        name2row_ready_ = true;
+      }
+    }
+
+    auto it = name2row_.find(name);
+    return it == name2row_.end() ? -1 : it->second;
+  }
+
+  // Copy a loaded registry into memory before modifying it
+  void Materialize() {
+    if (!file_) {
+      return;
+    }
+
+    FindRow({});
+
+    embedding_matrix_.resize(std::max(num_rows_, 16), dim_);
+    embedding_matrix_.topRows(num_rows_) = Embeddings();
+
+    row2name_.resize(num_rows_);
+    for (int32_t i = 0; i != num_rows_; ++i) {
+      row2name_[i] = Name(i);
+    }
+
+    mapped_embeddings_ = nullptr;
+    name_offsets_ = nullptr;
+    names_ = nullptr;
+    file_.reset();
+  }
+
+  // Make room for at least n rows. The capacity is doubled so that
+  // adding speakers one by one copies each row a constant number of
+  // times on average.
+  void Reserve(int32_t n) {
+    int32_t capacity = embedding_matrix_.rows();
+    if (n <= capacity) {
+      return;
+    }
+
+    capacity = std::max({n, 2 * capacity, 16});
+    embedding_matrix_.conservativeResize(capacity, dim_);
+  }
+
+  // The caller must have called Reserve() and v must have unit length
+  void AddRow(const std::string &name, const Eigen::RowVectorXf &v) {
+    embedding_matrix_.row(num_rows_) = v;
+
+    name2row_[name] = num_rows_;
+    row2name_.push_back(name);
+
+    if (!index_.Empty()) {
+      index_.Add(num_rows_, v);
+    }
+
+    num_rows_ += 1;
+
+    if (track_changes_) {
+      changes_.emplace_back(kRecordAdd, name);
+    }
+  }
+
+  // (Re)build the index if the number of speakers has doubled since it
+  // was last built, since the centroids may no longer fit the data.
+  void MaybeBuildIndex() {
+    if (config_.index_num_lists <= 0 ||
+        num_rows_ < config_.index_min_num_speakers ||
+        num_rows_ < 2 * num_indexed_rows_) {
+      return;
+    }
+
+    index_.Build(Embeddings(), config_.index_num_lists);
+    num_indexed_rows_ = num_rows_;
+  }
+
+  bool UseIndex() const {
+    return !index_.Empty() && num_rows_ >= config_.index_min_num_speakers;
+  }
+
+  /* Compute the scores of the normalized query v.
+   *
+   * @param rows If the index is used, it contains the rows that are compared
+   *             and ans[i] is the score of rows[i]. Otherwise, it is empty
+   *             and ans[i] is the score of row i.
+   */
+  Eigen::VectorXf ComputeScores(const Eigen::VectorXf &v,
+                                std::vector<int32_t> *rows) const {
+    rows->clear();
+
+    if (!UseIndex()) {
+      return Embeddings() * v;
+    }
+
+    *rows = index_.Candidates(v, config_.index_num_probes);
+
+    auto embeddings = Embeddings();
+
+    Eigen::VectorXf ans(rows->size());
+    for (int32_t i = 0; i != static_cast<int32_t>(rows->size()); ++i) {
+      ans[i] = embeddings.row((*rows)[i]) * v;
+    }
+
+    return ans;
+  }
+
  private:
   int32_t dim_;
+  SpeakerEmbeddingManagerConfig config_;
+
+  // Only the first num_rows_ rows are used. The others are reserved for
+  // new speakers. It is empty if the registry is read from file_.
   FloatMatrix embedding_matrix_;
+  int32_t num_rows_ = 0;
+
+  // row2name_ is empty if the registry is read from file_.
   std::unordered_map<std::string, int32_t> name2row_;
-  std::unordered_map<int32_t, std::string> row2name_;
+  std::vector<std::string> row2name_;
+
+  // A registry loaded by Load() is used in place until it is modified.
+  // The pointers point into file_.
+  std::unique_ptr<MappedFile> file_;
+  const float *mapped_embeddings_ = nullptr;
+  const uint32_t *name_offsets_ = nullptr;
+  const char *names_ = nullptr;
+
+  std::mutex name2row_mutex_;
+  bool name2row_ready_ = true;
+
+  InvertedFileIndex index_;
+
+  // Number of rows when the index was last built
+  int32_t num_indexed_rows_ = 0;
+
+  // Speakers added or removed since the last Save(), Append(), or Load().
+  // They are recorded only after one of them has been called.
+  std::vector<std::pair<int32_t, std::string>> changes_;
+  bool track_changes_ = false;
 };
 
 SpeakerEmbeddingManager::SpeakerEmbeddingManager(int32_t dim)
-    : impl_(std::make_unique<Impl>(dim)) {}
+    : SpeakerEmbeddingManager(dim, SpeakerEmbeddingManagerConfig{}) {}
+
+SpeakerEmbeddingManager::SpeakerEmbeddingManager(
+    int32_t dim, const SpeakerEmbeddingManagerConfig &config)
+    : impl_(std::make_unique<Impl>(dim, config)) {}
 
 SpeakerEmbeddingManager::~SpeakerEmbeddingManager() = default;
 
@@ -245,6 +972,11 @@ bool SpeakerEmbeddingManager::Add(
   return impl_->Add(name, embedding_list);
 }
 
+int32_t SpeakerEmbeddingManager::AddMany(const std::vector<std::string> &names,
+                                         const float *p) const {
+  return impl_->AddMany(names, p);
+}
+
 bool SpeakerEmbeddingManager::Remove(const std::string &name) const {
   return impl_->Remove(name);
 }
@@ -254,6 +986,22 @@ std::string SpeakerEmbeddingManager::Search(const float *p,
   return impl_->Search(p, threshold);
 }
 
+std::vector<std::string> SpeakerEmbeddingManager::SearchMany(
+    const float *p, int32_t n, float threshold) const {
+  return impl_->SearchMany(p, n, threshold);
+}
+bool SpeakerEmbeddingManager::Save(const std::string &filename) const {
+  return impl_->Save(filename);
+}
+
+bool SpeakerEmbeddingManager::Append(const std::string &filename) const {
+  return impl_->Append(filename);
+}
+
+bool SpeakerEmbeddingManager::Load(const std::string &filename) const {
+  return impl_->Load(filename);
+}
+
 std::vector<SpeakerMatch> SpeakerEmbeddingManager::GetBestMatches(
     const float *p, float threshold, int32_t n) const {
   return impl_->GetBestMatches(p, threshold, n);
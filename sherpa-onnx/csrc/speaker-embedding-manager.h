@@ -9,6 +9,8 @@
 #include <string>
 #include <vector>
 
+#include "sherpa-onnx/csrc/speaker-embedding-manager-config.h"
+
 struct SpeakerMatch {
   const std::string name;
   float score;
@@ -20,6 +22,10 @@ class SpeakerEmbeddingManager {
  public:
   // @param dim Embedding dimension.
   explicit SpeakerEmbeddingManager(int32_t dim);
+
+  SpeakerEmbeddingManager(int32_t dim,
+                          const SpeakerEmbeddingManagerConfig &config);
+
   ~SpeakerEmbeddingManager();
 
   /* Add the embedding and name of a speaker to the manager.
@@ -45,6 +51,19 @@ class SpeakerEmbeddingManager {
   bool Add(const std::string &name,
            const std::vector<std::vector<float>> &embedding_list) const;
 
+  /** Add many speakers at once.
+   *
+   * It is faster than calling Add() for each speaker since the storage
+   * is resized only once.
+   *
+   * @param names Names of the speakers.
+   * @param p Pointer to the embeddings. It is a row-major matrix of shape
+   *          (names.size(), dim).
+   * @return Return the number of speakers added. Speakers whose name
+   *         already exists are skipped.
+   */
+  int32_t AddMany(const std::vector<std::string> &names, const float *p) const;
+
   /* Remove a speaker by its name.
    *
    * @param name Name of the speaker to remove.
@@ -67,6 +86,21 @@ class SpeakerEmbeddingManager {
    */
   std::string Search(const float *p, float threshold) const;
 
+  /** Search() for a batch of embeddings.
+   *
+   * Without an index, the scores of a batch are computed with a single
+   * matrix multiplication.
+   *
+   * @param p Pointer to the embeddings. It is a row-major matrix of shape
+   *          (n, dim).
+   * @param n Number of embeddings.
+   * @param threshold A value between 0 and 1.
+   * @return Return a vector of size n. Its i-th entry is the result of
+   *         Search() for the i-th embedding.
+   */
+  std::vector<std::string> SearchMany(const float *p, int32_t n,
+                                      float threshold) const;
+
   /**
    * It is for speaker identification.
    *
@@ -110,6 +144,42 @@ class SpeakerEmbeddingManager {
   // Return a list of speaker names
   std::vector<std::string> GetAllSpeakers() const;
 
+  /** Save all speakers to a registry file.
+   *
+   * The file contains the normalized embeddings as a float matrix followed
+   * by a table of names. It is written to a temporary file first and then
+   * renamed, so readers never see a partially written file. Saving also
+   * compacts the records written by Append().
+   *
+   * @return Return true on success.
+   */
+  bool Save(const std::string &filename) const;
+
+  /** Append the speakers added or removed since the last Save(), Append(),
+   * or Load() to a registry file written by Save().
+   *
+   * It is much cheaper than Save() for online enrolment. Call Save() from
+   * time to time to compact the file.
+   *
+   * @return Return true on success. Return false if neither Save() nor
+   *         Load() has been called before, since it is unknown which
+   *         speakers the file contains.
+   */
+  bool Append(const std::string &filename) const;
+
+  /** Replace all speakers with the ones in a registry file.
+   *
+   * The file is memory-mapped and used in place, so loading does not copy
+   * the embeddings and names, and the pages are shared by all processes
+   * loading the same file. The speakers are copied into
+   * memory on the first modification or if the file has records written
+   * by Append().
+   *
+   * @return Return true on success. If the file is invalid, it returns
+   *         false and the speakers are unchanged.
+   */
+  bool Load(const std::string &filename) const;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -11,6 +11,7 @@
 #endif
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/mapped-file.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/spoken-language-identification-whisper-impl.h"
 
@@ -25,24 +26,16 @@ enum class ModelType : std::uint8_t {
 
 }
 
-static ModelType GetModelType(char *model_data, size_t model_data_length,
+static ModelType GetModelType(const char *model_data, size_t model_data_length,
                               bool debug) {
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
-  Ort::SessionOptions sess_opts;
-
-  auto sess = std::make_unique<Ort::Session>(env, model_data, model_data_length,
-                                             sess_opts);
-
-  Ort::ModelMetadata meta_data = sess->GetModelMetadata();
+  // Read the metadata without creating a session so that external data
+  // is not needed here
+  OnnxModelInfo info = GetOnnxModelInfo(model_data, model_data_length);
   if (debug) {
-    std::ostringstream os;
-    PrintModelMetadata(os, meta_data);
-    SHERPA_ONNX_LOGE("%s", os.str().c_str());
+    SHERPA_ONNX_LOGE("%s", info.ToString().c_str());
   }
 
-  Ort::AllocatorWithDefaultOptions allocator;
-  auto model_type =
-      LookupCustomModelMetaData(meta_data, "model_type", allocator);
+  auto model_type = info.LookupMetadata("model_type");
   if (model_type.empty()) {
     SHERPA_ONNX_LOGE(
         "No model_type in the metadata!\n"
@@ -71,7 +64,7 @@ SpokenLanguageIdentificationImpl::Create(
       SHERPA_ONNX_LOGE("Only whisper models are supported at present");
       exit(-1);
     }
-    auto buffer = ReadFile(config.whisper.encoder);
+    MappedFile buffer(config.whisper.encoder);
 
     model_type = GetModelType(buffer.data(), buffer.size(), config.debug);
   }
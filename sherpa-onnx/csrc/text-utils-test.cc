@@ -4,6 +4,12 @@
 
 #include "sherpa-onnx/csrc/text-utils.h"
 
+#include <algorithm>
+#include <regex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace sherpa_onnx {
@@ -47,4 +53,75 @@ TEST(RemoveInvalidUtf8Sequences, Case1) {
   EXPECT_EQ(s.size() + 4, v.size());
 }
 
+TEST(ReplaceAll, Case1) {
+  std::vector<std::pair<std::string, std::string>> replacements = {
+      {"：", "，"}, {"、", "，"}, {".", "。"}, {"ab", "b"}, {"b", "c"}};
+
+  EXPECT_EQ(ReplaceAll("你好：世界、再见.", replacements),
+            "你好，世界，再见。");
+
+  // Replaced text is not scanned again
+  EXPECT_EQ(ReplaceAll("aab.b", replacements), "ab。c");
+
+  EXPECT_EQ(ReplaceAll("", replacements), "");
+  EXPECT_EQ(ReplaceAll("xyz", {}), "xyz");
+}
+
+// ReplaceAll() and std::replace() give the same result as the std::regex
+// code they replaced in the lexicons and in CreateStream(hotwords)
+TEST(ReplaceAll, SameAsRegex) {
+  std::string text;
+  for (int32_t i = 0; i != 4; ++i) {
+    text += "今天天气很好：我们去公园、然后吃饭；好吗? 好的! 再见. ";
+  }
+
+  std::string expected =
+      std::regex_replace(text, std::regex("：|、|；"), "，");
+  expected = std::regex_replace(expected, std::regex("[.]"), "。");
+  expected = std::regex_replace(expected, std::regex("[?]"), "？");
+  expected = std::regex_replace(expected, std::regex("[!]"), "！");
+
+  std::vector<std::pair<std::string, std::string>> puncts = {
+      {"：", "，"}, {"、", "，"}, {"；", "，"},
+      {".", "。"},  {"?", "？"},  {"!", "！"},
+  };
+
+  EXPECT_EQ(ReplaceAll(text, puncts), expected);
+
+  std::string hotwords = "HELLO WORLD/I LOVE YOU/GOOD MORNING/SEE YOU";
+
+  std::string s = hotwords;
+  std::replace(s.begin(), s.end(), '/', '\n');
+
+  EXPECT_EQ(s, std::regex_replace(hotwords, std::regex("/"), "\n"));
+}
+
+TEST(SplitTextIntoSentences, English) {
+  std::vector<std::string> expected = {"Hello world!", "It costs 3.14 dollars.",
+                                       "He said \"really?!\"", "Yes;",
+                                       "the end"};
+  EXPECT_EQ(SplitTextIntoSentences("  Hello world! It costs 3.14 dollars. He "
+                                   "said \"really?!\" Yes; the end\n\n"),
+            expected);
+}
+
+TEST(SplitTextIntoSentences, Chinese) {
+  std::vector<std::string> expected = {"这是第一句。", "他说：「好吗？」",
+                                       "最后一句"};
+  EXPECT_EQ(SplitTextIntoSentences("这是第一句。他说：「好吗？」最后一句"),
+            expected);
+}
+
+TEST(SplitTextIntoSentenceSpans, Case1) {
+  std::string text = " Hi there.  你好。\nBye";
+  std::vector<std::pair<int32_t, int32_t>> expected = {
+      {1, 10}, {12, 21}, {22, 25}};
+  EXPECT_EQ(SplitTextIntoSentenceSpans(text), expected);
+}
+
+TEST(SplitTextIntoSentences, Empty) {
+  EXPECT_TRUE(SplitTextIntoSentences("").empty());
+  EXPECT_TRUE(SplitTextIntoSentences(" \n  \n").empty());
+}
+
 }  // namespace sherpa_onnx
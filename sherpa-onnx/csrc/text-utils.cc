@@ -9,6 +9,7 @@
 #include <cassert>
 #include <cctype>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -384,6 +385,36 @@ std::vector<std::string> SplitUtf8(const std::string &text) {
   return MergeCharactersIntoWords(ans);
 }
 
+std::string ReplaceAll(
+    const std::string &text,
+    const std::vector<std::pair<std::string, std::string>> &replacements) {
+  std::string ans;
+  ans.reserve(text.size());
+
+  size_t i = 0;
+  while (i < text.size()) {
+    const std::pair<std::string, std::string> *r = nullptr;
+    for (const auto &p : replacements) {
+      const auto &from = p.first;
+      if (!from.empty() && from[0] == text[i] &&
+          text.compare(i, from.size(), from) == 0) {
+        r = &p;
+        break;
+      }
+    }
+
+    if (r) {
+      ans.append(r->second);
+      i += r->first.size();
+    } else {
+      ans.push_back(text[i]);
+      ++i;
+    }
+  }
+
+  return ans;
+}
+
 std::string ToLowerCase(const std::string &s) {
   std::string ans(s.size(), 0);
   std::transform(s.begin(), s.end(), ans.begin(),
@@ -502,4 +533,120 @@ std::string RemoveInvalidUtf8Sequences(const std::string &text,
   return ans;
 }
 
+// Return the number of bytes of the sentence-ending punctuation at p,
+// which has n bytes, or 0 if there is none
+static int32_t SentenceEndLength(const char *p, int32_t n) {
+  // 。！？；
+  static const char *kWidePunctuations[] = {"\xe3\x80\x82", "\xef\xbc\x81",
+                                            "\xef\xbc\x9f", "\xef\xbc\x9b"};
+
+  for (const char *w : kWidePunctuations) {
+    if (n >= 3 && strncmp(p, w, 3) == 0) {
+      return 3;
+    }
+  }
+
+  return 0;
+}
+
+// Return the number of bytes of the closing quote or bracket at p, which
+// has n bytes, or 0 if there is none
+static int32_t ClosingQuoteLength(const char *p, int32_t n) {
+  if (*p == '"' || *p == '\'' || *p == ')' || *p == ']') {
+    return 1;
+  }
+
+  // ” ’ 」 』 ）
+  static const char *kWideQuotes[] = {"\xe2\x80\x9d", "\xe2\x80\x99",
+                                      "\xe3\x80\x8d", "\xe3\x80\x8f",
+                                      "\xef\xbc\x89"};
+  for (const char *w : kWideQuotes) {
+    if (n >= 3 && strncmp(p, w, 3) == 0) {
+      return 3;
+    }
+  }
+
+  return 0;
+}
+
+std::vector<std::string> SplitTextIntoSentences(const std::string &text) {
+  std::vector<std::string> ans;
+  for (const auto &span : SplitTextIntoSentenceSpans(text)) {
+    ans.emplace_back(text, span.first, span.second - span.first);
+  }
+
+  return ans;
+}
+
+std::vector<std::pair<int32_t, int32_t>> SplitTextIntoSentenceSpans(
+    const std::string &text) {
+  std::vector<std::pair<int32_t, int32_t>> ans;
+
+  const char *p = text.data();
+  int32_t n = static_cast<int32_t>(text.size());
+
+  auto add = [&ans, &text](int32_t begin, int32_t end) {
+    while (begin < end && std::isspace(static_cast<uint8_t>(text[begin]))) {
+      ++begin;
+    }
+
+    while (end > begin && std::isspace(static_cast<uint8_t>(text[end - 1]))) {
+      --end;
+    }
+
+    if (begin < end) {
+      ans.emplace_back(begin, end);
+    }
+  };
+
+  int32_t start = 0;
+  int32_t i = 0;
+  while (i < n) {
+    if (p[i] == '\n') {
+      add(start, i);
+      start = ++i;
+      continue;
+    }
+
+    bool is_ascii_end =
+        p[i] == '.' || p[i] == '!' || p[i] == '?' || p[i] == ';';
+    int32_t k = is_ascii_end ? 1 : SentenceEndLength(p + i, n - i);
+    if (k == 0) {
+      ++i;
+      continue;
+    }
+
+    // Include repeated punctuations and closing quotes, e.g., ?!" or 。」
+    int32_t end = i + k;
+    while (end < n) {
+      bool is_end = p[end] == '.' || p[end] == '!' || p[end] == '?' ||
+                    p[end] == ';';
+      int32_t m = is_end ? 1 : SentenceEndLength(p + end, n - end);
+      if (m == 0) {
+        m = ClosingQuoteLength(p + end, n - end);
+      }
+
+      if (m == 0) {
+        break;
+      }
+
+      end += m;
+    }
+
+    // Do not split 3.14 since no space follows the period
+    if (is_ascii_end && end < n &&
+        !std::isspace(static_cast<uint8_t>(p[end]))) {
+      i = end;
+      continue;
+    }
+
+    add(start, end);
+    start = i = end;
+  }
+
+  add(start, n);
+
+  return ans;
+}
+
 }  // namespace sherpa_onnx
@@ -10,6 +10,7 @@
 #include <limits>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -124,9 +125,34 @@ std::vector<std::string> SplitUtf8(const std::string &text);
 std::string ToLowerCase(const std::string &s);
 void ToLowerCase(std::string *in_out);
 
+/* Replace all occurrences of the given strings in a single pass.
+ *
+ * At each position, the first pair in replacements whose first string
+ * matches is applied. Text produced by a replacement is not scanned again.
+ * It is a much cheaper alternative to std::regex_replace() for literal
+ * patterns.
+ */
+std::string ReplaceAll(
+    const std::string &text,
+    const std::vector<std::pair<std::string, std::string>> &replacements);
+
 std::string RemoveInvalidUtf8Sequences(const std::string &text,
                                        bool show_debug_msg = false);
 
+/* Split text into sentences.
+ *
+ * A sentence ends after one of .!?; followed by a space or the end of the
+ * text, after one of 。！？； or at a newline. Closing quotes and brackets
+ * after the punctuation belong to the sentence. Leading and trailing
+ * spaces are removed and empty sentences are dropped.
+ */
+std::vector<std::string> SplitTextIntoSentences(const std::string &text);
+
+// Like SplitTextIntoSentences() but return the byte range [begin, end) of
+// each sentence in text
+std::vector<std::pair<int32_t, int32_t>> SplitTextIntoSentenceSpans(
+    const std::string &text);
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_TEXT_UTILS_H_
@@ -0,0 +1,144 @@
+// sherpa-onnx/csrc/thread-pool-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/thread-pool.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <future>  // NOLINT
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+TEST(ThreadPool, Submit) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.NumThreads(), 4);
+
+  std::atomic<int32_t> sum{0};
+  for (int32_t i = 0; i != 1000; ++i) {
+    pool.Submit([&sum, i]() { sum += i; });
+  }
+  pool.Wait();
+
+  EXPECT_EQ(sum, 999 * 1000 / 2);
+}
+
+TEST(ThreadPool, Enqueue) {
+  ThreadPool pool(3);
+
+  std::vector<std::future<int32_t>> futures;
+  for (int32_t i = 0; i != 100; ++i) {
+    futures.push_back(pool.Enqueue([i]() { return i * i; }));
+  }
+
+  for (int32_t i = 0; i != 100; ++i) {
+    EXPECT_EQ(futures[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPool, NestedSubmit) {
+  // Tasks submitted from a worker go to its local queue and can be stolen
+  // by the other workers.
+  ThreadPool pool(4);
+
+  std::atomic<int32_t> count{0};
+  for (int32_t i = 0; i != 10; ++i) {
+    pool.Submit([&pool, &count]() {
+      for (int32_t k = 0; k != 10; ++k) {
+        pool.Submit([&count]() { ++count; });
+      }
+    });
+  }
+  pool.Wait();
+
+  EXPECT_EQ(count, 100);
+}
+
+TEST(ThreadPool, DestructorWaits) {
+  std::atomic<int32_t> count{0};
+  {
+    ThreadPool pool(2);
+    for (int32_t i = 0; i != 50; ++i) {
+      pool.Submit([&count]() { ++count; });
+    }
+  }
+
+  EXPECT_EQ(count, 50);
+}
+
+TEST(ThreadPool, RunConcurrently) {
+  std::atomic<int32_t> sum{0};
+  std::vector<std::function<void()>> tasks;
+  for (int32_t i = 0; i != 10; ++i) {
+    tasks.push_back([&sum, i]() { sum += i; });
+  }
+
+  RunConcurrently(tasks);
+  EXPECT_EQ(sum, 45);
+
+  ThreadPool pool(3);
+  RunConcurrently(&pool, tasks);
+  EXPECT_EQ(sum, 90);
+
+  // The error of the first failed task is reported
+  tasks.clear();
+  for (int32_t i = 0; i != 8; ++i) {
+    tasks.push_back([i]() {
+      if (i % 3 == 2) {
+        throw std::runtime_error(std::to_string(i));
+      }
+    });
+  }
+
+  for (int32_t k = 0; k != 20; ++k) {
+    try {
+      RunConcurrently(tasks);
+      FAIL() << "It should throw";
+    } catch (const std::runtime_error &e) {
+      EXPECT_STREQ(e.what(), "2");
+    }
+  }
+}
+
+TEST(ThreadPool, RunConcurrentlyExit) {
+  // SHERPA_ONNX_EXIT() in a task exits only after the other tasks finish
+  // mode 0: a temporary pool; mode 1: nested; mode 2: a given pool
+  auto run = [](int32_t mode) {
+    std::vector<std::function<void()>> tasks;
+    tasks.push_back([]() { SHERPA_ONNX_EXIT(3); });
+    tasks.push_back([]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      fprintf(stderr, "slow task done\n");
+    });
+
+    if (mode == 1) {
+      RunConcurrently({[&tasks]() { RunConcurrently(tasks); }, []() {}});
+    } else if (mode == 2) {
+      ThreadPool pool(2);
+      RunConcurrently(&pool, tasks);
+    } else {
+      RunConcurrently(tasks);
+    }
+
+    fprintf(stderr, "not reached\n");
+  };
+
+  for (int32_t mode = 0; mode != 3; ++mode) {
+    EXPECT_EXIT(run(mode), ::testing::ExitedWithCode(3), "slow task done");
+  }
+
+  // Outside of RunConcurrently() it exits directly
+  EXPECT_EXIT(SHERPA_ONNX_EXIT(4), ::testing::ExitedWithCode(4), "");
+}
+
+}  // namespace sherpa_onnx
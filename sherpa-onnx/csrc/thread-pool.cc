@@ -0,0 +1,239 @@
+// sherpa-onnx/csrc/thread-pool.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/thread-pool.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+// Identify the pool and the queue of the current worker thread so that
+// tasks submitted from inside a task stay on the local queue.
+thread_local const ThreadPool *tls_pool = nullptr;
+thread_local int32_t tls_index = -1;
+
+// True while the current thread runs a task of RunConcurrently()
+thread_local bool tls_defer_exit = false;
+
+// Thrown by Exit() inside a task of RunConcurrently(). It is deliberately
+// not derived from std::exception so that it is not swallowed by handlers
+// for ordinary errors.
+struct ExitRequest {
+  int code;
+};
+
+// It sets tls_defer_exit while it is alive
+class DeferExitGuard {
+ public:
+  DeferExitGuard() : saved_(tls_defer_exit) { tls_defer_exit = true; }
+  ~DeferExitGuard() { tls_defer_exit = saved_; }
+
+  DeferExitGuard(const DeferExitGuard &) = delete;
+  DeferExitGuard &operator=(const DeferExitGuard &) = delete;
+
+ private:
+  bool saved_;
+};
+
+}  // namespace
+
+void Exit(int code) {
+  if (tls_defer_exit) {
+    throw ExitRequest{code};
+  }
+
+  exit(code);
+}
+
+ThreadPool::ThreadPool(int32_t num_threads) {
+  if (num_threads <= 0) {
+    num_threads = static_cast<int32_t>(std::thread::hardware_concurrency());
+  }
+
+  if (num_threads <= 0) {
+    num_threads = 1;
+  }
+
+  queues_.reserve(num_threads);
+  for (int32_t i = 0; i != num_threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+
+  threads_.reserve(num_threads);
+  for (int32_t i = 0; i != num_threads; ++i) {
+    threads_.emplace_back([this, i]() { WorkerLoop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  Wait();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+
+  for (auto &t : threads_) {
+    t.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  int32_t num_queues = static_cast<int32_t>(queues_.size());
+
+  int32_t i;
+  if (tls_pool == this) {
+    i = tls_index;
+  } else {
+    i = static_cast<int32_t>(next_queue_.fetch_add(1) % num_queues);
+  }
+
+  ++num_pending_;
+  {
+    std::lock_guard<std::mutex> lock(queues_[i]->mutex);
+    queues_[i]->tasks.push_back(std::move(task));
+    ++num_queued_;
+  }
+
+  {
+    // Pair with the predicate check in WorkerLoop() to avoid lost wakeups
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  work_cv_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this]() { return num_pending_ == 0; });
+}
+
+bool ThreadPool::PopLocal(int32_t i, std::function<void()> *task) {
+  auto &q = *queues_[i];
+  std::lock_guard<std::mutex> lock(q.mutex);
+  if (q.tasks.empty()) {
+    return false;
+  }
+
+  *task = std::move(q.tasks.back());
+  q.tasks.pop_back();
+  --num_queued_;
+
+  return true;
+}
+
+bool ThreadPool::Steal(int32_t i, std::function<void()> *task) {
+  int32_t num_queues = static_cast<int32_t>(queues_.size());
+  for (int32_t k = 1; k != num_queues; ++k) {
+    auto &q = *queues_[(i + k) % num_queues];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) {
+      continue;
+    }
+
+    *task = std::move(q.tasks.front());
+    q.tasks.pop_front();
+    --num_queued_;
+
+    return true;
+  }
+
+  return false;
+}
+
+void ThreadPool::WorkerLoop(int32_t i) {
+  tls_pool = this;
+  tls_index = i;
+
+  std::function<void()> task;
+  while (true) {
+    if (PopLocal(i, &task) || Steal(i, &task)) {
+      task();
+      task = nullptr;
+
+      if (--num_pending_ == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_cv_.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_cv_.wait(lock, [this]() { return stop_ || num_queued_ > 0; });
+
+    if (stop_ && num_queued_ == 0) {
+      break;
+    }
+  }
+}
+
+void RunConcurrently(const std::vector<std::function<void()>> &tasks) {
+  if (tasks.size() <= 1) {
+    for (const auto &t : tasks) {
+      t();
+    }
+    return;
+  }
+
+  int32_t num_threads = static_cast<int32_t>(
+      std::min<size_t>(tasks.size(), std::thread::hardware_concurrency()));
+
+  ThreadPool pool(num_threads);
+  RunConcurrently(&pool, tasks);
+}
+
+void RunConcurrently(ThreadPool *pool,
+                     const std::vector<std::function<void()>> &tasks) {
+  if (tasks.size() <= 1) {
+    for (const auto &t : tasks) {
+      t();
+    }
+    return;
+  }
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(tasks.size());
+  for (const auto &t : tasks) {
+    // The loaders call SHERPA_ONNX_EXIT() on errors. Calling exit() on a
+    // worker while other tasks are still running races with the destruction
+    // of static objects, so we defer it to the calling thread.
+    futures.push_back(pool->Enqueue([&t]() {
+      DeferExitGuard guard;
+      t();
+    }));
+  }
+
+  std::exception_ptr first_error;
+  for (auto &f : futures) {
+    try {
+      f.get();
+    } catch (...) {
+      if (!first_error) {
+        first_error = std::current_exception();
+      }
+    }
+  }
+
+  if (!first_error) {
+    return;
+  }
+
+  try {
+    std::rethrow_exception(first_error);
+  } catch (const ExitRequest &e) {
+    // If we are ourselves a task of an outer RunConcurrently(), this
+    // throws again and the outermost calling thread exits.
+    Exit(e.code);
+  }
+}
+
+}  // namespace sherpa_onnx
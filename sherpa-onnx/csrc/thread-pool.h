@@ -0,0 +1,108 @@
+// sherpa-onnx/csrc/thread-pool.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_THREAD_POOL_H_
+#define SHERPA_ONNX_CSRC_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+/** A fixed-size work-stealing thread pool.
+ *
+ * Each worker owns a task deque. Tasks submitted from a worker thread go to
+ * the back of its own deque and are popped LIFO for cache locality; tasks
+ * submitted from other threads are distributed round-robin. An idle worker
+ * steals from the front of the other workers' deques.
+ */
+class ThreadPool {
+ public:
+  // @param num_threads Number of worker threads. If it is <= 0, we use
+  //                    std::thread::hardware_concurrency().
+  explicit ThreadPool(int32_t num_threads);
+
+  // Wait for all pending tasks and join the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  int32_t NumThreads() const { return static_cast<int32_t>(threads_.size()); }
+
+  void Submit(std::function<void()> task);
+
+  // Like Submit() but returns a future for the result of f().
+  // Exceptions thrown by f() are propagated through the future.
+  template <typename F>
+  auto Enqueue(F &&f) -> std::future<decltype(f())> {
+    using R = decltype(f());
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    auto ans = task->get_future();
+    Submit([task]() { (*task)(); });
+    return ans;
+  }
+
+  // Block until all submitted tasks have finished.
+  //
+  // Caution: Don't call it from inside a task of this pool.
+  void Wait();
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool PopLocal(int32_t i, std::function<void()> *task);
+  bool Steal(int32_t i, std::function<void()> *task);
+  void WorkerLoop(int32_t i);
+
+ private:
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  bool stop_ = false;
+
+  // Number of tasks sitting in the queues
+  std::atomic<int64_t> num_queued_{0};
+
+  // Number of tasks submitted but not yet finished
+  std::atomic<int64_t> num_pending_{0};
+
+  std::atomic<uint32_t> next_queue_{0};
+};
+
+/** Run the given tasks concurrently on a temporary pool and wait for all of
+ * them.
+ *
+ * If some tasks throw, the exception of the first of them in the given order
+ * is rethrown after all tasks have finished, so the reported error does not
+ * depend on the scheduling. Likewise, SHERPA_ONNX_EXIT() inside a task does
+ * not exit on the worker thread; the calling thread exits with the given
+ * code after all tasks have finished.
+ */
+void RunConcurrently(const std::vector<std::function<void()>> &tasks);
+
+// Like RunConcurrently() above but it uses the given pool.
+//
+// Caution: Don't call it from inside a task of this pool.
+void RunConcurrently(ThreadPool *pool,
+                     const std::vector<std::function<void()>> &tasks);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_THREAD_POOL_H_
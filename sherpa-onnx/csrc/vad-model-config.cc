@@ -29,9 +29,17 @@ void VadModelConfig::Register(ParseOptions *po) {
                "Pre-record seconds before speech starts");
   po->Register("vad-post-record-seconds", &post_record_seconds,
                "Post-record seconds after speech ends");
+
+  pre_gate.Register(po);
 }
 
-bool VadModelConfig::Validate() const { return silero_vad.Validate(); }
+bool VadModelConfig::Validate() const {
+  if (!pre_gate.Validate()) {
+    return false;
+  }
+
+  return silero_vad.Validate();
+}
 
 std::string VadModelConfig::ToString() const {
   std::ostringstream os;
@@ -43,7 +51,8 @@ std::string VadModelConfig::ToString() const {
   os << "provider=\"" << provider << "\", ";
   os << "debug=" << (debug ? "True" : "False") << ", ";
   os << "pre_record_seconds=" << pre_record_seconds << ", ";
-  os << "post_record_seconds=" << post_record_seconds << ")";
+  os << "post_record_seconds=" << post_record_seconds << ", ";
+  os << "pre_gate=" << pre_gate.ToString() << ")";
 
   return os.str();
 }
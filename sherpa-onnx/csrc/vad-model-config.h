@@ -8,6 +8,7 @@
 
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/silero-vad-model-config.h"
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
 
 namespace sherpa_onnx {
 
@@ -23,7 +24,9 @@ struct VadModelConfig {
 
   float pre_record_seconds = 0.5;
   float post_record_seconds = 0.5;
-  
+
+  VadPreGateConfig pre_gate;
+
   VadModelConfig() = default;
 
   VadModelConfig(const SileroVadModelConfig &silero_vad, int32_t sample_rate,
@@ -5,7 +5,9 @@
 #define SHERPA_ONNX_CSRC_VAD_MODEL_H_
 
 #include <memory>
+#include <vector>
 
+#include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/vad-model-config.h"
 
 namespace sherpa_onnx {
@@ -41,6 +43,29 @@ class VadModel {
   virtual void SetMinSilenceDuration(float s) = 0;
   virtual void SetThreshold(float threshold) = 0;
   virtual float GetProb(const float *samples, int32_t n) = 0;
+
+  // The following two methods are for processing several streams with a
+  // single model, where each stream keeps its own model states.
+
+  // Return the initial model states for a stream
+  virtual std::vector<Ort::Value> GetInitStates() = 0;
+
+  /** Compute the speech probabilities of a batch of windows, one per stream.
+   *
+   * It does not use or change the internal model states.
+   *
+   * @param samples A 2-d array of shape (batch_size, n) in row major.
+   * @param batch_size Number of streams.
+   * @param n Number of samples of each stream. Should be equal to
+   *          WindowSize().
+   * @param states (*states)[i] contains the model states of the i-th
+   *               stream. On return, it contains the updated states.
+   *
+   * @return Return the speech probability of each stream.
+   */
+  virtual std::vector<float> GetProbBatch(
+      const float *samples, int32_t batch_size, int32_t n,
+      std::vector<std::vector<Ort::Value>> *states) = 0;
 };
 
 }  // namespace sherpa_onnx
@@ -0,0 +1,170 @@
+// sherpa-onnx/csrc/vad-offline-asr-pipeline-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-offline-asr-pipeline.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace sherpa_onnx {
+
+// Please download the models from
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/asr-models/silero_vad.onnx
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/asr-models/sherpa-onnx-paraformer-zh-2023-09-14.tar.bz2
+const char *const kVadModel = "./silero_vad.onnx";
+const char *const kModelDir = "./sherpa-onnx-paraformer-zh-2023-09-14";
+
+static bool HasModels() {
+  std::string dir = kModelDir;
+  for (const std::string &f :
+       {std::string(kVadModel), dir + "/model.int8.onnx", dir + "/tokens.txt",
+        dir + "/test_wavs/0.wav"}) {
+    if (!FileExists(f)) {
+      SHERPA_ONNX_LOGE("%s does not exist. Skipping test", f.c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Results of each channel, indexed by VadOfflineAsrResult::segment
+using ChannelResults =
+    std::map<int32_t, std::map<int32_t, VadOfflineAsrResult>>;
+
+// Feed each channel with the test wave three times, separated by silence.
+//
+// @param wait If true, call InputFinished() and Wait() before destroying
+//             the pipeline. Otherwise, the pipeline is destroyed right
+//             after the last samples are accepted.
+static ChannelResults RunPipeline(int32_t num_channels, bool wait) {
+  std::string dir = kModelDir;
+
+  VadModelConfig vad_config;
+  vad_config.silero_vad.model = kVadModel;
+
+  OfflineRecognizerConfig asr_config;
+  asr_config.model_config.paraformer.model = dir + "/model.int8.onnx";
+  asr_config.model_config.tokens = dir + "/tokens.txt";
+  OfflineRecognizer recognizer(asr_config);
+
+  VadOfflineAsrPipelineConfig config;
+  config.num_threads = 2;
+  config.batch_size = 2;
+
+  int32_t sample_rate = 0;
+  bool is_ok = false;
+  std::vector<float> wave =
+      ReadWave(dir + "/test_wavs/0.wav", &sample_rate, &is_ok);
+  EXPECT_TRUE(is_ok);
+  EXPECT_EQ(sample_rate, vad_config.sample_rate);
+
+  std::vector<float> samples;
+  for (int32_t i = 0; i != 3; ++i) {
+    samples.insert(samples.end(), wave.begin(), wave.end());
+    samples.resize(samples.size() + sample_rate, 0);
+  }
+
+  ChannelResults ans;
+  std::mutex mutex;
+  {
+    VadOfflineAsrPipeline pipeline(
+        vad_config, &recognizer, config,
+        [&ans, &mutex](const VadOfflineAsrResult &r) {
+          std::lock_guard<std::mutex> lock(mutex);
+          EXPECT_EQ(ans[r.channel].count(r.segment), 0);
+          ans[r.channel][r.segment] = r;
+        });
+
+    std::vector<int32_t> channels;
+    for (int32_t i = 0; i != num_channels; ++i) {
+      channels.push_back(pipeline.AddChannel());
+    }
+
+    int32_t chunk = sample_rate / 10;
+    for (int32_t start = 0; start < static_cast<int32_t>(samples.size());
+         start += chunk) {
+      int32_t n =
+          std::min(chunk, static_cast<int32_t>(samples.size()) - start);
+      for (auto c : channels) {
+        pipeline.AcceptWaveform(c, samples.data() + start, n);
+      }
+    }
+
+    if (wait) {
+      for (auto c : channels) {
+        pipeline.InputFinished(c);
+      }
+
+      pipeline.Wait();
+      EXPECT_EQ(static_cast<int32_t>(ans.size()), num_channels);
+    }
+  }
+
+  return ans;
+}
+
+TEST(VadOfflineAsrPipeline, OrderedResults) {
+  if (!HasModels()) {
+    return;
+  }
+
+  int32_t num_channels = 3;
+  ChannelResults results = RunPipeline(num_channels, true);
+  ASSERT_EQ(static_cast<int32_t>(results.size()), num_channels);
+
+  const auto &first = results.begin()->second;
+  ASSERT_GE(first.size(), 3);
+
+  for (const auto &p : results) {
+    const auto &segments = p.second;
+
+    // Segment indexes are 0, 1, 2, ... and follow the audio
+    ASSERT_EQ(segments.size(), first.size());
+    int32_t i = 0;
+    float last_start = -1;
+    for (const auto &s : segments) {
+      EXPECT_EQ(s.first, i);
+      EXPECT_EQ(s.second.channel, p.first);
+      EXPECT_GT(s.second.start, last_start);
+      last_start = s.second.start;
+
+      // All channels receive the same audio
+      EXPECT_EQ(s.second.result.text, first.at(i).result.text);
+      ++i;
+    }
+  }
+}
+
+TEST(VadOfflineAsrPipeline, Shutdown) {
+  if (!HasModels()) {
+    return;
+  }
+
+  int32_t num_channels = 2;
+  ChannelResults expected = RunPipeline(num_channels, true);
+
+  // The destructor decodes everything received so far and returns
+  ChannelResults results = RunPipeline(num_channels, false);
+  ASSERT_EQ(results.size(), expected.size());
+
+  for (const auto &p : expected) {
+    const auto &segments = results.at(p.first);
+    ASSERT_EQ(segments.size(), p.second.size());
+
+    for (const auto &s : p.second) {
+      EXPECT_EQ(segments.at(s.first).result.text, s.second.result.text);
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
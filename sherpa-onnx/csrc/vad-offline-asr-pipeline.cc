@@ -0,0 +1,497 @@
+// sherpa-onnx/csrc/vad-offline-asr-pipeline.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-offline-asr-pipeline.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/batched-voice-activity-detector.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
+
+namespace sherpa_onnx {
+
+void VadOfflineAsrPipelineConfig::Register(ParseOptions *po) {
+  po->Register("nj", &num_threads,
+               "Number of threads decoding speech segments concurrently. "
+               "Each of them uses --num-threads threads to run the neural "
+               "network.");
+
+  po->Register("batch-size", &batch_size,
+               "Maximum number of speech segments decoded at once.");
+
+  po->Register("max-batch-duration", &max_batch_duration,
+               "Maximum total duration in seconds of the speech segments in "
+               "a batch. 0 means no limit.");
+
+  po->Register("max-delay", &max_delay,
+               "Maximum time in seconds a speech segment waits for other "
+               "segments to form a batch.");
+}
+
+bool VadOfflineAsrPipelineConfig::Validate() const {
+  if (num_threads < 1) {
+    SHERPA_ONNX_LOGE("--nj should be positive. Given: %d", num_threads);
+    return false;
+  }
+
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("--batch-size should be positive. Given: %d",
+                     batch_size);
+    return false;
+  }
+
+  if (max_batch_duration < 0) {
+    SHERPA_ONNX_LOGE("--max-batch-duration should be >= 0. Given: %.3f",
+                     max_batch_duration);
+    return false;
+  }
+
+  if (max_delay < 0) {
+    SHERPA_ONNX_LOGE("--max-delay should be >= 0. Given: %.3f", max_delay);
+    return false;
+  }
+
+  return true;
+}
+
+std::string VadOfflineAsrPipelineConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "VadOfflineAsrPipelineConfig(";
+  os << "num_threads=" << num_threads << ", ";
+  os << "batch_size=" << batch_size << ", ";
+  os << "max_batch_duration=" << max_batch_duration << ", ";
+  os << "max_delay=" << max_delay << ")";
+
+  return os.str();
+}
+
+class VadOfflineAsrPipeline::Impl {
+ public:
+  Impl(const VadModelConfig &vad_config, const OfflineRecognizer *recognizer,
+       const VadOfflineAsrPipelineConfig &config,
+       VadOfflineAsrCallback callback)
+      : vad_(vad_config),
+        sample_rate_(vad_config.sample_rate),
+        recognizer_(recognizer),
+        config_(config),
+        callback_(std::move(callback)),
+        pool_(config.num_threads) {
+    worker_ = std::thread([this]() { Run(); });
+  }
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto &c : channels_) {
+        c->input_finished = true;
+      }
+      stop_ = true;
+    }
+    cv_.notify_all();
+
+    worker_.join();
+
+    // It waits for the batches in the pool
+    pool_.Wait();
+  }
+
+  int32_t AddChannel() {
+    auto c = std::make_unique<Channel>();
+    c->stream = vad_.CreateStream();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    c->id = static_cast<int32_t>(channels_.size());
+    channels_.push_back(std::move(c));
+    return channels_.back()->id;
+  }
+
+  void AcceptWaveform(int32_t channel, const float *samples, int32_t n) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Channel *c = GetChannel(channel);
+      c->pending.insert(c->pending.end(), samples, samples + n);
+    }
+    cv_.notify_all();
+  }
+
+  void InputFinished(int32_t channel) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      GetChannel(channel)->input_finished = true;
+    }
+    cv_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++num_waiters_;
+    cv_.notify_all();
+
+    done_cv_.wait(lock, [this]() { return IsIdle(); });
+    --num_waiters_;
+  }
+
+ private:
+  struct Channel {
+    int32_t id = 0;
+
+    // It is used only by the worker thread
+    std::unique_ptr<VadStream> stream;
+    int32_t num_segments = 0;
+
+    // The following fields are protected by mutex_
+    std::vector<float> pending;
+    bool input_finished = false;
+  };
+
+  struct Segment {
+    int32_t channel = 0;
+    int32_t index = 0;
+    SpeechSegmentView view;
+
+    // When it was finished by the VAD
+    std::chrono::steady_clock::time_point time;
+  };
+
+  // Must be called with mutex_ held
+  Channel *GetChannel(int32_t channel) const {
+    if (channel < 0 || channel >= static_cast<int32_t>(channels_.size())) {
+      SHERPA_ONNX_LOGE("Invalid channel: %d. Number of channels: %d", channel,
+                       static_cast<int32_t>(channels_.size()));
+      exit(-1);
+    }
+
+    return channels_[channel].get();
+  }
+
+  // Must be called with mutex_ held
+  bool IsIdle() const {
+    if (num_processing_ > 0 || !ready_.empty() ||
+        num_outstanding_batches_ > 0) {
+      return false;
+    }
+
+    for (const auto &c : channels_) {
+      if (!c->pending.empty()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Whether the next batch can be submitted to the pool. If force is
+  // true, segments don't wait for other segments to form a batch.
+  //
+  // Must be called with mutex_ held
+  bool CanDispatch(bool force,
+                   std::chrono::steady_clock::time_point now) const {
+    if (ready_.empty()) {
+      return false;
+    }
+
+    if (force) {
+      return true;
+    }
+
+    // Keep at most one batch per decoding thread in the pool so that the
+    // remaining segments can accumulate in ready_ and be grouped by length.
+    if (num_outstanding_batches_ >= pool_.NumThreads()) {
+      return false;
+    }
+
+    return static_cast<int32_t>(ready_.size()) >= config_.batch_size ||
+           now >= Deadline();
+  }
+
+  // When the oldest segment in ready_ has waited for max_delay
+  //
+  // Must be called with mutex_ held
+  std::chrono::steady_clock::time_point Deadline() const {
+    auto oldest = std::min_element(
+        ready_.begin(), ready_.end(),
+        [](const Segment &a, const Segment &b) { return a.time < b.time; });
+
+    return oldest->time +
+           std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+               std::chrono::duration<float>(config_.max_delay));
+  }
+
+  // Must be called with mutex_ held
+  bool HasWork() const {
+    for (const auto &c : channels_) {
+      if (!c->pending.empty() || c->input_finished) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // The worker thread. It runs the VAD and dispatches batches.
+  void Run() {
+    std::vector<Channel *> channels;
+    std::vector<bool> finished;
+    std::vector<std::vector<float>> samples;
+    std::vector<VadStream *> streams;
+
+    while (true) {
+      bool stop = false;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // It is woken up by new samples, finished batches, Wait() and
+        // the destructor. A timeout is used only if segments are waiting
+        // for a batch, so that they are dispatched after max_delay.
+        while (!HasWork() &&
+               !CanDispatch(stop_ || num_waiters_ > 0,
+                            std::chrono::steady_clock::now()) &&
+               !(stop_ && IsIdle())) {
+          if (!ready_.empty() &&
+              num_outstanding_batches_ < pool_.NumThreads()) {
+            cv_.wait_until(lock, Deadline());
+          } else {
+            cv_.wait(lock);
+          }
+        }
+
+        stop = stop_;
+
+        channels.clear();
+        finished.clear();
+        for (auto &c : channels_) {
+          if (c->pending.empty() && !c->input_finished) {
+            continue;
+          }
+
+          channels.push_back(c.get());
+          finished.push_back(c->input_finished);
+          c->input_finished = false;
+        }
+
+        // Reuse the buffers of the previous iteration
+        samples.resize(std::max(samples.size(), channels.size()));
+        for (size_t i = 0; i != channels.size(); ++i) {
+          samples[i].clear();
+          samples[i].swap(channels[i]->pending);
+        }
+
+        num_processing_ = channels.empty() ? 0 : 1;
+      }
+
+      std::vector<Segment> segments;
+      if (!channels.empty()) {
+        streams.clear();
+        for (size_t i = 0; i != channels.size(); ++i) {
+          VadStream *s = channels[i]->stream.get();
+          s->AcceptWaveform(samples[i].data(), samples[i].size());
+          streams.push_back(s);
+        }
+
+        vad_.Compute(streams.data(), static_cast<int32_t>(streams.size()));
+
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i != channels.size(); ++i) {
+          VadStream *s = streams[i];
+          if (finished[i]) {
+            s->Flush();
+          }
+
+          while (!s->Empty()) {
+            Segment seg;
+            seg.channel = channels[i]->id;
+            seg.index = channels[i]->num_segments++;
+            seg.view = s->FrontView();
+            seg.time = now;
+            s->Pop();
+
+            if (seg.view.NumSamples() > 0) {
+              segments.push_back(std::move(seg));
+            }
+          }
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &seg : segments) {
+          ready_.push_back(std::move(seg));
+        }
+        num_processing_ = 0;
+
+        Dispatch(stop || num_waiters_ > 0);
+
+        if (IsIdle()) {
+          done_cv_.notify_all();
+        }
+
+        if (stop && IsIdle()) {
+          break;
+        }
+      }
+    }
+  }
+
+  // Must be called with mutex_ held
+  void Dispatch(bool force) {
+    auto now = std::chrono::steady_clock::now();
+
+    while (CanDispatch(force, now)) {
+      auto batch = std::make_shared<std::vector<Segment>>(TakeBatch());
+      ++num_outstanding_batches_;
+
+      pool_.Submit([this, batch]() { DecodeBatch(batch.get()); });
+    }
+  }
+
+  // Take the longest segments first, so that segments in a batch have
+  // similar lengths.
+  //
+  // Must be called with mutex_ held
+  std::vector<Segment> TakeBatch() {
+    std::stable_sort(ready_.begin(), ready_.end(),
+                     [](const Segment &a, const Segment &b) {
+                       return a.view.NumSamples() > b.view.NumSamples();
+                     });
+
+    int32_t n = 0;
+    float duration = 0;
+    for (const auto &seg : ready_) {
+      if (n == config_.batch_size) {
+        break;
+      }
+
+      float d = seg.view.NumSamples() / static_cast<float>(sample_rate_);
+      if (n > 0 && config_.max_batch_duration > 0 &&
+          duration + d > config_.max_batch_duration) {
+        break;
+      }
+
+      duration += d;
+      ++n;
+    }
+
+    std::vector<Segment> ans(std::make_move_iterator(ready_.begin()),
+                             std::make_move_iterator(ready_.begin() + n));
+    ready_.erase(ready_.begin(), ready_.begin() + n);
+
+    return ans;
+  }
+
+  void DecodeBatch(std::vector<Segment> *batch) {
+    int32_t n = static_cast<int32_t>(batch->size());
+
+    std::vector<std::unique_ptr<OfflineStream>> ss;
+    std::vector<OfflineStream *> ss_pointers;
+    ss.reserve(n);
+    ss_pointers.reserve(n);
+
+    std::vector<float> tmp;
+    for (auto &seg : *batch) {
+      auto stream = recognizer_->CreateStream();
+
+      const SpeechSegmentView &v = seg.view;
+      if (v.size[1] == 0) {
+        stream->AcceptWaveform(sample_rate_, v.data[0], v.size[0]);
+      } else {
+        // The segment wraps around the end of the VAD buffer
+        tmp.resize(v.NumSamples());
+        v.CopyTo(tmp.data());
+        stream->AcceptWaveform(sample_rate_, tmp.data(), tmp.size());
+      }
+
+      ss_pointers.push_back(stream.get());
+      ss.push_back(std::move(stream));
+    }
+
+    recognizer_->DecodeStreams(ss_pointers.data(), n);
+
+    {
+      std::lock_guard<std::mutex> lock(callback_mutex_);
+      for (int32_t i = 0; i != n; ++i) {
+        const Segment &seg = (*batch)[i];
+
+        VadOfflineAsrResult r;
+        r.channel = seg.channel;
+        r.segment = seg.index;
+        r.start = seg.view.start / static_cast<float>(sample_rate_);
+        r.duration = seg.view.NumSamples() / static_cast<float>(sample_rate_);
+        r.result = ss[i]->GetResult();
+
+        if (callback_) {
+          callback_(r);
+        }
+      }
+    }
+
+    // Release the samples of the VAD buffer
+    batch->clear();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --num_outstanding_batches_;
+    }
+    cv_.notify_all();
+    done_cv_.notify_all();
+  }
+
+ private:
+  BatchedVoiceActivityDetector vad_;
+  int32_t sample_rate_;
+
+  const OfflineRecognizer *recognizer_;
+  VadOfflineAsrPipelineConfig config_;
+  VadOfflineAsrCallback callback_;
+  std::mutex callback_mutex_;
+
+  // The following fields are protected by mutex_
+  std::mutex mutex_;
+  std::condition_variable cv_;       // it wakes up the worker thread
+  std::condition_variable done_cv_;  // it wakes up Wait()
+  std::vector<std::unique_ptr<Channel>> channels_;
+  std::vector<Segment> ready_;  // finished but not yet assigned to a batch
+  int32_t num_processing_ = 0;  // 1 if the worker is running the VAD
+  int32_t num_outstanding_batches_ = 0;
+  int32_t num_waiters_ = 0;
+  bool stop_ = false;
+
+  ThreadPool pool_;
+  std::thread worker_;
+};
+
+VadOfflineAsrPipeline::VadOfflineAsrPipeline(
+    const VadModelConfig &vad_config, const OfflineRecognizer *recognizer,
+    const VadOfflineAsrPipelineConfig &config, VadOfflineAsrCallback callback)
+    : impl_(std::make_unique<Impl>(vad_config, recognizer, config,
+                                   std::move(callback))) {}
+
+VadOfflineAsrPipeline::~VadOfflineAsrPipeline() = default;
+
+int32_t VadOfflineAsrPipeline::AddChannel() const {
+  return impl_->AddChannel();
+}
+
+void VadOfflineAsrPipeline::AcceptWaveform(int32_t channel,
+                                           const float *samples,
+                                           int32_t n) const {
+  impl_->AcceptWaveform(channel, samples, n);
+}
+
+void VadOfflineAsrPipeline::InputFinished(int32_t channel) const {
+  impl_->InputFinished(channel);
+}
+
+void VadOfflineAsrPipeline::Wait() const { impl_->Wait(); }
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,126 @@
+// sherpa-onnx/csrc/vad-offline-asr-pipeline.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_VAD_OFFLINE_ASR_PIPELINE_H_
+#define SHERPA_ONNX_CSRC_VAD_OFFLINE_ASR_PIPELINE_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/vad-model-config.h"
+
+namespace sherpa_onnx {
+
+struct VadOfflineAsrPipelineConfig {
+  // Number of threads decoding batches concurrently. Note that each of
+  // them uses model_config.num_threads intra-op threads.
+  int32_t num_threads = 1;
+
+  // Maximum number of segments decoded in a single batch
+  int32_t batch_size = 4;
+
+  // Maximum total duration in seconds of the segments in a batch.
+  // 0 means no limit.
+  float max_batch_duration = 0;
+
+  // Maximum time in seconds a segment waits for other segments to form
+  // a batch
+  float max_delay = 0.2;
+
+  VadOfflineAsrPipelineConfig() = default;
+
+  VadOfflineAsrPipelineConfig(int32_t num_threads, int32_t batch_size,
+                              float max_batch_duration, float max_delay)
+      : num_threads(num_threads),
+        batch_size(batch_size),
+        max_batch_duration(max_batch_duration),
+        max_delay(max_delay) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+struct VadOfflineAsrResult {
+  // The channel returned by VadOfflineAsrPipeline::AddChannel()
+  int32_t channel = 0;
+
+  // Index of the segment in its channel, starting from 0
+  int32_t segment = 0;
+
+  // Start time of the segment in seconds, relative to the first sample
+  // of the channel
+  float start = 0;
+
+  // Duration of the segment in seconds
+  float duration = 0;
+
+  OfflineRecognitionResult result;
+};
+
+// It is invoked from the decoding threads, but never concurrently.
+using VadOfflineAsrCallback = std::function<void(const VadOfflineAsrResult &)>;
+
+/** Speech recognition of many audio channels with VAD and an offline model.
+ *
+ * AcceptWaveform() only copies the samples, so it never waits for the
+ * VAD or for decoding. A background thread runs the VAD of all channels
+ * with a single model. Speech segments are grouped by length into batches,
+ * which are decoded on a thread pool. Results are delivered through a
+ * callback.
+ *
+ * Results of a channel may be delivered out of order if
+ * config.num_threads > 1. Use VadOfflineAsrResult::segment to reorder
+ * them.
+ */
+class VadOfflineAsrPipeline {
+ public:
+  /**
+   * @param vad_config Config of the VAD. The input samples must use its
+   *                   sample rate.
+   * @param recognizer It is not owned by this class and must outlive it.
+   * @param config Config of the pipeline.
+   * @param callback It is invoked once for each speech segment.
+   */
+  VadOfflineAsrPipeline(const VadModelConfig &vad_config,
+                        const OfflineRecognizer *recognizer,
+                        const VadOfflineAsrPipelineConfig &config,
+                        VadOfflineAsrCallback callback);
+
+  // It decodes all received samples before returning, including the
+  // segments that have not ended yet.
+  ~VadOfflineAsrPipeline();
+
+  // Add a new channel and return its ID. It is thread-safe.
+  int32_t AddChannel() const;
+
+  /** Add samples to a channel. It is thread-safe.
+   *
+   * @param channel A value returned by AddChannel().
+   * @param samples Samples in the range [-1, 1] at the sample rate of
+   *                the VAD.
+   * @param n Number of samples.
+   */
+  void AcceptWaveform(int32_t channel, const float *samples, int32_t n) const;
+
+  // Tell the pipeline that the channel has no more samples, so that the
+  // segment in progress is finished. It is thread-safe.
+  void InputFinished(int32_t channel) const;
+
+  // Block until all samples received so far have been processed and
+  // all finished segments have been decoded.
+  void Wait() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_OFFLINE_ASR_PIPELINE_H_
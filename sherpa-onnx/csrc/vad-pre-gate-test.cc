@@ -0,0 +1,76 @@
+// sherpa-onnx/csrc/vad-pre-gate-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> Sine(int32_t n, float amplitude) {
+  std::vector<float> ans(n);
+  for (int32_t i = 0; i != n; ++i) {
+    ans[i] = amplitude * std::sin(2 * M_PI * 200 * i / 16000.0f);
+  }
+  return ans;
+}
+
+TEST(VadPreGate, Hysteresis) {
+  VadPreGateConfig config;
+  config.enabled = true;
+  config.hangover = 0.1;  // 1600 samples
+
+  VadPreGate gate(config, 16000);
+
+  std::vector<float> silence(512);
+  std::vector<float> loud = Sine(512, 0.1);       // about -23 dBFS
+  std::vector<float> quiet = Sine(512, 0.002);  // about -57 dBFS
+
+  EXPECT_TRUE(gate.IsOpen(loud.data(), loud.size()));
+
+  // The model keeps running during the hangover
+  EXPECT_TRUE(gate.IsOpen(silence.data(), silence.size()));
+  EXPECT_TRUE(gate.IsOpen(silence.data(), silence.size()));
+  EXPECT_TRUE(gate.IsOpen(silence.data(), silence.size()));
+  EXPECT_FALSE(gate.IsOpen(silence.data(), silence.size()));
+
+  // Between the two thresholds, a closed gate stays closed
+  EXPECT_FALSE(gate.IsOpen(quiet.data(), quiet.size()));
+
+  EXPECT_TRUE(gate.IsOpen(loud.data(), loud.size()));
+
+  // and an open gate stays open
+  for (int32_t i = 0; i != 10; ++i) {
+    EXPECT_TRUE(gate.IsOpen(quiet.data(), quiet.size()));
+  }
+
+  gate.Reset();
+  EXPECT_TRUE(gate.IsOpen(silence.data(), silence.size()));
+}
+
+TEST(VadPreGate, Noise) {
+  VadPreGateConfig config;
+  config.enabled = true;
+  config.hangover = 0;
+
+  VadPreGate gate(config, 16000);
+
+  // Alternating signs give the maximum zero-crossing rate
+  std::vector<float> noise(512);
+  for (int32_t i = 0; i != static_cast<int32_t>(noise.size()); ++i) {
+    noise[i] = (i % 2 ? 1 : -1) * 0.002;  // about -54 dBFS
+  }
+
+  EXPECT_FALSE(gate.IsOpen(noise.data(), noise.size()));
+
+  // The same energy with a low zero-crossing rate is not noise
+  std::vector<float> tone = Sine(512, 0.0028);
+  gate.Reset();
+  EXPECT_TRUE(gate.IsOpen(tone.data(), tone.size()));
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,128 @@
+// sherpa-onnx/csrc/vad-pre-gate.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void VadPreGateConfig::Register(ParseOptions *po) {
+  po->Register("vad-pre-gate", &enabled,
+               "true to skip the VAD model for windows that are obviously "
+               "silence according to their energy and zero-crossing rate.");
+
+  po->Register("vad-pre-gate-low-energy-db", &low_energy_db,
+               "Windows with an RMS energy below this value (in dBFS) are "
+               "silence.");
+
+  po->Register("vad-pre-gate-high-energy-db", &high_energy_db,
+               "After a silence, the VAD model is run again only for a window "
+               "with an RMS energy above this value (in dBFS).");
+
+  po->Register("vad-pre-gate-zero-crossing-rate", &zero_crossing_rate,
+               "Windows below --vad-pre-gate-high-energy-db with a "
+               "zero-crossing rate above this value are treated as noise.");
+
+  po->Register("vad-pre-gate-hangover", &hangover,
+               "The VAD model is skipped only after this many seconds of "
+               "silence.");
+}
+
+bool VadPreGateConfig::Validate() const {
+  if (!enabled) {
+    return true;
+  }
+
+  if (low_energy_db > high_energy_db) {
+    SHERPA_ONNX_LOGE(
+        "--vad-pre-gate-low-energy-db (%.3f) should not be larger than "
+        "--vad-pre-gate-high-energy-db (%.3f)",
+        low_energy_db, high_energy_db);
+    return false;
+  }
+
+  if (hangover < 0) {
+    SHERPA_ONNX_LOGE("--vad-pre-gate-hangover should be >= 0. Given: %.3f",
+                     hangover);
+    return false;
+  }
+
+  return true;
+}
+
+std::string VadPreGateConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "VadPreGateConfig(";
+  os << "enabled=" << (enabled ? "True" : "False") << ", ";
+  os << "low_energy_db=" << low_energy_db << ", ";
+  os << "high_energy_db=" << high_energy_db << ", ";
+  os << "zero_crossing_rate=" << zero_crossing_rate << ", ";
+  os << "hangover=" << hangover << ")";
+
+  return os.str();
+}
+
+VadPreGate::VadPreGate(const VadPreGateConfig &config, int32_t sample_rate)
+    : config_(config), sample_rate_(sample_rate) {}
+
+bool VadPreGate::IsOpen(const float *samples, int32_t n) {
+  if (n <= 0) {
+    return open_;
+  }
+
+  double energy = 0;
+  int32_t num_crossings = 0;
+  float prev = last_sample_;
+
+  for (int32_t i = 0; i != n; ++i) {
+    float s = samples[i];
+    energy += s * s;
+    num_crossings += (s >= 0) != (prev >= 0);
+    prev = s;
+  }
+  last_sample_ = prev;
+
+  // 1e-10 corresponds to -100 dB and avoids log(0) for digital silence
+  float db = 10 * std::log10(energy / n + 1e-10);
+  float zcr = static_cast<float>(num_crossings) / n;
+
+  if (!open_) {
+    if (db > config_.high_energy_db) {
+      open_ = true;
+      num_silence_samples_ = 0;
+    }
+
+    return open_;
+  }
+
+  bool is_silence =
+      db < config_.low_energy_db ||
+      (db < config_.high_energy_db && zcr > config_.zero_crossing_rate);
+
+  if (!is_silence) {
+    num_silence_samples_ = 0;
+    return true;
+  }
+
+  num_silence_samples_ += n;
+  if (num_silence_samples_ > config_.hangover * sample_rate_) {
+    open_ = false;
+  }
+
+  return open_;
+}
+
+void VadPreGate::Reset() {
+  open_ = true;
+  num_silence_samples_ = 0;
+  last_sample_ = 0;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,86 @@
+// sherpa-onnx/csrc/vad-pre-gate.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_VAD_PRE_GATE_H_
+#define SHERPA_ONNX_CSRC_VAD_PRE_GATE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+// A cheap energy and zero-crossing rate detector that runs before the
+// VAD model. The model is skipped for windows that are obviously silence,
+// e.g., digital silence or low-level line noise.
+struct VadPreGateConfig {
+  bool enabled = false;
+
+  // A window with an RMS energy below it (in dBFS) is silence
+  float low_energy_db = -60;
+
+  // A closed gate opens only for a window with an RMS energy above it
+  // (in dBFS). Between low_energy_db and high_energy_db, the gate keeps
+  // its state, i.e., it has hysteresis.
+  float high_energy_db = -50;
+
+  // A window below high_energy_db whose zero-crossing rate is above this
+  // value is treated as noise, i.e., as silence.
+  float zero_crossing_rate = 0.35;
+
+  // The gate closes only after this much silence, in seconds. The model
+  // still runs on this silence so that its states follow the audio.
+  float hangover = 0.5;
+
+  VadPreGateConfig() = default;
+
+  VadPreGateConfig(bool enabled, float low_energy_db, float high_energy_db,
+                   float zero_crossing_rate, float hangover)
+      : enabled(enabled),
+        low_energy_db(low_energy_db),
+        high_energy_db(high_energy_db),
+        zero_crossing_rate(zero_crossing_rate),
+        hangover(hangover) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+class VadPreGate {
+ public:
+  VadPreGate(const VadPreGateConfig &config, int32_t sample_rate);
+
+  /** Decide whether to run the VAD model on a window.
+   *
+   * It is called for consecutive windows. For windows that overlap, pass
+   * only the new samples of each window.
+   *
+   * @param samples Pointer to a 1-d array of samples in the range [-1, 1].
+   * @param n Number of samples.
+   *
+   * @return Return true to run the model. Return false if the window is
+   *         silence and the model can be skipped.
+   */
+  bool IsOpen(const float *samples, int32_t n);
+
+  void Reset();
+
+ private:
+  VadPreGateConfig config_;
+  int32_t sample_rate_;
+
+  bool open_ = true;
+
+  // Number of silence samples since the last non-silence window
+  int32_t num_silence_samples_ = 0;
+
+  // The last sample of the previous window, for counting zero crossings
+  float last_sample_ = 0;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_PRE_GATE_H_
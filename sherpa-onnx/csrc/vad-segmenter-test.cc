@@ -0,0 +1,89 @@
+// sherpa-onnx/csrc/vad-segmenter-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-segmenter.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(VadSegmenter, Windows) {
+  VadModelConfig config;
+  VadSegmenter segmenter(config, 576, 512);
+
+  std::vector<float> samples(1000);
+  for (int32_t i = 0; i != static_cast<int32_t>(samples.size()); ++i) {
+    samples[i] = i;
+  }
+
+  segmenter.AcceptWaveform(samples.data(), 500);
+  EXPECT_EQ(segmenter.NumWindows(), 0);
+
+  segmenter.AcceptWaveform(samples.data() + 500, 500);
+  EXPECT_EQ(segmenter.NumWindows(), 1);
+  EXPECT_EQ(segmenter.GetWindow(0)[0], 0);
+
+  float prob = 0;
+  segmenter.AcceptProbs(&prob, 1);
+  EXPECT_EQ(segmenter.NumWindows(), 0);
+
+  // 488 samples are left
+  segmenter.AcceptWaveform(samples.data(), 88 + 512);
+  EXPECT_EQ(segmenter.NumWindows(), 2);
+  EXPECT_EQ(segmenter.GetWindow(0)[0], 512);
+  EXPECT_EQ(segmenter.GetWindow(1)[0], 512 + 512 - 1000);
+}
+
+TEST(VadSegmenter, Segments) {
+  VadModelConfig config;
+  config.silero_vad.min_silence_duration = 0.1;
+  config.silero_vad.min_speech_duration = 0.1;
+
+  int32_t window_size = 512;
+  VadSegmenter segmenter(config, window_size, window_size);
+
+  std::vector<float> window(window_size);
+
+  auto feed = [&](int32_t num_windows, float prob) {
+    for (int32_t i = 0; i != num_windows; ++i) {
+      segmenter.AcceptWaveform(window.data(), window_size);
+      ASSERT_EQ(segmenter.NumWindows(), 1);
+      segmenter.AcceptProbs(&prob, 1);
+    }
+  };
+
+  feed(20, 0.1);
+  EXPECT_FALSE(segmenter.IsSpeechDetected());
+  EXPECT_TRUE(segmenter.Empty());
+
+  feed(30, 0.9);
+  EXPECT_TRUE(segmenter.IsSpeechDetected());
+  EXPECT_TRUE(segmenter.Empty());
+
+  feed(1, 0.1);
+  EXPECT_FALSE(segmenter.IsSpeechDetected());
+  ASSERT_FALSE(segmenter.Empty());
+
+  const SpeechSegment &s = segmenter.Front();
+  EXPECT_GT(s.samples.size(), 30 * window_size);
+  EXPECT_LT(s.start, 20 * window_size);
+
+  const SpeechSegmentView &v = segmenter.FrontView();
+  EXPECT_EQ(v.start, s.start);
+  EXPECT_EQ(v.NumSamples(), s.samples.size());
+
+  segmenter.Pop();
+  EXPECT_TRUE(segmenter.Empty());
+
+  // A segment in progress is returned by Flush()
+  feed(10, 0.9);
+  EXPECT_TRUE(segmenter.IsSpeechDetected());
+  segmenter.Flush();
+  EXPECT_FALSE(segmenter.IsSpeechDetected());
+  EXPECT_FALSE(segmenter.Empty());
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,172 @@
+// sherpa-onnx/csrc/vad-segmenter.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-segmenter.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+VadSegmenter::VadSegmenter(const VadModelConfig &config, int32_t window_size,
+                           int32_t window_shift,
+                           float buffer_size_in_seconds /*= 60*/)
+    : config_(config),
+      window_size_(window_size),
+      window_shift_(window_shift),
+      buffer_(buffer_size_in_seconds * config.sample_rate) {
+  // TODO(fangjun): Currently, we support only one vad model.
+  // If a new vad model is added, we need to change the place
+  // where max_speech_duration is placed.
+  max_utterance_length_ =
+      config_.sample_rate * config_.silero_vad.max_speech_duration;
+
+  min_speech_samples_ =
+      config_.sample_rate * config_.silero_vad.min_speech_duration;
+
+  last_.reserve(window_size + 4 * window_shift);
+}
+
+void VadSegmenter::AcceptWaveform(const float *samples, int32_t n) {
+  // note n is usually window_size and there is no need to use
+  // an extra buffer here
+  last_.insert(last_.end(), samples, samples + n);
+}
+
+int32_t VadSegmenter::NumWindows() const {
+  int32_t n = static_cast<int32_t>(last_.size());
+  if (n < window_size_) {
+    return 0;
+  }
+
+  // Note: For v4, window_shift == window_size
+  return (n - window_size_) / window_shift_ + 1;
+}
+
+const float *VadSegmenter::GetWindow(int32_t i) const {
+  return last_.data() + i * window_shift_;
+}
+
+void VadSegmenter::AcceptProbs(const float *probs, int32_t k) {
+  if (k != NumWindows()) {
+    SHERPA_ONNX_LOGE("Expected %d probabilities. Given: %d", NumWindows(), k);
+    exit(-1);
+  }
+
+  if (k == 0) {
+    return;
+  }
+
+  int32_t min_silence_samples;
+  if (buffer_.Size() > max_utterance_length_) {
+    min_silence_samples = config_.sample_rate * new_min_silence_duration_s_;
+  } else {
+    min_silence_samples =
+        config_.sample_rate * config_.silero_vad.min_silence_duration;
+  }
+
+  bool is_speech = false;
+  for (int32_t i = 0; i != k; ++i) {
+    buffer_.Push(GetWindow(i), window_shift_);
+    is_speech = is_speech || probs[i] > config_.silero_vad.threshold;
+  }
+
+  last_.erase(last_.begin(), last_.begin() + k * window_shift_);
+
+  if (is_speech) {
+    if (start_ == -1) {
+      // beginning of speech
+      // Add pre_record_samples to capture audio before speech starts
+      start_ = std::max(buffer_.Tail() - 2 * window_size_ -
+                            min_speech_samples_ - pre_record_samples_,
+                        buffer_.Head());
+    }
+  } else {
+    // non-speech
+    if (start_ != -1 && buffer_.Size()) {
+      // end of speech, save the speech segment
+      // Add post_record_samples to capture audio after speech ends
+      int32_t end = buffer_.Tail() - min_silence_samples + post_record_samples_;
+      AddSegment(start_, end);
+    }
+
+    if (start_ == -1) {
+      int32_t end = buffer_.Tail() - 2 * window_size_ - min_speech_samples_;
+      int32_t n = std::max(0, end - buffer_.Head());
+      if (n > 0) {
+        buffer_.Pop(n);
+      }
+    }
+
+    start_ = -1;
+  }
+}
+
+void VadSegmenter::Reset() {
+  Clear();
+
+  buffer_.Reset();
+
+  start_ = -1;
+}
+
+void VadSegmenter::Flush() {
+  if (start_ == -1 || buffer_.Size() == 0) {
+    return;
+  }
+
+  int32_t end = buffer_.Tail();
+  if (end <= start_) {
+    return;
+  }
+
+  AddSegment(start_, end);
+  start_ = -1;
+}
+
+void VadSegmenter::AddSegment(int32_t start, int32_t end) {
+  SpeechSegmentView segment;
+  segment.start = start;
+
+  if (buffer_.GetRegions(start, end - start, &segment.data[0],
+                         &segment.size[0], &segment.data[1],
+                         &segment.size[1])) {
+    segment.storage = buffer_.Retain(start, end - start);
+  }
+
+  segments_.push(std::move(segment));
+
+  buffer_.Pop(end - buffer_.Head());
+}
+
+void VadSegmenter::Pop() {
+  segments_.pop();
+  front_is_valid_ = false;
+}
+
+void VadSegmenter::Clear() {
+  std::queue<SpeechSegmentView>().swap(segments_);
+  front_is_valid_ = false;
+}
+
+const SpeechSegment &VadSegmenter::Front() const {
+  if (!front_is_valid_) {
+    front_ = segments_.front().ToSpeechSegment();
+    front_is_valid_ = true;
+  }
+
+  return front_;
+}
+
+void VadSegmenter::SetPreRecordSeconds(float seconds) {
+  pre_record_samples_ = static_cast<int32_t>(seconds * config_.sample_rate);
+}
+
+void VadSegmenter::SetPostRecordSeconds(float seconds) {
+  post_record_samples_ = static_cast<int32_t>(seconds * config_.sample_rate);
+}
+
+}  // namespace sherpa_onnx
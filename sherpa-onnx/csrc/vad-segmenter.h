@@ -0,0 +1,108 @@
+// sherpa-onnx/csrc/vad-segmenter.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_VAD_SEGMENTER_H_
+#define SHERPA_ONNX_CSRC_VAD_SEGMENTER_H_
+
+#include <queue>
+#include <vector>
+
+#include "sherpa-onnx/csrc/circular-buffer.h"
+#include "sherpa-onnx/csrc/vad-model-config.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+
+namespace sherpa_onnx {
+
+// It turns the speech probabilities of a stream into speech segments.
+//
+// It does not run any model. The caller computes the probability of each
+// window returned by GetWindow() and passes them to AcceptProbs(). This
+// allows several streams to share one model, e.g., in
+// BatchedVoiceActivityDetector.
+class VadSegmenter {
+ public:
+  /**
+   * @param config The vad config.
+   * @param window_size Number of samples of a window, i.e., the model input.
+   * @param window_shift Number of samples between two windows.
+   * @param buffer_size_in_seconds Maximum length of the audio kept for
+   *                               the current segment.
+   */
+  VadSegmenter(const VadModelConfig &config, int32_t window_size,
+               int32_t window_shift, float buffer_size_in_seconds = 60);
+
+  // Append samples. Call NumWindows() afterwards to get the number of
+  // windows to compute.
+  void AcceptWaveform(const float *samples, int32_t n);
+
+  // Number of complete windows in the received samples
+  int32_t NumWindows() const;
+
+  // Return the start of the i-th window, 0 <= i < NumWindows().
+  // It contains window_size samples.
+  const float *GetWindow(int32_t i) const;
+
+  /** Process the probabilities of all windows returned by NumWindows().
+   *
+   * @param probs Speech probability of each window.
+   * @param k Number of entries in probs. Must be equal to NumWindows().
+   */
+  void AcceptProbs(const float *probs, int32_t k);
+
+  bool Empty() const { return segments_.empty(); }
+
+  void Pop();
+
+  void Clear();
+
+  // It copies the samples of the front segment on the first call
+  const SpeechSegment &Front() const;
+
+  const SpeechSegmentView &FrontView() const { return segments_.front(); }
+
+  bool IsSpeechDetected() const { return start_ != -1; }
+
+  void Reset();
+
+  void Flush();
+
+  void SetPreRecordSeconds(float seconds);
+  void SetPostRecordSeconds(float seconds);
+
+ private:
+  // Add the samples [start, end) of buffer_ as a segment and remove
+  // them from buffer_
+  void AddSegment(int32_t start, int32_t end);
+
+ private:
+  // The segments refer to the samples in buffer_
+  std::queue<SpeechSegmentView> segments_;
+
+  // A copy of the front segment for Front()
+  mutable SpeechSegment front_;
+  mutable bool front_is_valid_ = false;
+
+  VadModelConfig config_;
+  int32_t window_size_;
+  int32_t window_shift_;
+
+  CircularBuffer buffer_;
+
+  // Samples that are not processed yet. Its capacity is reserved, so it
+  // is not reallocated if the input is given in small chunks.
+  std::vector<float> last_;
+
+  int max_utterance_length_ = -1;  // in samples
+  float new_min_silence_duration_s_ = 0.1;
+
+  int32_t min_speech_samples_;
+
+  int32_t start_ = -1;
+
+  int32_t pre_record_samples_ = 1.0;   // samples to keep before speech starts
+  int32_t post_record_samples_ = 0.5;  // samples to keep after speech ends
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_SEGMENTER_H_
@@ -0,0 +1,86 @@
+// sherpa-onnx/csrc/vad-stream.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_VAD_STREAM_H_
+#define SHERPA_ONNX_CSRC_VAD_STREAM_H_
+
+#include <utility>
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/vad-model-config.h"
+#include "sherpa-onnx/csrc/vad-segmenter.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+
+namespace sherpa_onnx {
+
+// A stream of BatchedVoiceActivityDetector. It has its own model states
+// and speech segments.
+class VadStream {
+ public:
+  VadStream(const VadModelConfig &config, int32_t window_size,
+            int32_t window_shift, float buffer_size_in_seconds = 60)
+      : segmenter_(config, window_size, window_shift,
+                   buffer_size_in_seconds) {}
+
+  // The samples are processed in
+  // BatchedVoiceActivityDetector::Compute()
+  void AcceptWaveform(const float *samples, int32_t n) {
+    segmenter_.AcceptWaveform(samples, n);
+  }
+
+  bool Empty() const { return segmenter_.Empty(); }
+
+  void Pop() { segmenter_.Pop(); }
+
+  void Clear() { segmenter_.Clear(); }
+
+  const SpeechSegment &Front() const { return segmenter_.Front(); }
+
+  const SpeechSegmentView &FrontView() const {
+    return segmenter_.FrontView();
+  }
+
+  bool IsSpeechDetected() const { return segmenter_.IsSpeechDetected(); }
+
+  // It also resets the model states
+  void Reset() {
+    segmenter_.Reset();
+    states_.clear();
+  }
+
+  // At the end of the utterance, you can invoke this method so that
+  // the last speech segment can be detected.
+  void Flush() { segmenter_.Flush(); }
+
+  void SetPreRecordSeconds(float seconds) {
+    segmenter_.SetPreRecordSeconds(seconds);
+  }
+
+  void SetPostRecordSeconds(float seconds) {
+    segmenter_.SetPostRecordSeconds(seconds);
+  }
+
+  float GetLastScore() const { return last_score_; }
+
+  // The following methods are used by BatchedVoiceActivityDetector
+  VadSegmenter &GetSegmenter() { return segmenter_; }
+
+  // Empty if the states have not been initialized
+  std::vector<Ort::Value> &GetStates() { return states_; }
+
+  void SetStates(std::vector<Ort::Value> states) {
+    states_ = std::move(states);
+  }
+
+  void SetLastScore(float score) { last_score_ = score; }
+
+ private:
+  VadSegmenter segmenter_;
+  std::vector<Ort::Value> states_;
+  float last_score_ = 0.0f;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_STREAM_H_
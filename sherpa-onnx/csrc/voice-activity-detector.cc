@@ -4,9 +4,7 @@
 
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
 
-#include <algorithm>
-#include <queue>
-#include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -17,8 +15,9 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
-#include "sherpa-onnx/csrc/circular-buffer.h"
 #include "sherpa-onnx/csrc/vad-model.h"
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
+#include "sherpa-onnx/csrc/vad-segmenter.h"
 
 namespace sherpa_onnx {
 
@@ -27,7 +26,8 @@ class VoiceActivityDetector::Impl {
   explicit Impl(const VadModelConfig &config, float buffer_size_in_seconds = 60)
       : model_(VadModel::Create(config)),
         config_(config),
-        buffer_(buffer_size_in_seconds * config.sample_rate) {
+        segmenter_(config, model_->WindowSize(), model_->WindowShift(),
+                   buffer_size_in_seconds) {
     Init();
   }
 
@@ -36,166 +36,140 @@ class VoiceActivityDetector::Impl {
        float buffer_size_in_seconds = 60)
       : model_(VadModel::Create(mgr, config)),
         config_(config),
-        buffer_(buffer_size_in_seconds * config.sample_rate) {
+        segmenter_(config, model_->WindowSize(), model_->WindowShift(),
+                   buffer_size_in_seconds) {
     Init();
   }
 
   void SetPreRecordSeconds(float seconds) {
-    pre_record_samples_ = static_cast<int32_t>(seconds * config_.sample_rate);
+    segmenter_.SetPreRecordSeconds(seconds);
   }
 
   void SetPostRecordSeconds(float seconds) {
-    post_record_samples_ = static_cast<int32_t>(seconds * config_.sample_rate);
+    segmenter_.SetPostRecordSeconds(seconds);
   }
+
   float GetLastScore() const { return last_score_; }
 
   void AcceptWaveform(const float *samples, int32_t n) {
-    if (buffer_.Size() > max_utterance_length_) {
-      model_->SetMinSilenceDuration(new_min_silence_duration_s_);
-      model_->SetThreshold(new_threshold_);
-    } else {
-      model_->SetMinSilenceDuration(config_.silero_vad.min_silence_duration);
-      model_->SetThreshold(config_.silero_vad.threshold);
-    }
-
-    int32_t window_size = model_->WindowSize();
-    int32_t window_shift = model_->WindowShift();
-
-    // note n is usually window_size and there is no need to use
-    // an extra buffer here
-    last_.insert(last_.end(), samples, samples + n);
+    segmenter_.AcceptWaveform(samples, n);
 
-    if (last_.size() < window_size) {
+    int32_t k = segmenter_.NumWindows();
+    if (k == 0) {
       return;
     }
 
-    // Note: For v4, window_shift == window_size
-    int32_t k =
-        (static_cast<int32_t>(last_.size()) - window_size) / window_shift + 1;
-    const float *p = last_.data();
-    bool is_speech = false;
-
-    for (int32_t i = 0; i < k; ++i, p += window_shift) {
-      buffer_.Push(p, window_shift);
-      // NOTE(fangjun): Please don't use a very large n.
-      last_score_ = model_->GetProb(p, window_size);  // Get raw probability
-      is_speech = is_speech || last_score_ > config_.silero_vad.threshold;
+    probs_.resize(k);
+    for (int32_t i = 0; i != k; ++i) {
+      probs_[i] = ComputeProb(segmenter_.GetWindow(i));
     }
+    last_score_ = probs_.back();
 
-    last_ = std::vector<float>(
-        p, static_cast<const float *>(last_.data()) + last_.size());
-
-    if (is_speech) {
-      if (start_ == -1) {
-        // beginning of speech
-        // Add pre_record_samples to capture audio before speech starts
-        start_ = std::max(buffer_.Tail() - 2 * model_->WindowSize() -
-                         model_->MinSpeechDurationSamples() -
-                         pre_record_samples_,
-                         buffer_.Head());
-      }
-    } else {
-      // non-speech
-      if (start_ != -1 && buffer_.Size()) {
-        // end of speech, save the speech segment
-        // Add post_record_samples to capture audio after speech ends
-        int32_t end = buffer_.Tail() - model_->MinSilenceDurationSamples() +
-                      post_record_samples_;
-        std::vector<float> s = buffer_.Get(start_, end - start_);
-        SpeechSegment segment;
-
-        segment.start = start_;
-        segment.samples = std::move(s);
-
-        segments_.push(std::move(segment));
-
-        buffer_.Pop(end - buffer_.Head());
-      }
-
-      if (start_ == -1) {
-        int32_t end = buffer_.Tail() - 2 * model_->WindowSize() -
-                      model_->MinSpeechDurationSamples();
-        int32_t n = std::max(0, end - buffer_.Head());
-        if (n > 0) {
-          buffer_.Pop(n);
-        }
-      }
-
-      start_ = -1;
-    }
+    segmenter_.AcceptProbs(probs_.data(), k);
   }
 
-  bool Empty() const { return segments_.empty(); }
+  bool Empty() const { return segmenter_.Empty(); }
 
-  void Pop() { segments_.pop(); }
+  void Pop() { segmenter_.Pop(); }
 
-  void Clear() { std::queue<SpeechSegment>().swap(segments_); }
+  void Clear() { segmenter_.Clear(); }
 
-  const SpeechSegment &Front() const { return segments_.front(); }
+  const SpeechSegment &Front() const { return segmenter_.Front(); }
 
-  void Reset() {
-    std::queue<SpeechSegment>().swap(segments_);
+  const SpeechSegmentView &FrontView() const {
+    return segmenter_.FrontView();
+  }
 
+  void Reset() {
     model_->Reset();
-    buffer_.Reset();
+    segmenter_.Reset();
 
-    start_ = -1;
+    if (pre_gate_) {
+      pre_gate_->Reset();
+    }
+    skipped_windows_.clear();
+    model_skipped_ = false;
   }
 
-  void Flush() {
-    if (start_ == -1 || buffer_.Size() == 0) {
-      return;
-    }
+  void Flush() { segmenter_.Flush(); }
 
-    int32_t end = buffer_.Tail();
-    if (end <= start_) {
-      return;
+  bool IsSpeechDetected() const { return segmenter_.IsSpeechDetected(); }
+
+  const VadModelConfig &GetConfig() const { return config_; }
+
+ private:
+  void Init() {
+    if (config_.pre_gate.enabled) {
+      pre_gate_ =
+          std::make_unique<VadPreGate>(config_.pre_gate, config_.sample_rate);
     }
+  }
 
-    std::vector<float> s = buffer_.Get(start_, end - start_);
+  float ComputeProb(const float *window) {
+    int32_t window_size = model_->WindowSize();
 
-    SpeechSegment segment;
+    if (!pre_gate_) {
+      // NOTE(fangjun): Please don't use a very large n.
+      return model_->GetProb(window, window_size);
+    }
 
-    segment.start = start_;
-    segment.samples = std::move(s);
+    // Only the last window_shift samples are new for overlapping windows
+    int32_t window_shift = model_->WindowShift();
+    if (!pre_gate_->IsOpen(window + window_size - window_shift,
+                           window_shift)) {
+      // Keep the most recent skipped windows
+      if (static_cast<int32_t>(skipped_windows_.size()) >=
+          kNumWarmupWindows * window_size) {
+        skipped_windows_.erase(skipped_windows_.begin(),
+                               skipped_windows_.begin() + window_size);
+      }
+      skipped_windows_.insert(skipped_windows_.end(), window,
+                              window + window_size);
 
-    segments_.push(std::move(segment));
+      model_skipped_ = true;
+      return 0;
+    }
 
-    buffer_.Pop(end - buffer_.Head());
-    start_ = -1;
-  }
+    if (model_skipped_) {
+      // The model states are stale after skipping windows. We restart them
+      // with the most recent skipped windows so that the model has seen some
+      // silence before the current window, as if no window were skipped.
+      model_->Reset();
 
-  bool IsSpeechDetected() const { return start_ != -1; }
+      int32_t n = static_cast<int32_t>(skipped_windows_.size()) / window_size;
+      for (int32_t i = 0; i != n; ++i) {
+        model_->GetProb(skipped_windows_.data() + i * window_size,
+                        window_size);
+      }
 
-  const VadModelConfig &GetConfig() const { return config_; }
+      skipped_windows_.clear();
+      model_skipped_ = false;
+    }
 
- private:
-  void Init() {
-    // TODO(fangjun): Currently, we support only one vad model.
-    // If a new vad model is added, we need to change the place
-    // where max_speech_duration is placed.
-    max_utterance_length_ =
-        config_.sample_rate * config_.silero_vad.max_speech_duration;
+    return model_->GetProb(window, window_size);
   }
 
  private:
-  std::queue<SpeechSegment> segments_;
+  // Number of skipped windows to run before the model is used again
+  static constexpr int32_t kNumWarmupWindows = 4;
 
   std::unique_ptr<VadModel> model_;
   VadModelConfig config_;
-  CircularBuffer buffer_;
-  std::vector<float> last_;
+  VadSegmenter segmenter_;
+
+  // It is nullptr if the pre-gate is disabled
+  std::unique_ptr<VadPreGate> pre_gate_;
 
-  int max_utterance_length_ = -1;  // in samples
-  float new_min_silence_duration_s_ = 0.1;
-  float new_threshold_ = 0.90;
+  // Samples of up to kNumWarmupWindows windows skipped by the pre-gate
+  std::vector<float> skipped_windows_;
 
-  int32_t start_ = -1;
+  // true if the model has not run on some windows
+  bool model_skipped_ = false;
 
-  int32_t pre_record_samples_ = 1.0;   // samples to keep before speech starts
-  int32_t post_record_samples_ = 0.5;  // samples to keep after speech ends
-  float last_score_ = 0.0f;  // Add this member variable
+  // probabilities of the windows of the current AcceptWaveform() call
+  std::vector<float> probs_;
 
+  float last_score_ = 0.0f;
 };
 
 VoiceActivityDetector::VoiceActivityDetector(
@@ -224,6 +198,10 @@ const SpeechSegment &VoiceActivityDetector::Front() const {
   return impl_->Front();
 }
 
+const SpeechSegmentView &VoiceActivityDetector::FrontView() const {
+  return impl_->FrontView();
+}
+
 void VoiceActivityDetector::Reset() const { impl_->Reset(); }
 
 void VoiceActivityDetector::Flush() const { impl_->Flush(); }
@@ -4,6 +4,7 @@
 #ifndef SHERPA_ONNX_CSRC_VOICE_ACTIVITY_DETECTOR_H_
 #define SHERPA_ONNX_CSRC_VOICE_ACTIVITY_DETECTOR_H_
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -16,6 +17,37 @@ struct SpeechSegment {
   std::vector<float> samples;
 };
 
+// It is like SpeechSegment but it refers to the samples kept by the VAD
+// instead of copying them. The samples stay valid as long as the view
+// exists.
+struct SpeechSegmentView {
+  int32_t start = 0;  // in samples
+
+  // The samples are [data[0], data[0] + size[0]) followed by
+  // [data[1], data[1] + size[1]). size[1] is 0 if they are contiguous.
+  const float *data[2] = {nullptr, nullptr};
+  int32_t size[2] = {0, 0};
+
+  // It keeps the samples alive
+  std::shared_ptr<const std::vector<float>> storage;
+
+  int32_t NumSamples() const { return size[0] + size[1]; }
+
+  // out must have space for NumSamples() floats
+  void CopyTo(float *out) const {
+    std::copy(data[0], data[0] + size[0], out);
+    std::copy(data[1], data[1] + size[1], out + size[0]);
+  }
+
+  SpeechSegment ToSpeechSegment() const {
+    SpeechSegment ans;
+    ans.start = start;
+    ans.samples.resize(NumSamples());
+    CopyTo(ans.samples.data());
+    return ans;
+  }
+};
+
 class VoiceActivityDetector {
  public:
   explicit VoiceActivityDetector(const VadModelConfig &config,
@@ -33,6 +65,9 @@ class VoiceActivityDetector {
   void Clear();
   const SpeechSegment &Front() const;
 
+  // Same as Front() but it does not copy the samples
+  const SpeechSegmentView &FrontView() const;
+
   bool IsSpeechDetected() const;
 
   void Reset() const;
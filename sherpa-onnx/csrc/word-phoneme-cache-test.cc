@@ -0,0 +1,164 @@
+// sherpa-onnx/csrc/word-phoneme-cache-test.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/word-phoneme-cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(WordPhonemeCache, SaveAndLookup) {
+  std::string filename = "word-phoneme-cache-test.bin";
+
+  std::vector<std::pair<std::string, std::u32string>> entries = {
+      {"world", U"wˈɜːld"},
+      {"hello", U"həlˈəʊ"},
+      {"a", U"ɐ"},
+      {"你好", U"ni3hao3"},
+      {"empty", U""},
+  };
+
+  ASSERT_TRUE(WordPhonemeCache::Save(filename, entries));
+
+  WordPhonemeCache cache(filename);
+  EXPECT_EQ(cache.NumWords(), entries.size());
+
+  std::u32string phonemes;
+  for (const auto &e : entries) {
+    EXPECT_TRUE(cache.Lookup(e.first, &phonemes)) << e.first;
+    EXPECT_EQ(phonemes, e.second);
+  }
+
+  for (const char *w : {"", "b", "hell", "helloo", "zzz", "Hello"}) {
+    EXPECT_FALSE(cache.Lookup(w, &phonemes)) << w;
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST(WordPhonemeCache, Duplicated) {
+  std::string filename = "word-phoneme-cache-test-dup.bin";
+
+  std::vector<std::pair<std::string, std::u32string>> entries = {
+      {"a", U"a"},
+      {"a", U"b"},
+  };
+
+  EXPECT_FALSE(WordPhonemeCache::Save(filename, entries));
+
+  std::remove(filename.c_str());
+}
+
+// Replace the uint32_t at the given byte offset of a file
+static void Overwrite(const std::string &filename, size_t offset,
+                      uint32_t value) {
+  std::string s;
+  {
+    std::ifstream is(filename, std::ios::binary);
+    s.assign(std::istreambuf_iterator<char>(is),
+             std::istreambuf_iterator<char>());
+  }
+
+  ASSERT_LE(offset + sizeof(value), s.size());
+  std::memcpy(&s[offset], &value, sizeof(value));
+
+  std::ofstream os(filename, std::ios::binary);
+  os.write(s.data(), s.size());
+}
+
+TEST(WordPhonemeCache, Corrupted) {
+  std::string filename = "word-phoneme-cache-test-corrupted.bin";
+
+  std::vector<std::pair<std::string, std::u32string>> entries = {
+      {"a", U"a"},
+      {"bb", U"bb"},
+      {"ccc", U"ccc"},
+  };
+
+  // magic, version and number of words
+  size_t header_size = 16;
+  size_t offsets_size = (entries.size() + 1) * sizeof(uint32_t);
+  size_t word_offsets = header_size;
+  size_t phoneme_offsets = header_size + offsets_size;
+
+  struct TestCase {
+    size_t offset;
+    uint32_t value;
+    const char *error;
+  };
+
+  std::vector<TestCase> test_cases = {
+      // A word offset that decreases
+      {word_offsets + 2 * sizeof(uint32_t), 0, "Invalid offsets"},
+      // A phoneme offset that decreases
+      {phoneme_offsets + 2 * sizeof(uint32_t), 0, "Invalid offsets"},
+      // The first offset is not 0
+      {word_offsets, 1, "Invalid offsets"},
+      // A word offset past the end of the words
+      {word_offsets + 2 * sizeof(uint32_t), 100, "Invalid offsets"},
+      // A phoneme offset past the end of the phonemes
+      {phoneme_offsets + 2 * sizeof(uint32_t), 100, "Invalid offsets"},
+      // The last phoneme offset past the end of the file
+      {phoneme_offsets + 3 * sizeof(uint32_t), 100, "truncated"},
+  };
+
+  for (const auto &t : test_cases) {
+    ASSERT_TRUE(WordPhonemeCache::Save(filename, entries));
+    Overwrite(filename, t.offset, t.value);
+
+    EXPECT_EXIT(WordPhonemeCache cache(filename),
+                ::testing::ExitedWithCode(255), t.error)
+        << t.offset << " " << t.value;
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST(WordPhonemeCache, SplitWordAndPunctuation) {
+  struct TestCase {
+    const char *token;
+    const char *word;
+    char punct;
+  };
+
+  std::vector<TestCase> test_cases = {
+      {"hello", "hello", 0},
+      {"hello,", "hello", ','},
+      {"world.", "world", '.'},
+      {"(really)?", "really", '?'},
+      {"\"quoted\",", "quoted", ','},
+      {"'tis", "tis", 0},
+      {"end...", "end", '.'},
+      {"why?!", "why", '?'},
+      {"...", "", 0},
+      // Symbols that espeak-ng reads are kept
+      {"$5", "$5", 0},
+      {"$5.", "$5", '.'},
+      {"50%", "50%", 0},
+      {"50%,", "50%", ','},
+      {"#1", "#1", 0},
+      {"@user", "@user", 0},
+      {"+3", "+3", 0},
+      {"-3", "-3", 0},
+      {"3.14", "3.14", 0},
+      {"(#1)", "#1", 0},
+  };
+
+  std::string word;
+  for (const auto &t : test_cases) {
+    char punct = SplitWordAndPunctuation(t.token, &word);
+    EXPECT_EQ(word, t.word) << t.token;
+    EXPECT_EQ(punct, t.punct) << t.token;
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,224 @@
+// sherpa-onnx/csrc/word-phoneme-cache.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/word-phoneme-cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'H', 'E', 'R', 'P', 'A', 'W', 'P'};
+constexpr int32_t kVersion = 1;
+
+// magic, version and number of words
+constexpr size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(int32_t);
+
+size_t PadTo4(size_t n) { return (n + 3) / 4 * 4; }
+
+// Punctuations after which piper::phonemize_eSpeak() ends a clause
+bool IsClausePunctuation(char c) {
+  return c != 0 && std::strchr(",.;:!?", c) != nullptr;
+}
+
+// Clause punctuation, quotes and brackets
+bool IsWordBoundaryPunctuation(char c) {
+  return c != 0 && std::strchr(",.;:!?\"'`()[]{}", c) != nullptr;
+}
+
+// The offsets of n entries start at 0 and do not decrease. Then every
+// entry is within its section if the last offset is.
+bool IsValidOffsets(const uint32_t *offsets, int32_t n) {
+  if (offsets[0] != 0) {
+    return false;
+  }
+
+  for (int32_t i = 0; i != n; ++i) {
+    if (offsets[i + 1] < offsets[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+WordPhonemeCache::WordPhonemeCache(const std::string &filename)
+    : file_(filename) {
+  const char *p = file_.data();
+  size_t size = file_.size();
+
+  int32_t version = 0;
+  if (size < kHeaderSize || std::memcmp(p, kMagic, sizeof(kMagic)) != 0) {
+    SHERPA_ONNX_LOGE("'%s' is not a word phoneme cache", filename.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  std::memcpy(&version, p + sizeof(kMagic), sizeof(version));
+  std::memcpy(&num_words_, p + sizeof(kMagic) + sizeof(version),
+              sizeof(num_words_));
+
+  if (version != kVersion || num_words_ < 0) {
+    SHERPA_ONNX_LOGE("Unsupported word phoneme cache '%s'. Version: %d",
+                     filename.c_str(), version);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  size_t offsets_size = (num_words_ + 1) * sizeof(uint32_t);
+  if (size < kHeaderSize + 2 * offsets_size) {
+    SHERPA_ONNX_LOGE("'%s' is truncated", filename.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  word_offsets_ = reinterpret_cast<const uint32_t *>(p + kHeaderSize);
+  phoneme_offsets_ =
+      reinterpret_cast<const uint32_t *>(p + kHeaderSize + offsets_size);
+
+  // Lookup() reads the words and phonemes through the offsets
+  if (!IsValidOffsets(word_offsets_, num_words_) ||
+      !IsValidOffsets(phoneme_offsets_, num_words_)) {
+    SHERPA_ONNX_LOGE("Invalid offsets in the word phoneme cache '%s'",
+                     filename.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  size_t words_start = kHeaderSize + 2 * offsets_size;
+  size_t phonemes_start = words_start + PadTo4(word_offsets_[num_words_]);
+  size_t expected_size =
+      phonemes_start + phoneme_offsets_[num_words_] * sizeof(char32_t);
+
+  if (size < expected_size) {
+    SHERPA_ONNX_LOGE("'%s' is truncated. Expected size: %zu. Given: %zu",
+                     filename.c_str(), expected_size, size);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  words_ = p + words_start;
+  phonemes_ = reinterpret_cast<const char32_t *>(p + phonemes_start);
+}
+
+bool WordPhonemeCache::Lookup(const std::string &word,
+                              std::u32string *phonemes) const {
+  // Binary search for the first word not less than the given word
+  int32_t lo = 0;
+  int32_t hi = num_words_;
+  while (lo < hi) {
+    int32_t mid = lo + (hi - lo) / 2;
+    uint32_t begin = word_offsets_[mid];
+    uint32_t n = word_offsets_[mid + 1] - begin;
+
+    if (word.compare(0, word.size(), words_ + begin, n) > 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (lo == num_words_) {
+    return false;
+  }
+
+  uint32_t begin = word_offsets_[lo];
+  uint32_t n = word_offsets_[lo + 1] - begin;
+  if (word.compare(0, word.size(), words_ + begin, n) != 0) {
+    return false;
+  }
+
+  phonemes->assign(phonemes_ + phoneme_offsets_[lo],
+                   phonemes_ + phoneme_offsets_[lo + 1]);
+  return true;
+}
+
+bool WordPhonemeCache::Save(
+    const std::string &filename,
+    std::vector<std::pair<std::string, std::u32string>> entries) {
+  std::sort(entries.begin(), entries.end());
+
+  for (size_t i = 1; i < entries.size(); ++i) {
+    if (entries[i].first == entries[i - 1].first) {
+      SHERPA_ONNX_LOGE("Duplicated word '%s'", entries[i].first.c_str());
+      return false;
+    }
+  }
+
+  int32_t num_words = static_cast<int32_t>(entries.size());
+
+  std::vector<uint32_t> word_offsets = {0};
+  std::vector<uint32_t> phoneme_offsets = {0};
+  word_offsets.reserve(num_words + 1);
+  phoneme_offsets.reserve(num_words + 1);
+
+  for (const auto &e : entries) {
+    word_offsets.push_back(word_offsets.back() + e.first.size());
+    phoneme_offsets.push_back(phoneme_offsets.back() + e.second.size());
+  }
+
+  std::ofstream os(filename, std::ios::binary);
+  if (!os) {
+    SHERPA_ONNX_LOGE("Failed to open '%s' for writing", filename.c_str());
+    return false;
+  }
+
+  os.write(kMagic, sizeof(kMagic));
+  os.write(reinterpret_cast<const char *>(&kVersion), sizeof(kVersion));
+  os.write(reinterpret_cast<const char *>(&num_words), sizeof(num_words));
+
+  os.write(reinterpret_cast<const char *>(word_offsets.data()),
+           word_offsets.size() * sizeof(uint32_t));
+  os.write(reinterpret_cast<const char *>(phoneme_offsets.data()),
+           phoneme_offsets.size() * sizeof(uint32_t));
+
+  for (const auto &e : entries) {
+    os.write(e.first.data(), e.first.size());
+  }
+
+  const char padding[4] = {0};
+  os.write(padding, PadTo4(word_offsets.back()) - word_offsets.back());
+
+  for (const auto &e : entries) {
+    os.write(reinterpret_cast<const char *>(e.second.data()),
+             e.second.size() * sizeof(char32_t));
+  }
+
+  if (!os) {
+    SHERPA_ONNX_LOGE("Failed to write '%s'", filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+char SplitWordAndPunctuation(const std::string &token, std::string *word) {
+  size_t begin = 0;
+  size_t end = token.size();
+  while (begin < end && IsWordBoundaryPunctuation(token[begin])) {
+    ++begin;
+  }
+
+  while (end > begin && IsWordBoundaryPunctuation(token[end - 1])) {
+    --end;
+  }
+
+  word->assign(token, begin, end - begin);
+
+  for (size_t i = end; i < token.size(); ++i) {
+    if (IsClausePunctuation(token[i])) {
+      return token[i];
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,75 @@
+// sherpa-onnx/csrc/word-phoneme-cache.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_WORD_PHONEME_CACHE_H_
+#define SHERPA_ONNX_CSRC_WORD_PHONEME_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+
+namespace sherpa_onnx {
+
+/** A precomputed table from words to phonemes.
+ *
+ * The file is memory-mapped and searched in place, so loading it is fast,
+ * its pages are shared by all processes using it and lookups need no
+ * locks. The file contains
+ *
+ *   - a header: magic "SHERPAWP", version and number of words, the latter
+ *     two in int32_t
+ *   - byte offsets of the words, uint32_t[num_words + 1]
+ *   - offsets of the phonemes, uint32_t[num_words + 1]
+ *   - the words in UTF-8 sorted by bytes, padded to a multiple of 4 bytes
+ *   - the phonemes in UTF-32
+ */
+class WordPhonemeCache {
+ public:
+  WordPhonemeCache() = default;
+
+  // It exits if the file is not a valid word phoneme cache
+  explicit WordPhonemeCache(const std::string &filename);
+
+  // Return true and set *phonemes if the word is found
+  bool Lookup(const std::string &word, std::u32string *phonemes) const;
+
+  int32_t NumWords() const { return num_words_; }
+
+  // Save words and their phonemes. Words need not be sorted. Return false
+  // on error, e.g., if a word is duplicated.
+  static bool Save(
+      const std::string &filename,
+      std::vector<std::pair<std::string, std::u32string>> entries);
+
+ private:
+  MappedFile file_;
+
+  int32_t num_words_ = 0;
+  const uint32_t *word_offsets_ = nullptr;
+  const uint32_t *phoneme_offsets_ = nullptr;
+  const char *words_ = nullptr;
+  const char32_t *phonemes_ = nullptr;
+};
+
+/** Split a token of the input text into the word to look up and the
+ * clause punctuation after it.
+ *
+ * Only clause punctuation (.,;:!?), quotes and brackets at both ends are
+ * removed. Other symbols, e.g., in "$5", "50%", "#1", "@user" and "+3",
+ * are kept since espeak-ng reads them.
+ *
+ * @param token A token of the text without spaces.
+ * @param word On return, it contains the word. It is empty if the token
+ *             contains only punctuation.
+ * @return Return the first clause punctuation after the word or 0 if there
+ *         is none.
+ */
+char SplitWordAndPunctuation(const std::string &token, std::string *word);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_WORD_PHONEME_CACHE_H_
@@ -150,11 +150,12 @@ SHERPA_ONNX_EXTERN_C
 JNIEXPORT jobjectArray JNICALL
 Java_com_k2fsa_sherpa_onnx_Vad_front(JNIEnv *env, jobject /*obj*/, jlong ptr) {
   const auto &front =
-      reinterpret_cast<sherpa_onnx::VoiceActivityDetector *>(ptr)->Front();
+      reinterpret_cast<sherpa_onnx::VoiceActivityDetector *>(ptr)->FrontView();
 
-  jfloatArray samples_arr = env->NewFloatArray(front.samples.size());
-  env->SetFloatArrayRegion(samples_arr, 0, front.samples.size(),
-                           front.samples.data());
+  jfloatArray samples_arr = env->NewFloatArray(front.NumSamples());
+  env->SetFloatArrayRegion(samples_arr, 0, front.size[0], front.data[0]);
+  env->SetFloatArrayRegion(samples_arr, front.size[0], front.size[1],
+                           front.data[1]);
 
   jobjectArray obj_arr = (jobjectArray)env->NewObjectArray(
       2, env->FindClass("java/lang/Object"), nullptr);
@@ -18,6 +18,8 @@ static void PybindFastClusteringConfig(py::module *m) {
            py::arg("threshold") = 0.5)
       .def_readwrite("num_clusters", &PyClass::num_clusters)
       .def_readwrite("threshold", &PyClass::threshold)
+      .def_readwrite("block_size", &PyClass::block_size)
+      .def_readwrite("max_memory_mb", &PyClass::max_memory_mb)
       .def("__str__", &PyClass::ToString)
       .def("validate", &PyClass::Validate);
 }
@@ -0,0 +1,25 @@
+// sherpa-onnx/python/csrc/model-cache-config.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/model-cache-config.h"
+
+#include <string>
+
+#include "sherpa-onnx/csrc/model-cache.h"
+
+namespace sherpa_onnx {
+
+void PybindModelCacheConfig(py::module *m) {
+  using PyClass = ModelCacheConfig;
+  py::class_<PyClass>(*m, "ModelCacheConfig")
+      .def(py::init<>())
+      .def(py::init<bool, const std::string &>(), py::arg("enabled") = false,
+           py::arg("dir") = "")
+      .def_readwrite("enabled", &PyClass::enabled)
+      .def_readwrite("dir", &PyClass::dir)
+      .def("__str__", &PyClass::ToString)
+      .def("validate", &PyClass::Validate);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,16 @@
+// sherpa-onnx/python/csrc/model-cache-config.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_MODEL_CACHE_CONFIG_H_
+#define SHERPA_ONNX_PYTHON_CSRC_MODEL_CACHE_CONFIG_H_
+
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+void PybindModelCacheConfig(py::module *m);
+
+}
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_MODEL_CACHE_CONFIG_H_
@@ -5,6 +5,7 @@
 #include "sherpa-onnx/python/csrc/offline-punctuation.h"
 
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/offline-punctuation.h"
 
@@ -21,6 +22,7 @@ static void PybindOfflinePunctuationModelConfig(py::module *m) {
       .def_readwrite("num_threads", &PyClass::num_threads)
       .def_readwrite("debug", &PyClass::debug)
       .def_readwrite("provider", &PyClass::provider)
+      .def_readwrite("batch_size", &PyClass::batch_size)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -45,7 +47,9 @@ void PybindOfflinePunctuation(py::module *m) {
       .def(py::init<const OfflinePunctuationConfig &>(), py::arg("config"),
            py::call_guard<py::gil_scoped_release>())
       .def("add_punctuation", &PyClass::AddPunctuation, py::arg("text"),
-           py::call_guard<py::gil_scoped_release>());
+           py::call_guard<py::gil_scoped_release>())
+      .def("add_punctuation_batch", &PyClass::AddPunctuationBatch,
+           py::arg("texts"), py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
@@ -36,6 +36,8 @@ static void PybindOfflineRecognizerConfig(py::module *m) {
       .def_readwrite("blank_penalty", &PyClass::blank_penalty)
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("rule_fars", &PyClass::rule_fars)
+      .def_readwrite("shared_runtime", &PyClass::shared_runtime)
+      .def_readwrite("model_cache", &PyClass::model_cache)
       .def("__str__", &PyClass::ToString);
 }
 
@@ -37,6 +37,8 @@ static void PybindOfflineSpeakerSegmentationModelConfig(py::module *m) {
       .def_readwrite("num_threads", &PyClass::num_threads)
       .def_readwrite("debug", &PyClass::debug)
       .def_readwrite("provider", &PyClass::provider)
+      .def_readwrite("batch_size", &PyClass::batch_size)
+      .def_readwrite("num_parallel_batches", &PyClass::num_parallel_batches)
       .def("__str__", &PyClass::ToString)
       .def("validate", &PyClass::Validate);
 }
@@ -60,8 +62,24 @@ static void PybindOfflineSpeakerDiarizationConfig(py::module *m) {
       .def("validate", &PyClass::Validate);
 }
 
+static void PybindOfflineSpeakerDiarizationStream(py::module *m) {
+  using PyClass = OfflineSpeakerDiarizationStream;
+  py::class_<PyClass>(*m, "OfflineSpeakerDiarizationStream")
+      .def(
+          "accept_waveform",
+          [](PyClass &self, const std::vector<float> &samples) {
+            self.AcceptWaveform(samples.data(), samples.size());
+          },
+          py::arg("samples"), py::call_guard<py::gil_scoped_release>())
+      .def("flush", &PyClass::Flush,
+           py::call_guard<py::gil_scoped_release>())
+      .def("finalize", &PyClass::Finalize,
+           py::call_guard<py::gil_scoped_release>());
+}
+
 void PybindOfflineSpeakerDiarization(py::module *m) {
   PybindOfflineSpeakerDiarizationConfig(m);
+  PybindOfflineSpeakerDiarizationStream(m);
 
   using PyClass = OfflineSpeakerDiarization;
   py::class_<PyClass>(*m, "OfflineSpeakerDiarization")
@@ -69,6 +87,8 @@ void PybindOfflineSpeakerDiarization(py::module *m) {
            py::arg("config"))
       .def_property_readonly("sample_rate", &PyClass::SampleRate)
       .def("set_config", &PyClass::SetConfig, py::arg("config"))
+      .def("create_stream", &PyClass::CreateStream,
+           py::keep_alive<0, 1>())
       .def(
           "process",
           [](const PyClass &self, const std::vector<float> samples,
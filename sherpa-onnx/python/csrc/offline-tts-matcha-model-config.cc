@@ -30,6 +30,8 @@ void PybindOfflineTtsMatchaModelConfig(py::module *m) {
       .def_readwrite("dict_dir", &PyClass::dict_dir)
       .def_readwrite("noise_scale", &PyClass::noise_scale)
       .def_readwrite("length_scale", &PyClass::length_scale)
+      .def_readwrite("vocoder_chunk_size", &PyClass::vocoder_chunk_size)
+      .def_readwrite("vocoder_chunk_overlap", &PyClass::vocoder_chunk_overlap)
       .def("__str__", &PyClass::ToString)
       .def("validate", &PyClass::Validate);
 }
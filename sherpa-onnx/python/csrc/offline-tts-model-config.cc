@@ -32,6 +32,9 @@ void PybindOfflineTtsModelConfig(py::module *m) {
       .def_readwrite("num_threads", &PyClass::num_threads)
       .def_readwrite("debug", &PyClass::debug)
       .def_readwrite("provider", &PyClass::provider)
+      .def_readwrite("espeak_word_cache", &PyClass::espeak_word_cache)
+      .def_readwrite("espeak_word_cache_size",
+                     &PyClass::espeak_word_cache_size)
       .def("__str__", &PyClass::ToString);
 }
 
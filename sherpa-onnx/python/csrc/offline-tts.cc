@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/offline-tts.h"
 #include "sherpa-onnx/python/csrc/offline-tts-model-config.h"
@@ -25,8 +26,43 @@ static void PybindGeneratedAudio(py::module *m) {
       });
 }
 
+static void PybindOfflineTtsCacheConfig(py::module *m) {
+  using PyClass = OfflineTtsCacheConfig;
+  py::class_<PyClass>(*m, "OfflineTtsCacheConfig")
+      .def(py::init<>())
+      .def(py::init<int32_t, int32_t, const std::string &, int32_t>(),
+           py::arg("token_cache_size") = 0, py::arg("audio_cache_size_mb") = 0,
+           py::arg("audio_cache_file") = "", py::arg("tn_cache_size") = 0)
+      .def_readwrite("token_cache_size", &PyClass::token_cache_size)
+      .def_readwrite("audio_cache_size_mb", &PyClass::audio_cache_size_mb)
+      .def_readwrite("audio_cache_file", &PyClass::audio_cache_file)
+      .def_readwrite("tn_cache_size", &PyClass::tn_cache_size)
+      .def("validate", &PyClass::Validate)
+      .def("__str__", &PyClass::ToString);
+}
+
+static void PybindOfflineTtsCacheStats(py::module *m) {
+  using PyClass = OfflineTtsCacheStats;
+  py::class_<PyClass>(*m, "OfflineTtsCacheStats")
+      .def_readonly("token_cache_hits", &PyClass::token_cache_hits)
+      .def_readonly("token_cache_misses", &PyClass::token_cache_misses)
+      .def_readonly("audio_cache_hits", &PyClass::audio_cache_hits)
+      .def_readonly("audio_cache_misses", &PyClass::audio_cache_misses)
+      .def_readonly("audio_cache_entries", &PyClass::audio_cache_entries)
+      .def_readonly("audio_cache_bytes", &PyClass::audio_cache_bytes)
+      .def_readonly("tn_cache_hits", &PyClass::tn_cache_hits)
+      .def_readonly("tn_cache_misses", &PyClass::tn_cache_misses)
+      .def_property_readonly("token_cache_hit_rate",
+                             &PyClass::TokenCacheHitRate)
+      .def_property_readonly("audio_cache_hit_rate",
+                             &PyClass::AudioCacheHitRate)
+      .def_property_readonly("tn_cache_hit_rate", &PyClass::TnCacheHitRate)
+      .def("__str__", &PyClass::ToString);
+}
+
 static void PybindOfflineTtsConfig(py::module *m) {
   PybindOfflineTtsModelConfig(m);
+  PybindOfflineTtsCacheConfig(m);
 
   using PyClass = OfflineTtsConfig;
   py::class_<PyClass>(*m, "OfflineTtsConfig")
@@ -39,6 +75,9 @@ static void PybindOfflineTtsConfig(py::module *m) {
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("rule_fars", &PyClass::rule_fars)
       .def_readwrite("max_num_sentences", &PyClass::max_num_sentences)
+      .def_readwrite("num_batch_threads", &PyClass::num_batch_threads)
+      .def_readwrite("num_sentence_threads", &PyClass::num_sentence_threads)
+      .def_readwrite("cache", &PyClass::cache)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -46,6 +85,7 @@ static void PybindOfflineTtsConfig(py::module *m) {
 void PybindOfflineTts(py::module *m) {
   PybindOfflineTtsConfig(m);
   PybindGeneratedAudio(m);
+  PybindOfflineTtsCacheStats(m);
 
   using PyClass = OfflineTts;
   py::class_<PyClass>(*m, "OfflineTts")
@@ -53,6 +93,9 @@ void PybindOfflineTts(py::module *m) {
            py::call_guard<py::gil_scoped_release>())
       .def_property_readonly("sample_rate", &PyClass::SampleRate)
       .def_property_readonly("num_speakers", &PyClass::NumSpeakers)
+      .def("get_cache_stats", &PyClass::GetCacheStats)
+      .def("save_cache", &PyClass::SaveCache,
+           py::call_guard<py::gil_scoped_release>())
       .def(
           "generate",
           [](const PyClass &self, const std::string &text, int64_t sid,
@@ -82,7 +125,11 @@ void PybindOfflineTts(py::module *m) {
           },
           py::arg("text"), py::arg("sid") = 0, py::arg("speed") = 1.0,
           py::arg("callback") = py::none(),
-          py::call_guard<py::gil_scoped_release>());
+          py::call_guard<py::gil_scoped_release>())
+      .def("generate_batch", &PyClass::GenerateBatch, py::arg("texts"),
+           py::arg("sids") = std::vector<int64_t>{},
+           py::arg("speeds") = std::vector<float>{},
+           py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
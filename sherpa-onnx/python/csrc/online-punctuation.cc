@@ -5,6 +5,7 @@
 #include "sherpa-onnx/python/csrc/online-punctuation.h"
 
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/online-punctuation.h"
 
@@ -24,6 +25,7 @@ static void PybindOnlinePunctuationModelConfig(py::module *m) {
       .def_readwrite("num_threads", &PyClass::num_threads)
       .def_readwrite("debug", &PyClass::debug)
       .def_readwrite("provider", &PyClass::provider)
+      .def_readwrite("batch_size", &PyClass::batch_size)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -49,7 +51,10 @@ void PybindOnlinePunctuation(py::module *m) {
       .def(py::init<const OnlinePunctuationConfig &>(), py::arg("config"),
            py::call_guard<py::gil_scoped_release>())
       .def("add_punctuation_with_case", &PyClass::AddPunctuationWithCase,
-           py::arg("text"), py::call_guard<py::gil_scoped_release>());
+           py::arg("text"), py::call_guard<py::gil_scoped_release>())
+      .def("add_punctuation_with_case_batch",
+           &PyClass::AddPunctuationWithCaseBatch, py::arg("texts"),
+           py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
@@ -82,6 +82,8 @@ static void PybindOnlineRecognizerConfig(py::module *m) {
       .def_readwrite("temperature_scale", &PyClass::temperature_scale)
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("rule_fars", &PyClass::rule_fars)
+      .def_readwrite("shared_runtime", &PyClass::shared_runtime)
+      .def_readwrite("model_cache", &PyClass::model_cache)
       .def("__str__", &PyClass::ToString);
 }
 
@@ -0,0 +1,27 @@
+// sherpa-onnx/python/csrc/shared-runtime-config.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/shared-runtime-config.h"
+
+#include "sherpa-onnx/csrc/shared-runtime-config.h"
+
+namespace sherpa_onnx {
+
+void PybindSharedRuntimeConfig(py::module *m) {
+  using PyClass = SharedRuntimeConfig;
+  py::class_<PyClass>(*m, "SharedRuntimeConfig")
+      .def(py::init<>())
+      .def(py::init<bool, int32_t, int32_t, bool>(),
+           py::arg("enabled") = false, py::arg("intra_op_num_threads") = 0,
+           py::arg("inter_op_num_threads") = 1,
+           py::arg("allow_spinning") = true)
+      .def_readwrite("enabled", &PyClass::enabled)
+      .def_readwrite("intra_op_num_threads", &PyClass::intra_op_num_threads)
+      .def_readwrite("inter_op_num_threads", &PyClass::inter_op_num_threads)
+      .def_readwrite("allow_spinning", &PyClass::allow_spinning)
+      .def("__str__", &PyClass::ToString)
+      .def("validate", &PyClass::Validate);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,16 @@
+// sherpa-onnx/python/csrc/shared-runtime-config.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_SHARED_RUNTIME_CONFIG_H_
+#define SHERPA_ONNX_PYTHON_CSRC_SHARED_RUNTIME_CONFIG_H_
+
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+void PybindSharedRuntimeConfig(py::module *m);
+
+}
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_SHARED_RUNTIME_CONFIG_H_
@@ -21,6 +21,7 @@ static void PybindSpeakerEmbeddingExtractorConfig(py::module *m) {
       .def_readwrite("num_threads", &PyClass::num_threads)
       .def_readwrite("debug", &PyClass::debug)
       .def_readwrite("provider", &PyClass::provider)
+      .def_readwrite("batch_size", &PyClass::batch_size)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -37,6 +38,12 @@ void PybindSpeakerEmbeddingExtractor(py::module *m) {
            py::call_guard<py::gil_scoped_release>())
       .def("compute", &PyClass::Compute,
            py::call_guard<py::gil_scoped_release>())
+      .def(
+          "compute_batch",
+          [](const PyClass &self, std::vector<OnlineStream *> &ss) {
+            return self.ComputeBatch(ss.data(), ss.size());
+          },
+          py::arg("streams"), py::call_guard<py::gil_scoped_release>())
       .def("is_ready", &PyClass::IsReady,
            py::call_guard<py::gil_scoped_release>());
 }
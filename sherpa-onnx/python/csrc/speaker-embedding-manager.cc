@@ -11,11 +11,31 @@
 
 namespace sherpa_onnx {
 
+static void PybindSpeakerEmbeddingManagerConfig(py::module *m) {
+  using PyClass = SpeakerEmbeddingManagerConfig;
+  py::class_<PyClass>(*m, "SpeakerEmbeddingManagerConfig")
+      .def(py::init<>())
+      .def(py::init<int32_t, int32_t, int32_t>(),
+           py::arg("index_num_lists") = 0, py::arg("index_num_probes") = 16,
+           py::arg("index_min_num_speakers") = 100000)
+      .def_readwrite("index_num_lists", &PyClass::index_num_lists)
+      .def_readwrite("index_num_probes", &PyClass::index_num_probes)
+      .def_readwrite("index_min_num_speakers",
+                     &PyClass::index_min_num_speakers)
+      .def("validate", &PyClass::Validate)
+      .def("__str__", &PyClass::ToString);
+}
+
 void PybindSpeakerEmbeddingManager(py::module *m) {
+  PybindSpeakerEmbeddingManagerConfig(m);
+
   using PyClass = SpeakerEmbeddingManager;
   py::class_<PyClass>(*m, "SpeakerEmbeddingManager")
       .def(py::init<int32_t>(), py::arg("dim"),
            py::call_guard<py::gil_scoped_release>())
+      .def(py::init<int32_t, const SpeakerEmbeddingManagerConfig &>(),
+           py::arg("dim"), py::arg("config"),
+           py::call_guard<py::gil_scoped_release>())
       .def_property_readonly("num_speakers", &PyClass::NumSpeakers)
       .def_property_readonly("dim", &PyClass::Dim)
       .def_property_readonly("all_speakers", &PyClass::GetAllSpeakers)
@@ -41,6 +61,27 @@ void PybindSpeakerEmbeddingManager(py::module *m) {
           },
           py::arg("name"), py::arg("embedding_list"),
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "add_many",
+          [](const PyClass &self, const std::vector<std::string> &names,
+             const std::vector<std::vector<float>> &embeddings) -> int32_t {
+            if (names.size() != embeddings.size()) {
+              throw py::value_error(
+                  "names and embeddings should have the same length");
+            }
+
+            std::vector<float> v;
+            v.reserve(embeddings.size() * self.Dim());
+            for (const auto &e : embeddings) {
+              if (static_cast<int32_t>(e.size()) != self.Dim()) {
+                throw py::value_error("Invalid embedding dimension");
+              }
+              v.insert(v.end(), e.begin(), e.end());
+            }
+
+            return self.AddMany(names, v.data());
+          },
+          py::arg("names"), py::arg("embeddings"))
       .def(
           "remove",
           [](const PyClass &self, const std::string &name) -> bool {
@@ -53,6 +94,23 @@ void PybindSpeakerEmbeddingManager(py::module *m) {
               -> std::string { return self.Search(v.data(), threshold); },
           py::arg("v"), py::arg("threshold"),
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "search_many",
+          [](const PyClass &self,
+             const std::vector<std::vector<float>> &embeddings,
+             float threshold) -> std::vector<std::string> {
+            std::vector<float> v;
+            v.reserve(embeddings.size() * self.Dim());
+            for (const auto &e : embeddings) {
+              if (static_cast<int32_t>(e.size()) != self.Dim()) {
+                throw py::value_error("Invalid embedding dimension");
+              }
+              v.insert(v.end(), e.begin(), e.end());
+            }
+
+            return self.SearchMany(v.data(), embeddings.size(), threshold);
+          },
+          py::arg("embeddings"), py::arg("threshold"))
       .def(
           "verify",
           [](const PyClass &self, const std::string &name,
@@ -61,6 +119,12 @@ void PybindSpeakerEmbeddingManager(py::module *m) {
           },
           py::arg("name"), py::arg("v"), py::arg("threshold"),
           py::call_guard<py::gil_scoped_release>())
+      .def("save", &PyClass::Save, py::arg("filename"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("append", &PyClass::Append, py::arg("filename"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("load", &PyClass::Load, py::arg("filename"),
+           py::call_guard<py::gil_scoped_release>())
       .def(
           "score",
           [](const PyClass &self, const std::string &name,
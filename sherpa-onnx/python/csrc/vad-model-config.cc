@@ -8,11 +8,13 @@
 
 #include "sherpa-onnx/csrc/vad-model-config.h"
 #include "sherpa-onnx/python/csrc/silero-vad-model-config.h"
+#include "sherpa-onnx/python/csrc/vad-pre-gate.h"
 
 namespace sherpa_onnx {
 
 void PybindVadModelConfig(py::module *m) {
   PybindSileroVadModelConfig(m);
+  PybindVadPreGateConfig(m);
 
   using PyClass = VadModelConfig;
   py::class_<PyClass>(*m, "VadModelConfig")
@@ -27,6 +29,7 @@ void PybindVadModelConfig(py::module *m) {
       .def_readwrite("num_threads", &PyClass::num_threads)
       .def_readwrite("provider", &PyClass::provider)
       .def_readwrite("debug", &PyClass::debug)
+      .def_readwrite("pre_gate", &PyClass::pre_gate)
       .def("__str__", &PyClass::ToString)
       .def("validate", &PyClass::Validate);
 }
@@ -0,0 +1,28 @@
+// sherpa-onnx/python/csrc/vad-pre-gate.cc
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/vad-pre-gate.h"
+
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
+
+namespace sherpa_onnx {
+
+void PybindVadPreGateConfig(py::module *m) {
+  using PyClass = VadPreGateConfig;
+  py::class_<PyClass>(*m, "VadPreGateConfig")
+      .def(py::init<>())
+      .def(py::init<bool, float, float, float, float>(),
+           py::arg("enabled") = false, py::arg("low_energy_db") = -60,
+           py::arg("high_energy_db") = -50,
+           py::arg("zero_crossing_rate") = 0.35, py::arg("hangover") = 0.5)
+      .def_readwrite("enabled", &PyClass::enabled)
+      .def_readwrite("low_energy_db", &PyClass::low_energy_db)
+      .def_readwrite("high_energy_db", &PyClass::high_energy_db)
+      .def_readwrite("zero_crossing_rate", &PyClass::zero_crossing_rate)
+      .def_readwrite("hangover", &PyClass::hangover)
+      .def("__str__", &PyClass::ToString)
+      .def("validate", &PyClass::Validate);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,16 @@
+// sherpa-onnx/python/csrc/vad-pre-gate.h
+//
+// Copyright (c)  2024  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_VAD_PRE_GATE_H_
+#define SHERPA_ONNX_PYTHON_CSRC_VAD_PRE_GATE_H_
+
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+void PybindVadPreGateConfig(py::module *m);
+
+}
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_VAD_PRE_GATE_H_
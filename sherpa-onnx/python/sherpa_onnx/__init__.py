@@ -19,6 +19,7 @@ from _sherpa_onnx import (
     OfflineSpeakerSegmentationPyannoteModelConfig,
     OfflineStream,
     OfflineTts,
+    OfflineTtsCacheConfig,
     OfflineTtsConfig,
     OfflineTtsMatchaModelConfig,
     OfflineTtsModelConfig,
@@ -32,12 +33,14 @@ from _sherpa_onnx import (
     SpeakerEmbeddingExtractor,
     SpeakerEmbeddingExtractorConfig,
     SpeakerEmbeddingManager,
+    SpeakerEmbeddingManagerConfig,
     SpeechSegment,
     SpokenLanguageIdentification,
     SpokenLanguageIdentificationConfig,
     SpokenLanguageIdentificationWhisperConfig,
     VadModel,
     VadModelConfig,
+    VadPreGateConfig,
     VoiceActivityDetector,
     write_wave,
 )
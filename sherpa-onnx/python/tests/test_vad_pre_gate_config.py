@@ -0,0 +1,38 @@
+# sherpa-onnx/python/tests/test_vad_pre_gate_config.py
+#
+# Copyright (c)  2024  Xiaomi Corporation
+#
+# To run this single test, use
+#
+#  ctest --verbose -R  test_vad_pre_gate_config_py
+
+import unittest
+
+import _sherpa_onnx
+
+
+class TestVadPreGateConfig(unittest.TestCase):
+    def test_constructor(self):
+        config = _sherpa_onnx.VadPreGateConfig(
+            enabled=True,
+            low_energy_db=-70,
+            high_energy_db=-55,
+        )
+        assert config.enabled, config.enabled
+        assert config.low_energy_db == -70, config.low_energy_db
+        assert config.high_energy_db == -55, config.high_energy_db
+        assert abs(config.hangover - 0.5) < 1e-6, config.hangover
+        assert config.validate()
+        print(config)
+
+    def test_vad_model_config(self):
+        config = _sherpa_onnx.VadModelConfig()
+        assert not config.pre_gate.enabled, config.pre_gate.enabled
+
+        config.pre_gate = _sherpa_onnx.VadPreGateConfig(enabled=True)
+        assert config.pre_gate.enabled, config.pre_gate.enabled
+        print(config)
+
+
+if __name__ == "__main__":
+    unittest.main()